@@ -92,6 +92,25 @@ typedef struct {
   byte blue;
 } colorInstruction;
 
+// how a light gets to its new color: the Console sends the color once, and each unit
+// fades to it on its own.  see Simon_Fade.h.
+enum fadeEasing {
+  E_Linear=0, // even steps
+  E_EaseIn, // slow away, quick in
+  E_EaseOut, // quick away, slow in
+  E_EaseInOut, // slow at both ends
+
+  N_fadeEasings
+};
+
+typedef struct {
+  byte duration; // fade duration in 10's of ms. e.g. "42" maps to 420 ms.  0 goes straight there.
+  byte easing; // see above
+} fadeInstruction;
+
+// the longest fade one instruction can carry
+const unsigned long maxFadeTime = 2550UL;
+
 enum animationInstruction {
   A_None,
   A_Clear,
@@ -127,6 +146,8 @@ const colorInstruction cYellowConsole = {255, 255, 0};
 const colorInstruction cWhite = {255, 255, 255};
 // and this serves as an easy way to pull out the right RGB color from the
 const colorInstruction cMap[N_COLORS] = {cRed, cGreen, cBlue, cYellow};
+// no fade: the light steps to its color, as it always has
+const fadeInstruction fStep = {0, E_Linear};
 
 //**** System Modes
 
@@ -154,6 +175,7 @@ typedef struct {
   colorInstruction light[N_COLORS];
   byte animation; // not animationInstruction.  enums are stored as ints (2 bytes), and we only need 1 byte to represent the animations.
   fireInstruction fire[N_COLORS];
+  fadeInstruction fade[N_COLORS]; // how each light gets to light[]
 
 } systemState;
 
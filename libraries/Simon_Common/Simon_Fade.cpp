@@ -0,0 +1,65 @@
+#include "Simon_Fade.h"
+
+byte fadeEase(byte easing, byte t) {
+  switch ( easing ) {
+    case E_EaseIn:
+      return ( (unsigned int)t * t / 255 );
+    case E_EaseOut:
+      return ( 255 - (unsigned int)(255 - t) * (255 - t) / 255 );
+    case E_EaseInOut:
+      // the two halves of the above, each over half the fade
+      if ( t < 128 ) return ( 2U * t * t / 255 );
+      return ( 255 - 2U * (255 - t) * (255 - t) / 255 );
+  }
+  return ( t );
+}
+
+static byte fadeChannel(byte a, byte b, byte e) {
+  return ( fadeBlend<int, long>(a, b, e) );
+}
+
+void ColorFade::begin(const colorInstruction &color) {
+  this->color = this->target = this->from = color;
+  this->fade = fStep;
+  this->moving = false;
+  this->dirty = true;
+}
+
+void ColorFade::start(const colorInstruction &to, const fadeInstruction &fade, unsigned long now) {
+  this->dirty = true;
+  if ( memcmp(&to, &this->target, sizeof(colorInstruction)) == 0 && memcmp(&fade, &this->fade, sizeof(fadeInstruction)) == 0 ) return;
+
+  this->from = this->color;
+  this->target = to;
+  this->fade = fade;
+  this->startTime = now;
+  this->moving = fade.duration > 0;
+  if ( !this->moving ) this->color = to;
+}
+
+boolean ColorFade::update(unsigned long now) {
+  if ( this->moving ) {
+    unsigned long elapsed = now - this->startTime;
+    unsigned long duration = this->fade.duration * 10UL;
+    colorInstruction was = this->color;
+
+    if ( elapsed >= duration ) {
+      this->color = this->target;
+      this->moving = false;
+    } else {
+      byte e = fadeEase(this->fade.easing, elapsed * 255UL / duration);
+      this->color.red = fadeChannel(this->from.red, this->target.red, e);
+      this->color.green = fadeChannel(this->from.green, this->target.green, e);
+      this->color.blue = fadeChannel(this->from.blue, this->target.blue, e);
+    }
+    if ( memcmp(&was, &this->color, sizeof(colorInstruction)) != 0 ) this->dirty = true;
+  }
+
+  boolean show = this->dirty;
+  this->dirty = false;
+  return ( show );
+}
+
+boolean ColorFade::fading() {
+  return ( this->moving );
+}
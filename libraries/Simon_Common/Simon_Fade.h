@@ -0,0 +1,53 @@
+#ifndef Simon_Fade_h
+#define Simon_Fade_h
+
+//**** Color fades
+// The Console sends a light's color once, with how long to take getting there and the
+// easing curve (fadeInstruction, in systemState next to the color).  The Light module and
+// the Towers fade to it themselves, a step whenever a channel moves, so a fade that used
+// to be a packet every few tens of ms is one packet, and it doesn't step when one's lost.
+//
+// A new color mid-fade fades on from wherever the light has got to.  Integer math only:
+// the progress is a byte, 0 to 255, through the curve, then each channel from and to.
+
+#include <Arduino.h>
+#include <Simon_Common.h>
+
+// 't' of 255 along a fade, through 'easing'; 0 and 255 stay put.
+byte fadeEase(byte easing, byte t);
+
+// 'e' of 255 of the way from 'a' to 'b'.  (b - a) * e reaches 65025 either way, past the
+// board's 16-bit int, so the multiply's in 'L', twice the width of 'I'.  The fader uses
+// <int, long>; the host tests run it at the board's widths, int16_t and int32_t.
+template <typename I, typename L> byte fadeBlend(byte a, byte b, byte e) {
+  L p = (L)((I)b - (I)a) * e;
+  return ( a + (I)(p / 255) );
+}
+
+class ColorFade {
+  public:
+    // showing 'color', still.
+    void begin(const colorInstruction &color);
+
+    // from what's showing to 'to', as 'fade' says, starting at 'now' (ms).  the same
+    // instruction again (a resend, or a packet about something else) carries on as it was.
+    void start(const colorInstruction &to, const fadeInstruction &fade, unsigned long now);
+
+    // moves 'color' along to 'now' (ms).  true if it needs showing: it's moved, or start()
+    // was called since.
+    boolean update(unsigned long now);
+
+    // still on its way
+    boolean fading();
+
+    // what's showing, and where it's headed
+    colorInstruction color, target;
+
+  private:
+    colorInstruction from;
+    fadeInstruction fade;
+    unsigned long startTime; // ms
+    boolean moving, dirty;
+};
+
+#endif
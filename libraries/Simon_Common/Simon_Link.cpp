@@ -0,0 +1,35 @@
+#include "Simon_Link.h"
+
+void LightLink::begin(Stream *port) {
+  this->port = port;
+  this->heard = this->granted = false;
+  this->frames = this->unflowed = 0;
+}
+
+void LightLink::update(unsigned long now) {
+  // only the last word counts
+  while ( this->port->available() ) {
+    byte b = this->port->read();
+    if ( b != LINK_XON && b != LINK_XOFF ) continue;
+    this->granted = b == LINK_XON;
+    this->heard = true;
+    this->heardTime = now;
+  }
+
+  // the Light went quiet: as it was
+  if ( this->heard && now - this->heardTime > LINK_SILENT ) this->heard = false;
+}
+
+boolean LightLink::clear() {
+  return ( !this->heard || this->granted );
+}
+
+boolean LightLink::flowing() {
+  return ( this->heard );
+}
+
+void LightLink::sent() {
+  this->frames++;
+  if ( !this->heard ) this->unflowed++;
+  this->granted = false;
+}
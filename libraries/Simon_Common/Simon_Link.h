@@ -0,0 +1,45 @@
+#ifndef Simon_Link_h
+#define Simon_Link_h
+
+//**** Console to Light, over Serial1
+// The Console sends systemState as EasyTransfer frames; the Light answers with flow control.
+// The Light can't take bytes while a strip's show() has interrupts off (9.6 ms for the rim;
+// the UART keeps three bytes), so it says when it's clear: XON when it opens a window, and
+// again after each frame it takes; XOFF before it shows.  After an XOFF it waits a grace
+// time for a frame already on its way.  The Console sends one frame per XON.  A Light
+// that says nothing (older firmware, no wire back) gets frames whenever, as before.
+
+#include <Arduino.h>
+
+#define LINK_XON 0x11
+#define LINK_XOFF 0x13
+#define LINK_GRACE_US 1000UL // Light: after XOFF, for a frame the Console started before it heard
+#define LINK_OPEN_MIN 5UL // ms; Light: a window stays open at least this long
+#define LINK_KEEPALIVE 250UL // ms; Light: XON again this often while open
+#define LINK_FRAME_MS 10UL // Light: a frame that's started and gone quiet this long is lost
+#define LINK_SILENT 1000UL // ms; Console: nothing from the Light this long, send without it
+
+// the Console's end
+class LightLink {
+  public:
+    void begin(Stream *port);
+
+    // reads what the Light has said.  call often.
+    void update(unsigned long now);
+    // may a frame go?
+    boolean clear();
+    // is the Light saying when?
+    boolean flowing();
+    // one did
+    void sent();
+
+    // frames sent, and of those, sent without the Light's say-so
+    unsigned long frames, unflowed;
+
+  private:
+    Stream *port;
+    boolean heard, granted;
+    unsigned long heardTime; // ms
+};
+
+#endif
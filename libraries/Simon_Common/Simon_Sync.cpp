@@ -0,0 +1,31 @@
+#include "Simon_Sync.h"
+
+void ClockSync::begin() {
+  this->samples = this->next = 0;
+}
+
+void ClockSync::sample(unsigned long console, unsigned long local) {
+  this->offset[this->next] = (long)(console - local);
+  this->next = (this->next + 1) % SYNC_WINDOW;
+  if ( this->samples < SYNC_WINDOW ) this->samples++;
+  this->sampleTime = local;
+}
+
+boolean ClockSync::synced(unsigned long local) {
+  return ( this->samples > 0 && local - this->sampleTime < SYNC_STALE );
+}
+
+unsigned long ClockSync::console(unsigned long local) {
+  // the least delayed sample
+  long best = this->offset[0];
+  for ( byte i = 1; i < this->samples; i++ ) best = max(best, this->offset[i]);
+  return ( local + best + SYNC_DELAY );
+}
+
+unsigned long ClockSync::due(uint16_t at, unsigned long local) {
+  if ( !this->synced(local) ) return ( local );
+
+  // 'at' is near the Console's now, one way or the other: a signed 16 bits of ms is 32.7 s either side.
+  int16_t wait = (int16_t)(uint16_t)(at - (uint16_t)this->console(local));
+  return ( wait > 0 ? local + wait : local );
+}
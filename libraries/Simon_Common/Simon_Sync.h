@@ -0,0 +1,41 @@
+#ifndef Simon_Sync_h
+#define Simon_Sync_h
+
+//**** Clock sync
+// The Console broadcasts its millis() now and then (wireSync); every Tower hears the same
+// frame at the same moment, so each can keep an offset from its own millis() to the
+// Console's.  Instructions then carry the Console time to act at, and the Towers act together
+// however late or often their copy of the instruction arrived.
+//
+// Each sync sample is the Console's stamp less our clock when we read it.  The frame can only
+// be late reaching us (airtime, our loop), never early, so the largest of the last few samples
+// is the best estimate; a window of them tracks the crystals drifting apart.
+
+#include <Arduino.h>
+
+#define SYNC_WINDOW 4 // samples kept
+#define SYNC_DELAY 1 // ms; from the Console's stamp to the fastest we can read it
+#define SYNC_STALE 5000UL // ms; without a sample this long, stop trusting the offset
+
+class ClockSync {
+  public:
+    void begin();
+
+    // a sync frame stamped 'console' read at our 'local' time.
+    void sample(unsigned long console, unsigned long local);
+    boolean synced(unsigned long local);
+
+    // the Console's clock at our 'local' time.
+    unsigned long console(unsigned long local);
+
+    // our time to act on an instruction stamped 'at' (the low 16 bits of Console ms),
+    // given it's 'local' now.  now if we aren't synced, or it's already late.
+    unsigned long due(uint16_t at, unsigned long local);
+
+  private:
+    long offset[SYNC_WINDOW];
+    byte samples, next;
+    unsigned long sampleTime;
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include "Simon_Wire.h"
+
+#include <stddef.h> // offsetof
+
+#define WIRE_HEADER(type) ((WIRE_VERSION << 4) | (type))
+
+// where mask bit f lives in systemState
+static void wireField(byte f, byte &offset, byte &size) {
+  if ( f == 0 ) {
+    offset = offsetof(systemState, mode);
+    size = sizeof(byte);
+  } else if ( f == 1 ) {
+    offset = offsetof(systemState, animation);
+    size = sizeof(byte);
+  } else if ( f < 2 + N_COLORS ) {
+    offset = offsetof(systemState, light) + (f - 2) * sizeof(colorInstruction);
+    size = sizeof(colorInstruction);
+  } else if ( f < 2 + 2*N_COLORS ) {
+    offset = offsetof(systemState, fire) + (f - 2 - N_COLORS) * sizeof(fireInstruction);
+    size = sizeof(fireInstruction);
+  } else {
+    offset = offsetof(systemState, fade) + (f - 2 - 2*N_COLORS) * sizeof(fadeInstruction);
+    size = sizeof(fadeInstruction);
+  }
+}
+
+// true if packet number a is at or after b, allowing for wrap.
+static boolean wireAtOrAfter(byte a, byte b) {
+  return ( (byte)(a - b) < 128 );
+}
+
+byte wireKeyframe(const systemState &state, uint16_t at, byte *frame) {
+  frame[0] = WIRE_HEADER(W_KEYFRAME);
+  memcpy(&frame[1], &state, sizeof(systemState));
+  frame[1 + sizeof(systemState)] = lowByte(at);
+  frame[2 + sizeof(systemState)] = highByte(at);
+  return ( WIRE_KEYFRAME_SIZE );
+}
+
+byte wireDelta(const systemState &state, const systemState &key, unsigned int &touched, uint16_t at, byte *frame) {
+  frame[0] = WIRE_HEADER(W_DELTA);
+  frame[1] = state.packetNumber;
+  frame[2] = key.packetNumber;
+  frame[5] = lowByte(at);
+  frame[6] = highByte(at);
+
+  byte len = WIRE_DELTA_HEADER_SIZE;
+  for ( byte f = 0; f < WIRE_FIELDS; f++ ) {
+    byte offset, size;
+    wireField(f, offset, size);
+    const byte *now = (const byte *)&state + offset;
+    // once a field has changed, keep sending it: it may have changed back, and a receiver
+    // that heard the change needs to hear that too.
+    if ( memcmp(now, (const byte *)&key + offset, size) != 0 ) touched |= 1U << f;
+    if ( touched & (1U << f) ) {
+      memcpy(&frame[len], now, size);
+      len += size;
+    }
+  }
+  frame[3] = lowByte(touched);
+  frame[4] = highByte(touched);
+
+  return ( len );
+}
+
+boolean wirePacketNumber(const byte *frame, byte len, byte &packetNumber) {
+  if ( len < 2 || (frame[0] >> 4) != WIRE_VERSION ) return ( false );
+  if ( (frame[0] & 0x0F) != W_KEYFRAME && (frame[0] & 0x0F) != W_DELTA ) return ( false );
+  // both frame types have it second
+  packetNumber = frame[1];
+  return ( true );
+}
+
+boolean wireExecuteAt(const byte *frame, byte len, uint16_t &at) {
+  if ( len < 2 || (frame[0] >> 4) != WIRE_VERSION ) return ( false );
+  switch ( frame[0] & 0x0F ) {
+    case W_KEYFRAME:
+      if ( len != WIRE_KEYFRAME_SIZE ) return ( false );
+      at = word(frame[2 + sizeof(systemState)], frame[1 + sizeof(systemState)]);
+      return ( true );
+    case W_DELTA:
+      if ( len < WIRE_DELTA_HEADER_SIZE ) return ( false );
+      at = word(frame[6], frame[5]);
+      return ( true );
+  }
+  return ( false );
+}
+
+boolean wireApply(const byte *frame, byte len, systemState &state, boolean &valid) {
+  if ( len < 2 || (frame[0] >> 4) != WIRE_VERSION ) return ( false );
+  byte packetNumber = frame[1];
+
+  switch ( frame[0] & 0x0F ) {
+    case W_KEYFRAME:
+      // complete, so always good; even if the Console restarted and the numbers went back.
+      if ( len != WIRE_KEYFRAME_SIZE ) return ( false );
+      memcpy(&state, &frame[1], sizeof(systemState));
+      valid = true;
+      return ( true );
+
+    case W_DELTA: {
+      if ( len < WIRE_DELTA_HEADER_SIZE ) return ( false );
+      // need everything up to its keyframe.  resends are harmless, but don't go backwards.
+      if ( !valid || !wireAtOrAfter(state.packetNumber, frame[2]) ) return ( false );
+      if ( !wireAtOrAfter(packetNumber, state.packetNumber) ) return ( false );
+
+      unsigned int mask = word(frame[4], frame[3]);
+      byte at = WIRE_DELTA_HEADER_SIZE;
+      // check the length before touching anything
+      for ( byte f = 0; f < WIRE_FIELDS; f++ ) {
+        if ( !(mask & (1U << f)) ) continue;
+        byte offset, size;
+        wireField(f, offset, size);
+        at += size;
+      }
+      if ( at != len ) return ( false );
+
+      at = WIRE_DELTA_HEADER_SIZE;
+      for ( byte f = 0; f < WIRE_FIELDS; f++ ) {
+        if ( !(mask & (1U << f)) ) continue;
+        byte offset, size;
+        wireField(f, offset, size);
+        memcpy((byte *)&state + offset, &frame[at], size);
+        at += size;
+      }
+      state.packetNumber = packetNumber;
+      return ( true );
+    }
+  }
+
+  return ( false );
+}
+
+byte wireReport(byte node, unsigned int heard, unsigned int missed, byte *frame) {
+  frame[0] = WIRE_HEADER(W_REPORT);
+  frame[1] = node;
+  frame[2] = lowByte(heard);
+  frame[3] = highByte(heard);
+  frame[4] = lowByte(missed);
+  frame[5] = highByte(missed);
+  return ( WIRE_REPORT_SIZE );
+}
+
+boolean wireReadReport(const byte *frame, byte len, byte &node, unsigned int &heard, unsigned int &missed) {
+  if ( len != WIRE_REPORT_SIZE || frame[0] != WIRE_HEADER(W_REPORT) ) return ( false );
+  node = frame[1];
+  heard = word(frame[3], frame[2]);
+  missed = word(frame[5], frame[4]);
+  return ( true );
+}
+
+byte wireFire(byte seq, const fireInstruction &inst, uint16_t at, byte *frame) {
+  frame[0] = WIRE_HEADER(W_FIRE);
+  frame[1] = seq;
+  frame[2] = inst.duration;
+  frame[3] = inst.effect;
+  frame[4] = lowByte(at);
+  frame[5] = highByte(at);
+  return ( WIRE_FIRE_SIZE );
+}
+
+boolean wireReadFire(const byte *frame, byte len, byte &seq, fireInstruction &inst, uint16_t &at) {
+  if ( len != WIRE_FIRE_SIZE || frame[0] != WIRE_HEADER(W_FIRE) ) return ( false );
+  seq = frame[1];
+  inst.duration = frame[2];
+  inst.effect = frame[3];
+  at = word(frame[5], frame[4]);
+  return ( true );
+}
+
+byte wireFireAck(byte seq, byte *frame) {
+  frame[0] = WIRE_HEADER(W_FIRE_ACK);
+  frame[1] = seq;
+  return ( WIRE_FIRE_ACK_SIZE );
+}
+
+boolean wireReadFireAck(const byte *frame, byte len, byte &seq) {
+  if ( len != WIRE_FIRE_ACK_SIZE || frame[0] != WIRE_HEADER(W_FIRE_ACK) ) return ( false );
+  seq = frame[1];
+  return ( true );
+}
+
+byte wireSync(unsigned long ms, byte *frame) {
+  frame[0] = WIRE_HEADER(W_SYNC);
+  for ( byte i = 0; i < 4; i++ ) frame[1 + i] = (ms >> (8 * i)) & 0xFF;
+  return ( WIRE_SYNC_SIZE );
+}
+
+boolean wireReadSync(const byte *frame, byte len, unsigned long &ms) {
+  if ( len != WIRE_SYNC_SIZE || frame[0] != WIRE_HEADER(W_SYNC) ) return ( false );
+  ms = 0;
+  for ( byte i = 0; i < 4; i++ ) ms |= (unsigned long)frame[1 + i] << (8 * i);
+  return ( true );
+}
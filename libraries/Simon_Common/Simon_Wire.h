@@ -0,0 +1,98 @@
+#ifndef Simon_Wire_h
+#define Simon_Wire_h
+
+//**** Radio wire format
+// systemState goes over the air as one of:
+//
+//   keyframe: [header] [systemState] [at lo] [at hi]      everything; sent now and then, and
+//                                                          whenever a delta wouldn't be shorter.
+//   delta:    [header] [packet] [key] [mask lo] [mask hi] [at lo] [at hi] [fields...]
+//                                                          the fields that have changed since
+//                                                          keyframe 'key', in mask bit order.
+//
+// header is WIRE_VERSION in the high nibble and the frame type in the low nibble; receivers
+// ignore versions they don't know.  A delta carries the fields changed since its keyframe, not
+// since the last delta, so it applies to any state at or after the keyframe: a receiver that
+// misses some deltas catches up on the next one it hears.
+//
+// 'at' is when to act on the packet: the low 16 bits of the Console's millis().  Towers keep
+// the Console's time from sync frames (see Simon_Sync.h), so they all act at once:
+//
+//   sync:     [header] [ms] [ms] [ms] [ms]                 the Console's millis(), low byte first,
+//                                                          stamped as it goes on the air.
+//
+// mask bits: mode, animation, then light[], fire[] and fade[] per tower.  16 bits leaves
+// room for up to WIRE_MAX_TOWERS towers.  A fade goes out once with its color; the Towers
+// fade on their own (Simon_Fade.h), so a fade is one packet rather than one a step.
+//
+// Towers talk back with:
+//
+//   report:   [header] [node] [heard lo] [heard hi] [missed lo] [missed hi]
+//                                                          running counts of Console frames heard
+//                                                          and packet numbers never heard; they wrap.
+//
+// Fire goes to each Tower on its own, acknowledged, instead of in systemState:
+//
+//   fire:     [header] [seq] [duration] [effect] [at lo] [at hi]
+//                                                          Console to one Tower, ACK requested.
+//   fire ack: [header] [seq]                               the Tower's ACK payload.
+//
+// seq counts per Tower.  The Console retries until it hears the ack; a Tower that gets the
+// same seq again soon after acks it again but doesn't fire twice.
+
+#include <Arduino.h>
+#include <Simon_Common.h>
+
+#define WIRE_VERSION 3
+
+enum wireFrame {
+  W_KEYFRAME=0,
+  W_DELTA,
+  W_REPORT,
+  W_FIRE,
+  W_FIRE_ACK,
+  W_SYNC,
+
+  N_wireFrames
+};
+
+#define WIRE_MAX_TOWERS 4
+#define WIRE_FIELDS (2 + 3*N_COLORS)
+
+#define WIRE_KEYFRAME_SIZE (1 + sizeof(systemState) + 2)
+#define WIRE_DELTA_HEADER_SIZE 7
+#define WIRE_REPORT_SIZE 6
+#define WIRE_FIRE_SIZE 6
+#define WIRE_FIRE_ACK_SIZE 2
+#define WIRE_SYNC_SIZE 5
+#define WIRE_MAX_FRAME WIRE_KEYFRAME_SIZE
+
+// builds a frame for 'state', to act on 'at', into 'frame'; returns its length.  'touched' is
+// the delta's mask so far: clear it with each keyframe and keep it between deltas.
+byte wireKeyframe(const systemState &state, uint16_t at, byte *frame);
+byte wireDelta(const systemState &state, const systemState &key, unsigned int &touched, uint16_t at, byte *frame);
+
+// packet number and act-at time of a keyframe or delta, or false if it isn't one.
+boolean wirePacketNumber(const byte *frame, byte len, byte &packetNumber);
+boolean wireExecuteAt(const byte *frame, byte len, uint16_t &at);
+
+// applies a frame to 'state', which holds what we've heard so far.  'valid' says whether
+// 'state' is complete; it starts false and becomes true with the first keyframe.
+// returns false if the frame was of no use: not ours, stale, or a delta we can't apply yet.
+boolean wireApply(const byte *frame, byte len, systemState &state, boolean &valid);
+
+// a Tower's link report, and reading one back.  false if the frame isn't a report.
+byte wireReport(byte node, unsigned int heard, unsigned int missed, byte *frame);
+boolean wireReadReport(const byte *frame, byte len, byte &node, unsigned int &heard, unsigned int &missed);
+
+// a fire command for one Tower, and its ack.  the readers return false if the frame isn't one.
+byte wireFire(byte seq, const fireInstruction &inst, uint16_t at, byte *frame);
+boolean wireReadFire(const byte *frame, byte len, byte &seq, fireInstruction &inst, uint16_t &at);
+byte wireFireAck(byte seq, byte *frame);
+boolean wireReadFireAck(const byte *frame, byte len, byte &seq);
+
+// the Console's clock, and reading it back.  false if the frame isn't a sync.
+byte wireSync(unsigned long ms, byte *frame);
+boolean wireReadSync(const byte *frame, byte len, unsigned long &ms);
+
+#endif
@@ -289,4 +289,55 @@ void wavTrigger::getPlayingTracks(int playingTracks[14]) {
 	}
 }
 
+// **************************************************************
+void wavTrigger::requestPlayingTracks(void) {
+
+byte txbuf[5];
+
+	txbuf[0] = 0xf0; // SOM header byte 1
+	txbuf[1] = 0xaa; // SOM header byte 2
+	txbuf[2] = 0x05; // message length
+	txbuf[3] = CMD_GET_STATUS;
+	txbuf[4] = 0x55; // EOM byte
+	WTSerial->write(txbuf, 5);
+
+	rxCount = 0;
+}
+
+// **************************************************************
+bool wavTrigger::readPlayingTracks(int playingTracks[14]) {
+
+	while( WTSerial->available() ) {
+		byte b = WTSerial->read();
+
+		// hunt for the start of message
+		if( rxCount == 0 && b != 0xf0 ) continue;
+		if( rxCount == 1 && b != 0xaa ) {
+			rxCount = 0;
+			continue;
+		}
+		rxStatus[rxCount++] = b;
+		if( rxCount < 3 ) continue;
+
+		byte msgLength = rxStatus[2];
+		if( msgLength < 5 || msgLength > sizeof(rxStatus) ) {
+			rxCount = 0;
+			continue;
+		}
+		if( rxCount < msgLength ) continue;
+
+		rxCount = 0;
+		if( rxStatus[3] != 0x83 || rxStatus[msgLength-1] != 0x55 ) continue;
+
+		// as getPlayingTracks()
+		byte nTracks = (msgLength - 5)/2;
+		for( int tr=0; tr<14; tr++ ) {
+			if( tr >= nTracks ) playingTracks[tr] = 0;
+			else playingTracks[tr] = word(rxStatus[4+tr*2+1], rxStatus[4+tr*2]) +1;
+		}
+		return( true );
+	}
+	return( false );
+}
+
 
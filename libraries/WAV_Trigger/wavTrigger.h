@@ -72,6 +72,10 @@ public:
 	// MGD: implement GET_STATUS (Tx) and STATUS (Rx) to return playing track numbers
 	// See: http://robertsonics.com/wav-trigger-online-user-guide/
 	void getPlayingTracks(int playingTracks[14]);
+	// MGD: the same, without waiting on the reply.  requestPlayingTracks() sends GET_STATUS;
+	// readPlayingTracks() takes what has come in since and is true once the whole reply is.
+	void requestPlayingTracks(void);
+	bool readPlayingTracks(int playingTracks[14]);
 
 private:
 	void trackControl(int trk, int code);
@@ -79,6 +83,9 @@ private:
 //	AltSoftSerial WTSerial;
 	// MGD
 	Stream *WTSerial;
+	// MGD: a STATUS reply, as far as it has come
+	byte rxStatus[4+2*14+1];
+	byte rxCount;
 
 };
 
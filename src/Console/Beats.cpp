@@ -0,0 +1,236 @@
+// Made by tones/beatmap from the win tracks' files; don't edit.  See Cues.h.
+
+#include "Cues.h"
+
+const beatCue beatCues[] PROGMEM = {
+  // at (10 ms), level, kind
+  // 510 ThatsTheWayILikeIt.wav: 104 beats, 49 onsets
+  {     0, 115, CUE_BEAT  },
+  {     0,  97, CUE_ONSET },
+  {    10, 255, CUE_BEAT  },
+  {    56, 184, CUE_BEAT  },
+  {    89, 206, CUE_ONSET },
+  {   106, 219, CUE_BEAT  },
+  {   116, 226, CUE_BEAT  },
+  {   133, 119, CUE_BEAT  },
+  {   136, 228, CUE_ONSET },
+  {   144, 131, CUE_BEAT  },
+  {   171, 168, CUE_BEAT  },
+  {   183, 156, CUE_BEAT  },
+  {   198, 149, CUE_BEAT  },
+  {   198, 210, CUE_ONSET },
+  {   224, 233, CUE_BEAT  },
+  {   263, 113, CUE_BEAT  },
+  {   280, 141, CUE_BEAT  },
+  {   296,  82, CUE_BEAT  },
+  {   307, 145, CUE_BEAT  },
+  {   320, 203, CUE_BEAT  },
+  {   332, 232, CUE_BEAT  },
+  {   347,  75, CUE_BEAT  },
+  {   359, 117, CUE_BEAT  },
+  {   359, 213, CUE_ONSET },
+  {   384, 119, CUE_BEAT  },
+  {   387, 201, CUE_ONSET },
+  {   399, 119, CUE_BEAT  },
+  {   413, 171, CUE_BEAT  },
+  {   423, 158, CUE_BEAT  },
+  {   440, 212, CUE_BEAT  },
+  {   440, 198, CUE_ONSET },
+  {   470, 162, CUE_BEAT  },
+  {   524,  44, CUE_BEAT  },
+  {   541, 222, CUE_BEAT  },
+  {   552, 236, CUE_BEAT  },
+  {   552, 176, CUE_ONSET },
+  {   568, 106, CUE_BEAT  },
+  {   580, 167, CUE_BEAT  },
+  {   580, 213, CUE_ONSET },
+  {   597, 173, CUE_BEAT  },
+  {   608, 168, CUE_BEAT  },
+  {   608, 213, CUE_ONSET },
+  {   635, 220, CUE_ONSET },
+  {   643, 144, CUE_BEAT  },
+  {   654, 145, CUE_BEAT  },
+  {   663, 222, CUE_ONSET },
+  {   678, 122, CUE_BEAT  },
+  {   688, 111, CUE_BEAT  },
+  {   701, 105, CUE_BEAT  },
+  {   719, 124, CUE_BEAT  },
+  {   746,  41, CUE_BEAT  },
+  {   762, 219, CUE_BEAT  },
+  {   773, 234, CUE_BEAT  },
+  {   773, 194, CUE_ONSET },
+  {   790, 122, CUE_BEAT  },
+  {   801, 215, CUE_ONSET },
+  {   803, 151, CUE_BEAT  },
+  {   824, 159, CUE_BEAT  },
+  {   829, 221, CUE_ONSET },
+  {   856, 166, CUE_BEAT  },
+  {   856, 160, CUE_ONSET },
+  {   871, 136, CUE_ONSET },
+  {   874, 221, CUE_BEAT  },
+  {   884, 235, CUE_BEAT  },
+  {   884, 201, CUE_ONSET },
+  {   913, 115, CUE_BEAT  },
+  {   928, 154, CUE_ONSET },
+  {   940, 196, CUE_ONSET },
+  {   969,  41, CUE_BEAT  },
+  {   984, 222, CUE_BEAT  },
+  {   995, 236, CUE_BEAT  },
+  {  1012, 117, CUE_BEAT  },
+  {  1023, 211, CUE_ONSET },
+  {  1026, 134, CUE_BEAT  },
+  {  1049, 151, CUE_BEAT  },
+  {  1052, 220, CUE_ONSET },
+  {  1075, 203, CUE_ONSET },
+  {  1079, 162, CUE_BEAT  },
+  {  1092, 168, CUE_BEAT  },
+  {  1107, 238, CUE_BEAT  },
+  {  1135, 127, CUE_BEAT  },
+  {  1162, 217, CUE_ONSET },
+  {  1163, 154, CUE_BEAT  },
+  {  1177, 197, CUE_ONSET },
+  {  1190,  56, CUE_BEAT  },
+  {  1207, 225, CUE_BEAT  },
+  {  1217, 188, CUE_ONSET },
+  {  1218, 232, CUE_BEAT  },
+  {  1233, 104, CUE_BEAT  },
+  {  1245, 206, CUE_ONSET },
+  {  1246, 136, CUE_BEAT  },
+  {  1269, 163, CUE_BEAT  },
+  {  1273, 225, CUE_ONSET },
+  {  1301, 179, CUE_BEAT  },
+  {  1311, 191, CUE_BEAT  },
+  {  1328, 207, CUE_ONSET },
+  {  1329, 233, CUE_BEAT  },
+  {  1352, 181, CUE_ONSET },
+  {  1357, 137, CUE_BEAT  },
+  {  1372, 172, CUE_ONSET },
+  {  1385, 128, CUE_BEAT  },
+  {  1385, 232, CUE_ONSET },
+  {  1412,  76, CUE_BEAT  },
+  {  1429, 221, CUE_BEAT  },
+  {  1439, 239, CUE_BEAT  },
+  {  1439, 185, CUE_ONSET },
+  {  1457, 102, CUE_BEAT  },
+  {  1465, 166, CUE_ONSET },
+  {  1468, 152, CUE_BEAT  },
+  {  1489, 172, CUE_BEAT  },
+  {  1495, 219, CUE_ONSET },
+  {  1503, 135, CUE_BEAT  },
+  {  1521, 231, CUE_ONSET },
+  {  1522, 171, CUE_BEAT  },
+  {  1540, 218, CUE_BEAT  },
+  {  1550, 247, CUE_BEAT  },
+  {  1592, 196, CUE_ONSET },
+  {  1606, 215, CUE_ONSET },
+  {  1607, 148, CUE_BEAT  },
+  {  1634,  57, CUE_BEAT  },
+  {  1645,  34, CUE_BEAT  },
+  {  1660, 236, CUE_BEAT  },
+  {  1660, 200, CUE_ONSET },
+  {  1678,  80, CUE_BEAT  },
+  {  1688, 218, CUE_ONSET },
+  {  1689, 121, CUE_BEAT  },
+  {  1704, 152, CUE_BEAT  },
+  {  1716, 230, CUE_ONSET },
+  {  1720, 140, CUE_BEAT  },
+  {  1745, 187, CUE_BEAT  },
+  {  1745, 168, CUE_ONSET },
+  {  1762, 217, CUE_BEAT  },
+  {  1769, 166, CUE_ONSET },
+  {  1772, 241, CUE_BEAT  },
+  {  1802, 115, CUE_BEAT  },
+  {  1815, 127, CUE_BEAT  },
+  {  1815, 180, CUE_ONSET },
+  {  1829, 125, CUE_BEAT  },
+  {  1857,  35, CUE_BEAT  },
+  {  1873, 219, CUE_BEAT  },
+  {  1883, 229, CUE_BEAT  },
+  {  1883, 203, CUE_ONSET },
+  {  1900,  96, CUE_BEAT  },
+  {  1908, 180, CUE_ONSET },
+  {  1910, 141, CUE_BEAT  },
+  {  1927, 162, CUE_BEAT  },
+  {  1939, 222, CUE_ONSET },
+  {  1961, 217, CUE_ONSET },
+  {  1967, 177, CUE_BEAT  },
+  {  1984, 242, CUE_BEAT  },
+  {  1994, 227, CUE_BEAT  },
+  {  2020,  95, CUE_BEAT  },
+  {  2050, 209, CUE_ONSET },
+  // 512 PureKickDrum.wav: 16 beats, 16 onsets
+  {     0, 251, CUE_BEAT  },
+  {     0, 255, CUE_ONSET },
+  {    42, 242, CUE_ONSET },
+  {    43, 240, CUE_BEAT  },
+  {    85, 248, CUE_ONSET },
+  {    86, 241, CUE_BEAT  },
+  {   128, 225, CUE_BEAT  },
+  {   128, 250, CUE_ONSET },
+  {   171, 220, CUE_BEAT  },
+  {   171, 255, CUE_ONSET },
+  {   214, 234, CUE_BEAT  },
+  {   214, 255, CUE_ONSET },
+  {   257, 244, CUE_BEAT  },
+  {   257, 255, CUE_ONSET },
+  {   300, 243, CUE_BEAT  },
+  {   300, 255, CUE_ONSET },
+  {   342, 242, CUE_ONSET },
+  {   343, 239, CUE_BEAT  },
+  {   385, 248, CUE_ONSET },
+  {   386, 241, CUE_BEAT  },
+  {   428, 225, CUE_BEAT  },
+  {   428, 250, CUE_ONSET },
+  {   471, 220, CUE_BEAT  },
+  {   471, 255, CUE_ONSET },
+  {   514, 234, CUE_BEAT  },
+  {   514, 255, CUE_ONSET },
+  {   557, 244, CUE_BEAT  },
+  {   557, 255, CUE_ONSET },
+  {   600, 243, CUE_BEAT  },
+  {   600, 255, CUE_ONSET },
+  {   642, 242, CUE_ONSET },
+  {   643, 239, CUE_BEAT  },
+  // 513 PureKickDrum_70BPM.wav: 16 beats, 16 onsets
+  {     0, 248, CUE_BEAT  },
+  {     0, 255, CUE_ONSET },
+  {    85, 234, CUE_BEAT  },
+  {    85, 248, CUE_ONSET },
+  {   171, 227, CUE_BEAT  },
+  {   171, 255, CUE_ONSET },
+  {   257, 248, CUE_BEAT  },
+  {   257, 255, CUE_ONSET },
+  {   342, 234, CUE_BEAT  },
+  {   342, 242, CUE_ONSET },
+  {   428, 231, CUE_BEAT  },
+  {   428, 249, CUE_ONSET },
+  {   514, 240, CUE_BEAT  },
+  {   514, 255, CUE_ONSET },
+  {   600, 248, CUE_BEAT  },
+  {   600, 255, CUE_ONSET },
+  {   685, 234, CUE_BEAT  },
+  {   685, 248, CUE_ONSET },
+  {   771, 227, CUE_BEAT  },
+  {   771, 255, CUE_ONSET },
+  {   857, 248, CUE_BEAT  },
+  {   857, 255, CUE_ONSET },
+  {   942, 234, CUE_BEAT  },
+  {   942, 242, CUE_ONSET },
+  {  1028, 231, CUE_BEAT  },
+  {  1028, 249, CUE_ONSET },
+  {  1114, 240, CUE_BEAT  },
+  {  1114, 255, CUE_ONSET },
+  {  1200, 248, CUE_BEAT  },
+  {  1200, 255, CUE_ONSET },
+  {  1285, 234, CUE_BEAT  },
+  {  1285, 248, CUE_ONSET },
+};
+
+const beatMap beatMaps[] PROGMEM = {
+  // track, first cue, cues
+  { 510,     0,  153 }, // 510 ThatsTheWayILikeIt.wav
+  { 512,   153,   32 }, // 512 PureKickDrum.wav
+  { 513,   185,   32 }, // 513 PureKickDrum_70BPM.wav
+};
+
+const int N_BEAT_MAPS = 3;
@@ -32,6 +32,7 @@
 //------ "This" units.
 #include "Simon.h" // Game Play subunit.  Responsible for Simon game.
 #include "Tests.h"
+#include "Scheduler.h" // cooperative timing; nothing waits in place.
 
 //------ Output units.
 #include "Fire.h" // Fire subunit.  Responsible for UX output on remote Towers (fire)
@@ -63,6 +64,9 @@ void setup() {
   //------ Network
   network.begin();
 
+  //------ Timing
+  scheduler.begin();
+
   //------ Output units.
   fire.begin(); //
   light.begin(); //
@@ -76,13 +80,24 @@ void setup() {
 
 // main loop for the core.
 void loop() {
+  // one look at the touch sensors; everything this trip around asks that.
+  touch.update();
+
+  // run whatever the states have scheduled
+  scheduler.update();
+
   // calls the FSM to handle the state of the system
   simon.update();
 
   // perform Tower resends; you should do this always if you want meaningful synchronization with Towers
   network.update();
 
-  
+  // the hard buttons' fades
+  light.update();
+
+  // what the WAV board is playing: fades done, and now and then its word on it
+  sound.update();
+
   // MGD new buttons
   if( touch.startPressed() ) Serial << F("Touch: start pressed") << endl;
   if( touch.leftPressed() ) Serial << F("Touch: left pressed") << endl;
@@ -93,6 +108,6 @@ void loop() {
 int freeRam () {
   extern int __heap_start, *__brkval;
   int v;
-  return (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
+  return (int) ((char *) &v - (__brkval == 0 ? (char *) &__heap_start : (char *) __brkval));
 }
 
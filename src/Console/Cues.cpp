@@ -0,0 +1,49 @@
+// Cues
+#include "Cues.h"
+
+boolean Cues::begin(int track) {
+  this->startTime = millis();
+  this->at = this->last = 0;
+  this->late = this->lateMax = 0;
+
+  // the maps are sorted by track
+  int lo = 0, hi = N_BEAT_MAPS - 1;
+  while( lo <= hi ) {
+    int mid = (lo + hi) / 2;
+    int tr = pgm_read_word(&beatMaps[mid].track);
+    if( tr == track ) {
+      beatMap entry;
+      memcpy_P(&entry, &beatMaps[mid], sizeof(beatMap));
+      this->at = entry.first;
+      this->last = entry.first + entry.count;
+      return ( true );
+    }
+    if( tr < track ) lo = mid + 1;
+    else hi = mid - 1;
+  }
+  return ( false );
+}
+
+boolean Cues::next(beatCue &cue) {
+  if( !playing() ) return ( false );
+
+  unsigned long due = (unsigned long)pgm_read_word(&beatCues[this->at].at) * 10UL;
+  unsigned long now = millis() - this->startTime + CUE_ADVANCE;
+  if( now < due ) return ( false );
+
+  memcpy_P(&cue, &beatCues[this->at], sizeof(beatCue));
+  this->at++;
+  this->late = now - due;
+  if( this->late > this->lateMax ) this->lateMax = this->late;
+  return ( true );
+}
+
+boolean Cues::playing() {
+  return ( this->at < this->last );
+}
+
+void Cues::end() {
+  this->at = this->last;
+}
+
+Cues cues;
@@ -0,0 +1,56 @@
+#ifndef Cues_h
+#define Cues_h
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// Fire and light cues for the win tracks, worked out ahead of time from the music rather than
+// listened for.  Beats.cpp is made from the card's files by tones/beatmap (convert.sh runs it;
+// so does 'make beats' in tests/Host, over tones/), so don't edit it by hand: each track's
+// beats (the bass coming up) and onsets (the highs), in time order.  The fanfare starts the
+// track's map as it starts the track, and takes the cues as they come due; a track without a
+// map, and music from outside (listenMic), it still listens to with the MSGEQ7s.  The table's
+// read with memcpy_P(), so it has to stay in the first 64 KB of flash: 16k cues.
+
+#define CUE_ADVANCE 0 // ms to hand cues out ahead of the music, for the solenoids' and radio's lag
+
+enum cueKind { CUE_BEAT=0, CUE_ONSET };
+
+typedef struct {
+  uint16_t at; // 10 ms from the start of the track
+  uint8_t level; // 0-255, against the track's loudest
+  uint8_t kind; // cueKind
+} beatCue;
+
+typedef struct {
+  int track;
+  int first, count; // in beatCues
+} beatMap;
+
+// sorted by track
+extern const beatCue beatCues[] PROGMEM;
+extern const beatMap beatMaps[] PROGMEM;
+extern const int N_BEAT_MAPS;
+
+class Cues {
+  public:
+    // the track's map, from now, as it starts playing.  false if it hasn't one.
+    boolean begin(int track);
+    // the next cue that's come due, in order.  false if there isn't one yet.
+    boolean next(beatCue &cue);
+    // cues left to come
+    boolean playing();
+    // done with it
+    void end();
+
+    // how late cues were handed out (ms), the last and the most since begin()
+    unsigned long late, lateMax;
+
+  private:
+    int at, last; // in beatCues
+    unsigned long startTime;
+};
+
+extern Cues cues;
+
+#endif
@@ -17,6 +17,7 @@ color incColor(color val) {
     case I_BLU: return I_YEL;
     case I_YEL: return I_GRN;
     case I_GRN: return I_RED;
+    default: break;
   }
   return( I_RED ); // as a safety?
 
@@ -41,37 +42,59 @@ color oppTower(color val) {
     case I_BLU: return I_GRN;
     case I_GRN: return I_BLU;
     case I_YEL: return I_RED;
+    default: break;
   }
 
   return I_RED;
 }
 
+// what's playing.  the fanfare runs a step per loop; see updateFanfare().
+enum { FANFARE_OFF, FANFARE_LOSE, FANFARE_WIN } fanfarePlaying = FANFARE_OFF;
+int track;
+unsigned long startTime, trackLength;
+
+// lose
+unsigned long lastBlink;
+byte blinkState;
+
+// win
+Metro winTime(30000UL);  // Tracks are ~30s in length; see fitToMusic()
+unsigned long lastSample, sampleWait; // pace the beat detector
+boolean mapped; // the track's beats are in Beats.cpp, so we needn't listen for them; see Cues.h
+
+const unsigned long beatInterval = 333;  // 180 BPM max
+const byte beatChance = 95;  // chance in 100 a beat triggers a fire.  Makes the anim for a specific track different each time
+const byte airChance = 0;  // n in 100- chance of air effect
+const byte lightMoveChance = 50;  // n in 100 chance of the light moving on a beat
+const unsigned long lightFade = 150;  // ms the activity lights take to their next color: quick away, slow in
+const byte minFirePerFireball = 50;  // min fire level(ms) per fireball
+const byte maxFirePerFireball = 200;  // max fire level(ms) per fireball
+
+unsigned long beatEndTime;  // time left for beat effect
+unsigned long beatWaitTime;
+int fireballs;
+unsigned long firepower;
+float threshold; // initial threshold is likely to throw a fireball
+unsigned long budget;
+float bt;
+color fireTower, lightTower;
+
+// how long the fanfare for 'track' runs, where the level would have it run for 'length'
+unsigned long fitToMusic(int track, unsigned long length) {
+  unsigned long music = sound.trackLength(track);
+  if( music == 0 ) return( length ); // not indexed; as we were
+  if( music <= length + FANFARE_RUN_ON ) return( music );
+  return( length );
+}
+
 void loseFanfare() {
-    int track = sound.playLose();
-    unsigned long trackLength = 3000UL;
-    unsigned long currTime = millis();
-    unsigned long startTime = millis();
+    track = sound.playLose();
+    trackLength = fitToMusic(track, 3000UL);
+    startTime = millis();
 
     Serial << "Playing lose";
-/*
-    fire.setFire(I_RED,5,veryLean);
-    fire.setFire(I_GRN,5,veryLean);
-
-      while((currTime - startTime) < trackLength) {
-          currTime = millis();
-          network.update();
-          delay(1);
-      }
-    Serial << "Done losing" << endl;
-
-*/
-    byte fireChance = 20;  // n chance in 100 of a tower shooting a fireball
-
-    color fireTower = I_RED;
-
 
     // A lone small fireball as consolation on n towers
-    int fireballs = 0;
     byte num = random(0,4);
 
     switch(num) {
@@ -86,35 +109,44 @@ void loseFanfare() {
         break;
     }
 
-    unsigned long lastBlink = currTime;
-    byte blinkState = 0;
-    while((currTime - startTime) < trackLength) {
-      currTime = millis();
-
-      if (currTime - lastBlink > 500) {
-        lastBlink = currTime;
-        if (blinkState == 0) {
-           blinkState = 1;
-           light.setLight(I_RED, 255, 0 , 0);
-           light.setLight(I_GRN, 255, 0 , 0);
-           light.setLight(I_BLU, 255, 0 , 0);
-           light.setLight(I_YEL, 255, 0 , 0);
-        } else {
-          blinkState = 0;
-           light.setLight(I_RED, 255, 0 , 0);
-           light.setLight(I_GRN, 255, 0 , 0);
-           light.setLight(I_BLU, 255, 0 , 0);
-           light.setLight(I_YEL, 255, 0 , 0);
-           fire.clear();
-        }
+    lastBlink = startTime;
+    blinkState = 0;
+    fanfarePlaying = FANFARE_LOSE;
+}
+
+// returns true when it's over.
+boolean loseFanfareStep() {
+    unsigned long currTime = millis();
+
+    if ((currTime - startTime) >= trackLength) {
+      sound.fadeTrack(track);
+      return( true );
+    }
+
+    if (currTime - lastBlink > 500) {
+      lastBlink = currTime;
+      if (blinkState == 0) {
+         blinkState = 1;
+         light.setLight(I_RED, 255, 0 , 0);
+         light.setLight(I_GRN, 255, 0 , 0);
+         light.setLight(I_BLU, 255, 0 , 0);
+         light.setLight(I_YEL, 255, 0 , 0);
+      } else {
+        blinkState = 0;
+         light.setLight(I_RED, 255, 0 , 0);
+         light.setLight(I_GRN, 255, 0 , 0);
+         light.setLight(I_BLU, 255, 0 , 0);
+         light.setLight(I_YEL, 255, 0 , 0);
+         fire.clear();
       }
-      network.update();
     }
 
-    sound.fadeTrack(track);
+    return( false );
 }
 
 void playerFanfare(fanfare_t level) {
+  fanfarePlaying = FANFARE_OFF;
+
   if (!FANFARE_ENABLED) {
     Serial.println("Fanfare disabled");
     return;
@@ -124,8 +156,6 @@ void playerFanfare(fanfare_t level) {
   //Metro fanfareDuration(FANFARE_DURATION_PER_CORRECT * currentLength);
 
   // make sweet fire/light/music.
-  sound.setLeveling(0, 1);
-  int track;
 
   if (level == CONSOLATION) {
     loseFanfare();
@@ -140,7 +170,7 @@ void playerFanfare(fanfare_t level) {
   listenWav.update();   // populate avg
   listenWav.update();   // populate avg
 
-  unsigned long trackLength = 30000UL;
+  trackLength = 30000UL;
 
   switch(level) {
     case LEVEL1:
@@ -164,195 +194,247 @@ void playerFanfare(fanfare_t level) {
       break;
     case NONE:
       return;
+    default:
+      break;
   }
+  trackLength = fitToMusic(track, trackLength);
+
+  startTime = millis() - 1;
+  winTime.interval(trackLength);
+  winTime.reset();
+
+  float fireBudgetFactor = (26.5 - loadFireBudgetFactor());  // Divisor of track length we throw fire.  Tune this to throw less fire
+
+  beatEndTime = millis();
+  beatWaitTime = millis();
+  fireballs = 0;
+  firepower = 1;
+  threshold = 1.5;
+  budget = (unsigned long) ((float)trackLength / fireBudgetFactor);
+  bt = (float) trackLength / budget;
+  active = 0;
 
-  unsigned long startTime = millis() - 1;
-   Metro winTime(trackLength);  // Tracks are ~30s in length
-   winTime.reset();
-
-   unsigned long beatInterval = 333;  // 180 BPM max
-   byte beatChance = 95;  // chance in 100 a beat triggers a fire.  Makes the anim for a specific track different each time
-   byte airChance = 0;  // n in 100- chance of air effect
-   byte lightMoveChance = 50;  // n in 100 chance of the light moving on a beat
-   byte minFirePerFireball = 50;  // min fire level(ms) per fireball
-   byte maxFirePerFireball = 200;  // max fire level(ms) per fireball
-   float fireBudgetFactor = (26.5 - loadFireBudgetFactor());  // Divisor of track length we throw fire.  Tune this to throw less fire
-
-   unsigned long beatEndTime = millis();  // time left for beat effect
-   unsigned long beatWaitTime = millis();
-   unsigned long currTime;
-   int fireballs = 0;
-   unsigned long firepower = 1;
-   float threshold = 1.5; // initial threshold is likely to throw a fireball
-   unsigned long budget = (unsigned long) ((float)trackLength / fireBudgetFactor);
-   float bt = (float) trackLength / budget;
-   byte active;
-   //unsigned long samples = 0;
-   
   Serial << "FireFactor: " << fireBudgetFactor << " Track Length: " << trackLength << " budget: " << budget << endl;;
 
-   color fireTower = I_RED;
-   color lightTower = I_RED;
+  fireTower = I_RED;
+  lightTower = I_RED;
 
-   // Use the threshold to meet budget constraints for fire.  Ratio of current time / total Time and fire power / budget.
-   while(!winTime.check()) {
-     currTime = millis();
-     threshold *= bt * (float)firepower / ((float) (currTime - startTime));
-     threshold = constrain(threshold,0.5,10.0);
-     listenWav.setThreshold(bassBand, threshold);
-     listenWav.setThreshold(bassBand2, threshold);
-     network.update();
-     waitDuration(1UL);
-     listenWav.update();
-     //samples++;
-     //if (samples > 100) listenWav.print();
-     
-
-     if (hearBeat && currTime > beatEndTime) {
-       Serial << "Beat over.  " << endl;
-       light.clear();
-       fire.clear();
-       network.update();
-       hearBeat = false;
-       waitDuration(10UL);
-     }
+  lastSample = millis();
+  sampleWait = 1;
+  mapped = cues.begin(track);
+  Serial << "Beat map: " << (mapped ? "yes" : "no, listening") << endl;
+  fanfarePlaying = FANFARE_WIN;
+}
 
-    // Lights will queue changes based on activity level across all non bass bands
+// a beat: fire, most of the time.  'strength' (0-100) is how much.
+void throwFire(unsigned long currTime, long strength) {
+  if (random(1,101) <= beatChance) {
+    hearBeat = true;
+    //byte fireLevel = minFirePerFireball / 10 + random(0,maxFirePerFireball / 10);
+    byte fireLevel = fscale(0, 100, minFirePerFireball / 10, maxFirePerFireball / 10, strength, -6.0);
+    unsigned long fireMs = fireLevel * 10; // each level is 10ms
+    Serial << "Fire level: " << fireMs << " ";
 
-    for (byte i = 2; i < NUM_FREQUENCY_BANDS; i++) {
-      if ( listenWav.getBeat(i) ) {
-        active++;
-      }
-    }
+    flameEffect airEffect = veryRich;
 
-    if (active > 0) {
-      switch (active) {
+    if (random(1, 101) <= airChance) {
+      byte effect = random(0, 6);
+      switch (effect) {
       case 0:
-        light.clear();
+        airEffect = kickStart;
         break;
       case 1:
+        airEffect = kickMiddle;
+        break;
       case 2:
-        light.setLight(lightTower, 255, 0 , 0);
+        airEffect = kickEnd;
         break;
       case 3:
+        airEffect = gatlingGun;
+        break;
       case 4:
-        light.setLight(lightTower, 0, 255, 0);
+        airEffect = randomly;
         break;
       case 5:
+        airEffect = veryLean;
+        break;
+      }
+    }
+
+    byte towers = random(0,9);
+
+    if (firepower > budget) {  // tone it down if over budget
+      Serial << "Capping fire" << endl;
+      towers = towers / 2;
+      fireLevel = fscale(0, 100, minFirePerFireball / 10, maxFirePerFireball / 10, 0, -6.0);
+      fireMs = fireLevel * 10; // each level is 10ms
+    }
+
+    switch(towers) {
+      case 0:
+      case 1:
+      case 2:
+      case 3:
+        fire.setFire(fireTower,fireLevel,airEffect);
+        firepower += (1 * fireMs);
+        break;
+      case 4:
+      case 5:
+        fire.setFire(fireTower,fireLevel,airEffect);
+        fire.setFire(oppTower(fireTower),fireLevel,airEffect);
+        firepower += (2 * fireMs);
+        break;
       case 6:
-        light.setLight(lightTower, 0, 0, 255);
+        fire.setFire(fireTower,fireLevel,airEffect);
+        fire.setFire(oppTower(fireTower),fireLevel,airEffect);
+        fire.setFire(incColor(fireTower),fireLevel,airEffect);
+        firepower += (3 * fireMs);
         break;
-      default:
-        light.setLight(lightTower, 255, 255, 0);
-        active = 0;
+      case 7:
+        fire.setFire(I_RED,fireLevel,airEffect);
+        fire.setFire(I_GRN,fireLevel,airEffect);
+        fire.setFire(I_BLU,fireLevel,airEffect);
+        fire.setFire(I_YEL,fireLevel,airEffect);
+        firepower += (4 * fireMs);
         break;
-      }
+    }
 
-      if (random(1,101) <= lightMoveChance) {
-        lightTower = incColor(lightTower);
-      }
+    fireballs++;
+    beatEndTime = currTime + fireMs;
+    beatWaitTime = currTime + beatInterval;
+
+    fireTower = randColor();
+  } else {
+    Serial << "Ignore" << endl;
+  }
+}
+
+// the lights show how busy the music is; each beat outside the bass adds to 'active'.
+void showActivity() {
+  if (active > 0) {
+    switch (active) {
+    case 0:
+      light.clear();
+      break;
+    case 1:
+    case 2:
+      light.setLight(lightTower, 255, 0 , 0, lightFade, E_EaseOut);
+      break;
+    case 3:
+    case 4:
+      light.setLight(lightTower, 0, 255, 0, lightFade, E_EaseOut);
+      break;
+    case 5:
+    case 6:
+      light.setLight(lightTower, 0, 0, 255, lightFade, E_EaseOut);
+      break;
+    default:
+      light.setLight(lightTower, 255, 255, 0, lightFade, E_EaseOut);
+      active = 0;
+      break;
     }
 
-    // Fire is queued to the bass channels.  Air effect is random but unlikely right now
-     if (currTime > beatWaitTime) {
-       if (listenWav.getBeat(bassBand) || listenWav.getBeat(bassBand2)) {
-         if (random(1,101) <= beatChance) {
-           hearBeat = true;
-           //byte fireLevel = minFirePerFireball / 10 + random(0,maxFirePerFireball / 10);
-           byte fireLevel = fscale(0, 100, minFirePerFireball / 10, maxFirePerFireball / 10, random(101), -6.0);
-           unsigned long fireMs = fireLevel * 10; // each level is 10ms
-           Serial << "Fire level: " << fireMs << " ";
-
-           flameEffect airEffect = veryRich;
-
-            if (random(1, 101) <= airChance) {
-              byte effect = random(0, 6);
-              switch (effect) {
-              case 0:
-                airEffect = kickStart;
-                break;
-              case 1:
-                airEffect = kickMiddle;
-                break;
-              case 2:
-                airEffect = kickEnd;
-                break;
-              case 3:
-                airEffect = gatlingGun;
-                break;
-              case 4:
-                airEffect = randomly;
-                break;
-              case 5:
-                airEffect = veryLean;
-                break;
-              }
-            }
-
-          byte towers = random(0,9);
-          byte r = random(0,2) * 255;
-          byte g = random(0,2) * 255;
-          byte b = random(0,2) * 255;
-
-          if (firepower > budget) {  // tone it down if over budget
-            Serial << "Capping fire" << endl;
-            towers = towers / 2;
-            fireLevel = fscale(0, 100, minFirePerFireball / 10, maxFirePerFireball / 10, 0, -6.0);
-            fireMs = fireLevel * 10; // each level is 10ms
-          }
-          
-          switch(towers) {
-            case 0:
-            case 1:
-            case 2:
-            case 3:
-              fire.setFire(fireTower,fireLevel,airEffect);
-              firepower += (1 * fireMs);
-              break;
-            case 4:
-            case 5:
-              fire.setFire(fireTower,fireLevel,airEffect);
-              fire.setFire(oppTower(fireTower),fireLevel,airEffect);
-              firepower += (2 * fireMs);
-              break;
-            case 6:
-              fire.setFire(fireTower,fireLevel,airEffect);
-              fire.setFire(oppTower(fireTower),fireLevel,airEffect);
-              fire.setFire(incColor(fireTower),fireLevel,airEffect);
-              firepower += (3 * fireMs);
-              break;
-            case 7:
-              fire.setFire(I_RED,fireLevel,airEffect);
-              fire.setFire(I_GRN,fireLevel,airEffect);
-              fire.setFire(I_BLU,fireLevel,airEffect);
-              fire.setFire(I_YEL,fireLevel,airEffect);
-              firepower += (4 * fireMs);
-              break;
-          }
-
-           network.update();
-           fireballs++;
-           beatEndTime = currTime + fireMs;
-           beatWaitTime = currTime + beatInterval;
-
-           fireTower = randColor();
-         } else {
-           Serial << "Ignore" << endl;
-         }
-       }
-     }
+    if (random(1,101) <= lightMoveChance) {
+      lightTower = incColor(lightTower);
+    }
+  }
+}
 
-   }
+// done with the last beat's fire?
+boolean beatOver(unsigned long currTime) {
+  if (!hearBeat || currTime <= beatEndTime) return( false );
 
+  Serial << "Beat over.  " << endl;
   light.clear();
   fire.clear();
+  hearBeat = false;
+  return( true );
+}
+
+// one pass of the beat map: the cues that have come due.  beats throw fire, onsets move light.
+void cueStep(unsigned long currTime) {
+  beatOver(currTime);
+
+  beatCue cue;
+  while (cues.next(cue)) {
+    if (cue.kind == CUE_ONSET) {
+      active += 1 + cue.level / 64;
+    } else if (currTime > beatWaitTime) {
+      throwFire(currTime, map(cue.level, 0, 255, 0, 100));
+    }
+  }
+
+  showActivity();
+}
+
+// one pass of the beat map, or the beat detector.  returns true when it's over.
+boolean winFanfareStep() {
+   // Use the threshold to meet budget constraints for fire.  Ratio of current time / total Time and fire power / budget.
+   if (winTime.check()) {
+     light.clear();
+     fire.clear();
+
+     // ramp down the volume to exit the music playing cleanly.
+     sound.fadeTrack(track);
+     cues.end();
+
+     Serial << "Fireballs: " << fireballs << " power: " << firepower << " budget: " << budget << endl;
+     Serial << F("Gameplay: Player fanfare ended") << endl;
+     return( true );
+   }
+
+   light.animate(A_GameplayPressed);
+
+   unsigned long currTime = millis();
+   if (mapped) {
+     cueStep(currTime);
+     return( false );
+   }
+
+   // not mapped: listen for the beats
+   if (currTime - lastSample < sampleWait) return( false );
+
+   threshold *= bt * (float)firepower / ((float) (currTime - startTime));
+   threshold = constrain(threshold,0.5,10.0);
+   listenWav.setThreshold(bassBand, threshold);
+   listenWav.setThreshold(bassBand2, threshold);
+   listenWav.update();
+   lastSample = millis();
+   sampleWait = 1;
+   //samples++;
+   //if (samples > 100) listenWav.print();
 
-  // ramp down the volume to exit the music playing cleanly.
-  sound.fadeTrack(track);
+   if (beatOver(currTime)) sampleWait = 10;
 
-  Serial << "Fireballs: " << fireballs << " power: " << firepower << " budget: " << budget << endl;
-  Serial << F("Gameplay: Player fanfare ended") << endl;
+  // Lights will queue changes based on activity level across all non bass bands
 
+  for (byte i = 2; i < NUM_FREQUENCY_BANDS; i++) {
+    if ( listenWav.getBeat(i) ) {
+      active++;
+    }
+  }
+
+  showActivity();
+
+  // Fire is queued to the bass channels.  Air effect is random but unlikely right now
+   if (currTime > beatWaitTime) {
+     if (listenWav.getBeat(bassBand) || listenWav.getBeat(bassBand2)) {
+       throwFire(currTime, random(101));
+     }
+   }
+
+   return( false );
+}
+
+boolean updateFanfare() {
+  boolean done = true;
+  switch( fanfarePlaying ) {
+    case FANFARE_LOSE: done = loseFanfareStep(); break;
+    case FANFARE_WIN: done = winFanfareStep(); break;
+    case FANFARE_OFF: break;
+  }
+  if( done ) fanfarePlaying = FANFARE_OFF;
+  return( done );
 }
 
 void saveFireBudgetFactor(float factor) {
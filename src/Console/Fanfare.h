@@ -37,6 +37,7 @@
 #include "Fire.h"
 #include "Sound.h"
 #include "Mic.h"
+#include "Cues.h"
 #include "Simon.h"
 
 // fanfare mapping
@@ -54,7 +55,14 @@ enum fanfare_t {
   MAXOUT // must of had a pen and paper, because they max'd at 32 correct
 };
 
+// a fanfare runs as long as its level says, unless the track index (Tracks.h) knows the music:
+// then it ends with music that's shorter, and runs on to the end of music that's only this
+// much longer (ms), rather than fading the last of it off.
+#define FANFARE_RUN_ON 5000UL
+
+// starts the fanfare; updateFanfare() plays it, a step per loop, and returns true when it's over.
 void playerFanfare(fanfare_t level);
+boolean updateFanfare();
 
 color incColor(color val);
 color randColor();
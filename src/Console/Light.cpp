@@ -9,6 +9,7 @@ void Light::begin() {
   this->led[I_GRN] = new LED(LED_GRN);
   this->led[I_BLU] = new LED(LED_BLU);
   this->led[I_YEL] = new LED(LED_YEL);
+  for ( byte i = 0; i < N_COLORS; i++ ) this->fade[i].begin(cOff);
   Serial << F("Light: console hardwired buttons configured.") << endl;
 
   this->clear();
@@ -17,13 +18,13 @@ void Light::begin() {
 }
 
 // set light level, taking advantage of layout position
-void Light::setLight(color position, byte red, byte green, byte blue) {
+void Light::setLight(color position, byte red, byte green, byte blue, unsigned long duration, fadeEasing easing) {
   colorInstruction inst;
   inst.red = red;
   inst.green = green;
   inst.blue = blue;
 
-  this->setLight(position, inst);
+  this->setLight(position, inst, duration, easing);
 }
 
 void Light::clear() {
@@ -48,16 +49,33 @@ void Light::clearButtons() {
   }
 }
 
-void Light::setLight(color position, colorInstruction &inst) {
+void Light::setLight(color position, colorInstruction &inst, unsigned long duration, fadeEasing easing) {
+  fadeInstruction fade;
+  fade.duration = min(duration, maxFadeTime) / 10;
+  fade.easing = easing;
+
   // show on Towers and Light Module
-  network.send(position, inst);
+  network.send(position, inst, fade);
+
+  // show on hard buttons; without a fade, right now.
+  this->fade[position].start(inst, fade, millis());
+  if ( this->fade[position].update(millis()) ) this->show(position);
+}
+
+void Light::update() {
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    if ( this->fade[i].update(millis()) ) this->show((color)i);
+  }
+}
 
-  // show on hard buttons
+void Light::show(color position) {
+  const colorInstruction &inst = this->fade[position].color;
   switch( position ) {
     case I_RED: this->led[I_RED]->setValue(inst.red); break;
     case I_GRN: this->led[I_GRN]->setValue(inst.green); break;
     case I_BLU: this->led[I_BLU]->setValue(inst.blue); break;
     case I_YEL: this->led[I_YEL]->setValue(int(inst.red+inst.green)/2); break;
+    default: break;
   }
 }
 
@@ -16,6 +16,9 @@
 // LED abstracting
 #include <LED.h>
 
+// fades, as the Towers and Light module do them
+#include <Simon_Fade.h>
+
 // Manual button lights, panels, under console.  wire to N-channel MOSFET + and any GND.
 #define LED_YEL 8 // can move, PWM
 #define LED_GRN 9 // can move, PWM
@@ -27,9 +30,12 @@ class Light {
     // startup.  layout the towers.
     void begin();
 
-    // set fire level, taking advantage of layout position
-    void setLight(color position, byte red, byte green, byte blue);
-    void setLight(color position, colorInstruction &inst);
+    // set light level, taking advantage of layout position.  with a duration (ms, up to
+    // maxFadeTime), everything fades there on its own; the Console sends it once.
+    void setLight(color position, byte red, byte green, byte blue, unsigned long duration = 0, fadeEasing easing = E_Linear);
+    void setLight(color position, colorInstruction &inst, unsigned long duration = 0, fadeEasing easing = E_Linear);
+    // moves the hard buttons along their fades.  call often.
+    void update();
     void animate(animationInstruction animation);
     void stopAnimation();
     void clearButtons();
@@ -38,8 +44,10 @@ class Light {
 
   private:
 
-    // hardware LED
+    // hardware LED, and where each is in its fade
     LED *led[N_COLORS];
+    ColorFade fade[N_COLORS];
+    void show(color position);
 };
 
 extern Light light;
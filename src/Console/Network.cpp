@@ -9,18 +9,21 @@ void Network::begin(nodeID node) {
   Serial1.begin(115200);
   //start the library, pass in the data details and the name of the serial port. Can be Serial, Serial1, Serial2, etc.
   this->ET.begin(details(this->state), &Serial1);
+  this->lightLink.begin(&Serial1);
+  this->lightFlowing = false;
   Serial << F("Network: serial comms with Light module.") << endl;
 
   // arise, Cthulu
   //radio.Wakeup();  // this was crashing startup
 
-  // check the send time
-  Serial << F("Network: system datagram size (bytes)=") << sizeof(this->state) << endl;
+  // check the send time, with the longest frame we send
+  this->frameLength = wireKeyframe(this->state, 0, this->frame);
+  Serial << F("Network: system datagram size (bytes)=") << this->frameLength << endl;
   // send.   match Network::update Send syntax exactly
-  radio.Send(255, (const void*)(&this->state), sizeof(this->state), false, 0);
+  radio.Send(255, (const void*)this->frame, this->frameLength, false, 0);
   radio.SendWait();
   unsigned long tic = micros();
-  radio.Send(255, (const void*)(&this->state), sizeof(this->state), false, 0);
+  radio.Send(255, (const void*)this->frame, this->frameLength, false, 0);
   radio.SendWait();
   unsigned long toc = micros();
   Serial << F("Network: system datagram requires ") << toc - tic << F("us to send.") << endl;
@@ -30,9 +33,28 @@ void Network::begin(nodeID node) {
 //  this->packetSendInterval = float(toc - tic) * 1.1;
   Serial << F("Network: sending system datagram every ") << this->packetSendInterval << F("us.") << endl;
 
-  this->resendCount = 5;
+  // resends adapt to what the Towers report; until then, the old standby.
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    this->link[i].reportTime = 0;
+    this->link[i].loss = -1;
+    this->link[i].spread = 1;
+    this->link[i].clean = 0;
+  }
+  this->framesSent = this->packetsSent = 0;
+  for ( byte i = 0; i < N_COLORS; i++ ) this->fire[i].pending = false;
+  this->adapt();
+  this->resendCount = this->lightResends;
   this->sentCount = this->resendCount;
-  Serial << F("Network: will resend new packets x") << this->resendCount << endl;
+  Serial << F("Network: will resend new packets x") << this->resendCount << F(" until Towers report.") << endl;
+
+  // first packet out is a keyframe
+  this->keyTime = millis() - KEYFRAME_INTERVAL;
+  this->keyOwed = 0;
+  this->changeTime = millis();
+  this->lightOwed = false;
+
+  // and the Towers get our clock straight away
+  this->syncTime = millis() - SYNC_INTERVAL;
 
   // Get layout
   int addr = 69;
@@ -77,19 +99,61 @@ void Network::layout(color lightLayout[N_COLORS], color fireLayout[N_COLORS]) {
 
 // resends and stuff
 void Network::update() {
-  // if the sent count exceeds resend count, exit
-  if ( this->sentCount >= this->resendCount ) return;
+  // anything from the Towers?
+  this->receive();
+
+  // the Light module's copy, when the Towers act on it and the Light is clear of show()
+  this->lightLink.update(millis());
+  if ( this->lightLink.flowing() != this->lightFlowing ) {
+    this->lightFlowing = this->lightLink.flowing();
+    if ( this->lightFlowing ) Serial << F("Network: Light module flow control on.") << endl;
+    else Serial << F("Network: Light module quiet; sending without flow control. ") << this->lightLink.unflowed << F(" of ") << this->lightLink.frames << F(" frames so far.") << endl;
+  }
+  if ( this->lightOwed && (long)(millis() - this->lightAt) >= 0 && this->lightLink.clear() ) {
+    // handled by dedicated UART hardwre, so will happen in the background.
+    ET.sendData();
+    this->lightLink.sent();
+    this->lightOwed = false;
+  }
+
+  // fire first: it's what the crowd is waiting for.  then leave the air clear for the
+  // ack; the radios are half duplex.
+  if ( this->sendFire() ) return;
+
+  // the Towers' clocks.  short, and not often.
+  if ( millis() - this->syncTime >= SYNC_INTERVAL ) {
+    this->sendSync();
+    return;
+  }
+
+  // nothing new.  but if it's been a while, send a keyframe for anyone who missed the last one.
+  if ( this->sentCount >= this->resendCount ) {
+    if ( millis() - this->keyTime < KEYFRAME_INTERVAL ) return;
+    this->sentCount = 0;
+    this->changeTime = millis();
+  }
 
   // track send times
   static unsigned long lastSend = micros();
   unsigned long now = micros();
 
-  // send on an interval
-  if( now-lastSend < this->packetSendInterval ) return;
+  // send on an interval; resends maybe further apart.
+  unsigned long interval = this->packetSendInterval;
+  if ( this->sentCount > 0 ) interval *= this->spread;
+  if( now-lastSend < interval ) return;
 
   // if this is the first time we've sent, update the packet number
   if ( this->sentCount == 0 ) {
     this->state.packetNumber++;
+    this->packetsSent++;
+    boolean keyframe = this->encode();
+    // one already waiting goes when it's due, with whatever's newer
+    if ( !this->lightOwed ) this->lightAt = this->changeTime + EXECUTE_LEAD;
+    this->lightOwed = true;
+    this->adapt(); // links may have gone quiet
+    // deltas are no use without their keyframe, so it gets more.
+    this->resendCount = keyframe ? this->keyResends : this->lightResends;
+    if ( keyframe ) this->keyOwed = this->resendCount;
     /*
     Serial << F("Network::update.  New packet # ") << this->state.packetNumber << endl;
     for( int i=0; i<N_COLORS; i++ )
@@ -103,49 +167,235 @@ void Network::update() {
   this->send();
   
   this->sentCount++;
+  // a keyframe keeps its resends until they've all gone out: if a newer packet takes
+  // over first, that's sent as a keyframe too.
+  if ( this->keyOwed > 0 ) this->keyOwed--;
 
   // record last send time
   lastSend = now;
 }
 
 // makes the network do stuff with your stuff
-void Network::send(color position, colorInstruction &inst) {
-  // change on a delta
+void Network::send(color position, colorInstruction &inst, const fadeInstruction &fade) {
+  // change on a delta.  a new fade to the same color would change nothing.
   if ( memcmp((void*)(&inst), (void*)(&this->state.light[position]), sizeof(colorInstruction)) != 0 ) {
     this->state.light[position] = inst;
-    this->sentCount = 0;
+    this->state.fade[position] = fade;
+    this->changed();
   }
 }
 void Network::send(color position, fireInstruction &inst) {
   // change on a delta
   if ( memcmp((void*)(&inst), (void*)(&this->state.fire[position]), sizeof(fireInstruction)) != 0 ) {
     this->state.fire[position] = inst;
-    this->sentCount = 0;
+    this->changed(); // for the Light module
+    if ( inst.duration > 0 ) this->queueFire(position);
   }
 }
 void Network::send(systemMode mode) {
   // change on a delta
   if ( mode != (byte)state.mode ) {
     this->state.mode = (byte)mode;
-    this->sentCount = 0;
+    this->changed();
   }
 }
 void Network::send(animationInstruction &inst) {
   // change on a delta
   if ( memcmp((void*)(&inst), (void*)(&this->state.animation), sizeof(animationInstruction)) != 0 ) {
     this->state.animation = inst;
-    this->sentCount = 0;
+    this->changed();
   }
 }
 
+// changes made together (a beat's worth) go in the next packet, and act together.
+void Network::changed() {
+  if ( this->sentCount > 0 ) this->changeTime = millis();
+  this->sentCount = 0;
+}
+
 // internal dispatcher
 void Network::send() {
+  // Radio: the frame for this packet, built by encode().
+  radio.Send((byte)BROADCAST, (const void*)this->frame, this->frameLength, false, 0);
+  this->framesSent++;
+}
+
+// queues a fire command for every Tower doing fire for this position.  a newer command
+// replaces one still waiting for its ack.
+void Network::queueFire(color position) {
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    if ( this->fireLayout[i] == position ) {
+      this->fire[i].inst = this->state.fire[position];
+    } else if ( this->fireLayout[i] == N_COLORS ) {
+      // towers are handling multiple fire instructions
+      this->mergeFire(this->fire[i].inst);
+    } else {
+      continue;
+    }
+    this->fire[i].at = millis() + EXECUTE_LEAD;
+    this->fire[i].seq++;
+    this->fire[i].tries = 0;
+    this->fire[i].pending = true;
+  }
+}
+
+// sends fire commands that are due, and gives up on ones that have had their tries.
+// true if anything went out.
+boolean Network::sendFire() {
+  boolean sent = false;
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    fireCommand &cmd = this->fire[i];
+    if ( !cmd.pending ) continue;
+    if ( cmd.tries > 0 && millis() - cmd.sentAt < FIRE_RETRY_WAIT ) continue;
+
+    if ( cmd.tries >= FIRE_RETRIES ) {
+      Serial << F("Network: fire to Tower ") << i << F(" not acknowledged after ") << cmd.tries << F(" tries.") << endl;
+      cmd.pending = false;
+      continue;
+    }
+
+    byte frame[WIRE_FIRE_SIZE];
+    byte len = wireFire(cmd.seq, cmd.inst, cmd.at, frame);
+    radio.Send((byte)(TOWER1 + i), (const void*)frame, len, true, 0);
+    cmd.tries++;
+    cmd.sentAt = millis();
+    sent = true;
+  }
+  return ( sent );
+}
+
+void Network::fireAcked(byte node, byte seq) {
+  if ( node < TOWER1 || node >= TOWER1 + N_COLORS ) return;
+  fireCommand &cmd = this->fire[node - TOWER1];
+  // an ack for one we've since replaced doesn't count
+  if ( !cmd.pending || seq != cmd.seq ) return;
 
-  // Light: send.  handled by dedicated UART hardwre, so will happen in the background.
-  ET.sendData();
+  cmd.pending = false;
+  if ( cmd.tries > 1 ) Serial << F("Network: fire to Tower ") << node - TOWER1 << F(" acknowledged after ") << cmd.tries << F(" tries.") << endl;
+}
+
+// our clock for the Towers, stamped as late as we can: once the radio is free to send it.
+void Network::sendSync() {
+  byte frame[WIRE_SYNC_SIZE];
+  radio.SendWait();
+  byte len = wireSync(millis(), frame);
+  radio.Send((byte)BROADCAST, (const void*)frame, len, false, 0);
+
+  this->syncTime = millis();
+}
+
+// picks up fire acks and link reports from the Towers
+void Network::receive() {
+  if ( !radio.ReceiveComplete() || !radio.CRCPass() ) return;
+
+  const byte *data = (const byte*)radio.Data;
+  byte len = *radio.DataLen;
+  byte seq;
+  if ( wireReadFireAck(data, len, seq) ) {
+    this->fireAcked(radio.GetSender(), seq);
+    return;
+  }
+
+  byte node;
+  unsigned int heard, missed;
+  if ( !wireReadReport(data, len, node, heard, missed) ) return;
+  if ( node < TOWER1 || node >= TOWER1 + N_COLORS ) return;
+
+  towerLink &link = this->link[node - TOWER1];
+  unsigned int sent = this->framesSent - link.sent;
+  unsigned int packets = this->packetsSent - link.packets;
+  unsigned int dHeard = heard - link.heard;
+  unsigned int dMissed = missed - link.missed;
+  boolean first = link.reportTime == 0 || millis() - link.reportTime >= LINK_TIMEOUT;
+  link.reportTime = millis();
+
+  // first we've heard from it in a while, or it restarted: just take the counters.
+  if ( first || dHeard > sent ) {
+    link.heard = heard;
+    link.missed = missed;
+    link.sent = this->framesSent;
+    link.packets = this->packetsSent;
+    this->adapt();
+    return;
+  }
+  // wait for enough frames to say something
+  if ( sent < LINK_SAMPLE ) return;
+
+  // frame loss, smoothed.  the report was a frame or two behind our count; close enough.
+  float loss = 1.0 - (float)dHeard / (float)sent;
+  link.loss = link.loss < 0 ? loss : 0.75 * link.loss + 0.25 * loss;
+
+  // whole packets lost more often than the frame loss says they should be: the losses
+  // come in bursts, so spread the resends out.  back off after a while with nothing missed.
+  if ( dMissed > 1 && dMissed > 2.0 * (1.0 - DELIVERY_TARGET) * packets ) {
+    link.spread = min(link.spread * 2, SPREAD_MAX);
+    link.clean = 0;
+  } else if ( dMissed == 0 && ++link.clean >= LINK_CLEAN ) {
+    if ( link.spread > 1 ) link.spread /= 2;
+    link.clean = 0;
+  }
+
+  link.heard = heard;
+  link.missed = missed;
+  link.sent = this->framesSent;
+  link.packets = this->packetsSent;
+
+  this->adapt();
+}
+
+// sizes the resends for the worst Tower link we've heard from lately
+void Network::adapt() {
+  byte lightResends = RESEND_DEFAULT, keyResends = RESEND_DEFAULT, spread = 1;
+
+  float worst = -1;
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    if ( this->link[i].loss < 0 || millis() - this->link[i].reportTime >= LINK_TIMEOUT ) continue;
+    worst = max(worst, this->link[i].loss);
+    spread = max(spread, this->link[i].spread);
+  }
+
+  if ( worst >= 0 ) {
+    // a packet is missed if every copy is: loss^resends.
+    worst = constrain(worst, LOSS_FLOOR, 1.0);
+    float missed = worst;
+    for ( lightResends = RESEND_MIN; lightResends < RESEND_MAX && missed > 1.0 - DELIVERY_TARGET; lightResends++ ) missed *= worst;
+    missed = worst;
+    for ( keyResends = RESEND_MIN; keyResends < RESEND_MAX && missed > 1.0 - KEYFRAME_DELIVERY_TARGET; keyResends++ ) missed *= worst;
+  }
 
-  // apply physical Tower layout
-  systemState towerState;
+  if ( lightResends != this->lightResends || keyResends != this->keyResends || spread != this->spread ) {
+    if ( worst < 0 ) Serial << F("Network: no link reports");
+    else Serial << F("Network: worst link loss ") << (int)(worst * 100.0 + 0.5) << F("%");
+    Serial << F(", resends x") << lightResends << F(" (keyframes x") << keyResends << F(") every ") << spread << F(" intervals.") << endl;
+  }
+  this->lightResends = lightResends;
+  this->keyResends = keyResends;
+  this->spread = spread;
+}
+
+// builds the radio frame for the current packet: a delta against the last keyframe,
+// or a keyframe if it's time for one or the delta wouldn't be any shorter.  true for a keyframe.
+boolean Network::encode() {
+  systemState now;
+  towerState(now);
+
+  unsigned long at = this->changeTime + EXECUTE_LEAD;
+  boolean key = this->keyOwed > 0 || millis() - this->keyTime >= KEYFRAME_INTERVAL;
+  if ( !key ) {
+    this->frameLength = wireDelta(now, this->keyState, this->keyTouched, at, this->frame);
+    key = this->frameLength >= WIRE_KEYFRAME_SIZE;
+  }
+  if ( key ) {
+    this->frameLength = wireKeyframe(now, at, this->frame);
+    this->keyState = now;
+    this->keyTouched = 0;
+    this->keyTime = millis();
+  }
+  return ( key );
+}
+
+// applies the physical Tower layout
+void Network::towerState(systemState &towerState) {
   // copy out invariants
   towerState.packetNumber = this->state.packetNumber;
   towerState.mode = this->state.mode;
@@ -155,19 +405,15 @@ void Network::send() {
     if( this->lightLayout[i] != N_COLORS ) {
       // if single tower are handling single colors
       towerState.light[i] = this->state.light[this->lightLayout[i]];
+      towerState.fade[i] = this->state.fade[this->lightLayout[i]];
     } else {
       // towers are handling multiple color instructions
       this->mergeColor(towerState.light[i]);
+      this->mergeFade(towerState.fade[i]);
     }
-    if ( this->fireLayout[i] != N_COLORS ) {
-      towerState.fire[i] = this->state.fire[this->fireLayout[i]];
-    } else {
-      // towers are handling multiple fire instructions
-      this->mergeFire(towerState.fire[i]);
-    }
+    towerState.fire[i].duration = 0;
+    towerState.fire[i].effect = veryRich;
   }
-
-  radio.Send((byte)BROADCAST, (const void*)(&towerState), sizeof(towerState), false, 0);
 }
 
 // we sum up the lighting instructions
@@ -190,6 +436,14 @@ void Network::mergeColor(colorInstruction &inst) {
   inst.blue = constrain(blue, 0, 255);
 }
 
+// the slowest of the fades, so the merged color doesn't get there before its parts
+void Network::mergeFade(fadeInstruction &inst) {
+  inst = this->state.fade[0];
+  for ( byte i = 1; i < N_COLORS; i++ ) {
+    if ( this->state.fade[i].duration > inst.duration ) inst = this->state.fade[i];
+  }
+}
+
 // we sum up the fire instructions
 void Network::mergeFire(fireInstruction &inst) {
   unsigned long duration = 0, effect = 0;
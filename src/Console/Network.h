@@ -16,6 +16,54 @@
 
 //------ sizes, indexing and inter-unit data structure definitions.
 #include <Simon_Common.h>
+#include <Simon_Wire.h> // radio wire format
+#include <Simon_Link.h> // Light module flow control
+
+// send a keyframe at least this often, so Towers that missed one (or just powered up) catch up.
+#define KEYFRAME_INTERVAL 1000UL // ms
+
+// resends: enough copies of each packet that the worst Tower link gets it with this
+// probability, going by the frame loss the Towers report (Instruction::report).
+#define DELIVERY_TARGET 0.99
+#define KEYFRAME_DELIVERY_TARGET 0.9999 // deltas are no use without their keyframe
+#define RESEND_MIN 1
+#define RESEND_MAX 8
+#define RESEND_DEFAULT 5 // until the Towers report, or if they all go quiet
+#define LOSS_FLOOR 0.005 // never assume a perfect link
+#define SPREAD_MAX 4 // space resends up to this many send intervals when losses come in bursts
+#define LINK_TIMEOUT 5000UL // ms; forget a Tower's link after this long without a report
+#define LINK_SAMPLE 20 // frames; fewer than this is too few to estimate loss from
+#define LINK_CLEAN 5 // samples without a missed packet before we close the spacing up again
+
+// fire goes to each Tower on its own and is acknowledged; retry this often, this many times.
+#define FIRE_RETRY_WAIT 25UL // ms
+#define FIRE_RETRIES 6
+
+// the Towers keep our clock from a sync frame this often (Simon_Sync.h), and act on
+// instructions this long after we make them: long enough for a resend or a fire retry
+// to get there, so every Tower (and the Light module) acts at the same moment.
+#define SYNC_INTERVAL 500UL // ms
+#define EXECUTE_LEAD 60UL // ms
+
+// a fire command on its way to one Tower
+typedef struct {
+  fireInstruction inst;
+  unsigned long at; // ms, when to fire
+  byte seq; // counts per Tower; the Tower drops repeats
+  byte tries; // sends so far
+  boolean pending; // not acknowledged yet
+  unsigned long sentAt; // ms, last try
+} fireCommand;
+
+// what we know about the link to one Tower
+typedef struct {
+  unsigned long reportTime; // ms, last report
+  unsigned int heard, missed; // Tower's counters at the last sample
+  unsigned int sent, packets; // ours at the last sample
+  float loss; // frame loss, smoothed.  <0 until measured.
+  byte spread; // resend spacing, in send intervals
+  byte clean; // samples in a row without a missed packet
+} towerLink;
 
 // once we get radio comms, wait this long  before returning false from externUpdate.
 #define EXTERNAL_COMMS_TIMEOUT 10000UL
@@ -35,7 +83,8 @@ class Network {
     void update(); // should be called frequently for sync.
 
     // makes the network do stuff with your stuff
-    void send(color position, colorInstruction &inst);
+    // the light fades to 'inst' on the Towers and the Light module as 'fade' says
+    void send(color position, colorInstruction &inst, const fadeInstruction &fade = fStep);
     void send(color position, fireInstruction &inst);
     void send(animationInstruction &inst);
     void send(systemMode mode);
@@ -48,9 +97,32 @@ class Network {
 
     // internal actuator of public send methods
     void send();
+    void changed(); // something in state did
+    unsigned long changeTime; // ms, first change not in a packet yet
+
+    // the Light module is on the wire, so it would be ahead of the Towers: hold its copy until then.
+    unsigned long lightAt; // ms
+    boolean lightOwed;
+    // and only while it's clear of show()
+    LightLink lightLink;
+    boolean lightFlowing;
+
+    // Towers keep our clock from these
+    void sendSync();
+    unsigned long syncTime; // ms
+
+    // Tower state with the layout applied, and its frame for the radio.  no fire; that goes on its own.
+    void towerState(systemState &towerState);
+    boolean encode();
+    systemState keyState; // last keyframe sent; deltas are taken against it
+    unsigned int keyTouched; // fields changed since keyState
+    unsigned long keyTime; // ms
+    byte keyOwed; // resends of the keyframe still to go
+    byte frame[WIRE_MAX_FRAME], frameLength;
 
     // merges color and fire instructions when towers handle multiple channels
     void mergeColor(colorInstruction &inst);
+    void mergeFade(fadeInstruction &inst);
     void mergeFire(fireInstruction &inst);
 
     // gets the network setup
@@ -61,6 +133,19 @@ class Network {
     unsigned long packetSendInterval; // us
     byte resendCount, sentCount;
 
+    // link reports from the Towers set the resend count and spacing
+    void receive();
+    void adapt();
+    towerLink link[N_COLORS];
+    unsigned int framesSent, packetsSent;
+    byte lightResends, keyResends, spread;
+
+    // fire commands, by Tower
+    void queueFire(color position);
+    boolean sendFire();
+    void fireAcked(byte node, byte seq);
+    fireCommand fire[N_COLORS];
+
     // stores which towers should be sent color commands
     color lightLayout[N_COLORS];
     // stores which towers should be sent fire commands
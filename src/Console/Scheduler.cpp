@@ -0,0 +1,111 @@
+#include "Scheduler.h"
+
+void Scheduler::begin() {
+  Serial << F("Scheduler: startup.") << endl;
+
+  cancelAll();
+  resetLatency();
+}
+
+void Scheduler::update() {
+  // how long since we were last here?  that's one trip around loop().
+  unsigned long now = micros();
+  if ( this->lastUpdate != 0 ) {
+    unsigned long took = now - this->lastUpdate;
+    if ( took > this->maxLatency ) this->maxLatency = took;
+
+    byte bin = 0;
+    for ( unsigned long ms = took / 1000UL; ms > 0 && bin < LATENCY_BINS - 1; ms >>= 1 ) bin++;
+    this->bins[bin]++;
+  }
+  this->lastUpdate = now;
+
+  // run what's due.  a task may schedule its continuation; that waits for the next update().
+  unsigned long ms = millis();
+  task_t due[SCHEDULER_TASKS];
+  byte nDue = 0;
+  for ( byte i = 0; i < SCHEDULER_TASKS; i++ ) {
+    if ( this->tasks[i].task == NULL ) continue;
+
+    boolean ready = this->tasks[i].condition ? this->tasks[i].condition() : ms - this->tasks[i].start >= this->tasks[i].wait;
+    if ( ready ) {
+      due[nDue++] = this->tasks[i].task;
+      this->tasks[i].task = NULL;
+    }
+  }
+  for ( byte i = 0; i < nDue; i++ ) due[i]();
+}
+
+boolean Scheduler::after(unsigned long ms, task_t task) {
+  return ( add(task, NULL, ms) );
+}
+
+boolean Scheduler::when(condition_t condition, task_t task) {
+  return ( add(task, condition, 0) );
+}
+
+boolean Scheduler::add(task_t task, condition_t condition, unsigned long wait) {
+  for ( byte i = 0; i < SCHEDULER_TASKS; i++ ) {
+    if ( this->tasks[i].task != NULL ) continue;
+
+    this->tasks[i].task = task;
+    this->tasks[i].condition = condition;
+    this->tasks[i].start = millis();
+    this->tasks[i].wait = wait;
+    return ( true );
+  }
+
+  Serial << F("Scheduler: no room for task!") << endl;
+  return ( false );
+}
+
+boolean Scheduler::pending(task_t task) {
+  for ( byte i = 0; i < SCHEDULER_TASKS; i++ ) {
+    if ( this->tasks[i].task == task ) return ( true );
+  }
+  return ( false );
+}
+
+boolean Scheduler::pending() {
+  for ( byte i = 0; i < SCHEDULER_TASKS; i++ ) {
+    if ( this->tasks[i].task != NULL ) return ( true );
+  }
+  return ( false );
+}
+
+void Scheduler::cancel(task_t task) {
+  for ( byte i = 0; i < SCHEDULER_TASKS; i++ ) {
+    if ( this->tasks[i].task == task ) this->tasks[i].task = NULL;
+  }
+}
+
+void Scheduler::cancelAll() {
+  for ( byte i = 0; i < SCHEDULER_TASKS; i++ ) this->tasks[i].task = NULL;
+}
+
+unsigned long Scheduler::latency(byte bin) {
+  if ( bin >= LATENCY_BINS ) return ( 0 );
+  return ( this->bins[bin] );
+}
+
+unsigned long Scheduler::latencyMax() {
+  return ( this->maxLatency );
+}
+
+void Scheduler::printLatency() {
+  Serial << F("Scheduler: loop latency (ms):");
+  for ( byte i = 0; i < LATENCY_BINS; i++ ) {
+    if ( this->bins[i] == 0 ) continue;
+    if ( i < LATENCY_BINS - 1 ) Serial << F(" <") << (1UL << i) << F(":") << this->bins[i];
+    else Serial << F(" >=") << (1UL << (i - 1)) << F(":") << this->bins[i];
+  }
+  Serial << F(" max(us):") << this->maxLatency << endl;
+}
+
+void Scheduler::resetLatency() {
+  for ( byte i = 0; i < LATENCY_BINS; i++ ) this->bins[i] = 0;
+  this->maxLatency = 0;
+  this->lastUpdate = 0;
+}
+
+Scheduler scheduler;
@@ -0,0 +1,68 @@
+// Scheduler subunit.  Responsible for cooperative timing, so that nothing spins the main loop.
+//
+// Instead of waiting in place, a state hands the loop back and asks to be called again:
+// after a time (timed task), or once a condition holds (continuation).  loop() stays short,
+// so input polling, radio resends and Light keep getting their turn.
+//
+// Also keeps a histogram of loop latency (time between update() calls), to prove it.
+
+#ifndef Scheduler_h
+#define Scheduler_h
+
+#include <Arduino.h>
+
+#include <Streaming.h> // <<-style printing
+
+// pending tasks, at most.  the game needs two.
+#define SCHEDULER_TASKS 8
+
+// loop latency bins: <1 ms, <2 ms, <4 ms ... <512 ms, and everything longer.
+#define LATENCY_BINS 11
+
+typedef void (*task_t)();
+typedef boolean (*condition_t)();
+
+class Scheduler {
+  public:
+    // startup
+    void begin();
+
+    // call once per loop(); runs tasks that are due and measures loop latency.
+    void update();
+
+    // run task once, ms from now.  returns false if there's no room.
+    boolean after(unsigned long ms, task_t task);
+    // run task once condition returns true; checked every update().
+    boolean when(condition_t condition, task_t task);
+
+    // is this task (or any task) still waiting to run?
+    boolean pending(task_t task);
+    boolean pending();
+
+    // drop a waiting task, or all of them.
+    void cancel(task_t task);
+    void cancelAll();
+
+    // loop latency
+    unsigned long latency(byte bin); // loops that took less than 1<<bin ms
+    unsigned long latencyMax(); // longest loop, us
+    void printLatency();
+    void resetLatency();
+
+  private:
+    struct {
+      task_t task;
+      condition_t condition;
+      unsigned long start, wait; // ms
+    } tasks[SCHEDULER_TASKS];
+
+    boolean add(task_t task, condition_t condition, unsigned long wait);
+
+    unsigned long lastUpdate; // us
+    unsigned long bins[LATENCY_BINS];
+    unsigned long maxLatency; // us
+};
+
+extern Scheduler scheduler;
+
+#endif
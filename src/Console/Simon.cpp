@@ -63,23 +63,29 @@ void idleEnter() {
   network.update();
 
   sound.setMasterGain();
-  sound.setLeveling();
   sound.stopAll();
 
   idleBeforeFanfare.reset();
 
+  // only presses from here on start a game
+  touch.clearEvents();
+
   scoreboard.clear();
   scoreboard.resetCurrScore();
+
+  // how responsive were we since the last time we were here?
+  scheduler.printLatency();
+  scheduler.resetLatency();
 }
 void idleUpdate() {
   light.animate(A_Idle);
   // check buttons for game play start
-  if ( touch.anyButtonPressed() ) {
+  touchEvent press;
+  if ( touch.nextPress(press) ) {
     // going to start a game
     Serial << F("Simon: idle->game") << endl;
 
     sound.stopAll();
-    sound.setLeveling(1, 1); // 1x tone and 1x track
     //rockTrack = sound.playRock(501);
 
     // let's play a game
@@ -102,12 +108,17 @@ void idleExit() {
 }
 
 //***** Game
+// how long to light and tone each step of the sequence, and the gap between steps.
+unsigned long playDuration, pauseDuration = 100; // ms
+int gamePlaying; // step of the sequence being played back
+
 void gameEnter() {
   Serial << F("Simon: ->game") << endl;
 
   // there's a button held, so wait for a release.
-  waitAllReleased();
-
+  scheduler.when(allReleased, gameReady);
+}
+void gameReady() {
   // clear
   light.clear();
   fire.clear();
@@ -117,11 +128,9 @@ void gameEnter() {
   scoreboard.displayCurrScore(); // where we at?
 
   // delay after a player's last move
-  waitDuration(800UL);
+  scheduler.after(800UL, gameExtend);
 }
-void gameUpdate() {
-  light.animate(A_GameplayPressed);
-
+void gameExtend() {
   // check to see if we've maxed out
   if ( gameCurrent + 1 == gameMaxSequenceLength ) {
     // holy crap.  someone's good with a pen and paper.
@@ -133,38 +142,48 @@ void gameUpdate() {
   // add to the sequence
   gameSequence[gameCurrent++] = (color)random(N_COLORS);
 
-  // how long between each
-  unsigned long pauseDuration = 100; // ms
-
   // how long to light and tone
-  unsigned long playDuration = 420;
+  playDuration = 420;
   if ( gameCurrent >= 6 ) playDuration = 320; // gets faster as you progress
   if ( gameCurrent >= 14) playDuration = 220;
 
-  for (int i = 0; i < gameCurrent; i++) {
-    colorInstruction c = cMap[gameSequence[i]];
-    light.setLight(gameSequence[i], c);
-
-    // sound
-    sound.playTone(gameSequence[i]);
+  gamePlaying = 0;
+  gamePlayStep();
+}
+void gamePlayStep() {
+  // played it all?  their turn.
+  if ( gamePlaying == gameCurrent ) {
+    simon.transitionTo(player);
+    return;
+  }
 
-    // wait
-    waitDuration(playDuration);
+  colorInstruction c = cMap[gameSequence[gamePlaying]];
+  light.setLight(gameSequence[gamePlaying], c);
 
-    // done
-    light.clearButtons();
-    sound.stopTones();
+  // sound
+  sound.playTone(gameSequence[gamePlaying]);
 
-    // wait
-    waitDuration(pauseDuration);
-  }
+  scheduler.after(playDuration, gamePlayRest);
+}
+void gamePlayRest() {
+  // done
+  light.clearButtons();
+  sound.stopTones();
 
-  simon.transitionTo(player);
+  gamePlaying++;
+  scheduler.after(pauseDuration, gamePlayStep);
+}
+void gameUpdate() {
+  // the sequence plays back on the scheduler; keep the lights going meanwhile.
+  light.animate(A_GameplayPressed);
 }
 void gameExit() {
+  scheduler.cancelAll();
 }
 
 //***** Player
+boolean playerCorrect; // was the last press right?
+
 void playerEnter() {
   Serial << F("Simon: ->player") << endl;
 
@@ -176,20 +195,33 @@ void playerEnter() {
   playerTimeout.reset();
   // reset player position to start of sequence
   playerCurrent = 0;
+
+  // presses during playback don't count
+  touch.clearEvents();
 }
 void playerUpdate() {
-  // assume we're correct unless proved otherwise
-  boolean correct = true;
-
   light.animate(A_GameplayPressed);
+
+  // hold it while we're mashing; that's not more presses.
+  if ( scheduler.pending(playerReleased) ) {
+    touch.clearEvents();
+    static Metro printInterval(75);
+    if ( printInterval.check() ) {
+      touch.printElectrodeAndBaselineData();
+      printInterval.reset();
+    }
+    return;
+  }
+
   // wait for button press.
-  if ( touch.anyColorPressed() ) {
+  touchEvent press;
+  if ( touch.nextPress(press, N_COLORS) ) {
 
     light.animate(A_GameplayPressed);
     // you could, in theory, press all the buttons simultaneously to get it right...
     // but humans aren't that fast, so this is an alien/Ninja/godling detector.
-    color button = touch.whatPressed();
-    correct = (button == gameSequence[playerCurrent]) || CHEATY_PANTS_MODE; // note total cheat check.
+    color button = (color)press.index;
+    playerCorrect = (button == gameSequence[playerCurrent]) || CHEATY_PANTS_MODE; // note total cheat check.
 
     // light the correct button
     colorInstruction c = cMap[gameSequence[playerCurrent]];
@@ -197,7 +229,7 @@ void playerUpdate() {
     light.animate(A_GameplayPressed);
 
     // sound
-    if ( correct ) {
+    if ( playerCorrect ) {
       // correct tone
       sound.playTone(gameSequence[playerCurrent]);
       // got one more
@@ -212,36 +244,26 @@ void playerUpdate() {
       scoreboard.saveHighScore();
     }
 
-    // hold it while we're mashing
-    waitAllReleased();
-
-    // done
-    sound.stopTones();
-    light.clearButtons();
-
-    // reset timeout
-    playerTimeout.reset();
+    // pick it up when they let go
+    scheduler.when(allReleased, playerReleased);
+    return;
   }
 
   // exit to fanfare conditions:
-  boolean hasTimedOut = playerTimeout.check();
-  boolean hasWrongMove = !correct;
-  if ( hasTimedOut ||  hasWrongMove ) {
-    Serial << "Done.  current is: " << playerCurrent << " gamecurrent: " << gameCurrent << endl;
-
-    if ( gameCurrent > fanfareCorrectMapping[LEVEL4] ) {
-      fanfareLevel = LEVEL4;
-    } else if ( gameCurrent > fanfareCorrectMapping[LEVEL3] ) {
-      fanfareLevel = LEVEL3;
-    } else if ( gameCurrent > fanfareCorrectMapping[LEVEL2] ) {
-      fanfareLevel = LEVEL2;
-    } else if ( gameCurrent > fanfareCorrectMapping[LEVEL1] ) {
-      fanfareLevel = LEVEL1;
-    } else {
-      fanfareLevel = CONSOLATION;
-    }
+  if ( playerTimeout.check() ) playerDone();
+}
+void playerReleased() {
+  // done
+  sound.stopTones();
+  light.clearButtons();
 
-    simon.transitionTo(fanfare);
+  // reset timeout
+  playerTimeout.reset();
+
+  // exit to fanfare conditions:
+  if ( !playerCorrect ) {
+    playerDone();
+    return;
   }
 
   // exit to game conditions:
@@ -252,7 +274,25 @@ void playerUpdate() {
 
   // otherwise, we'll come back to playerUpdate to complete the sequence
 }
+void playerDone() {
+  Serial << "Done.  current is: " << playerCurrent << " gamecurrent: " << gameCurrent << endl;
+
+  if ( gameCurrent > fanfareCorrectMapping[LEVEL4] ) {
+    fanfareLevel = LEVEL4;
+  } else if ( gameCurrent > fanfareCorrectMapping[LEVEL3] ) {
+    fanfareLevel = LEVEL3;
+  } else if ( gameCurrent > fanfareCorrectMapping[LEVEL2] ) {
+    fanfareLevel = LEVEL2;
+  } else if ( gameCurrent > fanfareCorrectMapping[LEVEL1] ) {
+    fanfareLevel = LEVEL1;
+  } else {
+    fanfareLevel = CONSOLATION;
+  }
+
+  simon.transitionTo(fanfare);
+}
 void playerExit() {
+  scheduler.cancelAll();
 }
 
 //***** Fanfare
@@ -266,12 +306,12 @@ void fanfareEnter() {
 
   // defined in Fanfare.h/.cpp
   playerFanfare(fanfareLevel);
-
-  simon.transitionTo(idle);
 }
 void fanfareUpdate() {
+  if ( updateFanfare() ) simon.transitionTo(idle);
 }
 void fanfareExit() {
+  scheduler.cancelAll();
 }
 
 //***** Test
@@ -283,28 +323,12 @@ void testUpdate() {
   if( testModes.update() ) simon.transitionTo(idle);
 }
 void testExit() {
+  scheduler.cancelAll();
 }
 
-void waitDuration(unsigned long duration) {
-  Metro wait(duration);
-  wait.reset();
-  while ( !wait.check() ) {
-    network.update();
-    light.animate(A_GameplayPressed);
-  }
-}
-
-void waitAllReleased() {
-  static Metro printInterval(75);
-  //printInterval.reset();
-  while ( touch.anyColorPressed() ) {
-    network.update();
-    //if (printInterval.check()) {
-      touch.printElectrodeAndBaselineData();
-      //printInterval.reset();
-    //}
-  }
-  //delay(100);
+// continuation condition: no color buttons held.
+boolean allReleased() {
+  return ( !touch.anyColorPressed() );
 }
 
 // Not used, currently, but Mike would like to retain this code:
@@ -330,19 +354,3 @@ unsigned long trandom(unsigned long xmin, unsigned long xmode, unsigned long xma
     return ( xmax - sqrt( (1 - u) * maxMinusMin * maxMinusMode ) );
   }
 }
-
-void waitForButtonsReleased() {
-  // wait for all of the buttons to be released.
-  while ( touch.anyButtonPressed() ) {
-    network.update();
-  }
-}
-
-void waitForTimer(unsigned long t) {
-  Metro delayNow(t);
-  delayNow.reset();
-  while (! delayNow.check() ) {
-    network.update();
-  }
-}
-
@@ -22,6 +22,7 @@
 #include "Tests.h"
 #include "Sensor.h"
 #include "SimonScoreboard.h"
+#include "Scheduler.h"
 
 /*************************************
 
@@ -39,16 +40,17 @@ Finite State Machine (FSM) Map:
 void idleEnter(), idleUpdate(), idleExit();
 // Game
 void gameEnter(), gameUpdate(), gameExit();
+void gameReady(), gameExtend(), gamePlayStep(), gamePlayRest(); // continuations
 // Player
 void playerEnter(), playerUpdate(), playerExit();
+void playerReleased(), playerDone(); // continuations
 // Fanfare
 void fanfareEnter(), fanfareUpdate(), fanfareExit();
 // Test
 void testEnter(), testUpdate(), testExit();
 
 // Helper functions
-void waitAllReleased();
-void waitDuration(unsigned long duration);
+boolean allReleased();
 
 extern FSM simon;
 
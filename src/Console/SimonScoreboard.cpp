@@ -93,7 +93,7 @@ void SimonScoreboard::resetCurrScore() {
 }
 
 void SimonScoreboard::saveCurrScore(int playerCurrent) {
-  if (playerCurrent > currScore) {
+  if (playerCurrent > (int)currScore) {
     currScore = playerCurrent;
   }
   displayCurrScore();
@@ -137,10 +137,10 @@ void SimonScoreboard::displayCurrScore() {
 }
 
 void SimonScoreboard::showBackerMessages() {
-  char buffer[20], buffer2[20]; // 20 characters.
+  char buffer[21], buffer2[21]; // 20 characters, plus the terminator.
   static char thx[] = "THX! to our Backers:";
   static Metro cycleInterval(3000);
-  static int nMessages = sizeof(backerMessages)/2;
+  static int nMessages = sizeof(backerMessages)/sizeof(backerMessages[0]);
   static int i=random(0, nMessages); // start somewhere new at the beginning.
 
   if( cycleInterval.check() ) {
@@ -163,10 +163,10 @@ void SimonScoreboard::showBackerMessages() {
   }
 }
 void SimonScoreboard::showSimonTeam() {
-  char buffer[20], buffer2[20]; // 20 characters.
+  char buffer[21], buffer2[21]; // 20 characters, plus the terminator.
   static char thx[] = "*** Simon v2, by ***";
   static Metro cycleInterval(3000);
-  static int nMessages = sizeof(simonTeam)/2;
+  static int nMessages = sizeof(simonTeam)/sizeof(simonTeam[0]);
   static int i=random(0, nMessages); // start somewhere new at the beginning.
 
   if( cycleInterval.check() ) {
@@ -189,13 +189,13 @@ void SimonScoreboard::showSimonTeam() {
   }
 }
 
-void SimonScoreboard::showMessage(char * msg) {
+void SimonScoreboard::showMessage(const char * msg) {
   lcd.clear();
   lcd.setCursor(0, 0);
   lcd.print(msg);
 }
 
-void SimonScoreboard::showMessage2(char * msg) {
+void SimonScoreboard::showMessage2(const char * msg) {
   lcd.clear();
   lcd.setCursor(0, 1);
   lcd.print(msg);
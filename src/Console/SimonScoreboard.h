@@ -26,8 +26,8 @@ class SimonScoreboard {
 
     void displayCurrScore();
 
-    void showMessage(char * msg);
-    void showMessage2(char * msg);
+    void showMessage(const char * msg);
+    void showMessage2(const char * msg);
 
   private:
     uint32_t highScore;
@@ -1,5 +1,34 @@
 #include "Sound.h"
 
+// dB a voice comes down by with nTones and nTracks playing: [nTones][nTracks] =
+//   floor( 10*log10( nTones + nTracks * 10^(TRACK_GAIN_RELATIVE_TO_TONE/10) ) ),
+// and nothing for nothing.  see: https://www.noisemeters.com/apps/db-calculator.asp
+#if TRACK_GAIN_RELATIVE_TO_TONE != -12
+#error "levelTable is for TRACK_GAIN_RELATIVE_TO_TONE -12 dB; work it out again"
+#endif
+static const int8_t levelTable[WAV_VOICES+1][WAV_VOICES+1] PROGMEM = {
+  {  0, -12,  -9,  -8,  -6,  -6,  -5,  -4,  -3,  -3,  -2,  -2,  -2,  -1,  -1},
+  {  0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2},
+  {  3,   3,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   4},
+  {  4,   4,   4,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5},
+  {  6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6,   6},
+  {  6,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7},
+  {  7,   7,   7,   7,   7,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8},
+  {  8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8,   8},
+  {  9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9},
+  {  9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9,   9},
+  { 10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10},
+  { 10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10},
+  { 10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  11,  11,  11,  11,  11},
+  { 11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11},
+  { 11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11,  11},
+};
+
+// tones and drums, as against music
+static boolean toneTrack(int track) {
+  return ( (track >= trTones[0] && track <= trTones[N_TONES-1]) || (track >= trDrum[0] && track <= trDrum[1]) );
+}
+
 
 bool Sound::begin() {
 
@@ -15,12 +44,23 @@ bool Sound::begin() {
   // start the wav board
   wav.start(&WTSerial);
 
+  // nothing waiting to go, or on its way
+  this->nQueued = 0;
+  this->txFreeAt = micros();
+  this->queued = this->coalesced = this->sent = 0;
+  this->toneLatency = this->toneLatencyMax = 0;
+
+  // nothing playing that we know of; ask soon
+  voicesOff();
+  this->asked = false;
+  this->reconciles = this->replies = this->mismatches = 0;
+  this->lastAsked = millis() - WAV_RECONCILE;
+  this->leveled = 0;
+  leveling();
+
   // set master gain
   setMasterGain();
 
-  // set leveling
-  setLeveling();
-
   // quiet
   stopAll();
 
@@ -32,65 +72,108 @@ bool Sound::begin() {
 
 void Sound::setMasterGain(int gain) {
   int g = constrain(gain, -70, 4);
-  wav.masterGain(g);
+  enqueue(W_MasterGain, 0, g);
   Serial << F("Sound:setMasterGain: gain=") << g << endl;
 }
 
-// set how we want volume levels to be applied so that simultaneous playback does not clip.
-void Sound::setLeveling(int nTones, int nTracks) {
-  // see: https://www.noisemeters.com/apps/db-calculator.asp for the gnarly logarithm mess
-  // basically, we're calibrating the tone gain based on the number of tones and tracks currently playing,
-  // relative to the total gain that we want out of the system
-  this->toneGain = TONE_GAIN - floor( 10.0*log10(float(nTones) + float(nTracks)*pow(10.0, float(TRACK_GAIN_RELATIVE_TO_TONE)/10.0)) );
+// the gains each class plays at, with what's playing now.  we're calibrating the tone gain
+// based on the number of tones and tracks currently playing, relative to the total gain that
+// we want out of the system.
+void Sound::leveling() {
+  byte nTones = 0, nTracks = 0;
+  for( byte i=0; i<WAV_VOICES; i++ ) {
+    if( !this->voiceTrack[i] ) continue;
+    if( toneTrack(this->voiceTrack[i]) ) nTones++;
+    else nTracks++;
+  }
+  this->toneGain = TONE_GAIN - (int8_t)pgm_read_byte(&levelTable[nTones][nTracks]);
   this->trackGain = this->toneGain + TRACK_GAIN_RELATIVE_TO_TONE;
+}
+
+int Sound::levelGain(int track) {
+  return ( constrain(toneTrack(track) ? this->toneGain : this->trackGain, -70, 10) );
+}
 
-  Serial << F("Sound::setLeveling: nTones=") << nTones << F(" with gain=") << this->toneGain;
-  Serial << F(" nTracks=") << nTracks << F(" with gain=") << this->trackGain << endl;
+// after a start or a stop: those voices that should be at another gain now
+void Sound::relevel() {
+  leveling();
+  for( byte i=0; i<WAV_VOICES; i++ ) {
+    int tr = this->voiceTrack[i];
+    if( !tr || this->voiceManual[i] || this->voiceEnd[i] ) continue;
+    int ga = levelGain(tr);
+    if( ga == this->voiceGain[i] ) continue;
+    this->voiceGain[i] = ga;
+    enqueue(W_Gain, tr, ga);
+    this->leveled++;
+  }
 }
 
 int Sound::playWins(int track) {
-  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trWins) : track, this->trackGain) );
+  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trWins) : track) );
 }
 int Sound::playLose(int track) {
-  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trLose) : track, this->trackGain) );
+  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trLose) : track) );
 }
 int Sound::playBaff(int track) {
-  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trBaff) : track, this->trackGain) );
+  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trBaff) : track) );
 }
 int Sound::playRock(int track) {
-  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trRock) : track, this->trackGain) );
+  return ( playTrack(track == RANDOM_TRACK ? randomTrack(trRock) : track) );
 }
 int Sound::randomTrack(const int (&range)[2]) {
   return ( random(range[0], range[1] + 1) );
 }
 
 int Sound::playTrack(int track) {
-  return ( playTrack(track, this->trackGain) );
-}
-
-int Sound::playTrack(int track, int gain) {
   // enforce limits
   int tr = constrain(track, 1, 999);
-  int ga = constrain(gain, -70, 10);
 
-  // set volume
-  wav.trackGain(tr, ga);
-  // play in polyphonic mode
-  wav.trackPlayPoly(tr);
+  // leveled with itself counted
+  byte v = voiceOn(tr);
+  leveling();
+  int ga = levelGain(tr);
+  this->voiceGain[v] = ga;
 
-  Serial << F("Sound::playTrack: track=") << tr << F(" gain=") << ga << endl;
+  // set volume, and play in polyphonic mode; then the others come down to make room
+  enqueue(W_Play, tr, ga);
+  relevel();
+
+  if ( SOUND_VERBOSE ) Serial << F("Sound::playTrack: track=") << tr << F(" gain=") << ga << endl;
 
   return ( tr );
 }
 
+boolean Sound::lookupTrack(int track, trackInfo &info) {
+  // the table's sorted by track
+  int lo = 0, hi = N_TRACK_INFO - 1;
+  while( lo <= hi ) {
+    int mid = (lo + hi) / 2;
+    int tr = pgm_read_word(&trackTable[mid].track);
+    if( tr == track ) {
+      memcpy_P(&info, &trackTable[mid], sizeof(trackInfo));
+      return ( true );
+    }
+    if( tr < track ) lo = mid + 1;
+    else hi = mid - 1;
+  }
+  return ( false );
+}
+
+unsigned long Sound::trackLength(int track) {
+  trackInfo info;
+  return ( lookupTrack(track, info) ? info.length : 0 );
+}
+
 // Stop a track
 void Sound::stopTrack(int track) {
   // enforce limits
   int tr = constrain(track, 1, 999);
   // stop
-  wav.trackStop(tr);
+  enqueue(W_Stop, tr);
+  voiceOff(tr);
+  relevel();
 
-  Serial << F("Sound::stopTrack track=") << tr << endl;
+  if ( SOUND_VERBOSE ) Serial << F("Sound::stopTrack track=") << tr << endl;
 }
 
 // Fade out track
@@ -98,9 +181,10 @@ void Sound::fadeTrack(int track, unsigned long fadeTime) {
   // enforce limits
   int tr = constrain(track, 1, 999);
   // fade, with Stop at the end.  Stop is important, so voices can be freed up.
-  wav.trackFade(tr, -70, fadeTime, true);
+  enqueue(W_Fade, tr, -70, 0, fadeTime);
+  voiceFade(tr, fadeTime);
 
-  Serial << F("Sound::fadeTrack track=") << tr << F(" in(ms)=") << fadeTime << endl;
+  if ( SOUND_VERBOSE ) Serial << F("Sound::fadeTrack track=") << tr << F(" in(ms)=") << fadeTime << endl;
 }
 
 
@@ -111,9 +195,14 @@ void Sound::crossFadeTrack(int extro, int intro, unsigned long fadeTime) {
   int in = constrain(intro, 1, 999);
 
   // fade, with Stop at the end.  Stop is important, so voices can be freed up.
-  wav.trackCrossFade(ex, in, this->trackGain, fadeTime);
-
-  Serial << F("Sound::crossFadeTrack track=") << ex << F(" into=") << in << F(" in(ms)=") << fadeTime << endl;
+  voiceFade(ex, fadeTime);
+  byte v = voiceOn(in);
+  leveling();
+  this->voiceGain[v] = levelGain(in);
+  enqueue(W_CrossFade, ex, this->voiceGain[v], in, fadeTime);
+  relevel();
+
+  if ( SOUND_VERBOSE ) Serial << F("Sound::crossFadeTrack track=") << ex << F(" into=") << in << F(" in(ms)=") << fadeTime << endl;
 }
 
 // convenience function for Fx board. returns track #.
@@ -126,7 +215,7 @@ int Sound::playTone(byte colorIndex) {
     case I_YEL: tr = trTones[3]; break;
   }
 
-  return (playTrack(tr, this->toneGain));
+  return (playTrack(tr));
 }
 
 void Sound::stopTone(byte colorIndex) {
@@ -142,7 +231,7 @@ void Sound::stopTone(byte colorIndex) {
 }
 
 int Sound::playFailTone() {
-  return (playTrack(trTones[4], this->toneGain));
+  return (playTrack(trTones[4]));
 }
 void Sound::stopFailTone() {
   return (stopTrack(trTones[4]));
@@ -151,14 +240,15 @@ void Sound::stopFailTone() {
 
 // Stop all tones track
 void Sound::stopTones() {
-  // get the array of currently playing tracks
-  int tr[14];
-  wav.getPlayingTracks(tr);
-
-  // loop across and issue a stop command
-  for( byte i=0; i<14; i++ ) {
-    if( tr[i] > 0 && tr[i] <= N_TONES) wav.trackStop(tr[i]);
+  // loop across the voices and issue a stop command
+  for( byte i=0; i<WAV_VOICES; i++ ) {
+    int tr = this->voiceTrack[i];
+    if( tr > 0 && tr <= N_TONES ) {
+      enqueue(W_Stop, tr);
+      voiceOff(tr);
+    }
   }
+  relevel();
 
 //  for( int ti=0; ti<N_TONES; ti++ ) {
 //    // stop
@@ -172,23 +262,125 @@ void Sound::stopTones() {
 
 // Stop all track
 void Sound::stopAll() {
-  // get the array of currently playing tracks
-  int tr[14];
-  wav.getPlayingTracks(tr);
+  // stop, everything; and anything waiting to play or change won't.
+  enqueue(W_StopAll, 0);
+  voicesOff();
+
+//  Serial << F("Sound::stopAll") << endl;
+}
+
+
 
-  // loop across and issue a stop command
-  for( byte i=0; i<14; i++ ) {
-    if( tr[i] > 0 ) wav.trackStop(tr[i]);
+void Sound::update() {
+  // what's waiting, as the link has room
+  drain();
+
+  unsigned long now = millis();
+
+  // a fade with stop frees its voice when it's done
+  boolean ended = false;
+  for( byte i=0; i<WAV_VOICES; i++ ) {
+    if( this->voiceTrack[i] && this->voiceEnd[i] && (long)(now - this->voiceEnd[i]) >= 0 ) {
+      this->voiceTrack[i] = 0;
+      ended = true;
+    }
+  }
+  if( ended ) relevel();
+
+  if( this->asked ) {
+    int tr[WAV_VOICES];
+    if( wav.readPlayingTracks(tr) ) {
+      this->asked = false;
+      this->replies++;
+      // the board answered as of before anything we've sent since; next time.
+      if( !this->changed ) reconcile(tr);
+    } else if( now - this->askedAt >= WAV_REPLY_WAIT ) {
+      this->asked = false;
+    }
+  } else if( now - this->lastAsked >= WAV_RECONCILE && this->nQueued == 0 && inFlight(micros()) == 0 ) {
+    // once all we've said has gone: the reply is as of after it
+    wav.requestPlayingTracks();
+    this->txFreeAt = micros() + 5 * WAV_BYTE_US;
+    this->asked = true;
+    this->changed = false;
+    this->askedAt = this->lastAsked = now;
+    this->reconciles++;
   }
+}
 
-  // and, be damned sure
-  // stop
-  wav.stopAllTracks();
+boolean Sound::playing(int track) {
+  return ( voice(track) < WAV_VOICES );
+}
 
-//  Serial << F("Sound::stopAll") << endl;
+byte Sound::voices() {
+  byte n = 0;
+  for( byte i=0; i<WAV_VOICES; i++ ) if( this->voiceTrack[i] ) n++;
+  return ( n );
 }
 
+byte Sound::voice(int track) {
+  for( byte i=0; i<WAV_VOICES; i++ ) if( this->voiceTrack[i] == track ) return ( i );
+  return ( WAV_VOICES );
+}
+
+byte Sound::voiceOn(int track) {
+  // a playing track restarts in its voice; otherwise a free one, or the board takes the oldest
+  byte v = voice(track);
+  if( v == WAV_VOICES ) v = voice(0);
+  if( v == WAV_VOICES ) {
+    v = 0;
+    for( byte i=1; i<WAV_VOICES; i++ ) if( (long)(this->voiceStart[i] - this->voiceStart[v]) < 0 ) v = i;
+  }
+  this->voiceTrack[v] = track;
+  this->voiceStart[v] = millis();
+  this->voiceEnd[v] = 0;
+  this->voiceGain[v] = VOICE_UNLEVELED;
+  this->voiceManual[v] = false;
+  this->changed = true;
+  return ( v );
+}
+
+void Sound::voiceOff(int track) {
+  byte v = voice(track);
+  if( v < WAV_VOICES ) this->voiceTrack[v] = 0;
+  this->changed = true;
+}
+
+void Sound::voiceFade(int track, unsigned long fadeTime) {
+  byte v = voice(track);
+  if( v < WAV_VOICES ) this->voiceEnd[v] = (millis() + fadeTime) | 1; // 0 is 'till it's done'
+  this->changed = true;
+}
+
+void Sound::voicesOff() {
+  for( byte i=0; i<WAV_VOICES; i++ ) this->voiceTrack[i] = 0;
+  this->changed = true;
+}
 
+// what the board says is playing, over what we thought
+void Sound::reconcile(int playingTracks[WAV_VOICES]) {
+  boolean differs = false;
+  for( byte i=0; i<WAV_VOICES; i++ ) {
+    if( !this->voiceTrack[i] ) continue;
+    boolean still = false;
+    for( byte j=0; j<WAV_VOICES; j++ ) if( playingTracks[j] == this->voiceTrack[i] ) still = true;
+    if( !still ) {
+      // ended on its own
+      this->voiceTrack[i] = 0;
+      differs = true;
+    }
+  }
+  for( byte j=0; j<WAV_VOICES; j++ ) {
+    if( playingTracks[j] > 0 && !playing(playingTracks[j]) ) {
+      voiceOn(playingTracks[j]);
+      differs = true;
+    }
+  }
+  if( differs ) {
+    this->mismatches++;
+    relevel();
+  }
+}
 
 // Adjust volume on playing track
 void Sound::setVolume(int track, int gain) {
@@ -196,45 +388,141 @@ void Sound::setVolume(int track, int gain) {
   int tr = constrain(track, 1, 999);
   int ga = constrain(gain, -70, 10);
 
-  // set volume
-  wav.trackGain(tr, ga);
+  // set volume, once the tones are out
+  enqueue(W_Gain, tr, ga);
+  byte v = voice(tr);
+  if( v < WAV_VOICES ) {
+    this->voiceGain[v] = ga;
+    this->voiceManual[v] = true;
+  }
 
 //  Serial << F("Sound: volume for track:") << tr << F(" =") << ga << endl;
 }
 
-/*
-// Relevel volume on playing tracks to summed 0dB gain prevent clipping
-void Sound::relevelVol() {
-  // playing track indices.
-  int tr[14];
-  // get the array of currently playing tracks
-  wav.getPlayingTracks(tr);
-
-  // figure out what we've got in the way of total tracks, tone and music tracks
-  byte nTotal = 0;
-  byte nTones =0;
-  byte nTracks = 0;
-  for( byte i=0;i<14;i++ ) {
-    if( tr[i] > 0 ) {
-//      Serial << "TR: " << tr[i] << endl;
-      nTotal++;
-      if( tr[i] <= 100 ) nTones++; // any track number less than 100 is a tone
-      else nTracks++;
-    }
+// bytes on the wire, as the library sends them
+static byte wavBytes(byte kind) {
+  switch( kind ) {
+    case W_Play: return ( 9 + 8 );
+    case W_Stop: return ( 8 );
+    case W_Gain: return ( 9 );
+    case W_Fade: return ( 12 );
+    case W_CrossFade: return ( 9 + 8 + 12 + 12 );
+    case W_StopAll: return ( 5 );
+    case W_MasterGain: return ( 7 );
   }
+  return ( 0 );
+}
 
-  // with that, execute the volume adjustments per track
-  // figure out what we've got in the way of total tracks, tone and music tracks
-  for( byte i=0;i<14;i++ ) {
-    if( tr[i] > 0 ) {
-      if( tr[i] <= 100 ) setVol(tr[i], toneGain); // any track number less than 100 is a tone
-      else setVol(tr[i], trackGain);
+byte Sound::waiting() {
+  return ( this->nQueued );
+}
+
+void Sound::enqueue(byte kind, int track, int gain, int other, unsigned int time) {
+  this->queued++;
+
+  // what this makes pointless
+  for( byte i=0; i<this->nQueued; ) {
+    wavCommand &q = this->queue[i];
+    boolean same = q.track == track && q.kind != W_CrossFade && q.kind != W_StopAll && q.kind != W_MasterGain;
+    boolean pointless = false;
+    switch( kind ) {
+      case W_StopAll: pointless = q.kind != W_MasterGain; break;
+      case W_MasterGain: pointless = q.kind == W_MasterGain; break;
+      case W_Play:
+      case W_Stop: pointless = same; break;
+      case W_Fade: pointless = same && q.kind == W_Gain; break;
+      case W_Gain:
+        // the new gain goes with what's waiting
+        if( same && (q.kind == W_Gain || q.kind == W_Play) ) {
+          q.gain = gain;
+          this->coalesced++;
+          return;
+        }
+        break;
+    }
+    if( pointless ) {
+      drop(i);
+      this->coalesced++;
+    } else {
+      i++;
     }
   }
 
-  // QED
+  // full: the next one goes now, however long that takes
+  if( this->nQueued == WAV_QUEUE ) drain(true);
+
+  wavCommand &c = this->queue[this->nQueued++];
+  c.kind = kind;
+  c.track = track;
+  c.gain = gain;
+  c.other = other;
+  c.time = time;
+  if( kind == W_Gain ) c.priority = P_Gain;
+  else if( kind == W_StopAll || ((kind == W_Play || kind == W_Stop) && toneTrack(track)) ) c.priority = P_Tone;
+  else c.priority = P_Track;
+  // a clock read is a few us; only the tone starts are timed
+  if( kind == W_Play && c.priority == P_Tone ) c.queuedAt = micros();
+
+  // tones don't wait for the next loop
+  drain();
+}
+
+void Sound::drop(byte i) {
+  for( byte j=i+1; j<this->nQueued; j++ ) this->queue[j-1] = this->queue[j];
+  this->nQueued--;
+}
+
+// the most urgent, and of those the oldest
+byte Sound::next() {
+  byte n = 0;
+  for( byte i=1; i<this->nQueued; i++ ) {
+    if( this->queue[i].priority < this->queue[n].priority ) n = i;
+  }
+  return ( n );
+}
+
+unsigned long Sound::inFlight(unsigned long now) {
+  long left = this->txFreeAt - now;
+  return ( left > 0 ? left : 0 );
+}
+
+// as much as goes without getting more than WAV_IN_FLIGHT ahead; with 'block', one at least
+void Sound::drain(boolean block) {
+  if( this->nQueued == 0 ) return;
+
+  unsigned long now = micros();
+  while( this->nQueued > 0 ) {
+    byte i = next();
+    unsigned long ahead = inFlight(now);
+    if( !block && ahead > 0 && ahead + wavBytes(this->queue[i].kind) * WAV_BYTE_US > WAV_IN_FLIGHT * WAV_BYTE_US ) return;
+    block = false;
+    wavCommand c = this->queue[i];
+    drop(i);
+    send(c, now);
+  }
+}
+
+void Sound::send(wavCommand &c, unsigned long now) {
+  switch( c.kind ) {
+    case W_Play:
+      wav.trackGain(c.track, c.gain);
+      wav.trackPlayPoly(c.track);
+      break;
+    case W_Stop: wav.trackStop(c.track); break;
+    case W_Gain: wav.trackGain(c.track, c.gain); break;
+    case W_Fade: wav.trackFade(c.track, c.gain, c.time, true); break;
+    case W_CrossFade: wav.trackCrossFade(c.track, c.other, c.gain, c.time); break;
+    case W_StopAll: wav.stopAllTracks(); break;
+    case W_MasterGain: wav.masterGain(c.gain); break;
+  }
+  this->sent++;
+
+  this->txFreeAt = now + inFlight(now) + wavBytes(c.kind) * WAV_BYTE_US;
+  if( c.kind == W_Play && c.priority == P_Tone ) {
+    this->toneLatency = this->txFreeAt - c.queuedAt;
+    this->toneLatencyMax = max(this->toneLatencyMax, this->toneLatency);
+  }
 }
-*/
 
 // unit test for Music
 void Sound::unitTest() {
@@ -242,8 +530,7 @@ void Sound::unitTest() {
   // quiet
   this->stopAll();
 
-  // try out leveling to confirm 4x tones and 0x tracks don't clip;
-  this->setLeveling(4, 0);
+  // try out leveling to confirm 4x tones and 0x tracks don't clip; the gains follow what's playing
   this->playTone(I_RED);
   delay(1000);
   this->playTone(I_GRN);
@@ -260,11 +547,9 @@ void Sound::unitTest() {
   this->stopTones();
 
   // try out leveling to confirm 1x tones and 1x tracks don't clip;
-  this->setLeveling(1, 1);
-
   this->playTone(I_RED);
   delay(1000);
-  int tr = this->playWins(101);
+  this->playWins(101);
   delay(1000);
   this->stopTones();
   delay(5000);
@@ -272,9 +557,7 @@ void Sound::unitTest() {
   this->stopAll();
 
   // try out leveling to confirm zero tones and 1x tracks don't clip;
-  this->setLeveling(0, 1);
-
-  tr = this->playWins(101);
+  this->playWins(101);
   delay(5000);
 
   this->stopAll();
@@ -282,7 +565,7 @@ void Sound::unitTest() {
 }
 
 int Sound::playDrumSound(byte colorIndex) {
-  return playTrack(trDrum[0] + currDrumSet + colorIndex, this->toneGain);
+  return playTrack(trDrum[0] + currDrumSet + colorIndex);
 }
 
 int Sound::nextDrumSet() {
@@ -304,14 +587,14 @@ int Sound::prevDrumSet() {
   return currDrumSet;
 }
 
-char* drumKitLabels[] = {
+const char* drumKitLabels[] = {
   "Disco 1",
   "Disco 2",
   "Beep Boop",
   "Tribal",
 };
 
-char* Sound::getLabel(int drumSet) {
+const char* Sound::getLabel(int drumSet) {
   int id = drumSet + trDrum[0];
   if (id == 710)
     return drumKitLabels[0];
@@ -321,9 +604,10 @@ char* Sound::getLabel(int drumSet) {
     return drumKitLabels[2];
   if (id == 722)
     return drumKitLabels[3];
+  return "";
 }
 
-char* Sound::getCurrLabel() {
+const char* Sound::getCurrLabel() {
   return getLabel(currDrumSet);
 }
 
@@ -15,6 +15,9 @@
 
 #include <Simon_Common.h> // for color defs.
 
+// what's on the card: lengths, peaks and loops
+#include "Tracks.h"
+
 // define track number for tones
 #define N_TONES 5
 const int trTones[N_TONES] = {1, 2, 3, 4, 5}; // red, grn, blu, yel, wrong
@@ -46,6 +49,55 @@ const int trDrum[2] = {710, 725}; // store DRUM in 710-999
 
 #define RANDOM_TRACK 0 // use zero to mean "random", as zero isn't a valid track number.
 
+// Sound keeps its own picture of the board's voices, from the commands it sends, so a stop is
+// a trackStop for what's playing rather than a status request and a wait on the reply (7 ms,
+// as the library waits out its timeout unless all 14 voices are busy).  Tracks end on their
+// own, too, which only the board knows: now and then update() asks it, without waiting.
+#define WAV_VOICES 14 // the board's polyphony
+#define WAV_RECONCILE 5000UL // ms between asking the board what's playing
+#define WAV_REPLY_WAIT 50UL // ms to give up on a reply
+
+// Commands to the board wait in a queue, and update() sends them as the link can take them,
+// with no more than WAV_IN_FLIGHT bytes ahead on the wire: a tone waits behind that much, not
+// behind a backlog of gain changes.  Tones (and drums) go first, then music, then gain changes.
+// A command that makes one still waiting pointless replaces it: a gain change for a track with
+// one waiting, a play or stop for a track with anything waiting, stopAll() for everything.
+#define WAV_QUEUE 16 // commands waiting
+#define WAV_BYTE_US 174UL // 10 bits at 57600
+#define WAV_IN_FLIGHT 24 // bytes, ~4 ms
+#define SOUND_VERBOSE false // every play and stop to Serial
+
+// Leveling: simultaneous playback gets stacked, so each voice plays quieter the more there
+// are.  Tones (and drums) play at TONE_GAIN less the dB of what's playing, counting a tone as
+// one and a track as TRACK_GAIN_RELATIVE_TO_TONE down on it; tracks play that much under the
+// tones.  Every start and stop recounts the voices, and those whose class gain moved get a
+// gain change; the rest don't.  Voices given setVolume(), and fades, are left as they are.
+#define VOICE_UNLEVELED 127 // a voice's gain, before we've sent it one
+
+// in the order they go out
+enum wavPriority {
+  P_Tone = 0,
+  P_Track,
+  P_Gain
+};
+
+enum wavCommandKind {
+  W_Play, // gain, then play poly
+  W_Stop,
+  W_Gain,
+  W_Fade, // to gain, then stop
+  W_CrossFade, // track out, other in at gain
+  W_StopAll,
+  W_MasterGain
+};
+
+typedef struct {
+  byte kind, priority;
+  int track, other, gain;
+  unsigned int time; // ms, fades
+  unsigned long queuedAt; // us
+} wavCommand;
+
 // Real Keyboard Jockeys could probably write Sound as extending wavTrigger.
 class Sound {
   public:
@@ -55,13 +107,6 @@ class Sound {
     // set master gain
     void setMasterGain(int gain = MASTER_GAIN); // -70 to +4 dB
 
-    // set how we want volume levels to be applied so that simultaneous playback does not clip.
-    void setLeveling(int nTones=N_TONES-1, int nTracks=1);
-    // e.g.
-    //  bongo: setLeveling(4, 0) -> reduce individual track gains so that 4x tones and zero tracks can play simultaneously
-    //  gameplay: setLeveling(1, 1) -> reduce individual track gains so that 1x tones and 1x track (ROCK) can play simultaneously
-    //  win/lose: setLevel(0, 1) -> reduce individual track gains so that zero tones and 1x track (WINS/LOSE) can play simultaneously
-
     // note that the calling program should store the return value for later stopTrack
     // and fadeTrack usage.
 
@@ -74,6 +119,11 @@ class Sound {
     // Play a specific track by number
     int playTrack(int track);
 
+    // what the track index (Tracks.h) has on a track: false if it isn't on the card we indexed
+    boolean lookupTrack(int track, trackInfo &info);
+    // ms it plays for, or 0 if we don't know
+    unsigned long trackLength(int track);
+
     // Stop a track
     void stopTrack(int track);
     // Fade out track
@@ -93,35 +143,80 @@ class Sound {
     // Stop tones and tracks
     void stopAll();
 
+    // call every loop(): fades that have stopped their tracks, and now and then the board's
+    // word on what's playing
+    void update();
+    // as far as we know
+    boolean playing(int track);
+    byte voices();
+    // asked the board, heard back, and found it playing other than we thought
+    unsigned long reconciles, replies, mismatches;
+    // commands queued, replaced by a later one, and sent
+    unsigned long queued, coalesced, sent;
+    // gain changes sent by the leveling
+    unsigned long leveled;
+    // us from playTone() (or a drum) to the board having it: the last, and the most
+    unsigned long toneLatency, toneLatencyMax;
+    // waiting to go
+    byte waiting();
+
     // unit test for Music
     void unitTest();
 
     // set volume manually.  THIS IS VERY LIKELY TO CREATE CLIPPING UNLESS YOU KNOW WHAT YOU'RE DOING
+    // the leveling leaves the track alone until it's played again.
     void setVolume(int track, int gain);
 
     int playDrumSound(byte colorIndex);
     // returns the drum set index
     int nextDrumSet();
     int prevDrumSet();
-    char* getLabel(int drumSet);
-    char* getCurrLabel();
+    const char* getLabel(int drumSet);
+    const char* getCurrLabel();
 
   private:
-    // Play a track.  INTENTIONALLY private to preserve gain settings
-    // track is 1 to 999.
-    // gain is track gain -70 to +10.
-    // -> returns track #.
-    int playTrack(int track, int gain);
-
     // select a random track
     int randomTrack(const int (&range)[2]);
 
-    // store tone and volume levels
+    // tone and track gains, for what's playing
     int toneGain, trackGain;
+    void leveling();
+    // and the voices whose gain that moved
+    void relevel();
+    int levelGain(int track);
 
     // drum kit set index
     int currDrumSet;
 
+    // the voices: the track (0 is free), when it started and, for a fade with stop, when it
+    // ends (0 is when the track does)
+    int voiceTrack[WAV_VOICES];
+    unsigned long voiceStart[WAV_VOICES], voiceEnd[WAV_VOICES];
+    // the gain we last sent it, and whether that was setVolume()'s
+    int voiceGain[WAV_VOICES];
+    boolean voiceManual[WAV_VOICES];
+    byte voiceOn(int track);
+    void voiceOff(int track);
+    void voiceFade(int track, unsigned long fadeTime);
+    void voicesOff();
+    byte voice(int track); // its voice, or WAV_VOICES
+    void reconcile(int playingTracks[WAV_VOICES]);
+
+    // waiting on a status reply since this time (ms); a command since makes it stale
+    boolean asked, changed;
+    unsigned long askedAt, lastAsked;
+
+    // the outbound queue, oldest first, and when (us) the last byte we sent leaves the UART
+    wavCommand queue[WAV_QUEUE];
+    byte nQueued;
+    unsigned long txFreeAt;
+    void enqueue(byte kind, int track, int gain = 0, int other = 0, unsigned int time = 0);
+    void drop(byte i);
+    byte next(); // the one that goes first
+    unsigned long inFlight(unsigned long now); // us of bytes still on their way out
+    void drain(boolean block = false);
+    void send(wavCommand &cmd, unsigned long now);
+
 };
 
 extern Sound sound;
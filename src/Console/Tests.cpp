@@ -3,10 +3,27 @@
 
 #define MODE_TRACK_OFFSET 699
 
+// continuations on the scheduler; see update() and layoutModeLoop().
+static boolean modeStarting;
+static void modeStarted() { modeStarting = false; }
+
+static boolean layoutShowNow;
+static color layout[N_COLORS];
+static void layoutShow() { layoutShowNow = true; }
+static void layoutSave() {
+  layoutShowNow = true;
+
+  // do the deed.
+  network.layout(layout, layout);
+
+  // reset high score
+  scoreboard.resetHighScore();
+}
+
 // called from the main loop.  return true if we want to head back to playing Simon.
 boolean TestModes::update() {
 
-  char * systemModeNames[] = {
+  const char * systemModeNames[] = {
     "Gameplay Mode",
     "Whiteout Mode",
     "Bongo Mode",
@@ -29,19 +46,22 @@ boolean TestModes::update() {
 
     // Play the sound to let the use know what mode we're in
     sound.stopAll();
-    sound.setLeveling(1, 0); // Level for one track, no music
     sound.playTrack(MODE_TRACK_OFFSET + currentMode);
 
     // Show the mode name on the scoreboard
     scoreboard.showMessage(systemModeNames[currentMode]);
 
-    Metro delayFor(1500UL);
-    delayFor.reset();
-    while( !delayFor.check() ) network.update(); // better.
+    // let the announcement play out before the mode starts
+    modeStarting = true;
+    scheduler.after(1500UL, modeStarted);
 
     performStartup = true;
     modeChange = false;
   }
+  if( modeStarting ) return( false );
+
+  // presses from the last mode, or during the announcement, don't count
+  if( performStartup ) touch.clearEvents();
 
   // yes, we could accomplish this with an array of function pointers, if we were real software engineers...
   switch( currentMode ) {
@@ -93,7 +113,6 @@ void TestModes::whiteoutModeLoop(boolean performStartup) {
   if( performStartup ) {
     Serial << "Starting up whiteout mode!" << endl;
     sound.stopAll();
-    sound.setLeveling(1, 0); // prep for 1x tones and no music.
 
     step = 0;
 
@@ -174,24 +193,18 @@ void TestModes::whiteoutModeLoop(boolean performStartup) {
 // assign towers to locations around the Simon bezel
 void TestModes::layoutModeLoop(boolean performStartup) {
 
-  static boolean showNow = true;
-  static color layout[N_COLORS];
-
   // track idle for saving
   static Metro writeSettingsNow(5000UL);
 
   if( performStartup ) {
     Serial << "Starting up layoutMode" << endl;
     sound.stopAll();
-    sound.setLeveling(4, 0); // prep for 4x tones and no music.
 
     fire.clear();
     light.clear();
-    Metro delayFor(100UL);
-    delayFor.reset();
-    while( ! delayFor.check() ) network.update();
-
-    showNow = true;
+    // blink off, then show the layout
+    layoutShowNow = false;
+    scheduler.after(100UL, layoutShow);
 
     int addr = 69;
     for ( byte i = 0; i < N_COLORS; i++ ) {
@@ -201,21 +214,20 @@ void TestModes::layoutModeLoop(boolean performStartup) {
 
   }
 
-  if ( touch.anyChanged() ) {
-    if ( touch.anyColorPressed() ) {
-      // increment this tower's color assignment
-      byte tower = (byte)touch.whatPressed();
+  touchEvent press;
+  if ( touch.nextPress(press, N_COLORS) ) {
+    // increment this tower's color assignment
+    byte tower = press.index;
 
-      byte newLayout = (byte)layout[tower] +1;
-      layout[tower] = (color)newLayout;
-      if( layout[tower] > N_COLORS ) layout[tower]=I_RED; // N_COLORS is valid; means "All color channels"
+    byte newLayout = (byte)layout[tower] +1;
+    layout[tower] = (color)newLayout;
+    if( layout[tower] > N_COLORS ) layout[tower]=I_RED; // N_COLORS is valid; means "All color channels"
 
-      showNow = true;
-      writeSettingsNow.reset();
-    }
+    layoutShowNow = true;
+    writeSettingsNow.reset();
   }
 
-  if( showNow ) {
+  if( layoutShowNow ) {
     for( byte i=I_RED; i<N_COLORS; i++ ){
       colorInstruction c;
       if( layout[i] == N_COLORS ) c = cWhite;
@@ -223,22 +235,14 @@ void TestModes::layoutModeLoop(boolean performStartup) {
 
       light.setLight((color)i, c);
     }
-    showNow = false;
+    layoutShowNow = false;
   }
 
   if( writeSettingsNow.check() ) {
+    // blink off, then save and show it
     light.clear();
-    Metro delayFor(500UL);
-    delayFor.reset();
-    while( ! delayFor.check() ) network.update();
-    showNow = true;
     writeSettingsNow.reset();
-
-    // do the deed.
-    network.layout(layout, layout);
-
-    // reset high score
-    scoreboard.resetHighScore();
+    scheduler.after(500UL, layoutSave);
   }
 }
 
@@ -260,7 +264,6 @@ void TestModes::bongoModeLoop(boolean performStartup) {
   if( performStartup ) {
     Serial << "Starting up bongoMode" << endl;
     sound.stopAll();
-    sound.setLeveling(4, 0); // prep for 4x tones and no music.
 
     //turn all of the lights off to start out with
     fire.clear();
@@ -271,37 +274,36 @@ void TestModes::bongoModeLoop(boolean performStartup) {
   }
 
   light.animate(A_TronCycles);
-  if (touch.anyChanged()) {
-    if (touch.anyButtonPressed()) {
-
-      color pressed = touch.whatPressed();
-      light.animate(A_TronCycles);
-      //light.animate(A_GameplayPressed);
-
-      // change sound set
-      if (pressed == I_START)
-      {
-        scoreboard.showMessage2(sound.getLabel(sound.nextDrumSet()));
-        Serial << "Next Drum Set" << endl;
-      }
+  touchEvent press;
+  if (touch.nextPress(press)) {
+
+    color pressed = (color)press.index;
+    light.animate(A_TronCycles);
+    //light.animate(A_GameplayPressed);
+
+    // change sound set
+    if (pressed == I_START)
+    {
+      scoreboard.showMessage2(sound.getLabel(sound.nextDrumSet()));
+      Serial << "Next Drum Set" << endl;
+    }
 
-      // if anything's pressed, pack the instructions
-      sound.playDrumSound(pressed);
+    // if anything's pressed, pack the instructions
+    sound.playDrumSound(pressed);
 
-      if (pressed <= N_COLORS) {
-        colorInstruction c = cMap[pressed];
-        light.setLight(pressed, c);
+    if (pressed <= N_COLORS) {
+      colorInstruction c = cMap[pressed];
+      light.setLight(pressed, c);
 
-        // only allow full-on every 10s.
-        byte fireLevel = map(millis() - lastFireTime, 0UL, 10000UL, 50UL, 150UL) / 10;
-        fire.setFire(pressed, fireLevel, gatlingGun);
-        lastFireTime = millis();
-      }
-    } else {
-      light.clearButtons(); // clear lights
-      fire.clear(); // clear fire
-      sound.stopTones(); // stop tones
+      // only allow full-on every 10s.
+      byte fireLevel = map(millis() - lastFireTime, 0UL, 10000UL, 50UL, 150UL) / 10;
+      fire.setFire(pressed, fireLevel, gatlingGun);
+      lastFireTime = millis();
     }
+  } else if (touch.anyChanged() && !touch.anyButtonPressed()) {
+    light.clearButtons(); // clear lights
+    fire.clear(); // clear fire
+    sound.stopTones(); // stop tones
   }
 }
 
@@ -309,12 +311,12 @@ void TestModes::bongoModeLoop(boolean performStartup) {
 extern float fscale( float originalMin, float originalMax, float newBegin, float newEnd, float inputValue, float curve); // from Touch.cpp
 void TestModes::proximityModeLoop(boolean performStartup) {
 
-  static Metro restartTimer(25000UL); // tones are only 30 seconds long, so we need to restart
+  static Metro restartTimer(25000UL); // tones run out, so we need to restart them before they do
   static int gainMax=TONE_GAIN - 6;
   static int gainMin=gainMax - 40;
   static int trTone[N_COLORS];
   static byte lastDistance[N_COLORS];
-  static byte distanceThreshold = 200;
+  const unsigned long lightFade = 100UL; // ms: the pads ease after the hand, not a step a reading
 
   // track the last time we fired
   static unsigned long lastFireTime;
@@ -323,7 +325,6 @@ void TestModes::proximityModeLoop(boolean performStartup) {
     Serial << "Starting up proximityMode" << endl;
 
     sound.stopAll();
-    sound.setLeveling(4, 0); // prep for 4x tones and no music.
 
     for( byte i = 0; i < N_COLORS; i++ ) {
       // start the tones up
@@ -332,19 +333,26 @@ void TestModes::proximityModeLoop(boolean performStartup) {
       sound.setVolume(trTone[i], gainMin);
     }
 
+    // a little before the shortest of them ends, if the track index knows.  the tones (1-5)
+    // aren't in tones/, so the index we ship doesn't: they're taken as 30 s, restarted at 25 s
+    unsigned long shortest = 30000UL;
+    for( byte i = 0; i < N_COLORS; i++ ) {
+      unsigned long length = sound.trackLength(trTone[i]);
+      if( length > 0 ) shortest = min(shortest, length);
+    }
+    restartTimer.interval(shortest > 5000UL ? shortest - 5000UL : shortest / 2);
     restartTimer.reset();
     lastFireTime = millis();
   }
 
   light.animate(A_LaserWipe);
-  boolean showLightsNow = false;
   for( byte i = 0; i < N_COLORS; i++ ) {
     // read the sensor distance
     byte dist = touch.distance((color)i);
 
     if( dist != lastDistance[i] ) {
       // adjust the volume based on the distance
-      int gain = fscale(0, 255, gainMax, gainMin, dist, -10.0); // log10
+      int gain = gainMax + (gainMin - gainMax) * (int)fscaleLookup(fscaleCurve10, dist, 255) / 255; // log10
 
       sound.setVolume(trTone[i], gain);
 
@@ -354,7 +362,7 @@ void TestModes::proximityModeLoop(boolean performStartup) {
       c.red -= c.red > 0 ? dist : 0;
       c.green -= c.green > 0 ? dist : 0;
       c.blue -= c.blue > 0 ? dist : 0;
-      light.setLight((color)i, c);
+      light.setLight((color)i, c, lightFade);
       light.animate(A_ProximityPulseMatrix);
       if( dist<10 ) {
         // only allow full-on every 10s.
@@ -392,20 +400,19 @@ void TestModes::lightsTestModeLoop(boolean performStartup) {
     light.clear();
   }
 
-  if ( touch.anyChanged() ) {
-    if ( touch.anyColorPressed()) {
-      sound.playTrack(BOOP_TRACK);
+  touchEvent press;
+  if ( touch.nextPress(press, N_COLORS) ) {
+    sound.playTrack(BOOP_TRACK);
 
-      color whatPressed = touch.whatPressed();
+    color whatPressed = (color)press.index;
 
-      // advance the tower pressed into the next step of the sequence, wrap around.
-      towerSpotInSequence[whatPressed] ++;
-      towerSpotInSequence[whatPressed] %= 5;
+    // advance the tower pressed into the next step of the sequence, wrap around.
+    towerSpotInSequence[whatPressed] ++;
+    towerSpotInSequence[whatPressed] %= 5;
 
-      // send the correct color to that tower
-      colorInstruction c = colorSequence[towerSpotInSequence[whatPressed]];
-      light.setLight(whatPressed, c);
-    }
+    // send the correct color to that tower
+    colorInstruction c = colorSequence[towerSpotInSequence[whatPressed]];
+    light.setLight(whatPressed, c);
   }
 }
 
@@ -433,7 +440,6 @@ void TestModes::fireTestModeLoop(boolean performStartup) {
     dtostrf(budget, 3, 1, str_temp);
     sprintf(lcdMsg, "Fire Budget: %s", str_temp);
     scoreboard.showMessage(lcdMsg);
-    delay(100);
 
     // Turn off the fire and lights
     fire.clear();
@@ -523,28 +529,30 @@ void TestModes::fireTestModeLoop(boolean performStartup) {
   }
   */
 
-  if (touch.anyChanged() && touch.anyColorPressed()) {
-    // check for left and right to adjust fireBudget
-    while(touch.pressed(I_BLU)) {
+  // check for left and right to adjust fireBudget; holding repeats every 100 ms
+  static Metro repeatTimer(100UL);
+  static boolean adjusting = false;
+  touchEvent press;
+  if (touch.nextPress(press, N_COLORS)) adjusting = true;
+  if (adjusting && repeatTimer.check()) {
+    if (touch.pressed(I_BLU)) {
       if (budget <= 0) budget = 25.5;
       budget=constrain(budget-0.2, 0.0, 25.5);
-      Serial << "Budget: " << budget << endl;
-      dtostrf(budget, 3, 1, str_temp);
-      sprintf(lcdMsg, "Fire Budget: %s", str_temp);
-      saveFireBudgetFactor(budget);
-      scoreboard.showMessage(lcdMsg);
-      delay(100);
-    }
-    while(touch.pressed(I_RED)) {
+    } else if (touch.pressed(I_RED)) {
       if (budget >= 25.5) budget = 0;
       budget=constrain(budget+0.2, 0.0, 25.5);
+    } else {
+      adjusting = false;
+    }
+
+    if (adjusting) {
       Serial << "Budget: " << budget << endl;
       dtostrf(budget, 3, 1, str_temp);
       sprintf(lcdMsg, "Fire Budget: %s", str_temp);
       saveFireBudgetFactor(budget);
       scoreboard.showMessage(lcdMsg);
-      delay(100);
     }
+    repeatTimer.reset();
   }
 }
 
@@ -567,25 +575,25 @@ void TestModes::externModeLoop(boolean performStartup) {
    static unsigned long firepower = 1;
    static float threshold = 1.5; // initial threshold is likely to throw a fireball
    static color fireTower = I_RED;
-   static color lightTower = I_RED;
 
    static unsigned long trackLength = 30000;  // todo not really gonna work but test for now
    static unsigned long budget;
    static float bt;
-   static byte active;
    static boolean hearBeat = false;
-   static byte tower, tower2 = I_RED;
    static int numSamples = 0;
    static boolean printSamples = false;
    static float fireBudgetFactor;
+   static unsigned long lastSample, sampleWait; // pace the beat detector
+
+   light.animate(A_GameplayPressed);
 
    currTime = millis();
+   if (!performStartup && currTime - lastSample < sampleWait) return;
 
    if (performStartup) {
      fireBudgetFactor = 26.5 - loadFireBudgetFactor();
      budget = (unsigned long) ((float)trackLength / fireBudgetFactor);
      bt = (float) trackLength / budget;
-     active = 0;
      startTime = currTime - 1; // avoid / 0
      hearBeat = false;
      firepower = 1;
@@ -606,9 +614,9 @@ void TestModes::externModeLoop(boolean performStartup) {
    threshold = constrain(threshold,0.25,15.0);
    listenMic.setThreshold(bassBand, threshold);
    listenMic.setThreshold(bassBand2, threshold);
-   network.update();
-   waitDuration(1UL);
    listenMic.update();
+   lastSample = millis();
+   sampleWait = 1;
 
    if (printSamples) {
      numSamples++;
@@ -621,9 +629,8 @@ void TestModes::externModeLoop(boolean performStartup) {
    if (hearBeat && currTime > beatEndTime) {
      light.clear();
      fire.clear();
-     network.update();
      hearBeat = false;
-     waitDuration(10UL);
+     sampleWait = 10;
    }
 
   // Fire is queued to the bass channels.  Air effect is random but unlikely right now
@@ -2,7 +2,15 @@
 
 // MPR121 object instantiated in the library.
 
-boolean Touch::begin(byte sensorIndex[N_BUTTONS]) {
+// the MPR121 pulls ~IRQ low when the touch status changes, until it's read.  note when.
+static volatile boolean touchIrq = false;
+static volatile unsigned long touchIrqTime;
+static void touchISR() {
+  if ( !touchIrq ) touchIrqTime = millis();
+  touchIrq = true;
+}
+
+boolean Touch::begin(byte sensorIndex[N_BUTTONS], boolean useIrq) {
 
   Serial << F("Touch: startup.") << endl;
 
@@ -52,9 +60,16 @@ boolean Touch::begin(byte sensorIndex[N_BUTTONS]) {
       // WARNING: MPR121.reset() blows the whole thing up.  Probably need to resend configuration after doing so?
       MPR121.reset();
       //      Serial << F("Touch: MPR121: reset.") << endl;
-      // NOT USING interrupt handler.  Polling mode only.
-      MPR121.setInterruptPin(TOUCH_IRQ);
       */
+      this->useIrq = useIrq;
+      if ( useIrq ) {
+        MPR121.setInterruptPin(TOUCH_IRQ);
+        attachInterrupt(TOUCH_INT, touchISR, FALLING);
+        Serial << F("Touch: MPR121 IRQ on D") << TOUCH_IRQ << endl;
+      } else {
+        detachInterrupt(TOUCH_INT);
+        Serial << F("Touch: MPR121 polling.") << endl;
+      }
 
       // Alan removed
       // enable 13-th virtual proximity electrode, tying electrodes 0..3 together.
@@ -77,6 +92,20 @@ boolean Touch::begin(byte sensorIndex[N_BUTTONS]) {
       MPR121.updateAll();
       Serial << F("Touch: MPR121 data update.") << endl;
 
+      // first snapshot.  what's touched at power up isn't a press.
+      this->snapshot = this->reported = 0;
+      for( byte i=0; i<N_BUTTONS; i++ ) this->changeTime[i] = 0;
+      this->eventHead = this->eventTail = 0;
+      this->dropped = 0;
+      this->proxTracking = false;
+      for( byte e=0; e<PROXIMITY_ELECTRODES; e++ ) {
+        this->proxMin[e] = 400 << 4; // 300 seems to be the normal low end, but let's leave some room for drift
+        this->proxMaxDelta[e] = 0;
+      }
+      touchIrq = true;
+      this->update();
+      this->clearEvents();
+
       Serial << F("Touch: MPR121 initialization complete.") << endl;
       mprError = false;
     }
@@ -99,19 +128,116 @@ boolean Touch::begin(byte sensorIndex[N_BUTTONS]) {
   return ( true );
 }
 
+// one I2C read for everyone, when there's something to read; the rest of the loop asks the snapshot.
+boolean Touch::update() {
+  // filtered data for distance(), while someone wants it
+  if ( this->proxTracking ) {
+    if ( millis() - this->proxAskTime < PROXIMITY_IDLE ) this->proximityRead(false);
+    else this->proxTracking = false;
+  }
+
+  // take the flag, and when it went up
+  noInterrupts();
+  boolean irq = touchIrq;
+  unsigned long irqTime = touchIrqTime;
+  touchIrq = false;
+  interrupts();
+
+  // the line may still be low from before we were listening
+  if ( this->useIrq && !irq && !MPR121.touchStatusChanged() && millis() - this->readTime < TOUCH_POLL_INTERVAL ) return( false );
+
+  MPR121.updateTouchData();
+  this->readTime = millis();
+  unsigned long when = irq ? irqTime : this->readTime;
+
+  unsigned int was = this->snapshot;
+  this->snapshot = 0;
+  for( byte e=0; e<12; e++ ) if( MPR121.getTouchData(e) ) this->snapshot |= 1U << e;
+  if( this->snapshot == was ) return( false );
+
+  if ( this->useIrq && !irq ) {
+    // the IRQ may have come in since we took the flag, for the change we just read
+    noInterrupts();
+    irq = touchIrq;
+    if ( irq ) {
+      when = touchIrqTime;
+      touchIrq = false;
+    }
+    interrupts();
+  }
+  if ( this->useIrq && !irq ) {
+    Serial << F("Touch: change without an IRQ; polling from now on.") << endl;
+    this->useIrq = false;
+  }
+
+  // edges, by button
+  for( byte i=0; i<N_BUTTONS; i++ ) {
+    unsigned int bit = 1U << this->sensorIndex[i];
+    if( !((this->snapshot ^ was) & bit) ) continue;
+    this->changeTime[i] = when;
+
+    byte tail = this->eventTail;
+    byte next = (tail + 1) & (TOUCH_EVENTS - 1);
+    if( next == this->eventHead ) {
+      // full: the reader's behind.  keep what it hasn't seen.
+      this->dropped++;
+      continue;
+    }
+    touchEvent &e = this->events[tail];
+    e.index = i;
+    e.pressed = (this->snapshot & bit) != 0;
+    e.time = when;
+    this->eventTail = next; // publish
+  }
+  return( true );
+}
+
+boolean Touch::event(touchEvent &e) {
+  byte head = this->eventHead;
+  if( head == this->eventTail ) return( false );
+  e = this->events[head];
+  this->eventHead = (head + 1) & (TOUCH_EVENTS - 1); // give the slot back
+  return( true );
+}
+
+boolean Touch::nextPress(touchEvent &e, byte below) {
+  while( this->event(e) ) {
+    if( e.pressed && e.index < below ) return( true );
+  }
+  return( false );
+}
+
+// the reader's side: everything so far is old news.
+void Touch::clearEvents() {
+  this->eventHead = this->eventTail;
+}
+
+unsigned long Touch::eventsDropped() {
+  return( this->dropped );
+}
+
+unsigned long Touch::changedAt(byte index) {
+  return( this->changeTime[index] );
+}
+
+unsigned long Touch::snapshotTime() {
+  return( this->readTime );
+}
+
+boolean Touch::touched(byte electrode) {
+  return( (this->snapshot >> electrode) & 1 );
+}
+
 // Returns true if the state of a specific button has changed
 // based on what it was previously.
 boolean Touch::changed(byte index) {
   boolean ret = false;
 
   // capsense
-  static boolean previousState[N_BUTTONS];
-
-  MPR121.updateTouchData();
-  boolean currentState = MPR121.getTouchData(sensorIndex[index]);
+  boolean currentState = touched(sensorIndex[index]);
 
-  if (previousState[index] != currentState) {
-    previousState[index] = currentState;
+  if (bitRead(this->reported, index) != currentState) {
+    bitWrite(this->reported, index, currentState);
     ret |= true;
   }
 
@@ -136,8 +262,7 @@ boolean Touch::pressed(byte index) {
   boolean ret = false;
 
   // capsense
-  MPR121.updateTouchData();
-  ret |= MPR121.getTouchData(sensorIndex[index]);
+  ret |= touched(sensorIndex[index]);
 
   // hard buttons
   // call the updater for debouncing first.
@@ -171,56 +296,48 @@ color Touch::whatPressed() {
   return(N_BUTTONS);
 }
 
-nonColorButtons Touch::whatNonColorButtonPressed() {
-}
-
 // MGD new buttons
 boolean Touch::startPressed() {
   // capsense
-  MPR121.updateTouchData();
-  return( MPR121.getTouchData(I_START) );
+  return( touched(I_START) );
 }
 boolean Touch::rightPressed() {
   // capsense
-  MPR121.updateTouchData();
-  return( MPR121.getTouchData(I_RIGHT) );
+  return( touched(I_RIGHT) );
 }
 boolean Touch::leftPressed() {
   // capsense
-  MPR121.updateTouchData();
-  return( MPR121.getTouchData(I_LEFT) );
+  return( touched(I_LEFT) );
 }
 
-// returns "distance" an object is to the sensor, scaled [0, 255]
-// realistically, we see distance readings in [0,50], so scaling to a byte is reasonable
+// one burst of all 13 filtered readings, into the filters.  'seed' starts them where they are.
 // for distance/proximity, see http://cache.freescale.com/files/sensors/doc/app_note/AN3893.pdf
-byte Touch::distance(byte index) {
-
-  // for this, we need the filtered data
-  int sensorRead = 0;
-  for( int i=0; i<10; i++ ) {
-    // average ten readings
-    boolean bar = MPR121.updateFilteredData();
-    sensorRead += MPR121.getFilteredData(index);
-  }
-  sensorRead /= 10;
+void Touch::proximityRead(boolean seed) {
+  MPR121.updateFilteredData();
 
-  // track sensor returns for 12 sensors and the virtual 13th.
-  static int minRead[13] = { 400,400,400,400,400,400,400,400,400,400,400,400,400 }; // 300 seems to be the normal low end, but let's leave some room for drift
-  minRead[index] = min(minRead[index], sensorRead);
+  for( byte e=0; e<PROXIMITY_ELECTRODES; e++ ) {
+    int sensorRead = MPR121.getFilteredData(e) << 4;
+    if( seed ) this->proxFiltered[e] = sensorRead;
+    else this->proxFiltered[e] += (sensorRead - (int)this->proxFiltered[e]) >> PROXIMITY_SHIFT;
 
-  int delta = sensorRead - minRead[index];
+    // track the nearest, and how far from that we've seen
+    this->proxMin[e] = min(this->proxMin[e], this->proxFiltered[e]);
+    this->proxMaxDelta[e] = max(this->proxMaxDelta[e], this->proxFiltered[e] - this->proxMin[e]);
+  }
+}
 
-  // track deltas 12 sensors and the virtual 13th.
-  static int maxDelta[13] = { 0,0,0,0,0,0,0,0,0,0,0,0,0 };
-  maxDelta[index] = max(maxDelta[index], delta);
+// returns "distance" an object is to the sensor, scaled [0, 255]
+// realistically, we see distance readings in [0,50], so scaling to a byte is reasonable
+byte Touch::distance(byte index) {
+  // keep the filters running for a while; if they weren't, start them.
+  this->proxAskTime = millis();
+  if( !this->proxTracking ) {
+    this->proximityRead(true);
+    this->proxTracking = true;
+  }
 
   // nonlinear transform to get higher sensitivity at larger distances
-  byte distance = fscale(0, maxDelta[index], 0, 255, delta, -3.0);
-  //  Serial << F("Proximity: distance=") << distance << F(" delta=") << delta << F(" curr=") << sensorRead << F(" minR=") << minRead[sensorIndex] << F(" maxD=") << maxDelta[sensorIndex] << endl;
-
-  return( distance );
-
+  return( fscaleLookup(fscaleCurve3, this->proxFiltered[index] - this->proxMin[index], this->proxMaxDelta[index]) );
 }
 
 byte Touch::distance(color index) {
@@ -268,6 +385,26 @@ void Touch::printElectrodeAndBaselineData() {
 */
 }
 
+// fscale(0, 1, 0, 255, i/FSCALE_STEPS, curve), rounded
+const byte fscaleCurve3[FSCALE_STEPS+1] PROGMEM = {
+  0, 0, 1, 2, 4, 6, 9, 12, 16, 20, 25, 30, 36, 42, 49, 56, 64,
+  72, 81, 90, 100, 110, 121, 132, 144, 156, 169, 182, 195, 210, 224, 239, 255
+};
+const byte fscaleCurve10[FSCALE_STEPS+1] PROGMEM = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 2, 4, 6, 9, 14, 22, 32, 47, 67, 95, 134, 186, 255
+};
+
+byte fscaleLookup(const byte *curve, unsigned int in, unsigned int inMax) {
+  if( in >= inMax ) return( pgm_read_byte(&curve[FSCALE_STEPS]) );
+
+  // where we are, in 1/8ths of a step
+  unsigned int at = ((unsigned long)in * FSCALE_STEPS * 8) / inMax;
+  byte lo = pgm_read_byte(&curve[at >> 3]);
+  byte hi = pgm_read_byte(&curve[(at >> 3) + 1]);
+  return( lo + (((hi - lo) * (at & 7)) >> 3) );
+}
+
 // snagged this from https://github.com/BareConductive/midi_theremin/blob/public/midi_theremin/midi_theremin.ino
 // http://playground.arduino.cc/Main/Fscale
 float fscale( float originalMin, float originalMax, float newBegin, float newEnd, float inputValue, float curve) {
@@ -18,6 +18,7 @@
 #define TOUCH_SCL 21 // Wire SCL
 #define TOUCH_SDA 20 // Wire SDA
 #define TOUCH_IRQ 3 // int.1, D3; but could move if we don't implement an interrupt
+#define TOUCH_INT 1 // attachInterrupt() number for TOUCH_IRQ
 #define NUM_ELECTRODES 7
 #define MPR121_I2CADDR_DEFAULT 0x5A
 
@@ -40,10 +41,46 @@
 //------ sizes, indexing and inter-unit data structure definitions.
 #include <Simon_Common.h>
 
+// with the IRQ, we only read the MPR121 when it says something changed; and this often
+// regardless, in case we missed it.  if we did, the IRQ isn't wired: poll every loop() instead.
+#define TOUCH_POLL_INTERVAL 100UL // ms
+
+// presses and releases, as the reads see them: a ring with one writer (update) and one
+// reader (event, nextPress), so it's safe for either to be an ISR.  a power of two.  new
+// events are dropped while it's full, so states that use it clear it on the way in.
+#define TOUCH_EVENTS 8
+
+// proximity: while distance() has been asked lately, each update() also reads every
+// electrode's filtered data in one burst and smooths it.  distance() answers from that.
+#define PROXIMITY_ELECTRODES 13 // 12, and the virtual 13th
+#define PROXIMITY_SHIFT 2 // each read moves the filter 1/4 of the way
+#define PROXIMITY_IDLE 1000UL // ms; stop reading once nobody's asked this long
+
+typedef struct {
+  byte index; // button, as for pressed()
+  boolean pressed; // false on release
+  unsigned long time; // ms; the IRQ that flagged it, or the read that saw it
+} touchEvent;
+
 class Touch {
   public:
-    // intialization; returns true if ok.
-    boolean begin(byte sensorIndex[N_BUTTONS]);
+    // intialization; returns true if ok.  useIrq false polls the MPR121 every loop().
+    boolean begin(byte sensorIndex[N_BUTTONS], boolean useIrq = true);
+
+    // reads every electrode's touch status in one I2C transaction, if the IRQ says anything
+    // changed.  call once per loop(); everything below answers from the last read.
+    // returns true if there's a state change.
+    boolean update();
+
+    // next press or release since the last call, oldest first; false if there isn't one.
+    boolean event(touchEvent &e);
+    // next press, skipping releases and buttons from 'below' up; false if there isn't one.
+    boolean nextPress(touchEvent &e, byte below = N_BUTTONS);
+    void clearEvents();
+    unsigned long eventsDropped();
+    // when a button last changed state (ms), and when we last read them all
+    unsigned long changedAt(byte index);
+    unsigned long snapshotTime();
 
     // state change checks
     boolean changed(byte index); // returns true if state changed
@@ -54,9 +91,8 @@ class Touch {
     boolean anyColorPressed(); // convenience function; returns true if any index is pressed
     boolean anyButtonPressed();
     color whatPressed(); // returns the first pressed button found
-    nonColorButtons whatNonColorButtonPressed();
 
-    // returns "distance" an object is to the sensor
+    // returns "distance" an object is to the sensor, from the filter; no I2C, unless it's the first ask in a while.
     byte distance(color index); // roughly speaking, the distance an object is away from the sensor
     byte proximity(); // 13th "virtual" sensor, which is the sum of all active sensors
 
@@ -69,12 +105,29 @@ class Touch {
     boolean rightPressed();
 
   private:
-    // update function; returns true if there's a state change
-    boolean update();
-
     // maps color index to MPR121 sensor index
     byte sensorIndex[N_BUTTONS];
 
+    // the last read, by electrode; when it was taken; what changed() has reported, by button.
+    unsigned int snapshot, reported;
+    unsigned long readTime;
+    unsigned long changeTime[N_BUTTONS];
+    boolean touched(byte electrode);
+
+    // IRQ or polling
+    boolean useIrq;
+
+    // filtered data, x16; the nearest each has been, and the farthest from that, also x16.
+    unsigned int proxFiltered[PROXIMITY_ELECTRODES];
+    unsigned int proxMin[PROXIMITY_ELECTRODES], proxMaxDelta[PROXIMITY_ELECTRODES];
+    boolean proxTracking;
+    unsigned long proxAskTime;
+    void proximityRead(boolean seed);
+
+    touchEvent events[TOUCH_EVENTS];
+    volatile byte eventHead, eventTail; // read at head, written at tail; one slot stays empty
+    unsigned long dropped;
+
     // hardware buttons
     Bounce *button[N_COLORS];  // messy, but I can't figure out how to declare without instantiation, which the compiler requires.
 
@@ -88,5 +141,12 @@ extern Touch touch;
 // power transformation for nonlinear map() function
 float fscale( float originalMin, float originalMax, float newBegin, float newEnd, float inputValue, float curve);
 
+// fscale() with the curve worked out ahead of time: [0, inMax] onto [0, 255] along 'curve',
+// FSCALE_STEPS+1 bytes in PROGMEM, interpolated between steps.  no floats.
+#define FSCALE_STEPS 32
+byte fscaleLookup(const byte *curve, unsigned int in, unsigned int inMax);
+extern const byte fscaleCurve3[FSCALE_STEPS+1] PROGMEM; // fscale(..., -3.0)
+extern const byte fscaleCurve10[FSCALE_STEPS+1] PROGMEM; // fscale(..., -10.0)
+
 #endif
 
@@ -0,0 +1,28 @@
+// Made by tones/trackindex from the WAV Trigger's files; don't edit.  See Tracks.h.
+
+#include "Tracks.h"
+
+const trackInfo trackTable[] PROGMEM = {
+  // track, length ms, peak dBFS, loop start ms, loop end ms
+  { 100,    287UL,   0,      0UL,    287UL }, // 100 boop.wav
+  { 101,   2540UL,   0,      0UL,   2540UL }, // 101 win2.wav
+  { 300,   1481UL,   0,      0UL,   1481UL }, // 300 Addcoin.wav
+  { 301,   4142UL,   0,      0UL,   4142UL }, // 301 Fail_mus.wav
+  { 302,   1961UL,  -1,      0UL,   1961UL }, // 302 derez.wav
+  { 500,    453UL,   0,      0UL,    453UL }, // 500 rock1.wav
+  { 510,  20630UL,  -1,      0UL,  20630UL }, // 510 ThatsTheWayILikeIt.wav
+  { 512,   7407UL,   0,      0UL,   7407UL }, // 512 PureKickDrum.wav
+  { 513,  13836UL,   0,      0UL,  13836UL }, // 513 PureKickDrum_70BPM.wav
+  { 699,   1400UL,   0,      0UL,   1400UL }, // 699 game.wav
+  { 700,   1194UL,  -1,      0UL,   1194UL }, // 700 whit.wav
+  { 701,    866UL,  -1,      0UL,    866UL }, // 701 bngo.wav
+  { 702,   1211UL,   0,      0UL,   1211UL }, // 702 prox.wav
+  { 703,   1007UL,  -1,      0UL,   1007UL }, // 703 fire.wav
+  { 704,    997UL,   0,      0UL,    997UL }, // 704 lite.wav
+  { 705,   1218UL,   0,      0UL,   1218UL }, // 705 layo.wav
+  { 706,   1173UL,   0,      0UL,   1173UL }, // 706 extn.wav
+  { 900,    417UL,   0,      0UL,    417UL }, // 900 armd.wav
+  { 901,    867UL,   0,      0UL,    867UL }, // 901 darm.wav
+};
+
+const int N_TRACK_INFO = 19;
@@ -0,0 +1,23 @@
+#ifndef Tracks_h
+#define Tracks_h
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// What the WAV Trigger's SD card has on it, as far as the Console needs to know.  Tracks.cpp
+// is made from the card's files by tones/trackindex (convert.sh runs it; so does 'make tracks'
+// in tests/Host, over tones/), so don't edit it by hand.  A track that isn't there, Sound
+// doesn't know the length of: callers fall back on what they assumed before.
+
+typedef struct {
+  int track;
+  unsigned long length; // ms, to the end of the file
+  int8_t peak; // dBFS, rounded up
+  unsigned long loopStart, loopEnd; // ms: the file's loop, or all of it
+} trackInfo;
+
+// sorted by track
+extern const trackInfo trackTable[] PROGMEM;
+extern const int N_TRACK_INFO;
+
+#endif
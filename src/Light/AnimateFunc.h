@@ -3,6 +3,8 @@
 
 typedef void (*AnimateFunc)(Adafruit_NeoPixel&, int, int, int, void*);
 typedef void (*AnimateMatrixFunc)(Adafruit_NeoMatrix&, int, int, int, void*);
+class IndexedStrip;
+typedef void (*AnimateIndexedFunc)(IndexedStrip&, int, int, int, void*);
 
 #endif
 
@@ -11,9 +11,10 @@ struct RgbColor {
 };
 
 struct AnimationConfig {
-  char* name;
+  const char* name;
   Adafruit_NeoPixel *strip;
   Adafruit_NeoMatrix *matrix;
+  IndexedStrip *indexed;
   RgbColor color;
   void* position;
   bool ready;
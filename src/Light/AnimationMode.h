@@ -0,0 +1,24 @@
+#ifndef AnimationMode_h
+#define AnimationMode_h
+
+#include <Simon_Common.h>
+#include "AnimationConfig.h"
+
+// one animation on one config: 'animate' for a strip, 'animateMatrix' for a matrix, or
+// 'animateIndexed' for an IndexedStrip
+struct AnimationStep {
+  AnimateFunc animate;
+  AnimateMatrixFunc animateMatrix;
+  AnimationConfig *config;
+  AnimateIndexedFunc animateIndexed;
+};
+
+// what the Light does for one animationInstruction.  mapToAnimation() looks it up by number.
+struct AnimationMode {
+  void (*enter)(); // on switching to it: its positions back to the start, the rim's layers.  or NULL.
+  void (*inputs)(systemState &state); // every frame, before the steps: the Console's state into the configs.  or NULL.
+  const AnimationStep *steps;
+  byte nSteps;
+};
+
+#endif
@@ -1,17 +1,26 @@
+#include <FastLED.h>
 #include "Animations.h"
+#include "ColorTables.h"
 
 void setStripColor(Adafruit_NeoPixel &strip, int r, int g, int b) {
-  for (int i = 0; i < strip.numPixels(); i++) {
-    strip.setPixelColor(i, strip.Color(r, g, b));
-  }
-  strip.show();
+  setStripColor(strip, strip.Color(r, g, b));
 }
 
+// the Console resends the same colors over and over; a strip that's already that color
+// doesn't need drawing, or showing.
 void setStripColor(Adafruit_NeoPixel &strip, uint32_t c) {
-  for (int i = 0; i < strip.numPixels(); i++) {
-    strip.setPixelColor(i, c);
+  if (showScheduler.isSolid(strip, c)) {
+    return;
   }
-  strip.show();
+  // the first pixel as the library stores it (wire order, brightness and all), then copies
+  // of it, doubling, rather than Color() unpacked and scaled again for every pixel
+  strip.setPixelColor(0, c);
+  uint8_t *p = strip.getPixels();
+  uint16_t bytes = strip.numPixels() * 3;
+  for (uint16_t done = 3; done < bytes; done *= 2) {
+    memcpy8(p + done, p, min(done, (uint16_t)(bytes - done)));
+  }
+  showScheduler.solid(strip, c);
 }
 void setStripColor(Adafruit_NeoPixel &strip, colorInstruction &inst) {
   strip.setBrightness(255);
@@ -19,10 +28,27 @@ void setStripColor(Adafruit_NeoPixel &strip, colorInstruction &inst) {
 }
 
 void setStripColor(Adafruit_NeoMatrix &matrix, uint32_t c) {
-  for (int i = 0; i < matrix.numPixels(); i++) {
-    matrix.setPixelColor(i, c);
+  setStripColor((Adafruit_NeoPixel&) matrix, c);
+}
+
+void setStripColor(IndexedStrip &strip, int r, int g, int b) {
+  setStripColor(strip, strip.Color(r, g, b));
+}
+
+// the strip knows whether it's all one color; a new brightness still wants a show
+void setStripColor(IndexedStrip &strip, uint32_t c) {
+  if (strip.isSolid(c)) {
+    if (strip.changed) showScheduler.show(strip);
+    return;
   }
-  matrix.show();
+  for (int i = 0; i < strip.numPixels(); i++) {
+    strip.setPixelColor(i, c);
+  }
+  showScheduler.show(strip);
+}
+void setStripColor(IndexedStrip &strip, colorInstruction &inst) {
+  strip.setBrightness(255);
+  setStripColor(strip, strip.Color(inst.red, inst.green, inst.blue) );
 }
 
 
@@ -61,10 +87,27 @@ void colorWipe(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData) {
 // color wipes the last 8 pixels on the buttons
 void laserWipe(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData) {
   LaserWipePosition* pos = static_cast<LaserWipePosition*>(posData);
+  int next = laserWipeNext(pos, strip.numPixels() - 1);
+
+  // clear out the last color and set the next one
+  strip.setPixelColor(pos->prev, strip.Color(LED_OFF, LED_OFF, LED_OFF));
+  strip.setPixelColor(next, strip.Color(r, g, b));
+  pos->prev = next;
+}
+
+void laserWipe(IndexedStrip &strip, int r, int g, int b, void *posData) {
+  LaserWipePosition* pos = static_cast<LaserWipePosition*>(posData);
+  int next = laserWipeNext(pos, strip.numPixels() - 1);
+
+  strip.setPixelColor(pos->prev, strip.Color(LED_OFF, LED_OFF, LED_OFF));
+  strip.setPixelColor(next, strip.Color(r, g, b));
+  pos->prev = next;
+}
 
+// where the laser goes from pos->prev, on a strip ending at 'end'
+int laserWipeNext(LaserWipePosition *pos, int end) {
   // next is relative to the previous position
   int next = pos->prev;
-  int end = strip.numPixels() - 1;
   int start = end - 7;
 
   // first pixel on, direction set
@@ -86,11 +129,7 @@ void laserWipe(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData) {
   } else {
     ++next;
   }
-
-  // clear out the last color and set the next one
-  strip.setPixelColor(pos->prev, strip.Color(LED_OFF, LED_OFF, LED_OFF));
-  strip.setPixelColor(next, strip.Color(r, g, b));
-  pos->prev = next;
+  return ( next );
 }
 
 // IN PROGRESS
@@ -100,8 +139,8 @@ void laserWipeEdge(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData)
 
   // next is relative to the previous position
   int next = pos->prev;
-  int end = end + 31;
   int start = 9;
+  int end = start + 31;
 
   if (next == end) {
     next++;
@@ -121,28 +160,23 @@ void rainbowGlow(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData) {
   int* pos = (int*) posData;
   int next = (*pos);
 
+  // the wheel's 255 positions from 'next', off the table.  no % a pixel.
+  byte wheelPos = next % 255;
   for (int i = 0; i < strip.numPixels(); i++) {
-    strip.setPixelColor(i, Wheel(strip, (byte)((i + next) % 255) ) );
+    strip.setPixelColor(i, WHEEL_R(wheelPos), WHEEL_G(wheelPos), WHEEL_B(wheelPos));
+    if (++wheelPos == 255) wheelPos = 0;
   }
   //strip.show();
 
   next+=random(1,5); // increment for next pass
-  (*pos) = next;
+  (*pos) = next % 255; // only where it is on the wheel matters, and an int doesn't wrap cleanly
 }
 
 // Input a value 0 to 255 to get a color value.
 // The colours are a transition r - g - b - back to r.
+// (ColorTables.cpp has them worked out)
 uint32_t Wheel(Adafruit_NeoPixel &strip, byte WheelPos) {
-  WheelPos = 255 - WheelPos;
-  if (WheelPos < 85) {
-    return strip.Color(255 - WheelPos * 3, 0, WheelPos * 3);
-  } else if (WheelPos < 170) {
-    WheelPos -= 85;
-    return strip.Color(0, WheelPos * 3, 255 - WheelPos * 3);
-  } else {
-    WheelPos -= 170;
-    return strip.Color(WheelPos * 3, 255 - WheelPos * 3, 0);
-  }
+  return strip.Color(WHEEL_R(WheelPos), WHEEL_G(WheelPos), WHEEL_B(WheelPos));
 }
 
 // Proximity Pulse Matrix, used in Proximity Mode
@@ -203,6 +237,13 @@ void twinkleRand(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData) {
   strip.setPixelColor(random(strip.numPixels()), random(255));
 }
 
+void twinkleRand(IndexedStrip &strip, int r, int g, int b, void *posData) {
+  for (uint16_t i = 0; i < strip.numPixels(); i++) {
+    strip.setPixelColor(i, strip.Color(r, g, b));
+  }
+  strip.setPixelColor(random(strip.numPixels()), random(255));
+}
+
 /*****************************************************************************/
 // Gameplay animation
 static int gameplayMaxWidth = 13;
@@ -212,7 +253,6 @@ static int YellowMidPoint = 61;
 static int GreenMidPoint = 88;
 void gameplayMatrix(Adafruit_NeoMatrix &matrix, int r, int g, int b, void *posData) {
   matrix.setBrightness(50);
-  uint32_t ledOff = matrix.Color(LED_OFF, LED_OFF, LED_OFF);
   GameplayPosition* pos = static_cast<GameplayPosition*>(posData);
 
   //Serial << r << " " << g << " " << b << " " << pos->yellow << " " << pos->decayPos->prev << endl;
@@ -309,39 +349,65 @@ void gameplayFillFromMiddle(Adafruit_NeoMatrix &matrix, int center, int prev, ui
 
 void tronLightCycles(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData) {
   TronPosition* data = static_cast<TronPosition*>(posData);
+  // fade first: it maps what's lit, whoever drew it, for the moves to steer around
+  fadeCycles(strip, data);
   // dispatch the requests to the rim. number of cycles is proportional to the light level at each button
   if (data->addCycle)
-    addCycle(strip, data->cycles, data->x, data->y, strip.Color(r, g, b));
+    addCycle(strip, data, data->x, data->y, strip.Color(r, g, b));
   //addCycles.reset();
-  moveCycles(strip, data->cycles);
-  fadeCycles(strip);
+  moveCycles(strip, data);
+}
+
+static inline boolean isOccupied(TronPosition *data, uint16_t n) {
+  return( data->occupied[n >> 3] & (1 << (n & 7)) );
+}
+
+static inline void occupy(TronPosition *data, uint16_t n) {
+  data->occupied[n >> 3] |= 1 << (n & 7);
+}
+
+// no cycles, every slot free
+void beginCycles(TronPosition *data, TronCycles *cycles, uint8_t *occupied) {
+  data->cycles = cycles;
+  data->occupied = occupied;
+  for( byte c=0; c<MAX_CYCLES; c++ ) {
+    cycles[c].live = false;
+    data->slots[c] = c;
+  }
+  data->live = 0;
+  memset(data->occupied, 0, CYCLE_OCCUPIED_BYTES);
+  random16_set_seed(random(65536)); // the moves' rolls, off randomSeed()
 }
 
 // looks for active cycle at a pixel location
-boolean isCycle(TronCycles *cycles, int x, int y) {
-  for( int c=0; c<MAX_CYCLES; c++ ) {
-    if( cycles[c].live && cycles[c].x==x && cycles[c].y==y )
+boolean isCycle(TronPosition *data, int x, int y) {
+  for( byte k=0; k<data->live; k++ ) {
+    TronCycles &cycle = data->cycles[data->slots[k]];
+    if( (int)cycle.x==x && (int)cycle.y==y )
       return( true );
   }
   return( false );
 }
 
-void addCycle(Adafruit_NeoPixel &strip, TronCycles *cycles, uint32_t x, uint32_t y, uint32_t color) {
+void addCycle(Adafruit_NeoPixel &strip, TronPosition *data, uint32_t x, uint32_t y, uint32_t color) {
 
-  byte availableCycle=0;
-  while( cycles[availableCycle].live ) {
-    availableCycle++;
-    if( availableCycle == MAX_CYCLES ) {
-      Serial << F("addCycle error.  no available cycle slots.  Halting!") << endl;
-      while(1);
-    }
+  byte availableCycle;
+  if( data->live < MAX_CYCLES ) {
+    availableCycle = data->slots[data->live++];
+  } else {
+    // all in use: the oldest makes way.  its trail fades like any other.
+    availableCycle = data->slots[0];
+    memmove(&data->slots[0], &data->slots[1], MAX_CYCLES-1);
+    data->slots[MAX_CYCLES-1] = availableCycle;
   }
+  TronCycles *cycles = data->cycles;
 
   strip.setPixelColor(getPixelN(x,y), color);
+  occupy(data, getPixelN(x,y));
 
   // cycles don't start in exactly the same place; "thereabouts"
-  cycles[availableCycle].x = constrain((int)x + random(-5,6), 0, RIM_X);
-  cycles[availableCycle].y = constrain((int)y + random(-1,2), 0, RIM_Y);
+  cycles[availableCycle].x = constrain((int)x + random(-5,6), 0, RIM_X-1);
+  cycles[availableCycle].y = constrain((int)y + random(-1,2), 0, RIM_Y-1);
   cycles[availableCycle].color = color;
   cycles[availableCycle].live = true;
 
@@ -351,31 +417,39 @@ void addCycle(Adafruit_NeoPixel &strip, TronCycles *cycles, uint32_t x, uint32_t
 
 }
 
-// pass matrix in here
-void fadeCycles(Adafruit_NeoPixel &strip) {
-  const int fadeAmount = 255 / (CYCLE_TRAIL_LENGTH);
+// every channel down by CYCLE_FADE, saturating, straight on the strip's bytes.  the strip
+// keeps them scaled by its brightness, so the fade is scaled too (rounded up, so it fades).
+void fadeCycles(Adafruit_NeoPixel &strip, TronPosition *data) {
+  const uint8_t fade = ((uint16_t)CYCLE_FADE * strip.getBrightness() + 255) >> 8;
+  uint16_t n = min(strip.numPixels(), (uint16_t)(RIM_X*RIM_Y));
+  uint8_t *p = strip.getPixels();
 
-  for( int p=0; p<strip.numPixels(); p++ ) {
-    uint32_t c = strip.getPixelColor(p);
-
-    // assuming RGB order.
-    byte red = constrain( (int)((c << 8) >> 24) - fadeAmount, 0, 255);
-    byte green = constrain( (int)((c << 16) >> 24) - fadeAmount, 0, 255);
-    byte blue = constrain( (int)((c << 24) >> 24) - fadeAmount, 0, 255);
-
-    strip.setPixelColor(p, red, green, blue);
+  memset(data->occupied, 0, CYCLE_OCCUPIED_BYTES);
+  for( uint16_t i=0; i<n; i++, p+=3 ) {
+    p[0] = qsub8(p[0], fade);
+    p[1] = qsub8(p[1], fade);
+    p[2] = qsub8(p[2], fade);
+    if( p[0] | p[1] | p[2] ) occupy(data, i);
   }
 }
 
-void moveCycles(Adafruit_NeoPixel &strip, TronCycles *cycles) {
-  for( byte c=0; c<MAX_CYCLES; c++ ) {
-    if( cycles[c].live ) {
-      moveThisCycle(strip, cycles, c);
-     }
+void moveCycles(Adafruit_NeoPixel &strip, TronPosition *data) {
+  for( byte k=0; k<data->live; ) {
+    byte c = data->slots[k];
+    if( moveThisCycle(strip, data, c) ) {
+      k++;
+      continue;
+    }
+    // smashed: its slot goes to the free ones
+    memmove(&data->slots[k], &data->slots[k+1], data->live-k-1);
+    data->slots[--data->live] = c;
   }
 }
 
-void moveThisCycle(Adafruit_NeoPixel &strip, TronCycles *cycles, byte c) {
+// false if it smashed
+boolean moveThisCycle(Adafruit_NeoPixel &strip, TronPosition *data, byte c) {
+  TronCycles *cycles = data->cycles;
+
   int cw = (int)cycles[c].x+1;
   if( cw<0 ) cw = RIM_X-1;
   else if ( cw >= RIM_X) cw = 0;
@@ -385,57 +459,60 @@ void moveThisCycle(Adafruit_NeoPixel &strip, TronCycles *cycles, byte c) {
   else if ( ccw >= RIM_X) ccw = 0;
 
   uint32_t moveX[4] = {
-    cw, // CW. wrap.
-    ccw, // CCW. wrap
+    (uint32_t)cw, // CW. wrap.
+    (uint32_t)ccw, // CCW. wrap
     cycles[c].x, // DOWN
     cycles[c].x, // UP
   };
   uint32_t moveY[4] = {
     cycles[c].y, // CW
     cycles[c].y, // CCW
-    constrain(((int)cycles[c].y-1), 0, RIM_Y-1), // DOWN.  no wrap.
-    constrain(((int)cycles[c].y+1), 0, RIM_Y-1), // UP. no wrap.
+    (uint32_t)constrain(((int)cycles[c].y-1), 0, RIM_Y-1), // DOWN.  no wrap.
+    (uint32_t)constrain(((int)cycles[c].y+1), 0, RIM_Y-1), // UP. no wrap.
   };
 
   // drivin' and cryin'
 
-  // preference for moves
+  // preference for moves.  random8(), not random(): every live cycle rolls every frame, and
+  // random()'s 32-bit math is most of the frame with them all out.
   byte movePref[4];
-  byte r = random(0,100);
+  byte r = random8(100);
   // add some randomness to there's "jogs" in the paths.
   if( cycles[c].y == ALL_Y && r >= CYCLE_DICK_MOVE_PERCENT ) {
     // if we're in the center, try CW/CCW frist
     movePref[0]=cycles[c].movePref; // either CW or CCW.
     movePref[1]= movePref[0]==0 ? 1 : 0;
     // and only move UP or DOWN if we have to
-    movePref[2]=random(2,4); // either UP or DOWN.
+    movePref[2]=random8(2,4); // either UP or DOWN.
     movePref[3]= movePref[2]==2 ? 3 : 2;
   } else {
     // try to move UP or DOWN
-    movePref[0]=random(2,4); // either UP or DOWN.
+    movePref[0]=random8(2,4); // either UP or DOWN.
     movePref[1]= movePref[0]==2 ? 3 : 2;
     // and only move CW/CCW if we have to
     movePref[2]=cycles[c].movePref; // either CW or CCW.
     movePref[3]= movePref[2]==0 ? 1 : 0;
   }
 
-  const uint32_t Dead = strip.Color(LED_OFF, LED_OFF, LED_OFF);
   const uint32_t White = strip.Color(RED_MAX, GRN_MAX, BLU_MAX);
   // try some moves
   for( byte m=0; m<4; m++ ) {
-    if( strip.getPixelColor(getPixelN(moveX[movePref[m]], moveY[movePref[m]])) == Dead ) {
+    uint32_t n = getPixelN(moveX[movePref[m]], moveY[movePref[m]]);
+    if( !isOccupied(data, n) ) {
       // good.
       cycles[c].x = moveX[movePref[m]];
       cycles[c].y = moveY[movePref[m]];
 
-      strip.setPixelColor(getPixelN(cycles[c].x,cycles[c].y), cycles[c].color);
+      strip.setPixelColor(n, cycles[c].color);
+      occupy(data, n);
 
-      return;
+      return( true );
     }
   }
   // uh oh. smash!
   cycles[c].live = false;
   strip.setPixelColor(getPixelN(cycles[c].x,cycles[c].y), White);
+  return( false );
 }
 
 // returns the i-th pixel mapped to x,y
@@ -5,6 +5,7 @@
 #include <Adafruit_NeoPixel.h>
 #include <Adafruit_NeoMatrix.h>
 #include "AnimationConfig.h"
+#include "IndexedStrip.h"
 #include "Strip.h"
 #include "ConcurrentAnimator.h"
 
@@ -13,6 +14,9 @@ void setStripColor(Adafruit_NeoPixel &strip, int r, int g, int b);
 void setStripColor(Adafruit_NeoPixel &strip, uint32_t c);
 void setStripColor(Adafruit_NeoPixel &strip, colorInstruction &inst);
 void setStripColor(Adafruit_NeoMatrix &matrix, uint32_t c);
+void setStripColor(IndexedStrip &strip, int r, int g, int b);
+void setStripColor(IndexedStrip &strip, uint32_t c);
+void setStripColor(IndexedStrip &strip, colorInstruction &inst);
 void gameplayFillFromMiddle(Adafruit_NeoMatrix &matrix, int center, int prev, uint16_t color);
 
 uint32_t Wheel(Adafruit_NeoPixel &strip, byte WheelPos);
@@ -23,6 +27,9 @@ void laserWipeEdge(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData)
 void colorWipe(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData);
 void rainbowGlow(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData);
 void twinkleRand(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData);
+// and on the buttons as they are, IndexedStrips
+void laserWipe(IndexedStrip &strip, int r, int g, int b, void *posData);
+void twinkleRand(IndexedStrip &strip, int r, int g, int b, void *posData);
 
 // Animations designed or the NeoPixel Matrix wrapped around the inside of the console
 void colorWipeMatrix(Adafruit_NeoMatrix &matrix, int r, int g, int b, void *posData);
@@ -38,6 +45,7 @@ struct LaserWipePosition {
   int prev;
   int dir; // direction
 };
+int laserWipeNext(LaserWipePosition *pos, int end);
 
 struct ProxPulsePosition {
   int magnitude;
@@ -68,20 +76,29 @@ struct TronCycles {
 
 #define CYCLE_DICK_MOVE_PERCENT 15 // chance that a cycle will throw some "zigs" in it's path around the rim
 #define CYCLE_TRAIL_LENGTH BLU_X-RED_X // a light cycle leaves a trail as long as 1/4 of the rim circumference
+#define CYCLE_FADE (255 / (CYCLE_TRAIL_LENGTH)) // off every channel, every frame
 #define MAX_CYCLES 50
 struct TronPosition {
   TronCycles* cycles;
   uint32_t x,y; // location
   bool addCycle;
+
+  // slots in cycles[]: the first 'live' are live, oldest first; the rest are free
+  byte slots[MAX_CYCLES];
+  byte live;
+  // a bit per rim pixel, set if it's lit: a cycle can't go there
+  uint8_t* occupied;
 };
+#define CYCLE_OCCUPIED_BYTES ((RIM_X*RIM_Y + 7) / 8)
 
 // all state altered in these methods must be passed
 //void serialPrint();
-boolean isCycle(TronCycles *cycles, int x, int y);
-void addCycle(Adafruit_NeoPixel &strip, TronCycles *cycles, uint32_t x, uint32_t y, uint32_t color);
-void fadeCycles(Adafruit_NeoPixel &strip);
-void moveCycles(Adafruit_NeoPixel &strip, TronCycles *cycles);
-void moveThisCycle(Adafruit_NeoPixel &strip, TronCycles *cycles, byte c);
+void beginCycles(TronPosition *data, TronCycles *cycles, uint8_t *occupied);
+boolean isCycle(TronPosition *data, int x, int y);
+void addCycle(Adafruit_NeoPixel &strip, TronPosition *data, uint32_t x, uint32_t y, uint32_t color);
+void fadeCycles(Adafruit_NeoPixel &strip, TronPosition *data);
+void moveCycles(Adafruit_NeoPixel &strip, TronPosition *data);
+boolean moveThisCycle(Adafruit_NeoPixel &strip, TronPosition *data, byte c);
 uint32_t getPixelN(uint32_t x, uint32_t y);
 
 #endif
@@ -0,0 +1,89 @@
+#include "ColorTables.h"
+
+// Wheel(0) through Wheel(255)
+const uint8_t wheelTable[256][3] PROGMEM = {
+  { 255,   0,   0 }, { 252,   3,   0 }, { 249,   6,   0 }, { 246,   9,   0 },
+  { 243,  12,   0 }, { 240,  15,   0 }, { 237,  18,   0 }, { 234,  21,   0 },
+  { 231,  24,   0 }, { 228,  27,   0 }, { 225,  30,   0 }, { 222,  33,   0 },
+  { 219,  36,   0 }, { 216,  39,   0 }, { 213,  42,   0 }, { 210,  45,   0 },
+  { 207,  48,   0 }, { 204,  51,   0 }, { 201,  54,   0 }, { 198,  57,   0 },
+  { 195,  60,   0 }, { 192,  63,   0 }, { 189,  66,   0 }, { 186,  69,   0 },
+  { 183,  72,   0 }, { 180,  75,   0 }, { 177,  78,   0 }, { 174,  81,   0 },
+  { 171,  84,   0 }, { 168,  87,   0 }, { 165,  90,   0 }, { 162,  93,   0 },
+  { 159,  96,   0 }, { 156,  99,   0 }, { 153, 102,   0 }, { 150, 105,   0 },
+  { 147, 108,   0 }, { 144, 111,   0 }, { 141, 114,   0 }, { 138, 117,   0 },
+  { 135, 120,   0 }, { 132, 123,   0 }, { 129, 126,   0 }, { 126, 129,   0 },
+  { 123, 132,   0 }, { 120, 135,   0 }, { 117, 138,   0 }, { 114, 141,   0 },
+  { 111, 144,   0 }, { 108, 147,   0 }, { 105, 150,   0 }, { 102, 153,   0 },
+  {  99, 156,   0 }, {  96, 159,   0 }, {  93, 162,   0 }, {  90, 165,   0 },
+  {  87, 168,   0 }, {  84, 171,   0 }, {  81, 174,   0 }, {  78, 177,   0 },
+  {  75, 180,   0 }, {  72, 183,   0 }, {  69, 186,   0 }, {  66, 189,   0 },
+  {  63, 192,   0 }, {  60, 195,   0 }, {  57, 198,   0 }, {  54, 201,   0 },
+  {  51, 204,   0 }, {  48, 207,   0 }, {  45, 210,   0 }, {  42, 213,   0 },
+  {  39, 216,   0 }, {  36, 219,   0 }, {  33, 222,   0 }, {  30, 225,   0 },
+  {  27, 228,   0 }, {  24, 231,   0 }, {  21, 234,   0 }, {  18, 237,   0 },
+  {  15, 240,   0 }, {  12, 243,   0 }, {   9, 246,   0 }, {   6, 249,   0 },
+  {   3, 252,   0 }, {   0, 255,   0 }, {   0, 252,   3 }, {   0, 249,   6 },
+  {   0, 246,   9 }, {   0, 243,  12 }, {   0, 240,  15 }, {   0, 237,  18 },
+  {   0, 234,  21 }, {   0, 231,  24 }, {   0, 228,  27 }, {   0, 225,  30 },
+  {   0, 222,  33 }, {   0, 219,  36 }, {   0, 216,  39 }, {   0, 213,  42 },
+  {   0, 210,  45 }, {   0, 207,  48 }, {   0, 204,  51 }, {   0, 201,  54 },
+  {   0, 198,  57 }, {   0, 195,  60 }, {   0, 192,  63 }, {   0, 189,  66 },
+  {   0, 186,  69 }, {   0, 183,  72 }, {   0, 180,  75 }, {   0, 177,  78 },
+  {   0, 174,  81 }, {   0, 171,  84 }, {   0, 168,  87 }, {   0, 165,  90 },
+  {   0, 162,  93 }, {   0, 159,  96 }, {   0, 156,  99 }, {   0, 153, 102 },
+  {   0, 150, 105 }, {   0, 147, 108 }, {   0, 144, 111 }, {   0, 141, 114 },
+  {   0, 138, 117 }, {   0, 135, 120 }, {   0, 132, 123 }, {   0, 129, 126 },
+  {   0, 126, 129 }, {   0, 123, 132 }, {   0, 120, 135 }, {   0, 117, 138 },
+  {   0, 114, 141 }, {   0, 111, 144 }, {   0, 108, 147 }, {   0, 105, 150 },
+  {   0, 102, 153 }, {   0,  99, 156 }, {   0,  96, 159 }, {   0,  93, 162 },
+  {   0,  90, 165 }, {   0,  87, 168 }, {   0,  84, 171 }, {   0,  81, 174 },
+  {   0,  78, 177 }, {   0,  75, 180 }, {   0,  72, 183 }, {   0,  69, 186 },
+  {   0,  66, 189 }, {   0,  63, 192 }, {   0,  60, 195 }, {   0,  57, 198 },
+  {   0,  54, 201 }, {   0,  51, 204 }, {   0,  48, 207 }, {   0,  45, 210 },
+  {   0,  42, 213 }, {   0,  39, 216 }, {   0,  36, 219 }, {   0,  33, 222 },
+  {   0,  30, 225 }, {   0,  27, 228 }, {   0,  24, 231 }, {   0,  21, 234 },
+  {   0,  18, 237 }, {   0,  15, 240 }, {   0,  12, 243 }, {   0,   9, 246 },
+  {   0,   6, 249 }, {   0,   3, 252 }, {   0,   0, 255 }, {   3,   0, 252 },
+  {   6,   0, 249 }, {   9,   0, 246 }, {  12,   0, 243 }, {  15,   0, 240 },
+  {  18,   0, 237 }, {  21,   0, 234 }, {  24,   0, 231 }, {  27,   0, 228 },
+  {  30,   0, 225 }, {  33,   0, 222 }, {  36,   0, 219 }, {  39,   0, 216 },
+  {  42,   0, 213 }, {  45,   0, 210 }, {  48,   0, 207 }, {  51,   0, 204 },
+  {  54,   0, 201 }, {  57,   0, 198 }, {  60,   0, 195 }, {  63,   0, 192 },
+  {  66,   0, 189 }, {  69,   0, 186 }, {  72,   0, 183 }, {  75,   0, 180 },
+  {  78,   0, 177 }, {  81,   0, 174 }, {  84,   0, 171 }, {  87,   0, 168 },
+  {  90,   0, 165 }, {  93,   0, 162 }, {  96,   0, 159 }, {  99,   0, 156 },
+  { 102,   0, 153 }, { 105,   0, 150 }, { 108,   0, 147 }, { 111,   0, 144 },
+  { 114,   0, 141 }, { 117,   0, 138 }, { 120,   0, 135 }, { 123,   0, 132 },
+  { 126,   0, 129 }, { 129,   0, 126 }, { 132,   0, 123 }, { 135,   0, 120 },
+  { 138,   0, 117 }, { 141,   0, 114 }, { 144,   0, 111 }, { 147,   0, 108 },
+  { 150,   0, 105 }, { 153,   0, 102 }, { 156,   0,  99 }, { 159,   0,  96 },
+  { 162,   0,  93 }, { 165,   0,  90 }, { 168,   0,  87 }, { 171,   0,  84 },
+  { 174,   0,  81 }, { 177,   0,  78 }, { 180,   0,  75 }, { 183,   0,  72 },
+  { 186,   0,  69 }, { 189,   0,  66 }, { 192,   0,  63 }, { 195,   0,  60 },
+  { 198,   0,  57 }, { 201,   0,  54 }, { 204,   0,  51 }, { 207,   0,  48 },
+  { 210,   0,  45 }, { 213,   0,  42 }, { 216,   0,  39 }, { 219,   0,  36 },
+  { 222,   0,  33 }, { 225,   0,  30 }, { 228,   0,  27 }, { 231,   0,  24 },
+  { 234,   0,  21 }, { 237,   0,  18 }, { 240,   0,  15 }, { 243,   0,  12 },
+  { 246,   0,   9 }, { 249,   0,   6 }, { 252,   0,   3 }, { 255,   0,   0 },
+};
+
+// (int)(255 * pow(i / 255.0, GAMMA) + 0.5)
+const uint8_t gammaTable[256] PROGMEM = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    2,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,
+    5,   6,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
+   10,  10,  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,
+   17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+   25,  26,  27,  27,  28,  29,  29,  30,  31,  32,  32,  33,  34,  35,  35,  36,
+   37,  38,  39,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  50,
+   51,  52,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  66,  67,  68,
+   69,  70,  72,  73,  74,  75,  77,  78,  79,  81,  82,  83,  85,  86,  87,  89,
+   90,  92,  93,  95,  96,  98,  99, 101, 102, 104, 105, 107, 109, 110, 112, 114,
+  115, 117, 119, 120, 122, 124, 126, 127, 129, 131, 133, 135, 137, 138, 140, 142,
+  144, 146, 148, 150, 152, 154, 156, 158, 160, 162, 164, 167, 169, 171, 173, 175,
+  177, 180, 182, 184, 186, 189, 191, 193, 196, 198, 200, 203, 205, 208, 210, 213,
+  215, 218, 220, 223, 225, 228, 231, 233, 236, 239, 241, 244, 247, 249, 252, 255,
+};
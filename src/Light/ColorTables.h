@@ -0,0 +1,22 @@
+#ifndef ColorTables_h
+#define ColorTables_h
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// Tables in flash for the colors animations compute over and over.  A pgm_read_byte() is
+// an LPM, three cycles; Wheel() worked it out with branches, multiplies and a 32-bit pack.
+
+// the r, g and b of each of Wheel()'s 256 positions
+extern const uint8_t wheelTable[256][3] PROGMEM;
+
+// a perceptual curve for the bytes going to the wire: dim values come down, full ones stay
+#define GAMMA 2.8
+extern const uint8_t gammaTable[256] PROGMEM;
+
+#define WHEEL_R(pos) pgm_read_byte(&wheelTable[(pos)][0])
+#define WHEEL_G(pos) pgm_read_byte(&wheelTable[(pos)][1])
+#define WHEEL_B(pos) pgm_read_byte(&wheelTable[(pos)][2])
+#define GAMMA8(x) pgm_read_byte(&gammaTable[(x)])
+
+#endif
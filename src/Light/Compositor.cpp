@@ -0,0 +1,212 @@
+#include <FastLED.h>
+#include "Compositor.h"
+#include "ShowScheduler.h"
+#include "ColorTables.h"
+
+void Compositor::add(Adafruit_NeoPixel &strip) {
+  if (this->n >= COMPOSITE_STRIPS) return;
+
+  if (this->n == 0) this->limit_ = 255;
+  byte s = this->n++;
+  this->strips[s] = &strip;
+  for (byte l = 0; l < N_LAYERS; l++) this->layers[s][l].pixels = NULL;
+  this->changed[s] = false;
+  this->corrected[s] = false;
+  // the composite goes in as is
+  strip.setBrightness(255);
+}
+
+void Compositor::layer(Adafruit_NeoPixel &strip, byte level, Adafruit_NeoPixel &pixels,
+                       byte mode, byte brightness, byte alpha) {
+  for (byte s = 0; s < this->n; s++) {
+    if (this->strips[s] != &strip) continue;
+    if (level >= N_LAYERS || pixels.numPixels() == 0 || strip.numPixels() % pixels.numPixels()) return;
+
+    Layer &layer = this->layers[s][level];
+    layer.pixels = &pixels;
+    layer.run = strip.numPixels() / pixels.numPixels();
+    layer.mode = mode;
+    layer.brightness = brightness;
+    layer.alpha = alpha;
+    layer.lit = true;
+    this->changed[s] = true;
+    return;
+  }
+}
+
+void Compositor::gamma(Adafruit_NeoPixel &strip, boolean on) {
+  for (byte s = 0; s < this->n; s++) {
+    if (this->strips[s] != &strip || this->corrected[s] == on) continue;
+    this->corrected[s] = on;
+    this->changed[s] = true;
+  }
+}
+
+boolean Compositor::find(Adafruit_NeoPixel &pixels, byte &s, byte &l) {
+  for (s = 0; s < this->n; s++) {
+    for (l = 0; l < N_LAYERS; l++) {
+      if (this->layers[s][l].pixels == &pixels) return ( true );
+    }
+  }
+  return ( false );
+}
+
+void Compositor::brightness(Adafruit_NeoPixel &pixels, byte brightness) {
+  byte s, l;
+  if (!find(pixels, s, l) || this->layers[s][l].brightness == brightness) return;
+  this->layers[s][l].brightness = brightness;
+  this->changed[s] = true;
+}
+
+void Compositor::alpha(Adafruit_NeoPixel &pixels, byte alpha) {
+  byte s, l;
+  if (!find(pixels, s, l) || this->layers[s][l].alpha == alpha) return;
+  this->layers[s][l].alpha = alpha;
+  this->changed[s] = true;
+}
+
+boolean Compositor::drawn(Adafruit_NeoPixel &pixels) {
+  byte s, l;
+  if (!find(pixels, s, l)) return ( false );
+  this->layers[s][l].lit = true;
+  this->changed[s] = true;
+  return ( true );
+}
+
+void Compositor::clear(Adafruit_NeoPixel &pixels) {
+  byte s, l;
+  if (!find(pixels, s, l) || !this->layers[s][l].lit) return;
+  memset8(pixels.getPixels(), 0, pixels.numPixels() * 3);
+  this->layers[s][l].lit = false;
+  this->changed[s] = true;
+}
+
+boolean Compositor::has(Adafruit_NeoPixel &strip) {
+  for (byte s = 0; s < this->n; s++) {
+    if (this->strips[s] == &strip) return ( true );
+  }
+  return ( false );
+}
+
+void Compositor::limit(uint8_t limit) {
+  if (limit == this->limit_) return;
+  this->limit_ = limit;
+  for (byte s = 0; s < this->n; s++) this->changed[s] = true;
+  update();
+}
+
+uint8_t Compositor::limit() {
+  return ( this->limit_ );
+}
+
+boolean Compositor::sums(Adafruit_NeoPixel &strip, uint32_t sum[3]) {
+  for (byte s = 0; s < this->n; s++) {
+    if (this->strips[s] != &strip || !this->limited[s]) continue;
+    memcpy(sum, this->full[s], sizeof(this->full[s]));
+    return ( true );
+  }
+  return ( false );
+}
+
+void Compositor::update() {
+  for (byte s = 0; s < this->n; s++) {
+    if (!this->changed[s]) continue;
+    composite(s);
+    this->changed[s] = false;
+    this->composites++;
+    showScheduler.show(*this->strips[s]);
+  }
+}
+
+// every layer has the strip's type, so the bytes are in the same (wire) order throughout;
+// CRGB's r, g and b are just the first, second and third.
+void Compositor::composite(byte s) {
+  uint16_t pixels = this->strips[s]->numPixels();
+  CRGB *out = (CRGB *)this->strips[s]->getPixels();
+
+  // the layers with anything on them, bottom first
+  const CRGB *src[N_LAYERS];
+  uint16_t run[N_LAYERS], left[N_LAYERS];
+  byte mode[N_LAYERS], brightness[N_LAYERS], alpha[N_LAYERS];
+  byte k = 0;
+  for (byte l = 0; l < N_LAYERS; l++) {
+    Layer &layer = this->layers[s][l];
+    if (!layer.pixels || !layer.lit || layer.brightness == 0) continue;
+    if (layer.mode == BLEND_ALPHA && layer.alpha == 0) continue;
+    src[k] = (const CRGB *)layer.pixels->getPixels();
+    run[k] = left[k] = layer.run;
+    mode[k] = layer.mode;
+    brightness[k] = layer.brightness;
+    alpha[k] = layer.alpha;
+    k++;
+  }
+
+  boolean gamma = this->corrected[s];
+  // as setPixelColor() would: the same scale8()
+  uint8_t limit = this->limit_;
+  uint32_t sum[3] = { 0, 0, 0 };
+  this->limited[s] = limit != 255;
+
+  // nothing to blend (and black stays black)
+  if (k == 0) {
+    memset8(out, 0, pixels * 3);
+    memcpy(this->full[s], sum, sizeof(sum));
+    return;
+  }
+  if (k == 1 && run[0] == 1 && brightness[0] == 255 && (mode[0] != BLEND_ALPHA || alpha[0] == 255)) {
+    if (!gamma && limit == 255) {
+      memcpy8(out, src[0], pixels * 3);
+      return;
+    }
+    const uint8_t *from = (const uint8_t *)src[0];
+    uint8_t *to = (uint8_t *)out;
+    if (limit == 255) {
+      for (uint16_t b = pixels * 3; b > 0; b--) *to++ = GAMMA8(*from++);
+      return;
+    }
+    byte j = 0;
+    for (uint16_t b = pixels * 3; b > 0; b--) {
+      uint8_t v = gamma ? GAMMA8(*from++) : *from++;
+      sum[j] += v;
+      if (++j == 3) j = 0;
+      *to++ = scale8(v, limit);
+    }
+    memcpy(this->full[s], sum, sizeof(sum));
+    return;
+  }
+
+  for (uint16_t i = 0; i < pixels; i++) {
+    CRGB c(0, 0, 0);
+    for (byte j = 0; j < k; j++) {
+      CRGB p = *src[j];
+      // on to the layer's next pixel at the end of its run
+      if (--left[j] == 0) {
+        src[j]++;
+        left[j] = run[j];
+      }
+      if (!p) continue;
+      if (brightness[j] != 255) p.nscale8(brightness[j]);
+
+      switch (mode[j]) {
+        case BLEND_ADD: c += p; break;
+        case BLEND_MAX: c |= p; break;
+        case BLEND_ALPHA: nblend(c, p, alpha[j]); break;
+      }
+    }
+    if (gamma) {
+      c.r = GAMMA8(c.r);
+      c.g = GAMMA8(c.g);
+      c.b = GAMMA8(c.b);
+    }
+    if (limit != 255) {
+      sum[0] += c.r;
+      sum[1] += c.g;
+      sum[2] += c.b;
+      c.nscale8(limit);
+    }
+    out[i] = c;
+  }
+  memcpy(this->full[s], sum, sizeof(sum));
+}
+
+Compositor compositor;
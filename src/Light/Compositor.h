@@ -0,0 +1,88 @@
+#ifndef Compositor_h
+#define Compositor_h
+
+#include <Adafruit_NeoPixel.h>
+#include <Arduino.h>
+
+// Builds a strip from layers, so two animations can share it (the idle rainbow under a
+// gameplay press).  A layer is an Adafruit_NeoPixel (or NeoMatrix) the same type as its
+// strip that is never begun or shown; animations draw on it as they would on the strip.  It's
+// the strip's length, or shorter by a whole factor: then each of its pixels is a run of the
+// strip's (a pixel a row of the rim, for the idle rainbow, which paints rows).  update() blends the layers that changed into the strip, bottom first, one pass
+// over the pixels, and hands the strip to showScheduler.  Black in a layer is "nothing here".
+// A gamma curve can go on in the same pass, as the bytes are stored, and then the power
+// limiter's limit (PowerLimiter.h), from the layers each time, so a limit that comes down
+// and goes back up leaves nothing darker.  The strip's own brightness stays at full.
+
+#define COMPOSITE_STRIPS 1 // the rim
+
+enum layerLevel {
+  L_BACKGROUND = 0,
+  L_EFFECT,
+  L_OVERLAY,
+
+  N_LAYERS
+};
+
+enum blendMode {
+  BLEND_ADD = 0, // channels summed, saturating
+  BLEND_MAX, // the brighter of the two, per channel
+  BLEND_ALPHA // over what's below, by the layer's alpha
+};
+
+class Compositor {
+  public:
+    // 'strip' is drawn from layers from now on; its brightness goes on the composite
+    void add(Adafruit_NeoPixel &strip);
+    // 'pixels' goes in at 'level' of 'strip'.  nothing, if its length doesn't divide the strip's.
+    void layer(Adafruit_NeoPixel &strip, byte level, Adafruit_NeoPixel &pixels,
+               byte mode = BLEND_ADD, byte brightness = 255, byte alpha = 255);
+    // the composite through gammaTable (ColorTables.h) on its way into 'strip', or not
+    void gamma(Adafruit_NeoPixel &strip, boolean on);
+    // for a layer
+    void brightness(Adafruit_NeoPixel &pixels, byte brightness);
+    void alpha(Adafruit_NeoPixel &pixels, byte alpha);
+
+    // a layer was drawn on: composite its strip before it shows.  false if 'pixels' isn't a layer.
+    boolean drawn(Adafruit_NeoPixel &pixels);
+    // blank a layer; nothing to do if it already is
+    void clear(Adafruit_NeoPixel &pixels);
+
+    // call every loop(), before showScheduler.update()
+    void update();
+
+    // the power limit the composites go in at; when it moves, they're composited again now
+    void limit(uint8_t limit);
+    uint8_t limit();
+    // is 'strip' drawn from layers?
+    boolean has(Adafruit_NeoPixel &strip);
+    // its channel sums before the limit, in wire order, for the power limiter: the bytes under
+    // a limit have lost what scale8() dropped.  false if it went in at full; the bytes say.
+    boolean sums(Adafruit_NeoPixel &strip, uint32_t sum[3]);
+
+    unsigned long composites;
+
+  private:
+    boolean find(Adafruit_NeoPixel &pixels, byte &s, byte &l);
+    void composite(byte s);
+
+    struct Layer {
+      Adafruit_NeoPixel *pixels;
+      uint16_t run; // strip pixels a layer pixel covers
+      byte mode, brightness, alpha;
+      boolean lit; // drawn on since it was cleared
+    };
+
+    Adafruit_NeoPixel *strips[COMPOSITE_STRIPS];
+    Layer layers[COMPOSITE_STRIPS][N_LAYERS];
+    boolean changed[COMPOSITE_STRIPS];
+    boolean corrected[COMPOSITE_STRIPS]; // gamma
+    byte n;
+    uint8_t limit_;
+    uint32_t full[COMPOSITE_STRIPS][3]; // sums at full, of the last composite under a limit
+    boolean limited[COMPOSITE_STRIPS];
+};
+
+extern Compositor compositor;
+
+#endif
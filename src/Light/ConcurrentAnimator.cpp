@@ -18,7 +18,8 @@ void ConcurrentAnimator::push(AnimationConfig &config) {
   if (!config.timer.check()) {
       return;
   }
-  config.strip->show();
+  if (config.indexed) showScheduler.show(*config.indexed);
+  else showScheduler.show(*config.strip);
   config.ready = true;
   config.timer.reset();
 }
@@ -39,3 +40,18 @@ void ConcurrentAnimator::calculateAnimation(AnimateMatrixFunc animate, Animation
     config.ready = false;
 }
 
+// IndexedStrip
+
+void ConcurrentAnimator::animate(AnimateIndexedFunc animate, AnimationConfig &config) {
+  calculateAnimation(animate, config);
+  push(config);
+}
+
+void ConcurrentAnimator::calculateAnimation(AnimateIndexedFunc animate, AnimationConfig &config) {
+  if (!config.ready) {
+    return;
+  }
+  (*animate)((*config.indexed),
+      config.color.red, config.color.green, config.color.blue, config.position);
+  config.ready = false;
+}
@@ -8,6 +8,8 @@
 #include <Streaming.h>
 #include <Arduino.h>
 #include "AnimationConfig.h"
+#include "IndexedStrip.h"
+#include "ShowScheduler.h"
 
 class ConcurrentAnimator {
   public:
@@ -19,6 +21,10 @@ class ConcurrentAnimator {
     void animate(AnimateMatrixFunc animate, AnimationConfig &config);
     void calculateAnimation(AnimateMatrixFunc animate, AnimationConfig &config);
 
+    // IndexedStrip
+    void animate(AnimateIndexedFunc animate, AnimationConfig &config);
+    void calculateAnimation(AnimateIndexedFunc animate, AnimationConfig &config);
+
     void push(AnimationConfig &config);
 };
 
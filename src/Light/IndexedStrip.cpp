@@ -0,0 +1,199 @@
+#include "IndexedStrip.h"
+
+IndexedStrip::IndexedStrip(uint16_t n, uint8_t p, IndexedWire &wire, uint8_t bits) :
+  numLEDs(n), pin(p), bits(bits), brightness(255), limit(255), wire(&wire) {
+  this->indices = (uint8_t *)malloc((n * bits + 7) / 8);
+  clear();
+}
+
+void IndexedStrip::begin() {
+  pinMode(this->pin, OUTPUT);
+  digitalWrite(this->pin, LOW);
+}
+
+void IndexedStrip::show() {
+  if (!this->indices) return;
+  Adafruit_NeoPixel &out = this->wire->pixels;
+
+  if (this->wire->pin != this->pin) {
+    uint8_t was = this->wire->pin;
+    out.setPin(this->pin);
+    // setPin() lets go of the last one, and a data line left floating picks up noise
+    pinMode(was, OUTPUT);
+    digitalWrite(was, LOW);
+    this->wire->pin = this->pin;
+  }
+
+  uint8_t level = this->limit == 255 ? this->brightness : scale8(this->brightness, this->limit);
+  if (this->bits == INDEX_4BIT) {
+    // the colors in use at this brightness, once, then a lookup a pixel
+    CRGB shown[16];
+    for (byte e = 0; e < this->used; e++) {
+      shown[e] = ColorFromPalette(this->palette, e << 4, level, NOBLEND);
+    }
+    for (uint16_t i = 0; i < this->numLEDs; i++) {
+      const CRGB &c = shown[getIndex(i)];
+      out.setPixelColor(i, c.r, c.g, c.b);
+    }
+  } else {
+    for (uint16_t i = 0; i < this->numLEDs; i++) {
+      CRGB c = ColorFromPalette(this->palette, this->indices[i], level);
+      out.setPixelColor(i, c.r, c.g, c.b);
+    }
+  }
+
+  out.show();
+  this->changed = false;
+}
+
+void IndexedStrip::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+  if (n >= this->numLEDs) return;
+  uint8_t e = entry(CRGB(r, g, b), n);
+  setIndex(n, this->bits == INDEX_4BIT ? e : e << 4);
+}
+
+void IndexedStrip::setPixelColor(uint16_t n, uint32_t c) {
+  setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+uint32_t IndexedStrip::getPixelColor(uint16_t n) const {
+  if (n >= this->numLEDs) return ( 0 );
+  uint8_t index = getIndex(n);
+  CRGB c = ColorFromPalette(this->palette, this->bits == INDEX_4BIT ? index << 4 : index);
+  return ( Color(c.r, c.g, c.b) );
+}
+
+void IndexedStrip::setBrightness(uint8_t b) {
+  if (b == this->brightness) return;
+  this->brightness = b;
+  this->changed = true;
+}
+
+uint8_t IndexedStrip::getBrightness() const {
+  return ( this->brightness );
+}
+
+void IndexedStrip::setLimit(uint8_t limit) {
+  if (limit == this->limit) return;
+  this->limit = limit;
+  this->changed = true;
+}
+
+void IndexedStrip::clear() {
+  if (this->indices) memset(this->indices, 0, (this->numLEDs * this->bits + 7) / 8);
+  this->palette[0] = CRGB(0, 0, 0);
+  this->used = 1;
+  this->changed = true;
+}
+
+uint16_t IndexedStrip::numPixels() const {
+  return ( this->numLEDs );
+}
+
+uint32_t IndexedStrip::Color(uint8_t r, uint8_t g, uint8_t b) {
+  return ( ((uint32_t)r << 16) | ((uint32_t)g << 8) | b );
+}
+
+void IndexedStrip::setPalette(const CRGBPalette16 &palette) {
+  this->palette = palette;
+  this->used = 16;
+  this->changed = true;
+}
+
+void IndexedStrip::setIndex(uint16_t n, uint8_t index) {
+  if (n >= this->numLEDs) return;
+  if (this->bits == INDEX_4BIT) {
+    uint8_t &pair = this->indices[n >> 1];
+    pair = n & 1 ? (pair & 0x0F) | (index << 4) : (pair & 0xF0) | (index & 0x0F);
+  } else {
+    this->indices[n] = index;
+  }
+  this->changed = true;
+}
+
+uint8_t IndexedStrip::getIndex(uint16_t n) const {
+  if (this->bits == INDEX_4BIT) {
+    uint8_t pair = this->indices[n >> 1];
+    return ( n & 1 ? pair >> 4 : pair & 0x0F );
+  }
+  return ( this->indices[n] );
+}
+
+boolean IndexedStrip::isSolid(uint32_t c) {
+  if (!this->indices) return ( false );
+  CRGB k((uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+  uint8_t index = getIndex(0);
+  if (this->bits == INDEX_8BIT && (index & 0x0F)) return ( false );
+  if (this->palette[this->bits == INDEX_4BIT ? index : index >> 4] != k) return ( false );
+
+  // a byte at a time
+  uint8_t fill = this->bits == INDEX_4BIT ? index | (index << 4) : index;
+  uint16_t whole = this->numLEDs * this->bits / 8;
+  for (uint16_t i = 0; i < whole; i++) {
+    if (this->indices[i] != fill) return ( false );
+  }
+  // and an odd pixel at the end
+  return ( whole * 8 / this->bits == this->numLEDs || getIndex(this->numLEDs - 1) == index );
+}
+
+void IndexedStrip::sum(uint32_t &r, uint32_t &g, uint32_t &b) const {
+  r = g = b = 0;
+  if (!this->indices) return;
+
+  // pixels a palette entry; for INDEX_8BIT, where the blend between two lands is close enough
+  uint16_t count[16];
+  memset(count, 0, sizeof(count));
+  for (uint16_t i = 0; i < this->numLEDs; i++) {
+    uint8_t index = getIndex(i);
+    count[this->bits == INDEX_4BIT ? index : index >> 4]++;
+  }
+  for (uint8_t e = 0; e < 16; e++) {
+    if (!count[e]) continue;
+    CRGB c = ColorFromPalette(this->palette, e << 4, this->brightness, NOBLEND);
+    r += (uint32_t)c.r * count[e];
+    g += (uint32_t)c.g * count[e];
+    b += (uint32_t)c.b * count[e];
+  }
+}
+
+// the entry 'c' has, or a free one it can have.  with all sixteen taken, one no pixel but
+// 'drawing' (which is about to change) uses is free; failing that, the nearest color.
+uint8_t IndexedStrip::entry(const CRGB &c, uint16_t drawing) {
+  for (uint8_t e = 0; e < this->used; e++) {
+    if (this->palette[e] == c) return ( e );
+  }
+  if (this->used < 16) {
+    this->palette[this->used] = c;
+    return ( this->used++ );
+  }
+
+  uint16_t inUse = 0;
+  for (uint16_t i = 0; i < this->numLEDs; i++) {
+    if (i == drawing) continue;
+    uint8_t index = getIndex(i);
+    if (this->bits == INDEX_4BIT) {
+      inUse |= 1 << index;
+    } else {
+      inUse |= 1 << (index >> 4);
+      // blended with the next
+      if (index & 0x0F) inUse |= 1 << (((index >> 4) + 1) & 0x0F);
+    }
+  }
+  for (uint8_t e = 0; e < 16; e++) {
+    if (inUse & (1 << e)) continue;
+    this->palette[e] = c;
+    return ( e );
+  }
+
+  uint8_t nearest = 0;
+  uint16_t best = 0xFFFF;
+  for (uint8_t e = 0; e < 16; e++) {
+    const CRGB &p = this->palette[e];
+    uint16_t d = abs(p.r - c.r) + abs(p.g - c.g) + abs(p.b - c.b);
+    if (d < best) {
+      best = d;
+      nearest = e;
+    }
+  }
+  return ( nearest );
+}
@@ -0,0 +1,75 @@
+#ifndef IndexedStrip_h
+#define IndexedStrip_h
+
+#include <FastLED.h>
+#include <Adafruit_NeoPixel.h>
+#include <Arduino.h>
+
+// A strip that keeps a palette index a pixel instead of three bytes of color: half a byte
+// (INDEX_4BIT, one of the sixteen colors as is) or a whole one (INDEX_8BIT,
+// ColorFromPalette()'s 256 steps around the palette, blended).  It draws like an
+// Adafruit_NeoPixel; a color drawn takes a palette entry, or shares one.  show() expands
+// the indices into a NeoPixel buffer the strips on its wire share, moves that to the
+// strip's pin and sends it.  Worth it where a strip has few colors on it at once, like the
+// buttons: the palette is 48 bytes, the indices n/2 or n, and the wire's 3n is paid once.
+
+#define INDEX_4BIT 4
+#define INDEX_8BIT 8
+
+// RAM a strip takes: its indices and its palette
+#define INDEXED_MEM(n, bits) (((n) * (bits) + 7) / 8 + 16 * 3)
+
+// what IndexedStrips show through: a NeoPixel as long as the longest of them, never begun,
+// and the pin it's on
+struct IndexedWire {
+  Adafruit_NeoPixel &pixels;
+  uint8_t pin;
+};
+
+class IndexedStrip {
+  public:
+    IndexedStrip(uint16_t n, uint8_t p, IndexedWire &wire, uint8_t bits = INDEX_4BIT);
+
+    void begin();
+    void show();
+
+    // as Adafruit_NeoPixel's.  the color is rounded to the nearest entry if all sixteen are taken.
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+    void setPixelColor(uint16_t n, uint32_t c);
+    uint32_t getPixelColor(uint16_t n) const;
+    // 255 is full; applied at show()
+    void setBrightness(uint8_t b);
+    uint8_t getBrightness() const;
+    // a second brightness, the power limiter's; applied at show() with the strip's own
+    void setLimit(uint8_t limit);
+    // every pixel black, and the palette free but for entry 0, black
+    void clear();
+    uint16_t numPixels() const;
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b);
+
+    // the palette as it is, and the indices into it; for INDEX_8BIT, a palette of one's own
+    CRGBPalette16 palette;
+    void setPalette(const CRGBPalette16 &palette);
+    void setIndex(uint16_t n, uint8_t index);
+    uint8_t getIndex(uint16_t n) const;
+
+    // every pixel is 'c'
+    boolean isSolid(uint32_t c);
+    // the colors summed over the strip, channel by channel, at the strip's own brightness
+    void sum(uint32_t &r, uint32_t &g, uint32_t &b) const;
+    // drawn on or dimmed since the last show()
+    boolean changed;
+
+  private:
+    uint8_t entry(const CRGB &c, uint16_t drawing);
+
+    const uint16_t numLEDs;
+    const uint8_t pin, bits;
+    uint8_t brightness,
+            limit,
+            used, // palette entries taken, from 0
+           *indices;
+    IndexedWire *wire;
+};
+
+#endif
@@ -12,21 +12,27 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_NeoPixel.h>
 #include <Adafruit_NeoMatrix.h>
+#include <FastLED.h> // lib8tion, for the compositor
 #include <Streaming.h>
 #include <Metro.h>
 #include <EasyTransfer.h>
 #include <Simon_Common.h>
+#include <Simon_Fade.h>
 #include "ConcurrentAnimator.h"
 #include "AnimationConfig.h"
 #include "Animations.h"
 #include "ConcurrentAnimator.h"
 #include "AnimateFunc.h"
+#include "ShowScheduler.h"
+#include "Compositor.h"
+#include "IndexedStrip.h"
+#include "PowerLimiter.h"
 
 extern Adafruit_NeoPixel rimJob;
-extern Adafruit_NeoPixel redL;
-extern Adafruit_NeoPixel grnL;
-extern Adafruit_NeoPixel bluL;
-extern Adafruit_NeoPixel yelL;
+extern IndexedStrip redL;
+extern IndexedStrip grnL;
+extern IndexedStrip bluL;
+extern IndexedStrip yelL;
 extern Adafruit_NeoPixel cirL;
 extern Adafruit_NeoPixel placL;
 extern Metro fasterStripUpdateInterval;
@@ -36,6 +42,10 @@ extern ConcurrentAnimator animator;
 extern AnimationConfig circleConfig;
 extern AnimationConfig placardConfig;
 
+// the buttons fade to what the Console sends on their own
+IndexedStrip *buttonStrips[N_COLORS] = { &redL, &grnL, &bluL, &yelL };
+ColorFade buttonFades[N_COLORS];
+
 void setup() {
   Serial.begin(115200);
   Serial1.begin(115200);
@@ -54,6 +64,7 @@ void setup() {
   digitalWrite(LED_PIN, LOW);
 
   configureAnimations();
+  for (byte i = 0; i < N_COLORS; i++) buttonFades[i].begin(cOff);
 
   Serial << F("Light: startup complete.") << endl;
 }
@@ -64,10 +75,17 @@ void loop() {
     fasterStripUpdateInterval.reset();
   }
 
+  // layers into strips, then shows, and the Console's window; before EasyTransfer, so it sees a frame start
+  compositor.update();
+  showScheduler.update();
+
   static Metro quietUpdateInterval(10UL * 1000UL); // after 10 second of not instructions, we should do something.
   static byte lastPacketNumber=255;
 
-  if (ET.receiveData() && inst.packetNumber != lastPacketNumber) {
+  boolean gotPacket = ET.receiveData();
+  if (gotPacket) showScheduler.received();
+
+  if (gotPacket && inst.packetNumber != lastPacketNumber) {
     // track and apply deltas only
     lastPacketNumber = inst.packetNumber;
 
@@ -78,14 +96,15 @@ void loop() {
     //    }
 
     // dispatch the requests to the buttons
-    setStripColor(redL, inst.light[I_RED]);
-    setStripColor(grnL, inst.light[I_GRN]);
-    setStripColor(bluL, inst.light[I_BLU]);
-    if (inst.light[I_YEL].red == 255 && inst.light[I_YEL].green == 100) {
-      // hardcode the color so that it isn't 255,100,0, which is orangy for the console, but yellow for the tower
-      setStripColor(yelL, yelL.Color(RED_MAX, GRN_MAX, LED_OFF));
-    } else {
-      setStripColor(yelL, inst.light[I_YEL]);
+    for (byte i = 0; i < N_COLORS; i++) {
+      colorInstruction c = inst.light[i];
+      if (i == I_YEL && c.red == 255 && c.green == 100) {
+        // hardcode the color so that it isn't 255,100,0, which is orangy for the console, but yellow for the tower
+        c.red = RED_MAX;
+        c.green = GRN_MAX;
+        c.blue = LED_OFF;
+      }
+      buttonFades[i].start(c, inst.fade[i], millis());
     }
 
     // toggle LED to ACK new button press
@@ -94,11 +113,20 @@ void loop() {
     digitalWrite(LED_PIN, ledStatus);
     quietUpdateInterval.reset();
   }
+
+  // and on along their fades; a step, or a packet, shows straight away
+  for (byte i = 0; i < N_COLORS; i++) {
+    if (buttonFades[i].update(millis())) setStripColor(*buttonStrips[i], buttonFades[i].color);
+  }
+
+  // what the strips draw, now and then
+  static Metro powerReport(POWER_REPORT);
+  if (powerReport.check()) powerLimiter.report();
 }
 
 int freeRam () {
   extern int __heap_start, *__brkval;
   int v;
-  return (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
+  return (int) ((char *) &v - (__brkval == 0 ? (char *) &__heap_start : (char *) __brkval));
 }
 
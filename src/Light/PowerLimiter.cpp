@@ -0,0 +1,83 @@
+#include "PowerLimiter.h"
+
+void PowerLimiter::begin(uint16_t maxmA) {
+  this->maxmA = maxmA;
+  this->limit_ = 255;
+  this->peak = 0;
+  this->frames = this->limited = 0;
+  for (byte i = 0; i < POWER_STRIPS; i++) this->lit[i] = this->dark[i] = 0;
+}
+
+void PowerLimiter::demand(byte i, const uint8_t *grb, uint16_t pixels, uint8_t brightness) {
+  if (i >= POWER_STRIPS) return;
+  // black doesn't say how bright it would be at full; what it was still holds
+  if (brightness == 0) return;
+
+  uint32_t g = 0, r = 0, b = 0;
+  for (uint16_t k = pixels; k > 0; k--) {
+    g += *grb++;
+    r += *grb++;
+    b += *grb++;
+  }
+  // stored as scale8() has it, (c * (brightness + 1)) >> 8
+  uint32_t full = POWER_MA(r, g, b, 0) * 256 / (brightness + 1);
+  this->lit[i] = min(full, 0xFFFFUL);
+  this->dark[i] = pixels * POWER_DARK_MA;
+}
+
+void PowerLimiter::demand(byte i, uint32_t r, uint32_t g, uint32_t b, uint16_t pixels) {
+  if (i >= POWER_STRIPS) return;
+  this->lit[i] = min(POWER_MA(r, g, b, 0), 0xFFFFUL);
+  this->dark[i] = pixels * POWER_DARK_MA;
+}
+
+boolean PowerLimiter::update() {
+  uint32_t lit = 0, fixed = POWER_MCU_MA;
+  for (byte i = 0; i < POWER_STRIPS; i++) {
+    lit += this->lit[i];
+    fixed += this->dark[i];
+  }
+
+  // as calculate_max_brightness_for_power_mW(): the share of the lit part that fits
+  uint8_t fit = 255;
+  if (lit + fixed > this->maxmA) {
+    fit = this->maxmA > fixed ? (this->maxmA - fixed) * 255UL / lit : 0;
+    fit = max(fit, POWER_MIN_LIMIT);
+  }
+
+  uint8_t was = this->limit_;
+  if (fit < this->limit_) this->limit_ = fit;
+  else this->limit_ = min((unsigned int)fit, (unsigned int)this->limit_ + POWER_RECOVER);
+
+  this->frames++;
+  if (this->limit_ < 255) this->limited++;
+  this->peak = max(this->peak, drawn());
+  return ( this->limit_ != was );
+}
+
+uint8_t PowerLimiter::limit() {
+  return ( this->limit_ );
+}
+
+uint16_t PowerLimiter::demanded() {
+  uint32_t total = POWER_MCU_MA;
+  for (byte i = 0; i < POWER_STRIPS; i++) total += this->lit[i] + this->dark[i];
+  return ( min(total, 0xFFFFUL) );
+}
+
+uint16_t PowerLimiter::drawn() {
+  uint32_t lit = 0, fixed = POWER_MCU_MA;
+  for (byte i = 0; i < POWER_STRIPS; i++) {
+    lit += this->lit[i];
+    fixed += this->dark[i];
+  }
+  return ( min(fixed + lit * this->limit_ / 255, 0xFFFFUL) );
+}
+
+void PowerLimiter::report() {
+  Serial << F("Light: power ") << drawn() << F(" mA of ") << this->maxmA << F(" (") << demanded();
+  Serial << F(" at full), limit ") << this->limit_ << F(", peak ") << this->peak << F(" mA, limited ");
+  Serial << this->limited << F(" of ") << this->frames << F(" frames.") << endl;
+}
+
+PowerLimiter powerLimiter;
@@ -0,0 +1,67 @@
+#ifndef PowerLimiter_h
+#define PowerLimiter_h
+
+#include <Arduino.h>
+#include <Streaming.h>
+
+// Keeps the strips' draw under what the supply can give.  Every frame, before the shows go
+// out, showScheduler tells it what each strip it's about to show would draw at full (from
+// the bytes, or an IndexedStrip's palette); strips not showing draw what they did.  If the
+// board's total is over POWER_MAX_MA, the limit comes down to fit at once; once it isn't, the
+// limit goes back up POWER_RECOVER a frame, so a flash doesn't pump the rest.  The limit is
+// a brightness every strip shows at, put on at output: the compositor's pass, the other
+// NeoPixels' scaling on the way out (ShowScheduler.h), and the IndexedStrips' expansion.
+//
+// The draw is FastLED's model (power_mgt.cpp): so many mA a channel at full, and a little for
+// a dark pixel, off the bytes as they'll go out.  Our strips are NEO_GRB: green goes first.
+
+#define POWER_MAX_MA 8000 // the Light's 5 V supply, less a margin.  set to what it's rated for.
+#define POWER_RECOVER 8 // limit steps back up this much a frame
+#define POWER_MIN_LIMIT 16 // never down to black: the demand is read back off the bytes
+#define POWER_STRIPS 7 // as showScheduler
+#define POWER_REPORT 10000UL // ms between lines of telemetry on Serial
+
+// power_mgt.cpp's, at 5 V
+#define POWER_RED_MA 16
+#define POWER_GREEN_MA 11
+#define POWER_BLUE_MA 15
+#define POWER_DARK_MA 1
+#define POWER_MCU_MA 25
+
+// the model: mA at full from channel sums (0-255 a pixel) over 'pixels', dark pixels and all
+#define POWER_MA(r, g, b, pixels) ((((r) * POWER_RED_MA) >> 8) + (((g) * POWER_GREEN_MA) >> 8) + \
+                                   (((b) * POWER_BLUE_MA) >> 8) + (uint32_t)(pixels) * POWER_DARK_MA)
+
+class PowerLimiter {
+  public:
+    void begin(uint16_t maxmA = POWER_MAX_MA);
+
+    // strip 'i' is about to show these NEO_GRB bytes, which went in at 'brightness'
+    void demand(byte i, const uint8_t *grb, uint16_t pixels, uint8_t brightness);
+    // or channel sums at full brightness
+    void demand(byte i, uint32_t r, uint32_t g, uint32_t b, uint16_t pixels);
+
+    // once a frame, with this frame's demands in: the limit the shows go out at.  true if it moved.
+    boolean update();
+    uint8_t limit();
+
+    // telemetry, mA: what it would all draw at full, what it draws at the limit, the most it has
+    uint16_t demanded();
+    uint16_t drawn();
+    uint16_t peak;
+    uint16_t maxmA;
+    // frames, and those with the limit on
+    unsigned long frames, limited;
+
+    // a line of the above to Serial
+    void report();
+
+  private:
+    // per strip: mA at full from the channels, and from dark pixels
+    uint16_t lit[POWER_STRIPS], dark[POWER_STRIPS];
+    uint8_t limit_;
+};
+
+extern PowerLimiter powerLimiter;
+
+#endif
@@ -0,0 +1,271 @@
+#include <FastLED.h>
+#include "ShowScheduler.h"
+
+void ShowScheduler::begin(Stream *link) {
+  this->link = link;
+  this->n = 0;
+  this->next = 0;
+  this->due = false;
+  this->framesIn = this->framesLost = 0;
+  this->frame.interval(SHOW_FRAME);
+  this->frame.reset();
+
+  // open for business
+  this->receiving = false;
+  this->waiting = 0;
+  this->open = true;
+  this->openTime = millis();
+  this->grant();
+}
+
+void ShowScheduler::grant() {
+  if (!this->link) return;
+  this->link->write(LINK_XON);
+  this->grantTime = millis();
+}
+
+void ShowScheduler::received() {
+  this->framesIn++;
+  this->receiving = false;
+  // and the Console may send another
+  if (this->open) grant();
+}
+
+void ShowScheduler::add(Adafruit_NeoPixel &strip) {
+  byte i = add();
+  if (i == SHOW_STRIPS) return;
+  this->strips_[i] = &strip;
+}
+
+void ShowScheduler::add(IndexedStrip &strip) {
+  byte i = add();
+  if (i == SHOW_STRIPS) return;
+  this->indexed_[i] = &strip;
+}
+
+byte ShowScheduler::add() {
+  if (this->n >= SHOW_STRIPS) return ( SHOW_STRIPS );
+
+  byte i = this->n++;
+  this->strips_[i] = NULL;
+  this->indexed_[i] = NULL;
+  this->dirty[i] = false;
+  this->isFilled[i] = false;
+  this->requests_[i] = this->shows_[i] = this->showMicros_[i] = 0;
+  return ( i );
+}
+
+byte ShowScheduler::find(Adafruit_NeoPixel &strip) {
+  for (byte i = 0; i < this->n; i++) {
+    if (this->strips_[i] == &strip) return ( i );
+  }
+  return ( SHOW_STRIPS );
+}
+
+byte ShowScheduler::find(IndexedStrip &strip) {
+  for (byte i = 0; i < this->n; i++) {
+    if (this->indexed_[i] == &strip) return ( i );
+  }
+  return ( SHOW_STRIPS );
+}
+
+void ShowScheduler::show(Adafruit_NeoPixel &strip) {
+  byte i = find(strip);
+  if (i == SHOW_STRIPS) {
+    // a layer: its strip shows once it's composited
+    if (compositor.drawn(strip)) return;
+    // not ours; the old way
+    strip.show();
+    return;
+  }
+  this->requests_[i]++;
+  this->dirty[i] = true;
+}
+
+void ShowScheduler::show(IndexedStrip &strip) {
+  byte i = find(strip);
+  if (i == SHOW_STRIPS) {
+    strip.show();
+    return;
+  }
+  this->requests_[i]++;
+  this->dirty[i] = true;
+}
+
+void ShowScheduler::solid(Adafruit_NeoPixel &strip, uint32_t c) {
+  show(strip);
+
+  byte i = find(strip);
+  if (i == SHOW_STRIPS) return;
+  this->isFilled[i] = true;
+  this->fillColor[i] = c;
+  this->fillBrightness[i] = strip.getBrightness();
+  memcpy(this->fillBytes[i], strip.getPixels(), 3);
+}
+
+boolean ShowScheduler::isSolid(Adafruit_NeoPixel &strip, uint32_t c) {
+  byte i = find(strip);
+  if (i == SHOW_STRIPS || !this->isFilled[i]) return ( false );
+  if (this->fillColor[i] != c || this->fillBrightness[i] != strip.getBrightness()) return ( false );
+
+  // an animation may have drawn on it since
+  const uint8_t *p = strip.getPixels(), *f = this->fillBytes[i];
+  for (uint16_t k = strip.numPixels(); k > 0; k--, p += 3) {
+    if (p[0] != f[0] || p[1] != f[1] || p[2] != f[2]) {
+      this->isFilled[i] = false;
+      return ( false );
+    }
+  }
+  this->requests_[i]++;
+  return ( true );
+}
+
+// what strip 'i' would draw at full, as it is now
+void ShowScheduler::demand(byte i) {
+  if (this->indexed_[i]) {
+    uint32_t r, g, b;
+    this->indexed_[i]->sum(r, g, b);
+    powerLimiter.demand(i, r, g, b, this->indexed_[i]->numPixels());
+  } else {
+    Adafruit_NeoPixel &strip = *this->strips_[i];
+    uint32_t sum[3];
+    // NEO_GRB: green first
+    if (compositor.sums(strip, sum)) powerLimiter.demand(i, sum[1], sum[0], sum[2], strip.numPixels());
+    else powerLimiter.demand(i, strip.getPixels(), strip.numPixels(), compositor.has(strip) ? 255 : strip.getBrightness());
+  }
+}
+
+void ShowScheduler::showNow(byte i) {
+  uint8_t limit = powerLimiter.limit();
+  unsigned long t = micros();
+  if (this->indexed_[i]) {
+    this->indexed_[i]->setLimit(limit);
+    this->indexed_[i]->show();
+  } else {
+    Adafruit_NeoPixel &strip = *this->strips_[i];
+    uint16_t bytes = strip.numPixels() * 3;
+    if (limit == 255 || compositor.has(strip) || bytes > sizeof(this->unscaled)) {
+      // composited at the limit already.  a longer strip would go out unlimited: composite it.
+      strip.show();
+    } else {
+      // scaled for the wire, and back as drawn, so the limit costs nothing that stays
+      uint8_t *p = strip.getPixels();
+      memcpy(this->unscaled, p, bytes);
+      for (uint16_t k = 0; k < bytes; k++) p[k] = scale8(p[k], limit);
+      strip.show();
+      memcpy(p, this->unscaled, bytes);
+    }
+  }
+  this->showMicros_[i] += micros() - t;
+  this->shows_[i]++;
+  this->dirty[i] = false;
+}
+
+void ShowScheduler::update() {
+  unsigned long now = millis();
+
+  if (this->link) {
+    // a frame coming in holds everything until it's in
+    int waiting = this->link->available();
+    if (waiting && (!this->receiving || waiting != this->waiting)) {
+      this->receiving = true;
+      this->receiveTime = now;
+    }
+    this->waiting = waiting;
+    if (this->receiving) {
+      if (now - this->receiveTime < LINK_FRAME_MS) return;
+      // nothing more came: it won't finish.  what's left of it is no use.
+      while (this->link->available()) this->link->read();
+      this->waiting = 0;
+      this->receiving = false;
+      this->framesLost++;
+      if (this->open) grant();
+    }
+    // the Console forgets about us if we're quiet
+    if (this->open && now - this->grantTime >= LINK_KEEPALIVE) grant();
+  }
+
+  if (!this->due) {
+    if (!this->frame.check()) return;
+    this->frame.reset();
+    for (byte i = 0; i < this->n; i++) this->due |= this->dirty[i];
+    if (!this->due) return;
+  }
+
+  if (this->link) {
+    // close the window; give the Console its due first
+    if (this->open) {
+      if (now - this->openTime < LINK_OPEN_MIN) return;
+      this->link->write(LINK_XOFF);
+      this->open = false;
+      this->closeTime = micros();
+      return;
+    }
+    // and a frame it started before it heard
+    if (micros() - this->closeTime < LINK_GRACE_US) return;
+  }
+
+  // the draw, with what's about to go out.  a new limit goes on everything lit.
+  for (byte i = 0; i < this->n; i++) {
+    if (this->dirty[i]) demand(i);
+  }
+  if (powerLimiter.update()) {
+    compositor.limit(powerLimiter.limit());
+    for (byte i = 0; i < this->n; i++) this->dirty[i] = true;
+  }
+
+  // take turns, from the strip after the last one shown
+  unsigned long spent = 0;
+  for (byte k = 0; k < this->n; k++) {
+    byte i = (this->next + k) % this->n;
+    if (!this->dirty[i]) continue;
+
+    uint16_t pixels = this->indexed_[i] ? this->indexed_[i]->numPixels() : this->strips_[i]->numPixels();
+    unsigned long cost = pixels * SHOW_PIXEL_US;
+    if (spent > 0 && spent + cost > SHOW_BUDGET) continue; // next frame
+
+    showNow(i);
+    spent += cost;
+    this->next = (i + 1) % this->n;
+  }
+  this->due = false;
+
+  if (this->link) {
+    this->open = true;
+    this->openTime = millis();
+    grant();
+  }
+}
+
+// at startup, before the Console's talking
+void ShowScheduler::flush() {
+  for (byte i = 0; i < this->n; i++) {
+    if (this->dirty[i]) demand(i);
+  }
+  if (powerLimiter.update()) compositor.limit(powerLimiter.limit());
+  for (byte i = 0; i < this->n; i++) {
+    if (this->dirty[i]) showNow(i);
+  }
+}
+
+byte ShowScheduler::strips() {
+  return ( this->n );
+}
+
+Adafruit_NeoPixel *ShowScheduler::strip(byte i) {
+  return ( this->strips_[i] );
+}
+
+unsigned long ShowScheduler::requests(byte i) {
+  return ( this->requests_[i] );
+}
+
+unsigned long ShowScheduler::shows(byte i) {
+  return ( this->shows_[i] );
+}
+
+unsigned long ShowScheduler::showMicros(byte i) {
+  return ( this->showMicros_[i] );
+}
+
+ShowScheduler showScheduler;
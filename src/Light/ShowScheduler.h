@@ -0,0 +1,99 @@
+#ifndef ShowScheduler_h
+#define ShowScheduler_h
+
+#include <Adafruit_NeoPixel.h>
+#include <Metro.h>
+#include <Arduino.h>
+#include <Simon_Link.h>
+#include "Compositor.h"
+#include "IndexedStrip.h"
+#include "PowerLimiter.h"
+
+// Decides when each strip's show() runs.  show() holds interrupts off for ~30 us a pixel
+// (9.6 ms for the rim), and Serial1 drops bytes while it does.  So instead of showing on
+// the spot, animations and setStripColor() mark a strip dirty, and update() shows the dirty
+// ones a few at a time: at most SHOW_BUDGET of wire time per frame, taking turns.
+// Around the shows, it tells the Console when to send (Simon_Link.h): XOFF, a grace time,
+// the shows, then XON.  A frame that's coming in holds the shows until it's in.  Each
+// frame's shows go out at powerLimiter's limit; when that moves, every lit strip shows again.
+// The limit goes on at output, never on what's drawn: the compositor's strips are composited
+// again at it, and the other NeoPixels are scaled on the way out through a copy, put back
+// after.  Their own setBrightness() is the animations', and stays put.
+
+#define SHOW_STRIPS 7 // rim, four buttons, circle and placard
+#define SHOW_FRAME 10UL // ms between flushes
+#define SHOW_BUDGET 4000UL // us of show() per frame; a strip longer than that goes alone
+#define SHOW_PIXEL_US 30UL // 24 bits at 800 kHz
+#define SHOW_SCALE_PIXELS 18 // the longest NeoPixel strip not composited: the circle and placard
+
+class ShowScheduler {
+  public:
+    // flow control with the Console on 'link' (NULL: none)
+    void begin(Stream *link);
+    void add(Adafruit_NeoPixel &strip);
+    void add(IndexedStrip &strip);
+
+    // instead of strip.show(): show it soon
+    void show(Adafruit_NeoPixel &strip);
+    void show(IndexedStrip &strip);
+    // setStripColor() filled the strip with 'c'
+    void solid(Adafruit_NeoPixel &strip, uint32_t c);
+    // is the strip still all 'c', as solid() left it?  then there's nothing to draw or show.
+    boolean isSolid(Adafruit_NeoPixel &strip, uint32_t c);
+
+    // call every loop(), before EasyTransfer looks at the link
+    void update();
+    // EasyTransfer took a frame
+    void received();
+    // show everything dirty, now
+    void flush();
+
+    // counters, per strip (in the order added)
+    byte strips();
+    Adafruit_NeoPixel *strip(byte i); // NULL for an IndexedStrip
+    unsigned long requests(byte i); // show() and solid() calls, and isSolid() that saved one
+    unsigned long shows(byte i); // show()s that went out
+    unsigned long showMicros(byte i); // time in them
+    // frames from the Console: taken, and started but never finished (bytes lost)
+    unsigned long framesIn, framesLost;
+
+  private:
+    byte find(Adafruit_NeoPixel &strip);
+    byte find(IndexedStrip &strip);
+    byte add();
+    void showNow(byte i);
+    void demand(byte i);
+
+    // one or the other
+    Adafruit_NeoPixel *strips_[SHOW_STRIPS];
+    IndexedStrip *indexed_[SHOW_STRIPS];
+    byte n;
+    boolean dirty[SHOW_STRIPS];
+
+    // what solid() left: the color, the brightness, and the first pixel as stored
+    boolean isFilled[SHOW_STRIPS];
+    uint32_t fillColor[SHOW_STRIPS];
+    uint8_t fillBrightness[SHOW_STRIPS];
+    uint8_t fillBytes[SHOW_STRIPS][3];
+
+    unsigned long requests_[SHOW_STRIPS], shows_[SHOW_STRIPS], showMicros_[SHOW_STRIPS];
+
+    // what a strip had on it before it was scaled to the limit for the wire
+    uint8_t unscaled[SHOW_SCALE_PIXELS * 3];
+
+    byte next; // first strip to look at next frame
+    boolean due; // a frame's worth of shows is waiting on the link
+    Metro frame;
+
+    // the link's window: open (the Console may send), or closing for the shows
+    void grant();
+    Stream *link;
+    boolean open, receiving;
+    int waiting; // bytes, when we last looked
+    unsigned long openTime, grantTime, receiveTime; // ms
+    unsigned long closeTime; // us
+};
+
+extern ShowScheduler showScheduler;
+
+#endif
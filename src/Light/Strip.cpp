@@ -16,25 +16,32 @@ systemState inst;
 //   NEO_RGB     Pixels are wired for RGB bitstream (v1 FLORA pixels, not v2)
 
 // strip around the inner rim
-Adafruit_NeoMatrix rimJob = Adafruit_NeoMatrix(
-    107, 1, 1, 3, RIM_PIN,
-    NEO_MATRIX_BOTTOM + NEO_MATRIX_LEFT +
-    NEO_MATRIX_ROWS +
-    NEO_MATRIX_PROGRESSIVE +
-    NEO_TILE_BOTTOM + NEO_TILE_LEFT +
-    NEO_TILE_ROWS +
-    NEO_TILE_PROGRESSIVE,
-    NEO_GRB + NEO_KHZ800
-    );
+#define RIM_LAYOUT \
+    NEO_MATRIX_BOTTOM + NEO_MATRIX_LEFT + \
+    NEO_MATRIX_ROWS + \
+    NEO_MATRIX_PROGRESSIVE + \
+    NEO_TILE_BOTTOM + NEO_TILE_LEFT + \
+    NEO_TILE_ROWS + \
+    NEO_TILE_PROGRESSIVE
+Adafruit_NeoMatrix rimJob = Adafruit_NeoMatrix(107, 1, 1, 3, RIM_PIN, RIM_LAYOUT, NEO_GRB + NEO_KHZ800);
+
+// and its layers, never shown.  the effect has the rim's geometry, so matrix animations draw on it
+// as on the rim.  the background is the idle rainbow, a color a row: a pixel a row, the compositor
+// runs it along the rim's (Compositor.h), for 9 bytes, not 963.
+Adafruit_NeoMatrix rimBack = Adafruit_NeoMatrix(1, 1, 1, RIM_Y, RIM_PIN, RIM_LAYOUT, NEO_GRB + NEO_KHZ800);
+Adafruit_NeoMatrix rimEffect = Adafruit_NeoMatrix(107, 1, 1, 3, RIM_PIN, RIM_LAYOUT, NEO_GRB + NEO_KHZ800);
 
 // I don't know if this is valid; RIM_PIN is already assigned for the actual matrix above
 //Adafruit_NeoPixel rimJobStrip = Adafruit_NeoPixel(RIM_X*RIM_Y, RIM_PIN, NEO_GRB + NEO_KHZ800);
 
-// strips around the buttons
-Adafruit_NeoPixel redL = Adafruit_NeoPixel(BUTTON_N, RED_PIN, NEO_GRB + NEO_KHZ800);
-Adafruit_NeoPixel grnL = Adafruit_NeoPixel(BUTTON_N, GRN_PIN, NEO_GRB + NEO_KHZ800);
-Adafruit_NeoPixel bluL = Adafruit_NeoPixel(BUTTON_N, BLU_PIN, NEO_GRB + NEO_KHZ800);
-Adafruit_NeoPixel yelL = Adafruit_NeoPixel(BUTTON_N, YEL_PIN, NEO_GRB + NEO_KHZ800);
+// strips around the buttons.  a few colors at a time on each, so they keep palette indices,
+// and share one strip's worth of pixels to show through.
+Adafruit_NeoPixel buttonPixels = Adafruit_NeoPixel(BUTTON_N, RED_PIN, NEO_GRB + NEO_KHZ800);
+IndexedWire buttonWire = { buttonPixels, RED_PIN };
+IndexedStrip redL = IndexedStrip(BUTTON_N, RED_PIN, buttonWire, INDEX_4BIT);
+IndexedStrip grnL = IndexedStrip(BUTTON_N, GRN_PIN, buttonWire, INDEX_4BIT);
+IndexedStrip bluL = IndexedStrip(BUTTON_N, BLU_PIN, buttonWire, INDEX_4BIT);
+IndexedStrip yelL = IndexedStrip(BUTTON_N, YEL_PIN, buttonWire, INDEX_4BIT);
 
 // strip around the middle chotskies
 Adafruit_NeoPixel cirL = Adafruit_NeoPixel(CIRCLE_N, CIRCLE_PIN, NEO_GRB + NEO_KHZ800);
@@ -60,6 +67,7 @@ Metro fasterStripUpdateInterval(STRIP_UPDATE);
 // Animations
 ConcurrentAnimator animator;
 AnimationConfig rimConfig;
+AnimationConfig rimBackConfig;
 AnimationConfig redButtonConfig;
 AnimationConfig greenButtonConfig;
 AnimationConfig blueButtonConfig;
@@ -86,6 +94,7 @@ ProxPulsePosition proxPulsePos;
 ProxPulsePosition idlePos;
 GameplayPosition gameplayPos;
 TronCycles tronCycles[MAX_CYCLES];
+uint8_t tronOccupied[CYCLE_OCCUPIED_BYTES];
 TronPosition tronPosition;
 
 void configureAnimations() {
@@ -110,20 +119,34 @@ void configureAnimations() {
   // Neopixel strips
   rimJob.begin();
 
+  // the rim's animations draw on its layers: idle underneath, the rest on top
+  compositor.add(rimJob);
+  compositor.layer(rimJob, L_BACKGROUND, rimBack);
+  compositor.layer(rimJob, L_EFFECT, rimEffect, BLEND_ADD);
+  compositor.gamma(rimJob, RIM_GAMMA);
+
   rimConfig.name = "Outer rim";
-  rimConfig.matrix = &rimJob;
-  rimConfig.strip = &rimJob;
+  rimConfig.matrix = &rimEffect;
+  rimConfig.strip = &rimEffect;
   rimConfig.color = blue;
   rimConfig.ready = true;
   rimConfig.position = &proxPulsePos;
   rimConfig.timer = Metro(30UL);
 
+  rimBackConfig.name = "Outer rim - background";
+  rimBackConfig.matrix = &rimBack;
+  rimBackConfig.strip = &rimBack;
+  rimBackConfig.color = blue;
+  rimBackConfig.ready = true;
+  rimBackConfig.position = &idlePos;
+  rimBackConfig.timer = Metro(50UL);
+
   // Rim as a strip - TronCycles
   rimConfigStrip.name = "Outer rim - strip";
-  rimConfigStrip.strip = &rimJob;
+  rimConfigStrip.strip = &rimEffect;
   rimConfigStrip.color = blue;
   rimConfigStrip.ready = true;
-  tronPosition.cycles = tronCycles;
+  beginCycles(&tronPosition, tronCycles, tronOccupied);
   rimConfigStrip.position = &tronPosition;
   rimConfigStrip.timer = Metro(30UL);
 
@@ -136,9 +159,20 @@ void configureAnimations() {
   cirL.begin();
   placL.begin();
 
+  // shows go out a few strips a frame, and not over a packet from the Console, under the supply's cap
+  powerLimiter.begin();
+  showScheduler.begin(&Serial1);
+  showScheduler.add(rimJob);
+  showScheduler.add(redL);
+  showScheduler.add(grnL);
+  showScheduler.add(bluL);
+  showScheduler.add(yelL);
+  showScheduler.add(cirL);
+  showScheduler.add(placL);
+
   // Red Button
   redButtonConfig.name = "red button";
-  redButtonConfig.strip = &redL;
+  redButtonConfig.indexed = &redL;
   redButtonConfig.color = red;
   redButtonConfig.ready = true;
   redButtonConfig.position = &redLaserPos;
@@ -147,21 +181,21 @@ void configureAnimations() {
   // Green button
   memcpy(&greenButtonConfig, &redButtonConfig, sizeof(AnimationConfig));
   greenButtonConfig.name = "green button";
-  greenButtonConfig.strip = &grnL;
+  greenButtonConfig.indexed = &grnL;
   greenButtonConfig.color = green;
   greenButtonConfig.position = &greenLaserPos;
 
   // Blue button
   memcpy(&blueButtonConfig, &redButtonConfig, sizeof(AnimationConfig));
   blueButtonConfig.name = "blue button";
-  blueButtonConfig.strip = &bluL;
+  blueButtonConfig.indexed = &bluL;
   blueButtonConfig.color = blue;
   blueButtonConfig.position = &blueLaserPos;
 
   // Yellow button
   memcpy(&yellowButtonConfig, &redButtonConfig, sizeof(AnimationConfig));
   yellowButtonConfig.name = "yellow button";
-  yellowButtonConfig.strip = &yelL;
+  yellowButtonConfig.indexed = &yelL;
   yellowButtonConfig.color = yellow;
   yellowButtonConfig.position = &yellowLaserPos;
 
@@ -182,121 +216,207 @@ void configureAnimations() {
   placardConfig.timer = Metro(1000);
 
   clearAllStrips();
+  compositor.update();
+  showScheduler.flush();
 }
 
-void mapToAnimation(ConcurrentAnimator animator, systemState state) {
+/*****************************************************************************/
+// What each animationInstruction does, looked up by number.
 
-  if (state.animation == A_None) {
-    Serial << "NONE" << endl;
-  }
+static void enterNone() {
+  Serial << "NONE" << endl;
+}
 
-  if (state.animation == A_Clear) {
-    Serial << "CLEAR" << endl;
-    clearAllStrips();
-  }
+static void enterClear() {
+  Serial << "CLEAR" << endl;
+}
 
-  if (state.animation == A_LaserWipe) {
-    animator.animate(laserWipe, redButtonConfig);
-    animator.animate(laserWipe, greenButtonConfig);
-    animator.animate(laserWipe, blueButtonConfig);
-    animator.animate(laserWipe, yellowButtonConfig);
-  }
+// and keep it that way
+static void clearInputs(systemState &state) {
+  clearAllStrips();
+}
 
-  if (state.animation == A_Idle) {
-    rimConfig.position = &idlePos;
-    animator.animate(twinkleRand, redButtonConfig);
-    animator.animate(twinkleRand, greenButtonConfig);
-    animator.animate(twinkleRand, blueButtonConfig);
-    animator.animate(twinkleRand, yellowButtonConfig);
-    rimConfig.timer.interval(50UL);
-    animator.animate(idleMatrix, rimConfig);
-    animator.animate(rainbowGlow, placardConfig);
-    animator.animate(rainbowGlow, circleConfig);
-  }
+static void enterLaserWipe() {
+  memset(&redLaserPos, 0, sizeof(LaserWipePosition));
+  memset(&greenLaserPos, 0, sizeof(LaserWipePosition));
+  memset(&blueLaserPos, 0, sizeof(LaserWipePosition));
+  memset(&yellowLaserPos, 0, sizeof(LaserWipePosition));
+}
 
-  if (state.animation == A_ColorWipe) {
-    animator.animate(colorWipe, placardConfig);
-    animator.animate(colorWipe, circleConfig);
-  }
+static void enterIdle() {
+  rimLayers(true, false);
+  compositor.brightness(rimBack, 255);
+  memset(&idlePos, 0, sizeof(ProxPulsePosition));
+  placPos = 0;
+  circPos = 0;
+}
 
-  if (state.animation == A_ProximityPulseMatrix) {
-    rimConfig.position = &proxPulsePos;
-    rimConfig.color.red = state.light[0].red;
-    rimConfig.color.green = state.light[1].green;
-    rimConfig.color.blue = state.light[2].blue;
-    proxPulsePos.magnitude = state.light[3].red;
-    rimConfig.timer.interval(proxPulsePos.magnitude);
-
-    animator.animate(proximityPulseMatrix, rimConfig);
-    RgbColor inverse;
-    inverse.red = rimConfig.color.green;
-    inverse.green = rimConfig.color.blue;
-    inverse.blue = rimConfig.color.red;
-
-    circleConfig.color = inverse;
-    placardConfig.color = inverse;
-    animator.animate(colorWipe, placardConfig);
-    animator.animate(colorWipe, circleConfig);
-  }
+static void enterColorWipe() {
+  placPos = 0;
+  circPos = 0;
+}
+
+static void enterProximity() {
+  rimLayers(false, true);
+  rimConfig.position = &proxPulsePos;
+  memset(&proxPulsePos, 0, sizeof(ProxPulsePosition));
+  placPos = 0;
+  circPos = 0;
+}
 
-  if (state.animation == A_Gameplay) {
-    redL.setBrightness(40);
-    grnL.setBrightness(40);
-    bluL.setBrightness(40);
-    yelL.setBrightness(40);
+static void proximityInputs(systemState &state) {
+  rimConfig.color.red = state.light[0].red;
+  rimConfig.color.green = state.light[1].green;
+  rimConfig.color.blue = state.light[2].blue;
+  proxPulsePos.magnitude = state.light[3].red;
+  rimConfig.timer.interval(proxPulsePos.magnitude);
 
-    setStripColor(redL, BTN_COLOR_RED);
-    setStripColor(grnL, BTN_COLOR_GREEN);
-    setStripColor(bluL, BTN_COLOR_BLUE);
-    setStripColor(yelL, BTN_COLOR_YELLOW);
-  }
+  RgbColor inverse;
+  inverse.red = rimConfig.color.green;
+  inverse.green = rimConfig.color.blue;
+  inverse.blue = rimConfig.color.red;
 
-  if (state.animation == A_GameplayPressed) {
-    rimConfig.position = &gameplayPos;
-    rimConfig.timer.interval(20UL);
-    rimConfig.color.red = state.light[0].red;
-    rimConfig.color.green = state.light[1].green;
-    rimConfig.color.blue = state.light[2].blue;
-    gameplayPos.yellow = state.light[3].red;
+  circleConfig.color = inverse;
+  placardConfig.color = inverse;
+}
 
-    animator.animate(gameplayMatrix, rimConfig);
-  }
+static void gameplayInputs(systemState &state) {
+  redL.setBrightness(40);
+  grnL.setBrightness(40);
+  bluL.setBrightness(40);
+  yelL.setBrightness(40);
+
+  setStripColor(redL, BTN_COLOR_RED);
+  setStripColor(grnL, BTN_COLOR_GREEN);
+  setStripColor(bluL, BTN_COLOR_BLUE);
+  setStripColor(yelL, BTN_COLOR_YELLOW);
+}
+
+// the presses over a dimmed idle, which carries on from where it was
+static void enterGameplayPressed() {
+  rimLayers(true, true);
+  compositor.brightness(rimBack, IDLE_UNDER_PRESS);
+  rimConfig.position = &gameplayPos;
+  rimConfig.timer.interval(20UL);
+  memset(&gameplayPos, 0, sizeof(GameplayPosition));
+}
+
+static void gameplayPressedInputs(systemState &state) {
+  rimConfig.color.red = state.light[0].red;
+  rimConfig.color.green = state.light[1].green;
+  rimConfig.color.blue = state.light[2].blue;
+  gameplayPos.yellow = state.light[3].red;
+}
 
-  if (state.animation == A_TronCycles) {
+static void enterNoRim() {
+  rimLayers(false, false);
+}
 
-    tronPosition.addCycle = false;
-    animator.animate(tronLightCycles, rimConfigStrip);
+static void enterTron() {
+  rimLayers(false, true);
+  beginCycles(&tronPosition, tronCycles, tronOccupied);
+}
 
-    tronPosition.y = ALL_Y;
+// a cycle sets off from a lit pad, the lit ones in turn
+static void tronInputs(systemState &state) {
+  static byte nextPad = 0;
+  const uint32_t padX[N_COLORS] = { RED_X, GRN_X, BLU_X, YEL_X };
+  const RgbColor *padColor[N_COLORS] = { &red, &green, &blue, &yellow };
+  boolean lit[N_COLORS];
+  lit[I_RED] = state.light[I_RED].red >= 64;
+  lit[I_GRN] = state.light[I_GRN].green >= 64;
+  lit[I_BLU] = state.light[I_BLU].blue >= 64;
+  lit[I_YEL] = state.light[I_YEL].red > 64 && state.light[I_YEL].green > 64;
+
+  tronPosition.addCycle = false;
+  tronPosition.y = ALL_Y;
+  for (byte k = 0; k < N_COLORS; k++) {
+    byte pad = (nextPad + k) % N_COLORS;
+    if (!lit[pad]) continue;
     tronPosition.addCycle = true;
-    for (int i = 0; i < inst.light[I_RED].red / 64; i++) {
-      tronPosition.x = RED_X;
-      rimConfigStrip.color = red;
-      animator.animate(tronLightCycles, rimConfigStrip);
-    }
-    for (int i = 0; i < inst.light[I_GRN].green / 64; i++) {
-      tronPosition.x = GRN_X;
-      rimConfigStrip.color = green;
-      animator.animate(tronLightCycles, rimConfigStrip);
-    }
-    for (int i = 0; i < inst.light[I_BLU].blue / 64; i++) {
-      tronPosition.x = BLU_X;
-      rimConfigStrip.color = blue;
-      animator.animate(tronLightCycles, rimConfigStrip);
-    }
-    if(inst.light[I_YEL].red > 64 && inst.light[I_YEL].green > 64) {
-      for (int i = 0; i < (int)(inst.light[I_YEL].red+inst.light[I_YEL].green) / 128; i++ ) {
-        tronPosition.x = YEL_X;
-        rimConfigStrip.color = yellow;
-        animator.animate(tronLightCycles, rimConfigStrip);
-      }
-    }
+    tronPosition.x = padX[pad];
+    rimConfigStrip.color = *padColor[pad];
+    nextPad = (pad + 1) % N_COLORS;
+    break;
   }
+}
 
-  if (state.animation == A_NoRim) {
-    setStripColor(rimJob, LED_OFF, LED_OFF, LED_OFF);
+static const AnimationStep laserWipeSteps[] = {
+  { NULL, NULL, &redButtonConfig, laserWipe },
+  { NULL, NULL, &greenButtonConfig, laserWipe },
+  { NULL, NULL, &blueButtonConfig, laserWipe },
+  { NULL, NULL, &yellowButtonConfig, laserWipe },
+};
+
+static const AnimationStep idleSteps[] = {
+  { NULL, NULL, &redButtonConfig, twinkleRand },
+  { NULL, NULL, &greenButtonConfig, twinkleRand },
+  { NULL, NULL, &blueButtonConfig, twinkleRand },
+  { NULL, NULL, &yellowButtonConfig, twinkleRand },
+  { NULL, idleMatrix, &rimBackConfig },
+  { rainbowGlow, NULL, &placardConfig },
+  { rainbowGlow, NULL, &circleConfig },
+};
+
+static const AnimationStep colorWipeSteps[] = {
+  { colorWipe, NULL, &placardConfig },
+  { colorWipe, NULL, &circleConfig },
+};
+
+static const AnimationStep proximitySteps[] = {
+  { NULL, proximityPulseMatrix, &rimConfig },
+  { colorWipe, NULL, &placardConfig },
+  { colorWipe, NULL, &circleConfig },
+};
+
+static const AnimationStep gameplayPressedSteps[] = {
+  { NULL, idleMatrix, &rimBackConfig },
+  { NULL, gameplayMatrix, &rimConfig },
+};
+
+static const AnimationStep tronSteps[] = {
+  { tronLightCycles, NULL, &rimConfigStrip },
+};
+
+#define STEPS(s) s, sizeof(s) / sizeof(s[0])
+#define NO_STEPS NULL, 0
+
+static const AnimationMode animationModes[N_Animations] = {
+  { enterNone, NULL, NO_STEPS }, // A_None
+  { enterClear, clearInputs, NO_STEPS }, // A_Clear
+  { enterIdle, NULL, STEPS(idleSteps) }, // A_Idle
+  { NULL, gameplayInputs, NO_STEPS }, // A_Gameplay
+  { enterGameplayPressed, gameplayPressedInputs, STEPS(gameplayPressedSteps) }, // A_GameplayPressed
+  { NULL, NULL, NO_STEPS }, // A_GameplayDecay
+  { enterNoRim, NULL, NO_STEPS }, // A_NoRim
+  { enterTron, tronInputs, STEPS(tronSteps) }, // A_TronCycles
+  { NULL, NULL, NO_STEPS }, // A_TronCycles_AddCycle
+  { enterLaserWipe, NULL, STEPS(laserWipeSteps) }, // A_LaserWipe
+  { enterColorWipe, NULL, STEPS(colorWipeSteps) }, // A_ColorWipe
+  { NULL, NULL, NO_STEPS }, // A_ColorWipeMatrix
+  { enterProximity, proximityInputs, STEPS(proximitySteps) }, // A_ProximityPulseMatrix
+};
+
+void mapToAnimation(ConcurrentAnimator &animator, systemState &state) {
+  static byte current = N_Animations; // none yet
+
+  if (state.animation >= N_Animations) {
+    return;
   }
+  const AnimationMode &mode = animationModes[state.animation];
 
+  if (state.animation != current) {
+    current = state.animation;
+    if (mode.enter) mode.enter();
+  }
+  if (mode.inputs) mode.inputs(state);
+
+  for (byte i = 0; i < mode.nSteps; i++) {
+    const AnimationStep &step = mode.steps[i];
+    if (step.animateIndexed) animator.animate(step.animateIndexed, *step.config);
+    else if (step.animateMatrix) animator.animate(step.animateMatrix, *step.config);
+    else animator.animate(step.animate, *step.config);
+  }
 }
 
 void clearAllStrips() {
@@ -307,6 +427,12 @@ void clearAllStrips() {
   setStripColor(yelL, LED_OFF, LED_OFF, LED_OFF);
   setStripColor(placL, LED_OFF, LED_OFF, LED_OFF);
   setStripColor(cirL, LED_OFF, LED_OFF, LED_OFF);
-  setStripColor(rimJob, LED_OFF, LED_OFF, LED_OFF);
+  rimLayers(false, false);
+}
+
+// blank the rim's layers a mode doesn't draw on, so what the last mode left doesn't stay
+void rimLayers(boolean background, boolean effect) {
+  if (!background) compositor.clear(rimBack);
+  if (!effect) compositor.clear(rimEffect);
 }
 
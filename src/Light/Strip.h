@@ -10,8 +10,14 @@
 #include <Simon_Common.h> // common message definition
 
 #include "AnimationConfig.h"
+#include "AnimationMode.h"
 #include "Animations.h"
 #include "ConcurrentAnimator.h"
+#include "ShowScheduler.h"
+#include "Compositor.h"
+#include "IndexedStrip.h"
+#include "PowerLimiter.h"
+#include "ColorTables.h"
 #include "AnimateFunc.h"
 
 // GRN > RED
@@ -58,12 +64,23 @@
 #define STRIP_UPDATE 20UL
 #define FASTER_STIRP_UPDATE 10UL
 
-// count memory usage for LEDs, which is reported at startup.
-#define TOTAL_LED_MEM (RIM_X*RIM_Y + BUTTON_N*4 + CIRCLE_N + PLACARD_N)*3
+// the rim is composited from a background, a pixel a row, and an effect layer as long as it is
+#define RIM_LAYER_MEM ((RIM_Y + RIM_X*RIM_Y)*3)
+// the idle rainbow's layer brightness, under a gameplay press
+#define IDLE_UNDER_PRESS 64
+// the rim's composite through the gamma curve (ColorTables.h).  off: the brightnesses above,
+// and the animations' own, were set by eye without it, and it takes a quarter down to 2%.
+#define RIM_GAMMA false
+
+// count memory usage for LEDs, which is reported at startup.  the buttons: four strips of
+// indices, and the pixels they show through.
+#define TOTAL_LED_MEM ((RIM_X*RIM_Y + BUTTON_N + CIRCLE_N + PLACARD_N)*3 + RIM_LAYER_MEM + \
+                       INDEXED_MEM(BUTTON_N, INDEX_4BIT)*4)
 
 void configureAnimations();
-void mapToAnimation(ConcurrentAnimator, systemState);
+void mapToAnimation(ConcurrentAnimator&, systemState&);
 void clearAllStrips();
+void rimLayers(boolean background, boolean effect);
 
 #endif
 
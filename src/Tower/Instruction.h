@@ -12,11 +12,30 @@
 
 //------ sizes, indexing and inter-unit data structure definitions.
 #include <Simon_Common.h> 
+#include <Simon_Wire.h> // radio wire format
+#include <Simon_Sync.h> // the Console's clock
+
+// tell the Console how well we hear it this often; it sizes its resends from these.
+#define REPORT_INTERVAL 1000UL // ms
+
+// the same fire seq again inside this long is the Console retrying: ack, but don't fire.
+#define FIRE_DUPLICATE_WINDOW 2000UL // ms
+
+// packets wait here until the time they carry.  if it fills, the newest replaces the last.
+#define SCHEDULE_DEPTH 4
+
+// our light, its fade and mode from one packet, and when to show them
+typedef struct {
+  unsigned long due; // ms, our clock
+  colorInstruction light;
+  fadeInstruction fade;
+  byte mode;
+} scheduledState;
 
 class Instruction {
   public:
     void begin(nodeID node);
-    boolean update(colorInstruction &colorInst, fireInstruction &fireInst, systemMode &mode);
+    boolean update(colorInstruction &colorInst, fadeInstruction &fadeInst, fireInstruction &fireInst, systemMode &mode);
     byte getNodeID();
     
   protected:   
@@ -30,6 +49,29 @@ class Instruction {
     nodeID networkStart(nodeID node);
     
     byte lastPacketNumber;
+
+    // systemState, reassembled from keyframes and deltas
+    systemState state;
+    boolean stateValid;
+
+    // last fire command, for duplicate suppression
+    byte fireSeq;
+    boolean fireValid;
+    unsigned long fireTime;
+
+    // the Console's clock, and what's waiting for its time
+    ClockSync clock;
+    void schedule(uint16_t at);
+    scheduledState scheduled[SCHEDULE_DEPTH];
+    byte scheduledCount;
+    fireInstruction fireNext;
+    unsigned long fireDue;
+    boolean firePending;
+
+    // link report to the Console
+    void report();
+    unsigned int heardCount, missedCount;
+    unsigned long reportTime;
 };
 
 
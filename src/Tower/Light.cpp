@@ -5,6 +5,7 @@ void Light::begin(byte redPin, byte greenPin, byte bluePin) {
   
   // constructors
   this->tank = new LED(redPin, greenPin, bluePin);
+  this->fade.begin(cOff);
   // tank effect
   this->effect(Solid);
 }
@@ -14,18 +15,27 @@ void Light::effect(lightEffect_t effect, uint16_t onTime, uint16_t offTime) {
   tank->setBlink(onTime, offTime);
 }
 
-void Light::perform(colorInstruction &inst) {
+void Light::perform(colorInstruction &inst, const fadeInstruction &fade) {
+  // off it goes; without a fade, it's there already.
+  this->fade.start(inst, fade, millis());
+  if ( this->fade.update(millis()) ) this->write();
+}
+
+void Light::write() {
   // copy out the colors
   static RGB rgb; // could take advantage of the aligned memory structure and memcpy, but...
-  rgb.red = inst.red;
-  rgb.green = inst.green;
-  rgb.blue = inst.blue;
+  rgb.red = this->fade.color.red;
+  rgb.green = this->fade.color.green;
+  rgb.blue = this->fade.color.blue;
   
   // apply
   tank->writeRGB(rgb);
 }
 
 void Light::update() {
+  // the next step of a fade; PWM, so as often as it moves
+  if ( this->fade.update(millis()) ) this->write();
+
   // run the update functions
   tank->update();
 }
@@ -11,6 +11,7 @@
 
 //------ sizes, indexing and inter-unit data structure definitions.
 #include <Simon_Common.h>
+#include <Simon_Fade.h> // fades to the Console's colors
 
 // different lighting modes available.
 enum lightEffect_t {
@@ -24,13 +25,15 @@ class Light {
 
   void begin(byte redPin, byte greenPin, byte bluePin);
   void update();
-  void perform(colorInstruction &inst);
+  void perform(colorInstruction &inst, const fadeInstruction &fade = fStep);
   void effect(lightEffect_t effect = Solid, uint16_t onTime = 1000UL, uint16_t offTime = 100UL);
 
   private:
   
-  // RGB lighting tied together on tank
+  // RGB lighting tied together on tank, and where it is in its fade
   LED *tank;
+  ColorFade fade;
+  void write();
 };
 
 #endif
@@ -7,38 +7,119 @@ void Instruction::begin(nodeID node) {
   
   this->stateIndex = this->node - TOWER1;
   this->lastPacketNumber = (byte)-1; // 255. wraps.
+  this->stateValid = false; // until the first keyframe
+  this->heardCount = this->missedCount = 0;
+  this->fireValid = false;
+  this->reportTime = millis();
+  this->clock.begin();
+  this->scheduledCount = 0;
+  this->firePending = false;
   
   Serial << F("Instruction: listening to systemState index=") << this->stateIndex << endl;
 }
 
-boolean Instruction::update(colorInstruction &colorInst, fireInstruction &fireInst, systemMode &mode) { 
-  // check for comms traffic
+boolean Instruction::update(colorInstruction &colorInst, fadeInstruction &fadeInst, fireInstruction &fireInst, systemMode &mode) { 
+  boolean updated = false;
+
+  // check for comms traffic.  whatever it was, on to what's due, and the report.
   if ( radio.receiveDone() ) {
-    // process it.
-    if ( radio.DATALEN == sizeof(systemState) ) {
-      // save instruction
-      systemState state;
-      state = *(systemState*)radio.DATA;
-        
-      // copy it out
-      colorInst = state.light[this->stateIndex];
-      fireInst = state.fire[this->stateIndex];
-      mode = (systemMode)state.mode;
-      
-      // track
-      byte packetDelta = state.packetNumber - this->lastPacketNumber; // Wrap!
-      if( packetDelta > 1 ) {
-        Serial << F("Radio: missed packet.  Last=") << this->lastPacketNumber << F(" Current=") << state.packetNumber << endl;
+    // the Console's clock.  read it first thing: the sooner, the better the sample.
+    unsigned long console;
+    // fire comes to us alone, and wants an ack.
+    byte fireSeq;
+    fireInstruction fire;
+    uint16_t at;
+    if ( wireReadSync((const byte*)radio.DATA, radio.DATALEN, console) ) {
+      boolean wasSynced = this->clock.synced(millis());
+      this->clock.sample(console, millis());
+      if ( !wasSynced ) Serial << F("Radio: clock synced.") << endl;
+    } else if ( radio.TARGETID == this->node && wireReadFire((const byte*)radio.DATA, radio.DATALEN, fireSeq, fire, at) ) {
+      if ( radio.ACKRequested() ) {
+        byte ack[WIRE_FIRE_ACK_SIZE];
+        byte len = wireFireAck(fireSeq, ack);
+        radio.sendACK(ack, len);
+      }
+
+      // the Console didn't hear our last ack, and tried again.
+      boolean duplicate = this->fireValid && fireSeq == this->fireSeq && millis() - this->fireTime < FIRE_DUPLICATE_WINDOW;
+      this->fireSeq = fireSeq;
+      this->fireValid = true;
+      this->fireTime = millis();
+      if ( duplicate ) {
+        Serial << F("Radio: duplicate fire seq=") << fireSeq << endl;
       } else {
-        Serial << F(".");
+        // fire when the Console said; the other Towers will too.  out below, when it's due.
+        this->fireNext = fire;
+        this->fireDue = this->clock.due(at, millis());
+        this->firePending = true;
+      }
+    } else {
+      // count everything the Console sent that we heard, resends too.
+      byte packetNumber;
+      if ( wirePacketNumber((const byte*)radio.DATA, radio.DATALEN, packetNumber) ) this->heardCount++;
+      boolean wasValid = this->stateValid;
+
+      // process it.
+      if ( wireApply((const byte*)radio.DATA, radio.DATALEN, this->state, this->stateValid) ) {
+        // track
+        byte packetDelta = this->state.packetNumber - this->lastPacketNumber; // Wrap!
+        if( packetDelta > 1 ) {
+          if( wasValid ) this->missedCount += packetDelta - 1;
+          Serial << F("Radio: missed packet.  Last=") << this->lastPacketNumber << F(" Current=") << this->state.packetNumber << endl;
+        } else if ( packetDelta == 1 ) {
+          Serial << F(".");
+        }
+        this->lastPacketNumber = this->state.packetNumber;
+
+        // a new packet waits for its time; resends of it change nothing.
+        if ( packetDelta != 0 && wireExecuteAt((const byte*)radio.DATA, radio.DATALEN, at) ) this->schedule(at);
+
+        updated = true;
+      } else if ( !this->stateValid ) {
+        Serial << F("Radio: waiting for keyframe.") << endl;
       }
-      this->lastPacketNumber = state.packetNumber;
-      
-      return( true );
     }
   }
+
+  // copy out whatever's due
+  if ( this->firePending && (long)(millis() - this->fireDue) >= 0 ) {
+    fireInst = this->fireNext;
+    this->firePending = false;
+    updated = true;
+  }
+  if ( this->scheduledCount > 0 && (long)(millis() - this->scheduled[0].due) >= 0 ) {
+    colorInst = this->scheduled[0].light;
+    fadeInst = this->scheduled[0].fade;
+    mode = (systemMode)this->scheduled[0].mode;
+    this->scheduledCount--;
+    memmove(&this->scheduled[0], &this->scheduled[1], this->scheduledCount * sizeof(scheduledState));
+    updated = true;
+  }
+
+  // time to tell the Console how we're doing?
+  if ( this->stateValid && millis() - this->reportTime >= REPORT_INTERVAL ) this->report();
   
-  return( false ); // no update
+  return( updated );
+}
+
+// holds our part of the state we just got until the Console's time 'at'
+void Instruction::schedule(uint16_t at) {
+  if ( this->scheduledCount == SCHEDULE_DEPTH ) this->scheduledCount--;
+
+  scheduledState &next = this->scheduled[this->scheduledCount++];
+  next.due = this->clock.due(at, millis());
+  next.light = this->state.light[this->stateIndex];
+  next.fade = this->state.fade[this->stateIndex];
+  next.mode = this->state.mode;
+}
+
+// send our link counters to the Console.  no ACK; there'll be another one along shortly.
+void Instruction::report() {
+  byte frame[WIRE_REPORT_SIZE];
+  byte len = wireReport((byte)this->node, this->heardCount, this->missedCount, frame);
+  radio.send((byte)CONSOLE, (const void*)frame, len, false);
+
+  this->reportTime = millis();
 }
 
 // starts the radio
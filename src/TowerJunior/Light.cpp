@@ -17,12 +17,14 @@ void Light::begin() {
   
   FastLED.addLeds<WS2811, PIN_FASTLED, COLOR_ORDER>(Sails, Sails.size()).setCorrection(COLOR_CORRECTION);
 
-  // set master brightness control
+  // set master brightness control; each show() comes down from it to fit the supply
   FastLED.setBrightness(255);
+  FastLED.setMaxPowerInVoltsAndMilliamps(SAIL_VOLTS, SAIL_MAX_MA);
   //  FastLED.setDither( 0 ); // can't do this with WiFi stack?
   
   FastLED.clear();
   FastLED.show();
+  this->fade.begin(cOff);
   delay(1000);
   
 }
@@ -37,17 +39,45 @@ void Light::effect(lightEffect_t effect) {
   }
 }
 
-void Light::perform(colorInstruction &inst) {
+void Light::perform(colorInstruction &inst, const fadeInstruction &fade) {
+  // off it goes; without a fade, it's there already.
+  this->fade.start(inst, fade, millis());
+  if ( this->fade.update(millis()) ) this->show();
+}
+
+void Light::show() {
   // copy out the colors
-  this->currentColor.red = inst.red;
-  this->currentColor.green = inst.green;
-  this->currentColor.blue = inst.blue;
+  this->currentColor.red = this->fade.color.red;
+  this->currentColor.green = this->fade.color.green;
+  this->currentColor.blue = this->fade.color.blue;
   // do it.
   Sails.fill_solid(this->currentColor);
   FastLED.show();
 }
 
+// what the sails want at full, and the brightness FastLED shows them at to stay under the cap
+void Light::report() {
+  uint32_t mW = calculate_unscaled_power_mW(Sails, Sails.size());
+  uint8_t brightness = calculate_max_brightness_for_power_mW(Sails, Sails.size(), FastLED.getBrightness(),
+                       (uint32_t)SAIL_VOLTS * SAIL_MAX_MA);
+  Serial << F("Light: power ") << mW / SAIL_VOLTS * brightness / 255 << F(" mA of ") << SAIL_MAX_MA;
+  Serial << F(" (") << mW / SAIL_VOLTS << F(" at full), brightness ") << brightness << endl;
+}
+
 void Light::update() {
+  static Metro power(POWER_REPORT);
+  if ( power.check() ) this->report();
+
+  // the next step of a fade, a frame at a time.  blinking shows it on the next tick.
+  static Metro frame(FADE_FRAME);
+  if ( this->fade.fading() && frame.check() && this->fade.update(millis()) ) {
+    frame.reset();
+    if ( this->amBlinking ) {
+      this->currentColor = CRGB(this->fade.color.red, this->fade.color.green, this->fade.color.blue);
+    } else {
+      this->show();
+    }
+  }
 
   static Metro tick(this->onTime);
   static boolean amOn = false;
@@ -10,6 +10,7 @@
 
 //------ sizes, indexing and inter-unit data structure definitions.
 #include <Simon_Common.h>
+#include <Simon_Fade.h> // fades to the Console's colors
 
 #define PIN_FASTLED 3 // to LED DI.
 #define COLOR_ORDER RGB
@@ -18,6 +19,12 @@
 #define LEDS_UP 20
 #define LEDS_DOWN 20
 #define LEDS_SAIL (LEDS_UP+LEDS_DOWN)
+// a show is ~5 ms of the loop for all the sails, so fades step this often at most
+#define FADE_FRAME 20UL // ms
+// FastLED holds every show() under the supply's cap (power_mgt.cpp), and we say what it draws
+#define SAIL_VOLTS 5
+#define SAIL_MAX_MA 4000 // of the ~6.7 A the sails would draw full white.  set to the supply.
+#define POWER_REPORT 10000UL // ms between lines of telemetry on Serial
 
 // different lighting modes available.
 enum lightEffect_t {
@@ -30,12 +37,15 @@ class Light {
 
   void begin();
   void update();
-  void perform(colorInstruction &inst);
+  void perform(colorInstruction &inst, const fadeInstruction &fade = fStep);
   void effect(lightEffect_t effect = Solid);
 
   private:
 
   CRGB currentColor; // lighting
+  ColorFade fade; // where it is on the way to the Console's color
+  void show();
+  void report();
 
   boolean amBlinking = false;
   const uint16_t onTime = 1000UL;
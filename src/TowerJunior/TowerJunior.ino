@@ -83,6 +83,7 @@ void loop() {
 
   // a place to store instructions
   static colorInstruction lastColorInst, newColorInst;
+  static fadeInstruction newFadeInst; // how to get to newColorInst
   static fireInstruction lastFireInst, newFireInst;
   static systemMode lastMode, newMode;
 
@@ -93,6 +94,7 @@ void loop() {
       Serial << F("reset.") << endl;
 
       newColorInst = cRed;
+      newFadeInst = fStep;
       light.effect(Blink);
     } else {
       Serial << F("normal.") << endl;
@@ -109,7 +111,7 @@ void loop() {
   static Metro idleUpdate(IDLE_PERIOD);
 
   // check for radio traffic instructions
-  if( instruction.update(newColorInst, newFireInst, newMode) )
+  if( instruction.update(newColorInst, newFadeInst, newFireInst, newMode) )
     // reset idle
     idleUpdate.reset();
 
@@ -117,7 +119,7 @@ void loop() {
   if ( memcmp((void*)(&newColorInst), (void*)(&lastColorInst), sizeof(colorInstruction)) != 0 ) {
     Serial << F("New color instruction. R:") << newColorInst.red << F(" G:") << newColorInst.green << F(" B:") << newColorInst.blue << endl;
     // change the lights
-    light.perform(newColorInst);
+    light.perform(newColorInst, newFadeInst);
     // cache
     lastColorInst = newColorInst;   
   }
@@ -139,6 +141,7 @@ void loop() {
   // This lets us stay on the same color indefinitely for testing.
   if ( idleUpdate.check() && newMode != LIGHTS) {
     idleTestPattern(newColorInst);
+    newFadeInst = fStep;
     // and take a moment to check heap+stack remaining
     Serial << F("Tower: free RAM: ") << freeRam() << endl;
   }
@@ -0,0 +1,256 @@
+// Beat benchmark: the fanfare's cues from the beat map (Cues.h), against the beats the MSGEQ7
+// beat detector hears in the same music.
+//
+//   ./build/beatbench [-v] [-d dir] [-s seed]
+//
+// Each track in Beats.cpp is read from 'dir' (../../tones) and played into the simulated
+// MSGEQ7 on the WAV Trigger's output: seven band-passes at the chip's centres, each through a
+// peak detector, a 10-bit reading every ms.  Mic listens to it as the fanfare did: bands 0 and
+// 1 at a threshold of 1.5, sampled every loop, and a beat at most every 333 ms.  Each beat it
+// hears is matched to the map's nearest within 150 ms; how late it is, and how much that
+// varies, is the detector's timing error.  Then the map is played through Cues, with a loop
+// that takes 1-3 ms a turn.  Checks that every cue comes out, in order, and no more than a
+// loop late, and that the kick drum tracks' beats are at their tempo.
+
+#include <Arduino.h>
+#include <glob.h>
+#include <vector>
+
+#include "Host.h"
+#include "Check.h"
+#include "SimMSGEQ7.h"
+#include <wavfile.h>
+#include <Simon_Common.h>
+#include <Mic.h>
+#include <Cues.h>
+
+#define EQ_Q 1.5 // the chip's band-passes are broad
+#define EQ_DECAY_MS 20.0 // its peak detector lets go
+#define EQ_FLOOR 40 // reading with nothing playing
+#define EQ_SCALE 1000.0 // reading for a full-scale sine at a band's centre, over the floor
+#define THRESHOLD 1.5 // the fanfare's to start with
+#define HOLD_MS 333 // the fanfare's beatInterval
+#define LOOP_US 1000 // the rest of the fanfare's loop, between samples
+#define LOOP_MAX_MS 3 // the map's loop
+#define MATCH_MS 150 // a beat heard this close to one in the map is that one
+
+//------ the music, through the MSGEQ7
+
+static const double bandCenter[MSGEQ7_SIM_BANDS] = { 63, 160, 400, 1000, 2500, 6250, 16000 };
+
+static std::vector<int16_t> eq; // readings, a ms at a time, band by band
+static unsigned long long playedAt; // us
+static unsigned long playedMs;
+
+static void analyse(const WavFile &w) {
+  playedMs = (unsigned long)((unsigned long long)w.frames() * 1000 / w.rate);
+  eq.assign((size_t)playedMs * MSGEQ7_SIM_BANDS, EQ_FLOOR);
+  double decay = exp(-1.0 / (w.rate * EQ_DECAY_MS / 1000.0));
+
+  for ( int b = 0; b < MSGEQ7_SIM_BANDS; b++ ) {
+    // band-pass, 0 dB at the centre
+    double w0 = 2.0 * M_PI * bandCenter[b] / w.rate, alpha = sin(w0) / (2.0 * EQ_Q), a0 = 1.0 + alpha;
+    double b0 = alpha / a0, b2 = -alpha / a0, a1 = -2.0 * cos(w0) / a0, a2 = (1.0 - alpha) / a0;
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0, env = 0;
+    for ( uint32_t i = 0; i < w.frames(); i++ ) {
+      double x = w.mono(i) / 32768.0;
+      double y = b0 * x + b2 * x2 - a1 * y1 - a2 * y2;
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      env = max(fabs(y), env * decay);
+      unsigned long ms = (unsigned long long)i * 1000 / w.rate;
+      if ( ms < playedMs ) eq[ms * MSGEQ7_SIM_BANDS + b] = min(1023, EQ_FLOOR + (int)(env * EQ_SCALE));
+    }
+  }
+}
+
+static int eqLevel(uint8_t band, unsigned long long at) {
+  if ( at < playedAt ) return ( EQ_FLOOR );
+  unsigned long ms = (at - playedAt) / 1000;
+  if ( ms >= playedMs ) return ( EQ_FLOOR );
+  return ( eq[ms * MSGEQ7_SIM_BANDS + band] );
+}
+
+//------ the map
+
+static std::vector<long> mapBeats(const beatMap &m) {
+  std::vector<long> beats;
+  for ( int i = m.first; i < m.first + m.count; i++ ) {
+    beatCue c;
+    memcpy_P(&c, &beatCues[i], sizeof(beatCue));
+    if ( c.kind == CUE_BEAT ) beats.push_back(c.at * 10L);
+  }
+  return ( beats );
+}
+
+static long medianInterval(const std::vector<long> &t) {
+  std::vector<long> d;
+  for ( size_t i = 1; i < t.size(); i++ ) d.push_back(t[i] - t[i - 1]);
+  if ( d.empty() ) return ( 0 );
+  std::sort(d.begin(), d.end());
+  return ( d[d.size() / 2] );
+}
+
+// the fanfare's loop with the map: returns the most late a cue came out (ms)
+static unsigned long playMap(const beatMap &m) {
+  unsigned long start = millis(); // Cues starts the clock no sooner
+  CHECK(cues.begin(m.track));
+  unsigned long most = 0;
+  int n = 0;
+  long last = -1;
+  while ( cues.playing() ) {
+    beatCue c;
+    while ( cues.next(c) ) {
+      long now = millis() - start;
+      CHECK(c.at * 10L >= last); // in order
+      CHECK(now >= c.at * 10L - CUE_ADVANCE); // not early
+      most = max(most, (unsigned long)(now + CUE_ADVANCE - c.at * 10L));
+      last = c.at * 10L;
+      n++;
+    }
+    hostClock.advance(random(1, LOOP_MAX_MS + 1) * 1000ULL);
+  }
+  CHECK(n == m.count);
+  // a loop late, and the part of a ms millis() drops
+  CHECK(cues.lateMax <= most && most <= LOOP_MAX_MS + 1);
+  return ( most );
+}
+
+//------ the detector
+
+// the fanfare's loop without it: when Mic hears a beat in the bass (ms from the start)
+static std::vector<long> listen() {
+  listenWav.begin(WAV_RESET_PIN, WAV_STROBE_PIN, WAV_OUT_PIN);
+  listenWav.setThreshold(0, THRESHOLD);
+  listenWav.setThreshold(1, THRESHOLD);
+  playedAt = hostClock.now();
+
+  std::vector<long> heard;
+  long holdUntil = 0;
+  for ( ;; ) {
+    listenWav.update();
+    long ms = (hostClock.now() - playedAt) / 1000;
+    if ( ms >= (long)playedMs ) break;
+    if ( (listenWav.getBeat(0) || listenWav.getBeat(1)) && ms >= holdUntil ) {
+      heard.push_back(ms);
+      holdUntil = ms + HOLD_MS;
+    }
+    hostClock.advance(LOOP_US);
+  }
+  return ( heard );
+}
+
+//------ the two, side by side
+
+struct Result {
+  int beats, onsets;
+  unsigned long late; // the map's, most
+  int heard, matched, missed, extra;
+  double lagSum, lagSq;
+  long lagMax;
+};
+
+static void compare(const std::vector<long> &beats, const std::vector<long> &heard, Result &r) {
+  r.heard = heard.size();
+  r.matched = r.extra = r.missed = 0;
+  r.lagSum = r.lagSq = 0;
+  r.lagMax = 0;
+  for ( size_t i = 0; i < heard.size(); i++ ) {
+    long best = MATCH_MS + 1, lag = 0;
+    for ( size_t j = 0; j < beats.size(); j++ ) {
+      long d = heard[i] - beats[j];
+      if ( labs(d) < best ) {
+        best = labs(d);
+        lag = d;
+      }
+    }
+    if ( best > MATCH_MS ) {
+      r.extra++;
+      continue;
+    }
+    r.matched++;
+    r.lagSum += lag;
+    r.lagSq += (double)lag * lag;
+    if ( labs(lag) > labs(r.lagMax) ) r.lagMax = lag;
+  }
+  for ( size_t j = 0; j < beats.size(); j++ ) {
+    boolean found = false;
+    for ( size_t i = 0; i < heard.size() && !found; i++ ) found = labs(heard[i] - beats[j]) <= MATCH_MS;
+    if ( !found ) r.missed++;
+  }
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  const char *dir = "../../tones";
+  unsigned int seed = 1;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-d") == 0 && i + 1 < argc ) dir = argv[++i];
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [-v] [-d dir] [-s seed]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  hostBegin();
+  Serial.echo(verbose);
+  randomSeed(seed);
+  simWavEQ.setLevels(eqLevel);
+
+  printf("  track                        | map: beats onsets  late ms | heard matched  lag ms: mean    sd   max | missed extra\n");
+  int matched = 0, mapped = 0;
+  double lagSum = 0, lagSq = 0;
+  unsigned long lateMost = 0;
+  for ( int i = 0; i < N_BEAT_MAPS; i++ ) {
+    beatMap m;
+    memcpy_P(&m, &beatMaps[i], sizeof(beatMap));
+
+    char pattern[512];
+    snprintf(pattern, sizeof(pattern), "%s/%03d*.wav", dir, m.track);
+    glob_t g;
+    boolean there = glob(pattern, 0, NULL, &g) == 0 && g.gl_pathc == 1;
+    if ( !there ) fprintf(stderr, "beatbench: no file for track %d in %s\n", m.track, dir);
+    CHECK(there);
+    WavFile w;
+    char name[64] = "";
+    there = there && readWav(g.gl_pathv[0], w, "beatbench");
+    if ( there ) snprintf(name, sizeof(name), "%s", w.name);
+    globfree(&g);
+    if ( !there ) continue;
+
+    std::vector<long> beats = mapBeats(m);
+    long interval = medianInterval(beats);
+    // 140 and 70 BPM
+    if ( m.track == 512 ) CHECK(labs(interval - 429) <= 10);
+    if ( m.track == 513 ) CHECK(labs(interval - 857) <= 10);
+
+    Result r;
+    r.beats = beats.size();
+    r.onsets = m.count - r.beats;
+    r.late = playMap(m);
+    analyse(w);
+    compare(beats, listen(), r);
+
+    double mean = r.matched ? r.lagSum / r.matched : 0;
+    double sd = r.matched ? sqrt(max(0.0, r.lagSq / r.matched - mean * mean)) : 0;
+    printf("  %-28.28s |      %5d  %5d  %7lu | %5d %7d        %6.1f %5.1f %5ld | %6d %5d\n", name, r.beats, r.onsets,
+           r.late, r.heard, r.matched, mean, sd, r.lagMax, r.missed, r.extra);
+    matched += r.matched;
+    mapped += r.beats;
+    lagSum += r.lagSum;
+    lagSq += r.lagSq;
+    lateMost = max(lateMost, r.late);
+  }
+  CHECK(N_BEAT_MAPS > 0);
+
+  double mean = matched ? lagSum / matched : 0;
+  double sd = matched ? sqrt(max(0.0, lagSq / matched - mean * mean)) : 0;
+  printf("  from the map, every cue out no more than %lu ms late; the detector heard %d of %d beats, %.1f ms late +/- %.1f\n",
+         lateMost, matched, mapped, mean, sd);
+  printf("beatbench: %s\n", failures ? "FAILED" : "ok");
+  return ( failures ? 1 : 0 );
+}
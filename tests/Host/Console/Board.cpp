@@ -0,0 +1,34 @@
+#include "Board.h"
+#include "Host.h"
+#include "Sketch.h"
+
+#include <EEPROM.h>
+#include <RFM12B.h>
+#include <Simon_Common.h>
+
+// same locations Network.cpp reads
+#define RADIO_CONFIG_ADDR 42
+#define LAYOUT_ADDR 69
+#define HIGH_SCORE_ADDR 77
+
+void boardBegin(boolean echo) {
+  hostBegin();
+  Serial.echo(echo);
+
+  // radio: node, group, band
+  EEPROM.preset(RADIO_CONFIG_ADDR + 0, CONSOLE);
+  EEPROM.preset(RADIO_CONFIG_ADDR + 1, D_GROUP_ID);
+  EEPROM.preset(RADIO_CONFIG_ADDR + 2, RF12_915MHZ);
+
+  // one Tower per color, light and fire
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    EEPROM.preset(LAYOUT_ADDR + i, i);
+    EEPROM.preset(LAYOUT_ADDR + N_COLORS + i, i);
+  }
+
+  EEPROM.preset(HIGH_SCORE_ADDR, 0);
+}
+
+void boardRun(unsigned long long until) {
+  while ( hostClock.now() < until ) loop();
+}
@@ -0,0 +1,15 @@
+// The Console as installed: peripherals on their buses and EEPROM already set up
+// (radio config and Tower layout), so setup() takes the same path it does at an event.
+
+#ifndef Board_h
+#define Board_h
+
+#include <Arduino.h>
+
+// call before setup().  'echo' copies the sketch's Serial output to stdout.
+void boardBegin(boolean echo);
+
+// run loop() until the virtual clock reaches 'until' (us)
+void boardRun(unsigned long long until);
+
+#endif
@@ -0,0 +1,189 @@
+// Fade test: a light fading up, sent by the Console a step at a time as it used to be,
+// against the same fade sent once and done by the Towers and Light module themselves.
+//
+//   ./build/fadetest [-v]
+//
+// First the fader (Simon_Fade.h): its blend at the board's 16-bit int over full-range fades,
+// and the old one's wrapping there; a step is there at once; each easing runs from one color
+// to the other, never backing up; a new color mid-fade carries on from where the light got
+// to; the same instruction again doesn't start it over.  Then the Console, four Towers
+// listening: red up over a second as 50 steps, then as one fade.  The Towers must end up
+// with the color either way.  Reports the Console's new packets and bytes on the air.
+
+#include <Arduino.h>
+#include <FiniteStateMachine.h>
+#include "Host.h"
+#include "Check.h"
+#include "Sketch.h"
+#include "Board.h"
+#include "Air.h"
+#include "SimTower.h"
+#include <Simon_Common.h>
+#include <Simon_Wire.h>
+#include <Simon_Fade.h>
+#include <Light.h>
+
+#define FADE_MS 1000UL
+#define FADE_STEPS 50
+
+static boolean same(const colorInstruction &a, const colorInstruction &b) {
+  return ( memcmp(&a, &b, sizeof(colorInstruction)) == 0 );
+}
+
+//------ the fader
+
+static void step() {
+  ColorFade f;
+  f.begin(cOff);
+  CHECK(f.update(0));
+  CHECK(!f.update(1));
+
+  colorInstruction blue = cBlue;
+  f.start(blue, fStep, 10);
+  CHECK(same(f.color, cBlue) && !f.fading());
+  CHECK(f.update(10));
+}
+
+// every step between the ends of a channel, as the board's 16-bit int does it
+static void widths() {
+  const byte ends[][2] = { {0, 255}, {255, 0}, {0, 128}, {255, 127}, {1, 254} };
+  int wrapped = 0;
+  for ( unsigned int i = 0; i < sizeof(ends) / sizeof(ends[0]); i++ ) {
+    byte a = ends[i][0], b = ends[i][1];
+    for ( int e = 0; e < 256; e++ ) {
+      long exact = a + ((long)b - a) * e / 255;
+      CHECK((fadeBlend<int16_t, int32_t>(a, b, e)) == exact);
+      // the multiply in a 16-bit int, as it was: wraps past half-way on a full-range fade
+      wrapped += fadeBlend<int16_t, int16_t>(a, b, e) != exact;
+    }
+  }
+  CHECK(wrapped > 0);
+}
+
+static void easings() {
+  const colorInstruction from = {10, 200, 0}, to = {250, 0, 100};
+  for ( byte e = 0; e < N_fadeEasings; e++ ) {
+    CHECK(fadeEase(e, 0) == 0 && fadeEase(e, 255) == 255);
+    for ( int t = 1; t < 256; t++ ) CHECK(fadeEase(e, t) >= fadeEase(e, t - 1));
+
+    ColorFade f;
+    f.begin(from);
+    fadeInstruction fade = {FADE_MS / 10, e};
+    f.start(to, fade, 1000);
+    colorInstruction was = f.color;
+    int backs = 0, moves = 0;
+    for ( unsigned long ms = 1000; ms <= 1000 + FADE_MS; ms++ ) {
+      if ( f.update(ms) ) moves++;
+      backs += f.color.red < was.red || f.color.green > was.green || f.color.blue < was.blue;
+      was = f.color;
+    }
+    CHECK(backs == 0);
+    CHECK(moves > 100);
+    CHECK(same(f.color, to) && !f.fading());
+  }
+}
+
+static void restart() {
+  const colorInstruction white = cWhite;
+  fadeInstruction fade = {100, E_Linear};
+  ColorFade f;
+  f.begin(cOff);
+  f.start(white, fade, 0);
+  f.update(500);
+  colorInstruction half = f.color;
+  CHECK(half.red > 100 && half.red < 155);
+
+  // the same again: carries on
+  f.start(white, fade, 500);
+  f.update(750);
+  CHECK(f.color.red > half.red && f.color.red < 255);
+
+  // somewhere new: from here, not from where it started
+  colorInstruction was = f.color;
+  f.start(cOff, fade, 750);
+  f.update(751);
+  CHECK(f.color.red <= was.red && f.color.red >= was.red - 2);
+  f.update(1750);
+  CHECK(same(f.color, cOff));
+}
+
+//------ on the air
+
+static SimTower reference, towers[N_COLORS];
+
+static unsigned long frames, bytes, packets;
+static byte lastPacket;
+static void monitor(const AirFrame &frame) {
+  byte packetNumber;
+  if ( frame.group != D_GROUP_ID || frame.from != CONSOLE || !wirePacketNumber(frame.data, frame.len, packetNumber) ) return;
+  frames++;
+  bytes += frame.len;
+  if ( packetNumber != lastPacket ) packets++;
+  lastPacket = packetNumber;
+}
+
+static void count() {
+  frames = bytes = packets = 0;
+}
+
+// red from off to full, the old way or the new; then long enough for the resends and a
+// keyframe or two.  the same length of time either way.
+static void fadeUp(boolean stepped) {
+  light.setLight(I_RED, 0, 0, 0);
+  boardRun(hostClock.now() + 2000000ULL);
+
+  count();
+  unsigned long long start = hostClock.now();
+  if ( stepped ) {
+    for ( int s = 1; s <= FADE_STEPS; s++ ) {
+      light.setLight(I_RED, s * 255 / FADE_STEPS, 0, 0);
+      boardRun(start + s * FADE_MS * 1000ULL / FADE_STEPS);
+    }
+  } else {
+    light.setLight(I_RED, 255, 0, 0, FADE_MS, E_EaseInOut);
+  }
+  boardRun(start + 2 * FADE_MS * 1000ULL);
+
+  const colorInstruction red = cRed;
+  for ( byte i = 0; i < N_COLORS; i++ ) CHECK(towers[i].valid && same(towers[i].state.light[I_RED], red));
+  const fadeInstruction &fade = reference.state.fade[I_RED];
+  if ( stepped ) CHECK(fade.duration == 0);
+  else CHECK(fade.duration == FADE_MS / 10 && fade.easing == E_EaseInOut);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else {
+      fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  step();
+  widths();
+  easings();
+  restart();
+
+  boardBegin(verbose);
+  hostClock.setDeadline(120 * 1000000ULL);
+  air.monitor = monitor;
+  reference.begin(TOWER1, false);
+  for ( byte i = 0; i < N_COLORS; i++ ) towers[i].begin((nodeID)(TOWER1 + i));
+
+  setup();
+  boardRun(hostClock.now() + 3000000ULL);
+
+  fadeUp(true);
+  unsigned long stepFrames = frames, stepBytes = bytes, stepPackets = packets;
+  fadeUp(false);
+  CHECK(packets * 10 <= stepPackets);
+  CHECK(bytes * 4 <= stepBytes);
+
+  printf("  red up over %lu ms  |  packets  frames   bytes\n", FADE_MS);
+  printf("  %2d steps            |  %7lu %7lu %7lu\n", FADE_STEPS, stepPackets, stepFrames, stepBytes);
+  printf("  one fade            |  %7lu %7lu %7lu\n", packets, frames, bytes);
+  printf("fadetest: %s\n", failures ? "FAILED" : "ok");
+  return ( failures ? 1 : 0 );
+}
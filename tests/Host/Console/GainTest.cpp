@@ -0,0 +1,244 @@
+// Gain test: Sound's leveling, against the simulated WAV Trigger.
+//
+//   ./build/gaintest [-v] [-s seed] [-n steps]
+//
+// First every mix the board can play, tones and tracks: each voice on the board at the gain
+// setLeveling() used to work out with log10() and pow() for just that mix, and all of them
+// together within a dB of one tone at TONE_GAIN.  Then random starts, stops, fades and
+// stopTones(): after each, the board's gains are the ones for what's playing, and the gain
+// changes sent are the plays' own and one for each voice whose level moved, no more.  Then
+// setVolume()'s tones, which the leveling leaves alone, and a fade, which it doesn't cut short.
+
+#include <Arduino.h>
+
+#include "Host.h"
+#include "Check.h"
+#include "SimWavTrigger.h"
+#include <Simon_Common.h>
+#include <Sound.h>
+
+#define STEPS 400 // random starts and stops
+#define SETTLE_MS 40 // for the queue to go out
+#define FADE_MS 200UL
+#define TRACK_MS 3600000UL // the simulated board's tracks don't end on their own
+
+// the loop, a millisecond a turn
+static void settle(unsigned long ms) {
+  for ( unsigned long i = 0; i < ms; i++ ) {
+    sound.update();
+    hostClock.advance(1000ULL);
+  }
+}
+
+//------ what the gains should be
+
+// the tracks we play: tones and drums, and music
+#define N_CANDIDATES (N_TONES + 16 + 20)
+static int candidate[N_CANDIDATES];
+static boolean toneClass(int track) {
+  return ( (track >= trTones[0] && track <= trTones[N_TONES-1]) || (track >= trDrum[0] && track <= trDrum[1]) );
+}
+
+// as setLeveling() had it
+static int toneGainFor(int nTones, int nTracks) {
+  if ( nTones + nTracks == 0 ) return ( TONE_GAIN );
+  return ( TONE_GAIN - floor( 10.0*log10(float(nTones) + float(nTracks)*pow(10.0, float(TRACK_GAIN_RELATIVE_TO_TONE)/10.0)) ) );
+}
+static int gainFor(int track, int nTones, int nTracks) {
+  int g = toneGainFor(nTones, nTracks);
+  return ( toneClass(track) ? g : g + TRACK_GAIN_RELATIVE_TO_TONE );
+}
+
+// the board and Sound agree on what's playing, and it's all at its level; returns how many
+static int leveled(int &nTones, int &nTracks) {
+  nTones = nTracks = 0;
+  for ( int i = 0; i < N_CANDIDATES; i++ ) {
+    int t = candidate[i];
+    CHECK(sound.playing(t) == simWav.playing(t));
+    if ( !simWav.playing(t) ) continue;
+    if ( toneClass(t) ) nTones++;
+    else nTracks++;
+  }
+  CHECK(sound.voices() == simWav.voices());
+  CHECK(nTones + nTracks == simWav.voices());
+
+  // all together no louder than a tone on its own, but for the part of a dB floor() leaves
+  double power = 0;
+  for ( int i = 0; i < N_CANDIDATES; i++ ) {
+    int t = candidate[i];
+    if ( !simWav.playing(t) ) continue;
+    CHECK(simWav.gain(t) == gainFor(t, nTones, nTracks));
+    power += pow(10.0, simWav.gain(t) / 10.0);
+  }
+  CHECK(power < pow(10.0, (TONE_GAIN + 1) / 10.0));
+  return ( nTones + nTracks );
+}
+
+//------ every mix
+
+static int mixes() {
+  int n = 0;
+  for ( int nTones = 0; nTones <= WAV_VOICES; nTones++ ) {
+    for ( int nTracks = 0; nTones + nTracks <= WAV_VOICES; nTracks++ ) {
+      if ( nTones + nTracks == 0 ) continue;
+      sound.stopAll();
+      settle(SETTLE_MS);
+      // interleaved, so each start relevels a mix of both
+      for ( int i = 0; i < max(nTones, nTracks); i++ ) {
+        if ( i < nTones ) sound.playTrack(candidate[i]);
+        if ( i < nTracks ) sound.playTrack(candidate[N_TONES + 16 + i]);
+      }
+      settle(SETTLE_MS);
+      int t, k;
+      CHECK(leveled(t, k) == nTones + nTracks);
+      CHECK(t == nTones && k == nTracks);
+      n++;
+    }
+  }
+  return ( n );
+}
+
+//------ starts and stops
+
+static unsigned long steps, needed, sent;
+
+static void startsAndStops(int count) {
+  sound.stopAll();
+  settle(SETTLE_MS);
+  int was[N_CANDIDATES];
+
+  for ( int s = 0; s < count; s++ ) {
+    for ( int i = 0; i < N_CANDIDATES; i++ ) was[i] = simWav.playing(candidate[i]) ? simWav.gain(candidate[i]) : VOICE_UNLEVELED;
+    unsigned long gains = simWav.commands[CMD_TRACK_VOLUME], plays = simWav.plays;
+    int restarted = 0;
+
+    int t = candidate[random(N_CANDIDATES)], played = 0;
+    switch ( random(8) ) {
+      case 0: case 1: case 2:
+        played = sound.playTrack(t);
+        break;
+      case 3:
+        played = toneClass(t) ? sound.playDrumSound(random(N_COLORS)) : sound.playLose();
+        break;
+      case 4: case 5:
+        sound.stopTrack(t);
+        break;
+      case 6:
+        if ( sound.playing(t) ) sound.fadeTrack(t, FADE_MS);
+        break;
+      case 7:
+        sound.stopTones();
+        break;
+    }
+    for ( int i = 0; i < N_CANDIDATES; i++ ) if ( candidate[i] == played && was[i] != VOICE_UNLEVELED ) restarted = played;
+    settle(FADE_MS + SETTLE_MS);
+
+    int nTones, nTracks;
+    leveled(nTones, nTracks);
+
+    // what had to change: the plays' own gains, and those still playing at a new level
+    unsigned long need = simWav.plays - plays;
+    for ( int i = 0; i < N_CANDIDATES; i++ ) {
+      int c = candidate[i];
+      if ( c != restarted && was[i] != VOICE_UNLEVELED && simWav.playing(c) && simWav.gain(c) != was[i] ) need++;
+    }
+    CHECK(simWav.commands[CMD_TRACK_VOLUME] - gains == need);
+    needed += need;
+    sent += simWav.commands[CMD_TRACK_VOLUME] - gains;
+    steps++;
+  }
+}
+
+//------ setVolume() and fades
+
+static void manual() {
+  sound.stopAll();
+  settle(SETTLE_MS);
+
+  // proximity mode's tones, quiet
+  for ( byte c = 0; c < N_COLORS; c++ ) {
+    sound.playTone(c);
+    sound.setVolume(trTones[c], -40);
+  }
+  settle(SETTLE_MS);
+  unsigned long leveledBefore = sound.leveled;
+
+  // music on top, and off again: the tones stay where they were put
+  int tr = sound.playLose();
+  settle(SETTLE_MS);
+  CHECK(simWav.gain(tr) == gainFor(tr, N_COLORS, 1));
+  sound.stopTrack(tr);
+  settle(SETTLE_MS);
+  for ( byte c = 0; c < N_COLORS; c++ ) CHECK(simWav.gain(trTones[c]) == -40);
+  CHECK(sound.leveled == leveledBefore);
+
+  // played again, it's leveled again
+  sound.playTone(I_RED);
+  settle(SETTLE_MS);
+  CHECK(simWav.gain(trTones[I_RED]) == gainFor(trTones[I_RED], N_COLORS, 0));
+  CHECK(simWav.gain(trTones[I_GRN]) == -40);
+}
+
+static void fading() {
+  sound.stopAll();
+  settle(SETTLE_MS);
+
+  int tr = sound.playLose();
+  sound.playTone(I_RED);
+  settle(SETTLE_MS);
+  sound.fadeTrack(tr, 1000);
+  settle(SETTLE_MS);
+  CHECK(simWav.gain(tr) == -70);
+
+  // another tone mid-fade: red comes down, the music carries on fading out
+  unsigned long gains = simWav.commands[CMD_TRACK_VOLUME];
+  sound.playTone(I_GRN);
+  settle(SETTLE_MS);
+  CHECK(simWav.commands[CMD_TRACK_VOLUME] - gains == 2);
+  CHECK(simWav.gain(tr) == -70);
+  CHECK(simWav.gain(trTones[I_RED]) == gainFor(trTones[I_RED], 2, 1));
+
+  // and when it's done, two tones
+  settle(1000);
+  int nTones, nTracks;
+  CHECK(leveled(nTones, nTracks) == 2);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  unsigned int seed = 1;
+  int count = STEPS;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atoi(argv[++i]);
+    else if ( strcmp(argv[i], "-n") == 0 && i + 1 < argc ) count = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [-v] [-s seed] [-n steps]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  hostBegin();
+  Serial.echo(verbose);
+  int n = 0;
+  for ( int i = 0; i < N_TONES; i++ ) candidate[n++] = trTones[i];
+  for ( int t = trDrum[0]; t <= trDrum[1]; t++ ) candidate[n++] = t;
+  for ( int t = trLose[0]; t <= trLose[1]; t++ ) candidate[n++] = t;
+  for ( int i = 0; i < N_CANDIDATES; i++ ) simWav.setTrackLength(candidate[i], TRACK_MS);
+
+  sound.begin();
+  settle(SETTLE_MS);
+  randomSeed(seed);
+
+  int m = mixes();
+  startsAndStops(count);
+  manual();
+  fading();
+  CHECK(sound.mismatches == 0);
+
+  printf("  %d mixes of tones and tracks, each voice at its level\n", m);
+  printf("  %lu starts and stops | gain changes needed %lu, sent %lu; %lu by the leveling\n",
+         steps, needed, sent, sound.leveled);
+  printf("gaintest: %s\n", failures ? "FAILED" : "ok");
+  return ( failures ? 1 : 0 );
+}
@@ -0,0 +1,374 @@
+// Plays whole Simon games against the Console firmware on the virtual clock.
+//
+//   ./build/gamesim [options]
+//     -n games     games to play (default 100)
+//     -s seed      seeds the firmware's randomSeed() (via A5) and the player (default 1)
+//     -r ms        player's mean reaction time (default 450)
+//     -h ms        how long a button is held (default 150)
+//     -e p         chance any one press is wrong (default 0.02)
+//     -m lo,hi     player's memory span, drawn per game (default 4,16)
+//     -t p         chance a player past their span stalls (times out) rather than guesses (default 0.5)
+//     -i ms        idle time between games (default 2000)
+//     -c us        charge per millis()/micros() read (default: the host's)
+//     -f file      scripted touches instead of the player model: "<ms> <electrode> down|up" per line
+//     -w file      record the touches, model's or script's, in the same format
+//     -v           echo the firmware's Serial output
+//
+// Reports per-state dwell, sequence lengths reached, how games ended (timeout or
+// wrong press), fanfare levels, playback pacing, loop latency, and touch latency (from
+// a finger landing to the Touch snapshot that sees it).  The same options and seed give
+// the same report.
+
+#include <Arduino.h>
+#include <FiniteStateMachine.h>
+#include <time.h>
+
+#include "Host.h"
+#include "Sketch.h"
+#include "Board.h"
+#include "SimMPR121.h"
+#include <Simon_Common.h>
+#include <Fanfare.h>
+#include <Touch.h>
+
+// firmware state we watch; defined in Simon.cpp
+extern FSM simon;
+extern State idle, game, player, fanfare, test;
+extern color gameSequence[];
+extern int gameCurrent, playerCurrent;
+extern fanfare_t fanfareLevel;
+extern int fanfareCorrectMapping[N_LEVELS];
+
+#define MAX_SEQUENCE 32
+#define MAX_SCRIPT 4096
+
+//------ options
+
+static long nGames = 100;
+static unsigned long seed = 1;
+static float reactionMs = 450, holdMs = 150, errorRate = 0.02, stallRate = 0.5, idleMs = 2000;
+static int spanLo = 4, spanHi = 16;
+static unsigned int readCost = 0;
+static const char *scriptFile = NULL;
+static FILE *traceFile = NULL;
+static boolean verbose = false;
+
+//------ the player's own dice, separate from the firmware's random()
+
+static uint32_t dice = 1;
+static float roll() {
+  dice ^= dice << 13;
+  dice ^= dice >> 17;
+  dice ^= dice << 5;
+  return ( dice / 4294967296.0 );
+}
+// reaction times are skewed; a gamma-ish sum of uniforms does fine
+static unsigned long reaction() {
+  return ( (unsigned long)(reactionMs * (0.5 + (roll() + roll() + roll()) / 3.0)) );
+}
+
+//------ what we measure
+
+enum { S_TEST, S_IDLE, S_GAME, S_PLAYER, S_FANFARE, N_STATES };
+static const char *stateName[N_STATES] = { "test", "idle", "game", "player", "fanfare" };
+static State *states[N_STATES] = { &test, &idle, &game, &player, &fanfare };
+
+static unsigned long long dwell[N_STATES];
+static unsigned long visits[N_STATES];
+static unsigned long long longest[N_STATES];
+
+// loop() latency, binned as the firmware's Scheduler does: <1 ms, <2 ms ... and longer.
+#define LOOP_BINS 11
+static unsigned long loops[N_STATES];
+static unsigned long long slowest[N_STATES];
+static unsigned long loopBins[LOOP_BINS];
+
+// touch latency, binned the same way; and the presses Touch hasn't seen yet (us, 0 if none)
+static unsigned long touchBins[LOOP_BINS];
+static unsigned long long touchDown[N_BUTTONS];
+
+static unsigned long lengthReached[MAX_SEQUENCE + 1]; // sequence length when the game ended
+static unsigned long endedTimeout, endedWrong, endedMaxout;
+static unsigned long levels[MAXOUT + 1];
+
+// game (sequence playback) dwell by sequence length
+static unsigned long long playback[MAX_SEQUENCE + 1];
+static unsigned long playbackCount[MAX_SEQUENCE + 1];
+
+// last press the player made this round, checked against the sequence when it landed
+static boolean lastPressWrong;
+
+static int whichState() {
+  for ( int s = 0; s < N_STATES; s++ ) {
+    if ( simon.isInState(*states[s]) ) return ( s );
+  }
+  return ( -1 );
+}
+
+//------ touch injection
+
+// script and trace times are from the end of setup()
+static unsigned long long scriptStart;
+static void record(int electrode, const char *dir) {
+  if ( traceFile ) fprintf(traceFile, "%llu %d %s\n", (hostClock.now() - scriptStart) / 1000ULL, electrode, dir);
+}
+
+static void pressed(void *arg) {
+  int e = (int)(intptr_t)arg;
+  record(e, "down");
+  simMPR121.touch(e, true);
+  if ( e < N_BUTTONS ) touchDown[e] = hostClock.now();
+  if ( simon.isInState(player) && e < N_COLORS ) lastPressWrong = (e != gameSequence[playerCurrent]);
+}
+static void released(void *arg) {
+  record((int)(intptr_t)arg, "up");
+  simMPR121.touch((int)(intptr_t)arg, false);
+}
+static void tap(int electrode, unsigned long long at, unsigned long holdUs) {
+  hostClock.schedule(at, pressed, (void *)(intptr_t)electrode);
+  hostClock.schedule(at + holdUs, released, (void *)(intptr_t)electrode);
+}
+
+// schedules the script's touches from 'start'; returns the time of the last one.
+static unsigned long long loadScript(unsigned long long start) {
+  FILE *f = fopen(scriptFile, "r");
+  if ( f == NULL ) {
+    perror(scriptFile);
+    exit(2);
+  }
+  char line[128], dir[16];
+  unsigned long ms;
+  int electrode, n = 0;
+  unsigned long long last = start;
+  while ( fgets(line, sizeof(line), f) ) {
+    if ( line[0] == '#' ) continue;
+    if ( sscanf(line, "%lu %d %15s", &ms, &electrode, dir) != 3 ) continue;
+    if ( n++ == MAX_SCRIPT ) break;
+    unsigned long long at = start + ms * 1000ULL;
+    hostClock.schedule(at, strcmp(dir, "down") == 0 ? pressed : released, (void *)(intptr_t)electrode);
+    if ( at > last ) last = at;
+  }
+  fclose(f);
+  return ( last );
+}
+
+//------ player model
+
+static int span; // this game's memory span
+static unsigned long long busyUntil; // no new touches before this
+static int plannedFor = -1; // playerCurrent we've already planned a press for
+
+static void playerModel(int state) {
+  unsigned long long now = hostClock.now();
+  if ( now < busyUntil || simMPR121.touched() ) return;
+
+  if ( state == S_IDLE ) {
+    // walk up and hit start
+    span = spanLo + (int)(roll() * (spanHi - spanLo + 1));
+    busyUntil = now + (unsigned long long)(idleMs * 1000) + 1000000ULL;
+    tap(I_START, now + (unsigned long long)(idleMs * 1000), holdMs * 1000);
+    plannedFor = -1;
+    return;
+  }
+
+  if ( state != S_PLAYER || plannedFor == playerCurrent ) return;
+  plannedFor = playerCurrent;
+
+  int e = gameSequence[playerCurrent];
+  if ( gameCurrent > span ) {
+    // past what they can remember: stall, or guess
+    if ( roll() < stallRate ) return;
+    e = (int)(roll() * N_COLORS);
+  } else if ( roll() < errorRate ) {
+    e = (e + 1 + (int)(roll() * (N_COLORS - 1))) % N_COLORS;
+  }
+
+  unsigned long r = reaction();
+  tap(e, now + r * 1000ULL, holdMs * 1000);
+  busyUntil = now + (r + holdMs) * 1000ULL;
+}
+
+//------ bookkeeping on state changes
+
+static long gamesDone;
+static unsigned long long visitTime; // time in the current visit so far
+
+// a loop() that changes state has run the new state's enter() and first update(),
+// so its time belongs to the new state.
+static void entered(int to, int from, unsigned long long spent) {
+  if ( from >= 0 ) {
+    if ( from == S_GAME && gameCurrent <= MAX_SEQUENCE ) {
+      playback[gameCurrent] += visitTime;
+      playbackCount[gameCurrent]++;
+    }
+    if ( visitTime > longest[from] ) longest[from] = visitTime;
+  }
+  visits[to]++;
+  visitTime = spent;
+
+  if ( to == S_PLAYER ) {
+    lastPressWrong = false;
+    plannedFor = -1;
+  }
+
+  if ( to == S_FANFARE ) {
+    if ( fanfareLevel <= MAXOUT ) levels[fanfareLevel]++;
+    if ( fanfareLevel == IDLE ) return;
+
+    lengthReached[min(gameCurrent, MAX_SEQUENCE)]++;
+    if ( fanfareLevel == MAXOUT ) endedMaxout++;
+    else if ( lastPressWrong ) endedWrong++;
+    else endedTimeout++;
+    gamesDone++;
+  }
+}
+
+static int bin(unsigned long long us) {
+  int b = 0;
+  for ( unsigned long long ms = us / 1000; ms > 0 && b < LOOP_BINS - 1; ms >>= 1 ) b++;
+  return ( b );
+}
+
+static void looped(int state, unsigned long long spent) {
+  loops[state]++;
+  if ( spent > slowest[state] ) slowest[state] = spent;
+  loopBins[bin(spent)]++;
+
+  // electrodes are buttons one for one on the Console
+  for ( int e = 0; e < N_BUTTONS; e++ ) {
+    if ( touchDown[e] == 0 || !touch.pressed(e) ) continue;
+    unsigned long long seen = touch.changedAt(e) * 1000ULL;
+    touchBins[bin(seen > touchDown[e] ? seen - touchDown[e] : 0)]++;
+    touchDown[e] = 0;
+  }
+}
+
+static void printBins(const char *what, unsigned long *bins) {
+  printf("\n%s:", what);
+  for ( int b = 0; b < LOOP_BINS; b++ ) {
+    if ( bins[b] == 0 ) continue;
+    if ( b < LOOP_BINS - 1 ) printf(" <%dms:%lu", 1 << b, bins[b]);
+    else printf(" >=%dms:%lu", 1 << (b - 1), bins[b]);
+  }
+  printf("\n");
+}
+
+//------ report
+
+static const char *levelName(int l) {
+  switch ( l ) {
+    case LEVEL1: return ( "LEVEL1" );
+    case LEVEL2: return ( "LEVEL2" );
+    case LEVEL3: return ( "LEVEL3" );
+    case LEVEL4: return ( "LEVEL4" );
+    case IDLE: return ( "IDLE" );
+    case CONSOLATION: return ( "CONSOLATION" );
+    case MAXOUT: return ( "MAXOUT" );
+  }
+  return ( NULL );
+}
+
+static void report(double wall) {
+  double virt = hostClock.now() / 1e6;
+  printf("gamesim: %ld games, seed %lu, %.1f s virtual in %.2f s (%.0fx real time)\n",
+         gamesDone, seed, virt, wall, wall > 0 ? virt / wall : 0.0);
+
+  printf("\nstate     visits   total s   mean ms    max ms     loops  max loop ms\n");
+  for ( int s = 0; s < N_STATES; s++ ) {
+    printf("%-8s %7lu %9.1f %9.1f %9.1f %9lu %12.1f\n", stateName[s], visits[s], dwell[s] / 1e6,
+           visits[s] ? dwell[s] / 1e3 / visits[s] : 0.0, longest[s] / 1e3, loops[s], slowest[s] / 1e3);
+  }
+
+  printBins("loop latency", loopBins);
+  printBins("touch latency", touchBins);
+
+  printf("\ngames ended: %lu timeout (playerTimeout), %lu wrong press, %lu maxout\n", endedTimeout, endedWrong, endedMaxout);
+
+  printf("\nfanfare     count   (fanfareCorrectMapping: %d %d %d %d)\n", fanfareCorrectMapping[LEVEL1],
+         fanfareCorrectMapping[LEVEL2], fanfareCorrectMapping[LEVEL3], fanfareCorrectMapping[LEVEL4]);
+  for ( int l = 0; l <= MAXOUT; l++ ) {
+    if ( levelName(l) ) printf("%-11s %5lu\n", levelName(l), levels[l]);
+  }
+
+  printf("\nlength  games  playback mean ms\n");
+  for ( int n = 1; n <= MAX_SEQUENCE; n++ ) {
+    if ( lengthReached[n] == 0 && playbackCount[n] == 0 ) continue;
+    printf("%6d %6lu %17.1f\n", n, lengthReached[n], playbackCount[n] ? playback[n] / 1e3 / playbackCount[n] : 0.0);
+  }
+}
+
+//------ main
+
+static void usage() {
+  fprintf(stderr, "usage: gamesim [-n games] [-s seed] [-r ms] [-h ms] [-e p] [-m lo,hi] [-t p] [-i ms] [-c us] [-f script] [-w trace] [-v]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  for ( int i = 1; i < argc; i++ ) {
+    const char *a = argv[i];
+    if ( strcmp(a, "-v") == 0 ) { verbose = true; continue; }
+    if ( i + 1 >= argc || a[0] != '-' ) usage();
+    const char *v = argv[++i];
+    switch ( a[1] ) {
+      case 'n': nGames = atol(v); break;
+      case 's': seed = strtoul(v, NULL, 0); break;
+      case 'r': reactionMs = atof(v); break;
+      case 'h': holdMs = atof(v); break;
+      case 'e': errorRate = atof(v); break;
+      case 'm': if ( sscanf(v, "%d,%d", &spanLo, &spanHi) != 2 ) usage(); break;
+      case 't': stallRate = atof(v); break;
+      case 'i': idleMs = atof(v); break;
+      case 'c': readCost = atoi(v); break;
+      case 'f': scriptFile = v; break;
+      case 'w':
+        traceFile = fopen(v, "w");
+        if ( traceFile == NULL ) {
+          perror(v);
+          exit(2);
+        }
+        break;
+      default: usage();
+    }
+  }
+  dice = seed ? seed : 1;
+
+  boardBegin(verbose);
+  hostPins.setAnalog(A5, seed & 0x3FF);
+  hostClock.setReadCost(readCost);
+
+  clock_t wallStart = clock();
+  setup();
+
+  scriptStart = hostClock.now();
+  unsigned long long scriptEnd = 0;
+  if ( scriptFile ) scriptEnd = loadScript(scriptStart);
+
+  int state = whichState();
+  entered(state, -1, 0);
+  while ( scriptFile || gamesDone < nGames ) {
+    unsigned long long before = hostClock.now();
+    loop();
+    int now = whichState();
+    unsigned long long spent = hostClock.now() - before;
+    dwell[now] += spent;
+    looped(now, spent);
+    if ( now != state ) {
+      entered(now, state, spent);
+      state = now;
+    } else {
+      visitTime += spent;
+    }
+
+    if ( scriptFile ) {
+      // done once the script is spent and the firmware is back in idle
+      if ( hostClock.now() > scriptEnd && state == S_IDLE && simMPR121.touched() == 0 ) break;
+      continue;
+    }
+    playerModel(state);
+  }
+
+  report((double)(clock() - wallStart) / CLOCKS_PER_SEC);
+  if ( traceFile ) fclose(traceFile);
+  return ( gamesDone > 0 ? 0 : 1 );
+}
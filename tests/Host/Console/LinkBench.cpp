@@ -0,0 +1,236 @@
+// Radio link benchmark: the Console's Network against four Towers on a lossy channel.
+//
+//   ./build/linkbench [options]
+//     -t s         measured virtual seconds per row (default 60)
+//     -s seed      channel and traffic seed (default 1)
+//     -f us        mean fade length for the bursty rows (default 20000)
+//     -v           echo the firmware's Serial output
+//
+// Each row is one loss rate, both ways, either frame by frame or in fades, with Towers on
+// the old firmware (no link reports: fixed resends) or sending reports (adaptive resends).
+// The traffic is the game's: a light change every 100-400 ms, one in seven a fire change.
+// Reports how long a light change takes to reach every Tower (percentiles over Towers and
+// changes; delivered once a Tower's state covers its packet), how long a fire command takes
+// to reach its Tower, fire commands that never fired, and repeats that fired twice (should be
+// none) or were dropped by the Tower, and how much of the air the Console used.
+
+#include <Arduino.h>
+#include <math.h>
+
+#include "Host.h"
+#include "Board.h"
+#include "Air.h"
+#include "SimTower.h"
+#include <Simon_Common.h>
+#include <Simon_Wire.h>
+#include <Network.h>
+
+#define TICK_US 1000ULL // one trip around the Console's loop()
+#define WARMUP_S 10 // let the link estimates settle before measuring
+#define TAIL_S 3 // after the last change, time for stragglers
+#define RING 4096 // packets remembered
+#define MAX_SAMPLES 65536
+
+static SimTower towers[N_COLORS];
+
+// the Console's packets, by unwrapped sequence number
+static unsigned long lastSeq;
+static unsigned long long changeAt[RING]; // us; 0 if the packet carried no light change
+static unsigned long covered[N_COLORS]; // last sequence each Tower's state covers
+
+// a light change waiting for its packet
+static unsigned long long pendingAt;
+
+// fire commands waiting to fire, by Tower; us
+static unsigned long long fireAt[N_COLORS];
+static unsigned long fireLost, fireTwice;
+
+static boolean measuring;
+static unsigned long measureSeq;
+static double busy;
+static unsigned long frames;
+
+static double lightLatency[MAX_SAMPLES], fireLatency[MAX_SAMPLES];
+static unsigned long nLight, nFire;
+
+static uint32_t rng;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return ( rng );
+}
+
+static unsigned long unwrap(byte packetNumber) {
+  return ( lastSeq - (byte)((byte)lastSeq - packetNumber) );
+}
+
+static void monitor(const AirFrame &frame) {
+  if ( frame.group != D_GROUP_ID || frame.from != CONSOLE ) return;
+  if ( measuring ) busy += frame.end - frame.start;
+
+  byte packetNumber;
+  if ( !wirePacketNumber(frame.data, frame.len, packetNumber) ) return;
+  if ( measuring ) frames++;
+
+  // a new packet takes whatever change was waiting
+  if ( packetNumber != (byte)lastSeq ) {
+    lastSeq++;
+    changeAt[lastSeq % RING] = pendingAt;
+    pendingAt = 0;
+  }
+}
+
+static void applied(SimTower &tower, const AirFrame &frame) {
+  byte i = &tower - towers;
+  unsigned long seq = unwrap(tower.state.packetNumber);
+  if ( seq <= covered[i] ) return;
+
+  for ( unsigned long s = covered[i] + 1; s <= seq; s++ ) {
+    unsigned long long at = changeAt[s % RING];
+    if ( at == 0 ) continue;
+    if ( nLight < MAX_SAMPLES ) lightLatency[nLight++] = (frame.end - at) / 1000.0;
+  }
+  covered[i] = seq;
+}
+
+// the link's part: from the command to the Tower hearing it.  when it fires is syncbench's.
+static void fired(SimTower &tower, const fireInstruction &inst, unsigned long long heard, unsigned long long at) {
+  byte i = &tower - towers;
+  if ( !measuring ) return;
+  if ( fireAt[i] == 0 ) {
+    fireTwice++;
+    return;
+  }
+  if ( nFire < MAX_SAMPLES ) fireLatency[nFire++] = (heard - fireAt[i]) / 1000.0;
+  fireAt[i] = 0;
+}
+
+static void change() {
+  color c = (color)(next() % N_COLORS);
+  if ( next() % 7 == 0 ) {
+    fireInstruction inst;
+    inst.duration = 1 + next() % 254;
+    inst.effect = (flameEffect)(next() % 5);
+    network.send(c, inst);
+    if ( measuring ) {
+      // one still waiting never made it
+      if ( fireAt[c] != 0 ) fireLost++;
+      fireAt[c] = hostClock.now();
+    }
+  } else {
+    colorInstruction inst;
+    inst.red = next();
+    inst.green = next();
+    inst.blue = next();
+    network.send(c, inst);
+    if ( measuring && pendingAt == 0 ) pendingAt = hostClock.now();
+  }
+}
+
+static int compare(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return ( (x > y) - (x < y) );
+}
+
+static double percentile(double *v, unsigned long n, double p) {
+  if ( n == 0 ) return ( 0 );
+  unsigned long i = (unsigned long)(p * (n - 1) + 0.5);
+  return ( v[i] );
+}
+
+static void row(float loss, unsigned long fade, boolean reports, unsigned long seconds, uint32_t seed) {
+  // same channel and traffic for each policy
+  air.seed(seed);
+  rng = seed ? seed : 1;
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    towers[i].reports = reports;
+    air.setLoss(&towers[i], loss, fade);
+    air.setSendLoss(&towers[i], loss, fade);
+  }
+  network.begin(); // fresh link estimates
+
+  nLight = nFire = 0;
+  frames = 0;
+  busy = 0;
+  fireLost = fireTwice = 0;
+  unsigned long duplicates = 0;
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    covered[i] = lastSeq;
+    fireAt[i] = 0;
+    duplicates -= towers[i].duplicates;
+  }
+
+  unsigned long long start = hostClock.now();
+  unsigned long long measureAt = start + WARMUP_S * 1000000ULL;
+  unsigned long long stopAt = measureAt + seconds * 1000000ULL;
+  unsigned long long nextChange = start;
+  measuring = false;
+  while ( hostClock.now() < stopAt + TAIL_S * 1000000ULL ) {
+    if ( !measuring && hostClock.now() >= measureAt ) {
+      // count from here, and only changes made from here
+      measuring = true;
+      measureSeq = lastSeq;
+      for ( byte i = 0; i < N_COLORS; i++ ) covered[i] = lastSeq;
+    }
+    if ( hostClock.now() >= nextChange && hostClock.now() < stopAt ) {
+      change();
+      nextChange = hostClock.now() + (100 + next() % 300) * 1000ULL;
+    }
+    network.update();
+    hostClock.advance(TICK_US);
+  }
+
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    if ( fireAt[i] != 0 ) fireLost++;
+    duplicates += towers[i].duplicates;
+  }
+
+  qsort(lightLatency, nLight, sizeof(double), compare);
+  qsort(fireLatency, nFire, sizeof(double), compare);
+
+  printf("%5.0f%% %6s %-8s | %5.1f %5.1f %6.1f %7.1f | %5.1f %6.1f %6.1f %4lu %4lu %5lu | %5.1f%% %5.2f\n",
+         loss * 100, fade ? "fade" : "frame", reports ? "adaptive" : "fixed",
+         percentile(lightLatency, nLight, 0.5), percentile(lightLatency, nLight, 0.9),
+         percentile(lightLatency, nLight, 0.99), nLight ? lightLatency[nLight - 1] : 0,
+         percentile(fireLatency, nFire, 0.5), percentile(fireLatency, nFire, 0.99), nFire ? fireLatency[nFire - 1] : 0,
+         fireLost, fireTwice, duplicates,
+         100.0 * busy / (seconds + TAIL_S) / 1e6, (double)frames / max(1UL, lastSeq - measureSeq));
+}
+
+int main(int argc, char **argv) {
+  unsigned long seconds = 60, fade = 20000;
+  uint32_t seed = 1;
+  boolean verbose = false;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) seconds = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-f") == 0 && i + 1 < argc ) fade = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else {
+      fprintf(stderr, "usage: %s [-t s] [-s seed] [-f us] [-v]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  boardBegin(verbose);
+  Serial.begin(115200); // Console.ino's setup() would
+  air.monitor = monitor;
+
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    towers[i].begin((nodeID)(TOWER1 + i));
+    towers[i].onApply = applied;
+    towers[i].onFire = fired;
+  }
+
+  printf("linkbench: %lu s per row, 4 Towers, fades %lu us\n", seconds, fade);
+  printf("  loss   kind policy   | light ms: p50   p90    p99     max | fire ms: p50    p99    max lost  2x  drop | air   frames/packet\n");
+  const float losses[] = { 0, 0.05, 0.15, 0.3, 0.5 };
+  for ( byte l = 0; l < sizeof(losses) / sizeof(losses[0]); l++ ) {
+    for ( byte f = 0; f < 2; f++ ) {
+      if ( losses[l] == 0 && f == 1 ) continue;
+      for ( byte r = 0; r < 2; r++ ) row(losses[l], f ? fade : 0, r, seconds, seed);
+    }
+  }
+  return ( 0 );
+}
@@ -0,0 +1,25 @@
+// Runs the Console firmware on the virtual clock, printing its Serial output.
+//
+//   ./build/console [seconds] [seed]
+//
+// seconds: how much virtual time to run (default 30).  seed: value on A5, which
+// setup() feeds to randomSeed().
+
+#include <Arduino.h>
+#include "Host.h"
+#include "Sketch.h"
+#include "Board.h"
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? atof(argv[1]) : 30.0;
+  int seed = argc > 2 ? atoi(argv[2]) : 0;
+
+  boardBegin(true);
+  hostPins.setAnalog(A5, seed);
+
+  setup();
+  boardRun((unsigned long long)(seconds * 1e6));
+
+  fprintf(stderr, "console: ran %.3f s virtual\n", hostClock.now() / 1e6);
+  return ( 0 );
+}
@@ -0,0 +1,144 @@
+// Proximity mode benchmark: how fast the Console's loop() turns over while a hand hovers.
+//
+//   ./build/proxbench [options]
+//     -t s         measured virtual seconds (default 30)
+//     -s seed      hand and sensor noise seed (default 1)
+//     -n counts    sensor noise, +/- this many counts a read (default 3)
+//     -v           echo the firmware's Serial output
+//
+// Boots the Console, flips the mode switch to Proximity Mode, and then moves a hand over the
+// four color pads: it holds still over each in turn, then sweeps back and forth.  Reports
+// loop() rate and time, I2C traffic per loop(), and how much Touch::distance() wanders while
+// the hand holds still (the sensor is noisy; the filter shouldn't pass it on).  The virtual
+// clock charges the I2C bus, not the arithmetic, so float math doesn't show up here.
+
+#include <Arduino.h>
+#include <FiniteStateMachine.h>
+#include <math.h>
+
+#include "Host.h"
+#include "Sketch.h"
+#include "Board.h"
+#include "SimMPR121.h"
+#include <Simon_Common.h>
+#include <Sensor.h>
+#include <Touch.h>
+
+extern FSM simon;
+extern State idle, game, player, fanfare, test;
+
+#define HOLD_S 2 // still over each pad
+#define SWEEP_MS 1500 // across all four and back
+#define NEAR 30 // counts a hand right over a pad pulls the reading down; a touch is 40
+#define MAX_SAMPLES 1000000
+
+static uint32_t rng;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return ( rng );
+}
+
+// how far the hand pulls each pad down at 'ms' into the run; 'still' if it's holding.
+static int handOver(byte pad, unsigned long ms, boolean &still) {
+  unsigned long holdMs = HOLD_S * 1000UL * N_COLORS;
+  still = ms < holdMs;
+  float x; // hand position, in pads
+  if ( still ) x = ms / (HOLD_S * 1000UL);
+  else x = (N_COLORS - 1) * (0.5 - 0.5 * cos(2 * M_PI * (ms - holdMs) / SWEEP_MS));
+  float d = fabs(x - pad);
+  return ( d >= 1 ? 0 : (int)(NEAR * (1 - d)) );
+}
+
+static int compare(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return ( (x > y) - (x < y) );
+}
+
+static double loopMs[MAX_SAMPLES];
+
+int main(int argc, char **argv) {
+  unsigned long seconds = 30;
+  uint32_t seed = 1;
+  int noise = 3;
+  boolean verbose = false;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) seconds = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-n") == 0 && i + 1 < argc ) noise = atoi(argv[++i]);
+    else if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else {
+      fprintf(stderr, "usage: %s [-t s] [-s seed] [-n counts] [-v]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+  rng = seed ? seed : 1;
+
+  boardBegin(verbose);
+  setup();
+  boardRun(hostClock.now() + 3000000ULL); // gameplay mode falls through to idle
+
+  // the mode switch: idle goes to test, at Whiteout Mode; then Bongo, then Proximity
+  uint8_t level = digitalRead(MODE_ENABLE_PIN);
+  for ( byte flips = 0; flips < 3; flips++ ) {
+    level = !level;
+    hostPins.drive(MODE_ENABLE_PIN, level);
+    boardRun(hostClock.now() + 2000000ULL); // past the announcement
+  }
+  if ( !simon.isInState(test) ) {
+    fprintf(stderr, "proxbench: didn't reach the test modes\n");
+    return ( 1 );
+  }
+
+  // hover
+  unsigned long long start = hostClock.now(), stopAt = start + seconds * 1000000ULL;
+  unsigned long loops = 0, transactions = Wire.transactions, bytes = Wire.bytes;
+  byte lo[N_COLORS], hi[N_COLORS];
+  int lastPad = -1;
+  unsigned long spread = 0, holds = 0;
+  while ( hostClock.now() < stopAt ) {
+    unsigned long ms = (hostClock.now() - start) / 1000ULL;
+    boolean still;
+    for ( byte i = 0; i < N_COLORS; i++ ) {
+      int jitter = noise ? (int)(next() % (2 * noise + 1)) - noise : 0;
+      simMPR121.setProximity(i, handOver(i, ms, still) + jitter);
+    }
+
+    unsigned long long before = hostClock.now();
+    loop();
+    if ( loops < MAX_SAMPLES ) loopMs[loops] = (hostClock.now() - before) / 1000.0;
+    loops++;
+
+    // distance's range over each hold, after the first half second of it
+    int pad = still ? ms / (HOLD_S * 1000UL) : -1;
+    if ( pad != lastPad && lastPad >= 0 ) {
+      spread += hi[lastPad] - lo[lastPad];
+      holds++;
+    }
+    if ( pad != lastPad ) {
+      for ( byte i = 0; i < N_COLORS; i++ ) lo[i] = 255, hi[i] = 0;
+    }
+    lastPad = pad;
+    if ( still && ms % (HOLD_S * 1000UL) >= 500 ) {
+      // our look costs the bus what it costs, but it isn't the firmware's
+      unsigned long t = Wire.transactions, b = Wire.bytes;
+      byte d = touch.distance((color)pad);
+      transactions += Wire.transactions - t;
+      bytes += Wire.bytes - b;
+      lo[pad] = min(lo[pad], d);
+      hi[pad] = max(hi[pad], d);
+    }
+  }
+  transactions = Wire.transactions - transactions;
+  bytes = Wire.bytes - bytes;
+
+  unsigned long n = min(loops, (unsigned long)MAX_SAMPLES);
+  qsort(loopMs, n, sizeof(double), compare);
+  printf("proxbench: %lu s in Proximity Mode, noise +/-%d\n", seconds, noise);
+  printf("  loops/s %.1f | loop ms: p50 %.2f p99 %.2f max %.2f | I2C/loop: %.1f transactions, %.1f bytes | "
+         "distance spread holding still: %.1f\n",
+         loops / (double)seconds, loopMs[n / 2], loopMs[(unsigned long)(0.99 * (n - 1))], loopMs[n - 1],
+         (double)transactions / loops, (double)bytes / loops, holds ? (double)spread / holds : 0.0);
+  return ( 0 );
+}
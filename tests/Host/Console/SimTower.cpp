@@ -0,0 +1,152 @@
+#include "SimTower.h"
+#include "Host.h"
+
+#include <RFM12B.h>
+
+void SimTower::begin(nodeID node, boolean reports) {
+  this->node = node;
+  this->reports = reports;
+  this->sync = true;
+  this->valid = false;
+  this->fireValid = false;
+  this->lastPacketNumber = (byte)-1;
+  this->clock.begin();
+  this->setClock(0, 0, 0);
+  this->rng = node;
+  air.listen(this);
+
+  // Towers boot when they boot: stagger the first reports.
+  hostClock.schedule(hostClock.now() + REPORT_INTERVAL * 1000ULL * (node - TOWER1 + 1) / N_COLORS, report, this);
+}
+
+void SimTower::setClock(long ppm, unsigned long long boot, unsigned long jitter) {
+  this->ppm = ppm;
+  this->boot = boot;
+  this->jitter = jitter;
+}
+
+unsigned long SimTower::local(unsigned long long at) {
+  return ( (unsigned long)(((double)at * (1e6 + this->ppm) / 1e6 + this->boot) / 1000.0) );
+}
+
+// the Tower's loop gets round to something up to 'jitter' late
+unsigned long long SimTower::late() {
+  if ( this->jitter == 0 ) return ( 0 );
+  this->rng ^= this->rng << 13;
+  this->rng ^= this->rng >> 17;
+  this->rng ^= this->rng << 5;
+  return ( this->rng % this->jitter );
+}
+
+// when the loop gets to a frame that just arrived
+unsigned long long SimTower::read(const AirFrame &frame) {
+  return ( frame.end + TOWER_LOOP_US + late() );
+}
+
+// when the loop, which 'heard' it, acts on something due at local ms 'due'
+unsigned long long SimTower::act(unsigned long due, unsigned long long heard) {
+  double at = ((double)due * 1000.0 - this->boot) * 1e6 / (1e6 + this->ppm);
+  if ( at <= (double)heard ) return ( heard );
+  return ( (unsigned long long)at + late() );
+}
+
+void SimTower::hear(const AirFrame &frame) {
+  if ( frame.group != D_GROUP_ID || frame.from != CONSOLE ) return;
+  if ( frame.to == this->node ) {
+    hearFire(frame);
+    return;
+  }
+
+  unsigned long console;
+  if ( wireReadSync(frame.data, frame.len, console) ) {
+    this->clock.sample(console, local(read(frame)));
+    return;
+  }
+
+  byte packetNumber;
+  if ( wirePacketNumber(frame.data, frame.len, packetNumber) ) this->heard++;
+  boolean wasValid = this->valid;
+
+  if ( !wireApply(frame.data, frame.len, this->state, this->valid) ) {
+    this->refused++;
+    return;
+  }
+  this->applied++;
+
+  byte packetDelta = this->state.packetNumber - this->lastPacketNumber;
+  if ( wasValid && packetDelta > 1 ) this->missed += packetDelta - 1;
+  this->lastPacketNumber = this->state.packetNumber;
+
+  if ( this->onApply ) this->onApply(*this, frame);
+
+  // a new packet waits for its time
+  uint16_t at;
+  if ( packetDelta != 0 && this->onLight && wireExecuteAt(frame.data, frame.len, at) ) {
+    unsigned long long heard = read(frame);
+    unsigned long due = this->sync ? this->clock.due(at, local(heard)) : local(heard);
+    this->onLight(*this, this->state.packetNumber, act(due, heard));
+  }
+}
+
+// the report goes out on the air like any other frame, and takes its airtime.
+void SimTower::report(void *arg) {
+  SimTower *tower = (SimTower *)arg;
+
+  if ( tower->reports && tower->valid ) {
+    AirFrame frame;
+    frame.group = D_GROUP_ID;
+    frame.from = tower->node;
+    frame.to = CONSOLE;
+    frame.ackRequested = frame.isAck = false;
+    frame.len = wireReport(tower->node, tower->heard, tower->missed, frame.data);
+    frame.start = hostClock.now();
+    // at the Console's 115 kbps
+    frame.end = frame.start + (frame.len + RF12_OVERHEAD_BYTES) * 69UL;
+    air.transmit(frame, tower);
+    tower->reportsSent++;
+  }
+
+  hostClock.schedule(hostClock.now() + REPORT_INTERVAL * 1000ULL, report, arg);
+}
+
+void SimTower::hearFire(const AirFrame &frame) {
+  byte seq;
+  fireInstruction inst;
+  uint16_t at;
+  if ( !wireReadFire(frame.data, frame.len, seq, inst, at) ) return;
+
+  // the Tower gets to it on its next loop, and acks straight away
+  unsigned long long heard = read(frame);
+  if ( frame.ackRequested ) {
+    this->ackSeq = seq;
+    hostClock.schedule(heard, ack, this);
+  }
+
+  boolean duplicate = this->fireValid && seq == this->fireSeq && heard - this->fireTime < FIRE_DUPLICATE_WINDOW * 1000ULL;
+  this->fireSeq = seq;
+  this->fireValid = true;
+  this->fireTime = heard;
+  if ( duplicate ) {
+    this->duplicates++;
+    return;
+  }
+
+  this->fires++;
+  unsigned long due = this->sync ? this->clock.due(at, local(heard)) : local(heard);
+  if ( this->onFire ) this->onFire(*this, inst, heard, act(due, heard));
+}
+
+void SimTower::ack(void *arg) {
+  SimTower *tower = (SimTower *)arg;
+
+  AirFrame frame;
+  frame.group = D_GROUP_ID;
+  frame.from = tower->node;
+  frame.to = CONSOLE;
+  frame.ackRequested = false;
+  frame.isAck = true;
+  frame.len = wireFireAck(tower->ackSeq, frame.data);
+  frame.start = hostClock.now();
+  frame.end = frame.start + (frame.len + RF12_OVERHEAD_BYTES) * 69UL;
+  air.transmit(frame, tower);
+}
@@ -0,0 +1,82 @@
+// A Tower's radio side, as src/Tower/Instruction.cpp has it: rebuilds systemState from
+// the Console's keyframes and deltas, sends link reports back every REPORT_INTERVAL, and
+// acks fire commands, firing once per seq.  Its millis() runs off its own crystal; it
+// keeps the Console's time from sync frames and acts on packets and fire when they say.
+
+#ifndef SimTower_h
+#define SimTower_h
+
+#include <Arduino.h>
+#include <Simon_Common.h>
+#include <Simon_Wire.h>
+#include <Simon_Sync.h>
+
+#include "Air.h"
+
+// same as the Tower firmware
+#define REPORT_INTERVAL 1000UL // ms
+#define FIRE_DUPLICATE_WINDOW 2000UL // ms
+#define TOWER_LOOP_US 500 // from a frame arriving to the Tower acting on it
+
+class SimTower : public AirListener {
+  public:
+    // listen on the air as 'node'; 'reports' false is a Tower on the old firmware.
+    void begin(nodeID node, boolean reports = true);
+
+    // its clock: 'ppm' fast (or slow, negative), and powered up 'boot' us before the Console.
+    // its loop gets to a frame or a due instruction up to 'jitter' us late.
+    void setClock(long ppm, unsigned long long boot, unsigned long jitter);
+
+    virtual void hear(const AirFrame &frame);
+
+    // if set, called after every frame the Tower applies, with the frame.
+    void (*onApply)(SimTower &tower, const AirFrame &frame);
+
+    // if set, called when the Tower fires, with the virtual time it heard the command
+    // and the virtual time it fires (us).
+    void (*onFire)(SimTower &tower, const fireInstruction &inst, unsigned long long heard, unsigned long long at);
+
+    // if set, called for each new packet, with the virtual time the Tower shows it (us).
+    void (*onLight)(SimTower &tower, byte packetNumber, unsigned long long at);
+
+    // false: the old firmware, which doesn't report.
+    boolean reports;
+    // false: the firmware before clock sync, which acts on everything as it arrives.
+    boolean sync;
+
+    // what the Tower has
+    systemState state;
+    boolean valid;
+
+    // counters: frames applied and refused; what goes in the reports.
+    unsigned long applied, refused, reportsSent;
+    unsigned int heard, missed;
+    // fire commands carried out, and repeats acked but not fired
+    unsigned long fires, duplicates;
+
+    ClockSync clock;
+
+  private:
+    static void report(void *arg);
+    static void ack(void *arg);
+    void hearFire(const AirFrame &frame);
+
+    // the Tower's millis() at a virtual time, and the virtual time its loop acts on a local ms.
+    unsigned long local(unsigned long long at);
+    unsigned long long act(unsigned long due, unsigned long long heard);
+    unsigned long long read(const AirFrame &frame);
+    unsigned long long late();
+    long ppm;
+    unsigned long long boot;
+    unsigned long jitter;
+    uint32_t rng;
+
+    byte fireSeq, ackSeq;
+    boolean fireValid;
+    unsigned long long fireTime;
+
+    nodeID node;
+    byte lastPacketNumber;
+};
+
+#endif
@@ -0,0 +1,81 @@
+// Smoke test for the host build: boot the Console, play a one-step game by
+// touching red, and check the radio, WAV Trigger and state machine saw it.
+//
+//   ./build/smoke [-v]
+//
+// -v echoes the sketch's Serial output.
+
+#include <Arduino.h>
+#include <FiniteStateMachine.h>
+#include "Host.h"
+#include "Check.h"
+#include "Sketch.h"
+#include "Board.h"
+#include "Air.h"
+#include "SimMPR121.h"
+#include "SimWavTrigger.h"
+#include <Simon_Common.h>
+#include <Sound.h>
+
+extern FSM simon;
+extern State idle, game, player, fanfare, test;
+
+// longest single loop(), us.  nothing should spin the loop.
+static unsigned long long slowest = 0;
+#define MAX_LOOP_US 250000ULL
+static unsigned long loops = 0;
+
+// run loop() until the FSM is in 'state', or give up at 'limit' (s)
+static bool runUntil(State &state, double limit) {
+  while ( !simon.isInState(state) && hostClock.now() < limit * 1e6 ) {
+    unsigned long long before = hostClock.now();
+    loop();
+    loops++;
+    slowest = max(slowest, hostClock.now() - before);
+  }
+  return ( simon.isInState(state) );
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+  boardBegin(verbose);
+  // a stuck busy-wait shouldn't hang the test run
+  hostClock.setDeadline(120 * 1000000ULL);
+
+  setup();
+  CHECK(air.frames >= 2); // Network::begin times two sends
+  CHECK(simMPR121.writes > 0);
+  CHECK(simWav.masterGain() == MASTER_GAIN);
+
+  // Touch reads the sensors once per loop(), whoever asks
+  unsigned long statusReads = simMPR121.statusReads;
+
+  // test modes fall through to gameplay, then idle
+  CHECK(runUntil(idle, 10));
+
+  // touch red
+  simMPR121.pressAt(I_RED, hostClock.now() + 200000ULL);
+  simMPR121.releaseAt(I_RED, hostClock.now() + 400000ULL);
+  CHECK(runUntil(game, 15));
+  CHECK(runUntil(player, 20));
+  CHECK(simWav.plays > 0);
+  CHECK(simWav.lastPlayed >= trTones[0] && simWav.lastPlayed <= trTones[N_COLORS - 1]);
+
+  // the sequence went out to the Towers
+  unsigned long frames = air.frames;
+  CHECK(frames > 2);
+
+  // no answer: player times out, consolation fanfare, back to idle
+  CHECK(runUntil(fanfare, 30));
+  CHECK(runUntil(idle, 60));
+  CHECK(slowest < MAX_LOOP_US);
+  statusReads = (simMPR121.statusReads - statusReads) / 2; // two status registers a read
+  CHECK(statusReads <= loops);
+
+  printf("smoke: %s, %.3f s virtual, %lu radio frames, %lu I2C transactions, %lu WAV frames, slowest loop %.1f ms, "
+         "%.2f touch reads/loop\n",
+         failures ? "FAILED" : "ok", hostClock.now() / 1e6, air.frames, Wire.transactions, simWav.frames, slowest / 1e3,
+         (double)statusReads / loops);
+  return ( failures ? 1 : 0 );
+}
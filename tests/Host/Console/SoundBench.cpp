@@ -0,0 +1,311 @@
+// Sound benchmark: what stopping and starting tones costs on the WAV Trigger's serial link.
+//
+//   ./build/soundbench [options]
+//     -r rounds    game rounds, each a step longer than the last (default 12)
+//     -t s         virtual seconds of each tone start run (default 30)
+//     -s seed      colors and timing seed (default 1)
+//     -v           echo the firmware's Serial output
+//
+// Plays a game at Sound's level against the simulated WAV Trigger: music underneath, each
+// round the sequence a tone at a time and then the player's presses, stopTones() after every
+// one, and a win to finish with stopAll().  Twice: stopping as Sound used to, asking the board
+// what's playing and waiting on the reply (kept here as a reference), then from Sound's own
+// voices.  Reports the time each stop holds the loop, and the bytes either way on the link.
+// Checks that no tone is left sounding after a stop, and how often Sound's voices agree with
+// the board's, sampled every 100 ms.
+//
+// Then tone starts: bongo's drums, a hit every 60-250 ms; and proximity mode's four tones with
+// a gain change for each every 2 ms loop, a tone started on top now and then.  Straight to the
+// board as Sound used to send them, then through its queue.  Reports how long each start took
+// to reach the board, the gain changes asked for and sent, and how long the loop was held up
+// on a full UART.  Checks the queue's starts are bounded and the last gains all got there.
+
+#include <Arduino.h>
+
+#include "Host.h"
+#include "Check.h"
+#include "SimWavTrigger.h"
+#include <Simon_Common.h>
+#include <Sound.h>
+
+#define STEP_MS 350 // a tone in the sequence, before it's stopped
+#define GAP_MS 100
+#define PRESS_MS 250 // a player's press
+#define MUSIC_MS 20000UL // the simulated board's track lengths: the music ends mid-game
+#define SAMPLE_MS 100
+#define LOOP_MS 2 // a proximity mode loop()
+#define HITS_MAX 4096
+
+//------ as it was
+
+static void oldStopTones() {
+  int tr[14];
+  wav.getPlayingTracks(tr);
+  for ( byte i = 0; i < 14; i++ ) {
+    if ( tr[i] > 0 && tr[i] <= N_TONES ) wav.trackStop(tr[i]);
+  }
+}
+
+static void oldStopAll() {
+  int tr[14];
+  wav.getPlayingTracks(tr);
+  for ( byte i = 0; i < 14; i++ ) {
+    if ( tr[i] > 0 ) wav.trackStop(tr[i]);
+  }
+  wav.stopAllTracks();
+}
+
+//------
+
+struct Run {
+  const char *name;
+  boolean tracker;
+  unsigned long stops, samples, agreed, leftSounding;
+  unsigned long long blockedUs, worstUs;
+  unsigned long txBytes, rxBytes, asks;
+};
+
+static Run *run;
+static unsigned long long nextSample;
+
+// the loop, a millisecond a turn, for 'ms'
+static void play(unsigned long ms) {
+  unsigned long long until = hostClock.now() + ms * 1000ULL;
+  while ( hostClock.now() < until ) {
+    if ( run->tracker ) sound.update();
+    hostClock.advance(1000);
+
+    if ( run->tracker && hostClock.now() >= nextSample ) {
+      nextSample += SAMPLE_MS * 1000ULL;
+      boolean same = sound.voices() == simWav.voices();
+      for ( int t = 1; t < WAV_SIM_TRACKS && same; t++ ) {
+        if ( sound.playing(t) != simWav.playing(t) ) same = false;
+      }
+      run->samples++;
+      run->agreed += same;
+    }
+  }
+}
+
+static void timed(void (*stop)()) {
+  unsigned long long before = hostClock.now();
+  stop();
+  unsigned long long spent = hostClock.now() - before;
+  run->stops++;
+  run->blockedUs += spent;
+  run->worstUs = max(run->worstUs, spent);
+}
+
+static void stopTones() {
+  if ( run->tracker ) sound.stopTones();
+  else oldStopTones();
+}
+
+static void stopAll() {
+  if ( run->tracker ) sound.stopAll();
+  else oldStopAll();
+}
+
+// a tone, then stopped once the bytes are through
+static void tone(byte color, unsigned long ms) {
+  sound.playTone(color);
+  play(ms);
+  timed(stopTones);
+  play(GAP_MS);
+  for ( int t = 1; t <= N_TONES; t++ ) {
+    if ( simWav.playing(t) ) run->leftSounding++;
+  }
+}
+
+static void game(Run &r, int rounds, unsigned int seed) {
+  run = &r;
+  sound.begin();
+  unsigned long tx = Serial2.txBytes, rx = Serial2.rxBytes, asks = simWav.commands[CMD_GET_STATUS];
+  nextSample = hostClock.now();
+
+  randomSeed(seed);
+  byte sequence[64];
+  sound.playRock();
+  for ( int round = 0; round < rounds; round++ ) {
+    sequence[round] = random(N_COLORS);
+    for ( int s = 0; s <= round; s++ ) tone(sequence[s], STEP_MS);
+    for ( int s = 0; s <= round; s++ ) tone(sequence[s], PRESS_MS);
+    // the music's over: on again
+    if ( !simWav.playing(trRock[0]) ) sound.playRock();
+  }
+
+  int win = sound.playWins();
+  play(3000);
+  sound.fadeTrack(win);
+  play(2000);
+  timed(stopAll);
+  play(GAP_MS);
+  CHECK(simWav.voices() == 0);
+
+  r.txBytes = Serial2.txBytes - tx;
+  r.rxBytes = Serial2.rxBytes - rx;
+  r.asks = simWav.commands[CMD_GET_STATUS] - asks;
+}
+
+//------ tone starts
+
+static int compare(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return ( (x > y) - (x < y) );
+}
+
+struct Traffic {
+  const char *name;
+  boolean queued; // through Sound, or straight out as it was
+  boolean gains; // proximity mode's, every loop
+  unsigned long hits, gainsAsked, gainsSent, txBytes;
+  unsigned long long blockedUs, runUs;
+  double latency[HITS_MAX]; // ms
+};
+
+// as it was
+static void oldPlay(int track, int gain) {
+  wav.trackGain(track, gain);
+  wav.trackPlayPoly(track);
+}
+
+static void traffic(Traffic &t, unsigned long seconds, unsigned int seed) {
+  sound.begin();
+  for ( int i = 0; i < 100; i++ ) {
+    sound.update();
+    hostClock.advance(LOOP_MS * 1000ULL);
+  }
+
+  // proximity mode's tones, on and quiet
+  int lastGain[N_COLORS];
+  if ( t.gains ) {
+    for ( byte c = 0; c < N_COLORS; c++ ) {
+      lastGain[c] = -40;
+      if ( t.queued ) {
+        sound.playTone(c);
+        sound.setVolume(trTones[c], lastGain[c]);
+      } else {
+        oldPlay(trTones[c], lastGain[c]);
+      }
+    }
+  }
+
+  unsigned long tx = Serial2.txBytes, gains = simWav.commands[CMD_TRACK_VOLUME], plays = 0;
+  randomSeed(seed);
+  unsigned long long start = hostClock.now(), stopAt = start + seconds * 1000000ULL;
+  unsigned long long nextHit = start + random(60, 250) * 1000ULL, hitAt = 0;
+  for ( unsigned long turn = 0; hostClock.now() < stopAt; turn++ ) {
+    unsigned long long turnStart = hostClock.now();
+    if ( t.queued ) sound.update();
+
+    if ( t.gains ) {
+      for ( byte c = 0; c < N_COLORS; c++ ) {
+        lastGain[c] = -40 + (turn * 7 + c * 13) % 40;
+        t.gainsAsked++;
+        if ( t.queued ) sound.setVolume(trTones[c], lastGain[c]);
+        else wav.trackGain(trTones[c], lastGain[c]);
+      }
+    }
+
+    if ( !hitAt && hostClock.now() >= nextHit ) {
+      byte c = random(N_COLORS);
+      hitAt = hostClock.now();
+      plays = simWav.plays;
+      if ( t.gains ) {
+        if ( t.queued ) sound.playTone(c);
+        else oldPlay(trTones[c], TONE_GAIN);
+      } else {
+        if ( t.queued ) sound.playDrumSound(c);
+        else oldPlay(trDrum[0] + c, TONE_GAIN);
+      }
+      nextHit = hostClock.now() + random(60, 250) * 1000ULL;
+    }
+    if ( hitAt && simWav.plays != plays ) {
+      if ( t.hits < HITS_MAX ) t.latency[t.hits++] = (simWav.lastPlayedAt - hitAt) / 1e3;
+      hitAt = 0;
+    }
+
+    t.blockedUs += hostClock.now() - turnStart;
+    hostClock.advanceTo(max(hostClock.now(), turnStart + LOOP_MS * 1000ULL));
+  }
+  t.runUs = hostClock.now() - start;
+
+  // what's still waiting goes, and the board ends up where it was last asked to be
+  for ( int i = 0; i < 100; i++ ) {
+    if ( t.queued ) sound.update();
+    hostClock.advance(LOOP_MS * 1000ULL);
+  }
+  if ( t.gains ) {
+    for ( byte c = 0; c < N_COLORS; c++ ) CHECK(simWav.gain(trTones[c]) == lastGain[c]);
+  }
+  t.txBytes = Serial2.txBytes - tx;
+  t.gainsSent = simWav.commands[CMD_TRACK_VOLUME] - gains;
+  qsort(t.latency, t.hits, sizeof(double), compare);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  int rounds = 12;
+  unsigned long seconds = 30;
+  unsigned int seed = 1;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-r") == 0 && i + 1 < argc ) rounds = atoi(argv[++i]);
+    else if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) seconds = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [-r rounds] [-t s] [-s seed] [-v]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+  rounds = constrain(rounds, 1, 64);
+
+  hostBegin();
+  Serial.echo(verbose);
+  for ( int t = trRock[0]; t <= trRock[1]; t++ ) simWav.setTrackLength(t, MUSIC_MS);
+
+  Run runs[2] = {};
+  runs[0].name = "status read";
+  runs[1].name = "voice tracker";
+  runs[1].tracker = true;
+  for ( int i = 0; i < 2; i++ ) {
+    game(runs[i], rounds, seed);
+    CHECK(runs[i].leftSounding == 0);
+  }
+  // music that ends on its own, Sound hears about by the next reconcile: out for up to
+  // WAV_RECONCILE each time
+  CHECK(sound.replies > 0);
+  CHECK(runs[1].samples - runs[1].agreed <= WAV_RECONCILE / SAMPLE_MS * sound.mismatches + 1);
+
+  printf("  %d rounds, %lu stops  | blocked ms: mean    max | TX bytes  RX bytes  status asks\n", rounds, runs[0].stops);
+  for ( int i = 0; i < 2; i++ ) {
+    Run &r = runs[i];
+    printf("  %-20s |           %5.2f  %5.2f | %8lu  %8lu  %11lu\n", r.name, r.blockedUs / 1e3 / r.stops,
+           r.worstUs / 1e3, r.txBytes, r.rxBytes, r.asks);
+  }
+  printf("  voices as the board's: %lu of %lu samples; %lu reconciles, %lu replies, %lu put right\n",
+         runs[1].agreed, runs[1].samples, sound.reconciles, sound.replies, sound.mismatches);
+
+  static Traffic traffics[4] = {};
+  const char *names[4] = { "bongo", "bongo, queued", "proximity", "proximity, queued" };
+  printf("  tone starts          | hits  to the board ms: p50   max | gains asked   sent | TX bytes  loop held\n");
+  for ( int i = 0; i < 4; i++ ) {
+    Traffic &t = traffics[i];
+    t.name = names[i];
+    t.queued = i % 2;
+    t.gains = i >= 2;
+    traffic(t, seconds, seed);
+    CHECK(t.hits > seconds * 3);
+
+    double p50 = t.hits ? t.latency[t.hits / 2] : 0, most = t.hits ? t.latency[t.hits - 1] : 0;
+    printf("  %-20s | %4lu              %5.2f %5.2f |    %8lu %6lu | %8lu  %8.1f%%\n", t.name, t.hits, p50, most,
+           t.gainsAsked, t.gainsSent, t.txBytes, 100.0 * t.blockedUs / t.runUs);
+
+    // through the queue: no more than WAV_IN_FLIGHT bytes ahead, the start's own, and a loop
+    if ( t.queued ) CHECK(most * 1000 <= (WAV_IN_FLIGHT + 17) * WAV_BYTE_US + LOOP_MS * 1000);
+  }
+  printf("  as Sound has it: last tone start %.2f ms, most %.2f ms; %lu commands queued, %lu coalesced, %lu sent\n",
+         sound.toneLatency / 1e3, sound.toneLatencyMax / 1e3, sound.queued, sound.coalesced, sound.sent);
+  printf("soundbench: %s\n", failures ? "FAILED" : "ok");
+  return ( failures ? 1 : 0 );
+}
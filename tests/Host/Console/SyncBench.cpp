@@ -0,0 +1,245 @@
+// Tower clock sync benchmark: how far apart four Towers act on the same beat.
+//
+//   ./build/syncbench [options]
+//     -t s         measured virtual seconds per row (default 60)
+//     -s seed      channel, clock and traffic seed (default 1)
+//     -p ppm       Tower crystals are off by up to this, either way (default 100)
+//     -j us        Tower loops get to things up to this late (default 2000)
+//     -v           echo the firmware's Serial output
+//
+// The traffic is the Fanfare's: a beat every 333-600 ms puts new colors on every Tower and
+// fires one to four of them.  Each Tower has its own crystal error and power-up time.  Each
+// row is one loss rate, both ways, with Towers on the firmware before clock sync (act on a
+// packet when it arrives) or with it (act at the Console's time the packet carries).
+// Reports, over beats, the skew between the first and last Tower to show the beat's packet
+// and to fire, how long after the beat Towers show it, and beats a Tower never showed (it
+// missed that packet, and caught up on a later one) or fire that never fired.
+
+#include <Arduino.h>
+#include <math.h>
+
+#include "Host.h"
+#include "Board.h"
+#include "Air.h"
+#include "SimTower.h"
+#include <Simon_Common.h>
+#include <Simon_Wire.h>
+#include <Network.h>
+
+#define TICK_US 1000ULL // one trip around the Console's loop()
+#define WARMUP_S 10 // link estimates and clocks settle
+#define TAIL_S 3 // after the last beat, time for stragglers
+#define RING 4096 // packets and beats remembered
+#define MAX_SAMPLES 65536
+
+static SimTower towers[N_COLORS];
+
+// a beat: when it was made, and when each Tower showed it and fired; us, 0 if it didn't.
+typedef struct {
+  unsigned long long at;
+  unsigned long long light[N_COLORS], fire[N_COLORS];
+  boolean firing[N_COLORS];
+} beat;
+static beat beats[RING];
+static unsigned long nBeats;
+
+// the Console's packets, by unwrapped sequence number, and the beat each carried (or -1)
+static unsigned long lastSeq;
+static long packetBeat[RING];
+static long pendingBeat;
+
+static boolean measuring;
+
+static uint32_t rng;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return ( rng );
+}
+
+static unsigned long unwrap(byte packetNumber) {
+  return ( lastSeq - (byte)((byte)lastSeq - packetNumber) );
+}
+
+static void monitor(const AirFrame &frame) {
+  byte packetNumber;
+  if ( frame.group != D_GROUP_ID || frame.from != CONSOLE ) return;
+  if ( !wirePacketNumber(frame.data, frame.len, packetNumber) ) return;
+
+  // a new packet takes the beat that was waiting
+  if ( packetNumber != (byte)lastSeq ) {
+    lastSeq++;
+    packetBeat[lastSeq % RING] = pendingBeat;
+    pendingBeat = -1;
+  }
+}
+
+static void shown(SimTower &tower, byte packetNumber, unsigned long long at) {
+  byte i = &tower - towers;
+  long b = packetBeat[unwrap(packetNumber) % RING];
+  if ( b >= 0 && beats[b % RING].light[i] == 0 ) beats[b % RING].light[i] = at;
+}
+
+// the Tower's last fire command is this beat's; the Tower fires each seq once.
+static long fireBeat[N_COLORS];
+static void fired(SimTower &tower, const fireInstruction &inst, unsigned long long heard, unsigned long long at) {
+  byte i = &tower - towers;
+  if ( fireBeat[i] < 0 ) return;
+  beats[fireBeat[i] % RING].fire[i] = at;
+  fireBeat[i] = -1;
+}
+
+// every Tower gets a color, and the Fanfare's mix of fire: mostly one Tower, sometimes all.
+static void onBeat() {
+  long b = measuring ? (long)nBeats++ : -1;
+  if ( b >= 0 ) memset(&beats[b % RING], 0, sizeof(beat));
+  if ( b >= 0 ) beats[b % RING].at = hostClock.now();
+
+  for ( byte c = 0; c < N_COLORS; c++ ) {
+    colorInstruction inst;
+    inst.red = next();
+    inst.green = next();
+    inst.blue = next();
+    network.send((color)c, inst);
+  }
+
+  const byte mix[] = { 1, 1, 1, 1, 2, 2, 3, 4, 0 };
+  byte n = mix[next() % sizeof(mix)];
+  byte first = next() % N_COLORS;
+  const byte order[N_COLORS] = { 0, 2, 1, 3 }; // the tower, its opposite, then the others
+  for ( byte k = 0; k < n; k++ ) {
+    color c = (color)((first + order[k]) % N_COLORS);
+    // off, then on: the same fire as last time is still a new command
+    fireInstruction inst;
+    inst.duration = 0;
+    inst.effect = veryRich;
+    network.send(c, inst);
+    inst.duration = 5 + next() % 20;
+    network.send(c, inst);
+    fireBeat[c] = b;
+    if ( b >= 0 ) beats[b % RING].firing[c] = true;
+  }
+
+  pendingBeat = b;
+}
+
+static int compare(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return ( (x > y) - (x < y) );
+}
+
+static double percentile(double *v, unsigned long n, double p) {
+  if ( n == 0 ) return ( 0 );
+  unsigned long i = (unsigned long)(p * (n - 1) + 0.5);
+  return ( v[i] );
+}
+
+static double lightSkew[MAX_SAMPLES], fireSkew[MAX_SAMPLES], lag[MAX_SAMPLES];
+
+static void row(float loss, boolean sync, unsigned long seconds, uint32_t seed, long ppm, unsigned long jitter) {
+  // same channel, clocks and traffic for both firmwares
+  air.seed(seed);
+  rng = seed ? seed : 1;
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    towers[i].sync = sync;
+    towers[i].setClock((long)(next() % (2 * ppm + 1)) - ppm, (next() % 10000) * 1000ULL, jitter);
+    towers[i].clock.begin(); // a new crystal: the old samples are no use
+    air.setLoss(&towers[i], loss);
+    air.setSendLoss(&towers[i], loss);
+    fireBeat[i] = -1;
+  }
+  network.begin(); // fresh link estimates
+  nBeats = 0;
+  pendingBeat = -1;
+
+  unsigned long long start = hostClock.now();
+  unsigned long long measureAt = start + WARMUP_S * 1000000ULL;
+  unsigned long long stopAt = measureAt + seconds * 1000000ULL;
+  unsigned long long nextBeat = start;
+  measuring = false;
+  while ( hostClock.now() < stopAt + TAIL_S * 1000000ULL ) {
+    if ( !measuring && hostClock.now() >= measureAt ) measuring = true;
+    if ( hostClock.now() >= nextBeat && hostClock.now() < stopAt ) {
+      onBeat();
+      nextBeat = hostClock.now() + (333 + next() % 267) * 1000ULL;
+    }
+    network.update();
+    hostClock.advance(TICK_US);
+  }
+
+  unsigned long nLight = 0, nFire = 0, nLag = 0, unshown = 0, unfired = 0;
+  for ( unsigned long b = 0; b < nBeats && b < RING; b++ ) {
+    beat &x = beats[b];
+    unsigned long long lo[2] = { ~0ULL, ~0ULL }, hi[2] = { 0, 0 };
+    byte n[2] = { 0, 0 };
+    for ( byte i = 0; i < N_COLORS; i++ ) {
+      if ( x.light[i] ) {
+        lo[0] = min(lo[0], x.light[i]);
+        hi[0] = max(hi[0], x.light[i]);
+        n[0]++;
+        lag[nLag++] = (x.light[i] - x.at) / 1000.0;
+      } else {
+        unshown++;
+      }
+      if ( !x.firing[i] ) continue;
+      if ( x.fire[i] ) {
+        lo[1] = min(lo[1], x.fire[i]);
+        hi[1] = max(hi[1], x.fire[i]);
+        n[1]++;
+      } else {
+        unfired++;
+      }
+    }
+    if ( n[0] > 1 ) lightSkew[nLight++] = (hi[0] - lo[0]) / 1000.0;
+    if ( n[1] > 1 ) fireSkew[nFire++] = (hi[1] - lo[1]) / 1000.0;
+  }
+
+  qsort(lightSkew, nLight, sizeof(double), compare);
+  qsort(fireSkew, nFire, sizeof(double), compare);
+  qsort(lag, nLag, sizeof(double), compare);
+
+  printf("%5.0f%% %-6s | %5.1f %5.1f %6.1f | %5.1f %5.1f %6.1f | %5.1f %5.1f %6.1f | %5lu %4lu  (%lu beats)\n",
+         loss * 100, sync ? "sync" : "off",
+         percentile(lightSkew, nLight, 0.5), percentile(lightSkew, nLight, 0.99), nLight ? lightSkew[nLight - 1] : 0,
+         percentile(fireSkew, nFire, 0.5), percentile(fireSkew, nFire, 0.99), nFire ? fireSkew[nFire - 1] : 0,
+         percentile(lag, nLag, 0.5), percentile(lag, nLag, 0.99), nLag ? lag[nLag - 1] : 0,
+         unshown, unfired, nBeats);
+}
+
+int main(int argc, char **argv) {
+  unsigned long seconds = 60, jitter = 2000;
+  long ppm = 100;
+  uint32_t seed = 1;
+  boolean verbose = false;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) seconds = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-p") == 0 && i + 1 < argc ) ppm = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-j") == 0 && i + 1 < argc ) jitter = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else {
+      fprintf(stderr, "usage: %s [-t s] [-s seed] [-p ppm] [-j us] [-v]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+  if ( seconds > 600 ) seconds = 600; // the beats fit the ring
+
+  boardBegin(verbose);
+  Serial.begin(115200); // Console.ino's setup() would
+  air.monitor = monitor;
+
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    towers[i].begin((nodeID)(TOWER1 + i));
+    towers[i].onLight = shown;
+    towers[i].onFire = fired;
+  }
+
+  printf("syncbench: %lu s per row, 4 Towers, clocks +/-%ld ppm, loop jitter %lu us\n", seconds, ppm, jitter);
+  printf("  loss towers | light skew ms: p50 p99  max | fire skew: p50 p99  max | lag ms: p50   p99    max | unshown unfired\n");
+  const float losses[] = { 0, 0.15, 0.3 };
+  for ( byte l = 0; l < sizeof(losses) / sizeof(losses[0]); l++ ) {
+    for ( byte s = 0; s < 2; s++ ) row(losses[l], s, seconds, seed, ppm, jitter);
+  }
+  return ( 0 );
+}
@@ -0,0 +1,245 @@
+// Touch event test: replays recorded touches into the MPR121 and checks that the Touch
+// event ring hands every press and release to its reader, in order, stamped on time.
+//
+//   ./build/touchtest [-v] [-s seed] [trace ...]
+//
+// Traces are gamesim scripts, "<ms> <electrode> down|up" per line (record one with
+// gamesim -w); the default is traces/game.trace and traces/mash.trace.  Touch runs alone
+// under a loop() that takes 1-20 ms, and now and then 20-60 ms, as the Console's does.
+// Each trace runs with the IRQ, polling, and with the IRQ enabled but not wired (Touch
+// should notice the first change it reads and poll from then on; touches before that,
+// between its occasional reads, are lost).
+// Reports, from a finger landing, how late the event's stamp is and how late the reader
+// got it, and the status reads per loop().  Edges that land while an IRQ is already
+// waiting to be read share its stamp, so with the IRQ a stamp may be early, never late.
+// Last, a touch that lands inside update(), after it took the IRQ flag and before it read
+// the status: the IRQ for it came in, so Touch keeps using it.
+
+#include <Arduino.h>
+#include "Host.h"
+#include "Check.h"
+#include "Board.h"
+#include "SimMPR121.h"
+#include <Simon_Common.h>
+#include <Touch.h>
+
+#define MAX_EDGES 1024
+#define MAX_SAMPLES 4096
+#define TAIL_US 500000ULL // after the last edge, time to read it
+#define IRQ_STAMP_MS 1 // the IRQ's stamp may be this late; millis() ticks in whole ms
+
+//------ the trace
+
+typedef struct {
+  unsigned long long at; // us, from the start of the run
+  byte electrode;
+  boolean down;
+  boolean seen;
+} edge;
+static edge edges[MAX_EDGES];
+static int nEdges;
+
+static int loadTrace(const char *file) {
+  FILE *f = fopen(file, "r");
+  if ( f == NULL ) {
+    perror(file);
+    exit(2);
+  }
+  char line[128], dir[16];
+  unsigned long ms;
+  int electrode;
+  nEdges = 0;
+  while ( fgets(line, sizeof(line), f) && nEdges < MAX_EDGES ) {
+    if ( line[0] == '#' ) continue;
+    if ( sscanf(line, "%lu %d %15s", &ms, &electrode, dir) != 3 || electrode >= N_BUTTONS ) continue;
+    edges[nEdges].at = ms * 1000ULL;
+    edges[nEdges].electrode = electrode;
+    edges[nEdges].down = strcmp(dir, "down") == 0;
+    edges[nEdges].seen = false;
+    nEdges++;
+  }
+  fclose(f);
+  return ( nEdges );
+}
+
+// one edge at a time, so a long trace doesn't fill the clock's queue
+static unsigned long long start;
+static int applied;
+static void apply(void *arg) {
+  edge &x = edges[applied++];
+  simMPR121.touch(x.electrode, x.down);
+  if ( applied < nEdges ) hostClock.schedule(start + edges[applied].at, apply);
+}
+
+//------ the loop
+
+static uint32_t rng;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return ( rng );
+}
+
+// how long the rest of the Console's loop() takes, us
+static unsigned long long loopTime() {
+  if ( next() % 20 == 0 ) return ( (20 + next() % 41) * 1000ULL );
+  return ( (1 + next() % 20) * 1000ULL );
+}
+
+static int compare(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return ( (x > y) - (x < y) );
+}
+
+static double percentile(double *v, unsigned long n, double p) {
+  if ( n == 0 ) return ( 0 );
+  unsigned long i = (unsigned long)(p * (n - 1) + 0.5);
+  return ( v[i] );
+}
+
+static double stampLag[MAX_SAMPLES], readLag[MAX_SAMPLES];
+
+enum mode { M_IRQ, M_POLL, M_UNWIRED };
+static const char *modeName[] = { "irq", "poll", "unwired" };
+
+static void run(const char *name, mode m, uint32_t seed) {
+  byte sensorIndex[N_BUTTONS];
+  for ( byte i = 0; i < N_BUTTONS; i++ ) sensorIndex[i] = i;
+
+  simMPR121.releaseAll();
+  simMPR121.setIrqPin(m == M_UNWIRED ? 0xFF : TOUCH_IRQ);
+  CHECK(touch.begin(sensorIndex, m != M_POLL));
+  rng = seed ? seed : 1;
+
+  for ( int k = 0; k < nEdges; k++ ) edges[k].seen = false;
+  int seen = 0;
+  unsigned long n = 0, wrong = 0;
+  unsigned long long firstRead = 0; // when the reader first got an event
+
+  start = hostClock.now() + 100000ULL;
+  applied = 0;
+  hostClock.schedule(start + edges[0].at, apply);
+  unsigned long long stopAt = start + edges[nEdges - 1].at + TAIL_US;
+  unsigned long statusReads = simMPR121.statusReads, loops = 0;
+
+  while ( hostClock.now() < stopAt ) {
+    touch.update();
+    loops++;
+
+    touchEvent e;
+    while ( touch.event(e) ) {
+      // a read sees the button as its last edge left it
+      int k = applied - 1;
+      while ( k >= 0 && edges[k].electrode != e.index ) k--;
+      if ( k < 0 || edges[k].down != e.pressed || edges[k].seen ) {
+        wrong++;
+        continue;
+      }
+      edges[k].seen = true;
+      seen++;
+      if ( firstRead == 0 ) firstRead = hostClock.now();
+
+      unsigned long long at = start + edges[k].at;
+      long stamp = (long)(e.time - (unsigned long)(at / 1000ULL));
+      if ( m == M_IRQ ) CHECK(stamp <= IRQ_STAMP_MS);
+      if ( n < MAX_SAMPLES ) {
+        stampLag[n] = stamp;
+        readLag[n] = (hostClock.now() - at) / 1000.0;
+        n++;
+      }
+    }
+
+    hostClock.advance(loopTime());
+  }
+  statusReads = (simMPR121.statusReads - statusReads) / 2; // two status registers a read
+
+  CHECK(applied == nEdges);
+  CHECK(wrong == 0);
+  // unwired, Touch reads now and then until it sees a change, and polls from then on
+  for ( int k = 0; k < nEdges; k++ ) {
+    if ( m != M_UNWIRED || start + edges[k].at > firstRead ) CHECK(edges[k].seen);
+  }
+  CHECK(touch.eventsDropped() == 0);
+  if ( m == M_IRQ ) CHECK(statusReads * 4 < loops); // reads when something changed, and now and then
+  if ( m == M_POLL ) CHECK(statusReads == loops);
+
+  qsort(stampLag, n, sizeof(double), compare);
+  qsort(readLag, n, sizeof(double), compare);
+  printf("  %-12s %-7s | %5d %5d %7lu | %4.0f %4.0f %4.0f | %5.1f %5.1f %5.1f | %.2f\n",
+         name, modeName[m], nEdges, seen, touch.eventsDropped(),
+         percentile(stampLag, n, 0.5), percentile(stampLag, n, 0.99), n ? stampLag[n - 1] : 0,
+         percentile(readLag, n, 0.5), percentile(readLag, n, 0.99), n ? readLag[n - 1] : 0,
+         (double)statusReads / loops);
+}
+
+// the IRQ comes in while update() is on the bus, for the change it's reading
+static void touchNow(void *arg) {
+  simMPR121.touch(0, arg != NULL);
+}
+
+static void race() {
+  byte sensorIndex[N_BUTTONS];
+  for ( byte i = 0; i < N_BUTTONS; i++ ) sensorIndex[i] = i;
+  simMPR121.releaseAll();
+  simMPR121.setIrqPin(TOUCH_IRQ);
+  CHECK(touch.begin(sensorIndex, true));
+
+  int events = 0;
+  for ( int k = 0; k < 10; k++ ) {
+    // past the occasional read, so update() goes to the bus whatever the flag said
+    hostClock.advance((TOUCH_POLL_INTERVAL + 10) * 1000ULL);
+    hostClock.schedule(hostClock.now() + 1, touchNow, (void *)(k % 2 == 0 ? &events : NULL));
+    touch.update();
+    touchEvent e;
+    while ( touch.event(e) ) events++;
+  }
+  CHECK(events == 10);
+
+  // and it's still on the IRQ: no reads while nothing changes
+  unsigned long statusReads = simMPR121.statusReads;
+  for ( int l = 0; l < 20; l++ ) {
+    touch.update();
+    hostClock.advance(2000);
+  }
+  CHECK(simMPR121.statusReads == statusReads);
+  printf("  an IRQ inside update() | %d of 10 edges, %lu reads in 20 quiet loops\n", events,
+         (simMPR121.statusReads - statusReads) / 2);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  uint32_t seed = 1;
+  const char *traces[16];
+  int nTraces = 0;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atol(argv[++i]);
+    else if ( argv[i][0] != '-' && nTraces < 16 ) traces[nTraces++] = argv[i];
+    else {
+      fprintf(stderr, "usage: %s [-v] [-s seed] [trace ...]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+  if ( nTraces == 0 ) {
+    traces[nTraces++] = "traces/game.trace";
+    traces[nTraces++] = "traces/mash.trace";
+  }
+
+  boardBegin(verbose);
+  Serial.begin(115200); // Console.ino's setup() would
+
+  printf("  trace        touch   | edges  seen dropped | stamp ms: p50 p99 max | read ms: p50   p99   max | reads/loop\n");
+  for ( int t = 0; t < nTraces; t++ ) {
+    if ( loadTrace(traces[t]) == 0 ) {
+      fprintf(stderr, "touchtest: %s: no touches\n", traces[t]);
+      return ( 2 );
+    }
+    const char *name = strrchr(traces[t], '/') ? strrchr(traces[t], '/') + 1 : traces[t];
+    for ( byte m = M_IRQ; m <= M_UNWIRED; m++ ) run(name, (mode)m, seed);
+  }
+  race();
+
+  printf("touchtest: %s, %.1f s virtual\n", failures ? "FAILED" : "ok", hostClock.now() / 1e6);
+  return ( failures ? 1 : 0 );
+}
@@ -0,0 +1,149 @@
+// Track index test: the Console's table of what's on the WAV Trigger's card (Tracks.h), against
+// the files, as Sound looks it up and as Fanfare uses it.
+//
+//   ./build/tracktest [-v] [-d dir]
+//
+// Every WAV file in 'dir' (../../tones) must be in the table, at the length and peak read off
+// it here and looped whole (none of ours has a 'smpl' chunk); if not, 'make tracks'.  Every
+// entry must be found by Sound::lookupTrack(), and track numbers between them not.  Then
+// Fanfare's lengths: its level's for music the index doesn't know, the music's own when it's
+// shorter or only a little longer.
+
+#include <Arduino.h>
+#include <glob.h>
+
+#include "Host.h"
+#include "Check.h"
+#include <Simon_Common.h>
+#include <Sound.h>
+#include <Fanfare.h>
+
+extern unsigned long fitToMusic(int track, unsigned long length); // Fanfare.cpp
+
+//------ the files
+
+// length (ms) and peak (dBFS, rounded up) of a 16-bit PCM WAV, as simply as it can be read
+static boolean readWav(const char *path, unsigned long &length, int &peak) {
+  FILE *f = fopen(path, "rb");
+  if ( !f ) return ( false );
+  unsigned char h[12], c[8];
+  boolean ok = fread(h, 1, 12, f) == 12 && !memcmp(h, "RIFF", 4) && !memcmp(h + 8, "WAVE", 4);
+  unsigned int channels = 0, rate = 0;
+  while ( ok && fread(c, 1, 8, f) == 8 ) {
+    uint32_t size = c[4] | (c[5] << 8) | (c[6] << 16) | ((uint32_t)c[7] << 24);
+    if ( !memcmp(c, "fmt ", 4) ) {
+      unsigned char fmt[16];
+      ok = fread(fmt, 1, 16, f) == 16 && fmt[0] == 1 && fmt[14] == 16;
+      channels = fmt[2];
+      rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16);
+      fseek(f, size - 16 + (size & 1), SEEK_CUR);
+    } else if ( !memcmp(c, "data", 4) ) {
+      ok = ok && channels && rate;
+      if ( !ok ) break;
+      length = (unsigned long)((unsigned long long)(size / (2 * channels)) * 1000 / rate);
+      int most = 0;
+      int16_t s;
+      for ( uint32_t i = 0; i < size / 2 && fread(&s, 2, 1, f) == 1; i++ ) most = max(most, abs((int)s));
+      peak = most ? (int)ceil(20.0 * log10(most / 32768.0)) : -96;
+      fclose(f);
+      return ( true );
+    } else {
+      fseek(f, size + (size & 1), SEEK_CUR);
+    }
+  }
+  fclose(f);
+  return ( false );
+}
+
+static int files(const char *dir) {
+  char pattern[512];
+  snprintf(pattern, sizeof(pattern), "%s/[0-9][0-9][0-9]*.wav", dir);
+  glob_t g;
+  CHECK(glob(pattern, 0, NULL, &g) == 0);
+  int n = 0;
+  for ( size_t i = 0; i < g.gl_pathc; i++ ) {
+    const char *path = g.gl_pathv[i], *name = strrchr(path, '/') + 1;
+    unsigned long length = 0;
+    int peak = 0;
+    CHECK(readWav(path, length, peak));
+    int track = atoi(name);
+
+    trackInfo info;
+    boolean there = sound.lookupTrack(track, info);
+    if ( !there ) fprintf(stderr, "tracktest: %s isn't in the index; make tracks\n", name);
+    CHECK(there);
+    if ( !there ) continue;
+    CHECK(info.track == track);
+    CHECK(info.length == length);
+    CHECK(info.peak == peak);
+    CHECK(info.loopStart == 0 && info.loopEnd == length);
+    CHECK(sound.trackLength(track) == length);
+    n++;
+  }
+  globfree(&g);
+  return ( n );
+}
+
+//------ the lookup
+
+static void lookup() {
+  trackInfo info;
+  int last = 0;
+  for ( int i = 0; i < N_TRACK_INFO; i++ ) {
+    trackInfo entry;
+    memcpy_P(&entry, &trackTable[i], sizeof(trackInfo));
+    CHECK(entry.track > last); // sorted, no repeats
+    CHECK(sound.lookupTrack(entry.track, info));
+    CHECK(memcmp(&info, &entry, sizeof(trackInfo)) == 0);
+    for ( int t = last + 1; t < entry.track; t++ ) CHECK(!sound.lookupTrack(t, info));
+    CHECK(entry.length > 0 && entry.loopEnd <= entry.length && entry.loopStart < entry.loopEnd);
+    last = entry.track;
+  }
+  CHECK(!sound.lookupTrack(0, info) && !sound.lookupTrack(last + 1, info) && !sound.lookupTrack(1000, info));
+  CHECK(sound.trackLength(last + 1) == 0);
+}
+
+//------ Fanfare
+
+static void fanfare() {
+  // nothing we know of: the level's length
+  CHECK(sound.trackLength(trWins[1] + 1) == 0);
+  CHECK(fitToMusic(trWins[1] + 1, 18000UL) == 18000UL);
+
+  for ( int i = 0; i < N_TRACK_INFO; i++ ) {
+    trackInfo entry;
+    memcpy_P(&entry, &trackTable[i], sizeof(trackInfo));
+    unsigned long music = entry.length;
+    // music that's shorter: ends with it
+    CHECK(fitToMusic(entry.track, music + 1000UL) == music);
+    // a little longer: runs on to its end
+    CHECK(fitToMusic(entry.track, music > 1000UL ? music - 1000UL : 0) == music);
+    // a lot longer: the level's length, and a fade
+    if ( music > FANFARE_RUN_ON + 1000UL ) CHECK(fitToMusic(entry.track, music - FANFARE_RUN_ON - 1000UL) == music - FANFARE_RUN_ON - 1000UL);
+  }
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  const char *dir = "../../tones";
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-d") == 0 && i + 1 < argc ) dir = argv[++i];
+    else {
+      fprintf(stderr, "usage: %s [-v] [-d dir]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  hostBegin();
+  Serial.echo(verbose);
+
+  lookup();
+  int n = files(dir);
+  CHECK(n > 0);
+  fanfare();
+
+  printf("  %d tracks in the index, %d files in %s as it has them\n", N_TRACK_INFO, n, dir);
+  printf("tracktest: %s\n", failures ? "FAILED" : "ok");
+  return ( failures ? 1 : 0 );
+}
@@ -0,0 +1,120 @@
+// Radio wire format test: plays games on the Console while four Towers listen
+// through a lossy channel and reassemble systemState from keyframes and deltas.
+//
+//   ./build/wiretest [-v] [loss]
+//
+// Every time a Tower applies a frame, its state must match a lossless reference
+// receiver; once play stops, every Tower must catch up.  Reports airtime against
+// the full-state frames the Console used to send.  The Towers send link reports,
+// so the Console sizes its resends for the loss.  loss defaults to 0.3.
+
+#include <Arduino.h>
+#include <FiniteStateMachine.h>
+#include "Host.h"
+#include "Check.h"
+#include "Sketch.h"
+#include "Board.h"
+#include "Air.h"
+#include "SimMPR121.h"
+#include "SimTower.h"
+#include <RFM12B.h>
+#include <Simon_Common.h>
+#include <Simon_Wire.h>
+
+extern FSM simon;
+extern State idle, game, player, fanfare, test;
+extern color gameSequence[];
+extern int gameCurrent, playerCurrent;
+
+// every time a Tower applies a frame it should agree with the reference, which heard it first.
+static SimTower reference, towers[N_COLORS];
+static unsigned long mismatches;
+static void applied(SimTower &tower, const AirFrame &frame) {
+  if ( memcmp(&tower.state, &reference.state, sizeof(systemState)) != 0 ) mismatches++;
+}
+
+// airtime, and what the same frames would have cost as a bare systemState
+static unsigned long keyframes, deltas, bytes;
+static double busy, fullBusy;
+static void monitor(const AirFrame &frame) {
+  byte packetNumber;
+  if ( frame.group != D_GROUP_ID || frame.from != CONSOLE || !wirePacketNumber(frame.data, frame.len, packetNumber) ) return;
+  if ( (frame.data[0] & 0x0F) == W_KEYFRAME ) keyframes++;
+  else deltas++;
+  bytes += frame.len;
+  busy += frame.end - frame.start;
+  fullBusy += (double)(frame.end - frame.start) * (sizeof(systemState) + RF12_OVERHEAD_BYTES) / (frame.len + RF12_OVERHEAD_BYTES);
+}
+
+// press now, let go a bit later
+static void tap(int electrode) {
+  simMPR121.pressAt(electrode, hostClock.now() + 300000ULL);
+  simMPR121.releaseAt(electrode, hostClock.now() + 450000ULL);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  float loss = 0.3;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else loss = atof(argv[i]);
+  }
+
+  boardBegin(verbose);
+  hostClock.setDeadline(600 * 1000000ULL);
+  air.monitor = monitor;
+  air.seed(42);
+
+  reference.begin(TOWER1, false);
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    towers[i].begin((nodeID)(TOWER1 + i));
+    towers[i].onApply = applied;
+    air.setLoss(&towers[i], loss);
+  }
+
+  setup();
+
+  // three games, playing the sequence back correctly until the 8th step
+  int games = 0;
+  int lastPlayer = -1;
+  unsigned long long nextTouch = 0;
+  while ( games < 3 && hostClock.now() < 400 * 1000000ULL ) {
+    boolean wasFanfare = simon.isInState(fanfare);
+    loop();
+    if ( !wasFanfare && simon.isInState(fanfare) ) games++;
+
+    if ( hostClock.now() < nextTouch || simMPR121.touched() ) continue;
+    if ( simon.isInState(idle) ) {
+      tap(I_START);
+      nextTouch = hostClock.now() + 2000000ULL;
+    } else if ( simon.isInState(player) && playerCurrent != lastPlayer && gameCurrent < 8 ) {
+      tap(gameSequence[playerCurrent]);
+      lastPlayer = playerCurrent;
+      nextTouch = hostClock.now() + 500000ULL;
+    } else if ( !simon.isInState(player) ) {
+      lastPlayer = -1;
+    }
+  }
+  CHECK(games == 3);
+
+  // quiet; keyframes bring everyone up to date
+  boardRun(hostClock.now() + 4000000ULL);
+
+  CHECK(reference.valid);
+  CHECK(keyframes > 0 && deltas > keyframes);
+  unsigned long applied = 0, refused = 0;
+  for ( byte i = 0; i < N_COLORS; i++ ) {
+    CHECK(towers[i].valid);
+    CHECK(memcmp(&towers[i].state, &reference.state, sizeof(systemState)) == 0);
+    applied += towers[i].applied;
+    refused += towers[i].refused;
+  }
+  CHECK(mismatches == 0);
+
+  printf("wiretest: %s, %.1f s virtual, %.0f%% loss: %lu keyframes, %lu deltas, %.1f bytes/frame, "
+         "airtime %.0f ms (full state: %.0f ms, %.0f%% saved); towers applied %lu, refused %lu\n",
+         failures ? "FAILED" : "ok", hostClock.now() / 1e6, loss * 100, keyframes, deltas,
+         (double)bytes / (keyframes + deltas), busy / 1e3, fullBusy / 1e3, 100.0 * (1 - busy / fullBusy),
+         applied, refused);
+  return ( failures ? 1 : 0 );
+}
@@ -0,0 +1,252 @@
+// Light color tables test: the tables, and the animations and fills that use them, give the
+// bytes the code they replaced gave; and what they save.
+//
+//   ./build/colortest [-v] [-s seed]
+//
+// The old Wheel(), rainbowGlow() and per-pixel setStripColor() are kept here as references.
+// Checks, bit for bit: wheelTable against Wheel()'s arithmetic at all 256 positions;
+// rainbowGlow() against the old one, frame by frame; setStripColor()'s doubling copy against
+// a setPixelColor() a pixel, with and without brightness; gammaTable against its formula;
+// the rim composited from the background, a pixel a row, and the effect, pixel by pixel; and
+// the rim composited with gamma against the curve applied to the plain composite.
+// Then prints host ns per call, old and new, and the charged cycles of the fills.
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include <FastLED.h>
+#include <math.h>
+#include <time.h>
+
+#include "Host.h"
+#include "Check.h"
+#include "Sketch.h"
+#include <Strip.h>
+
+#define FRAMES 3000
+#define TIMED_CALLS 20001
+
+extern Adafruit_NeoMatrix rimJob, rimBack, rimEffect;
+
+//------ as they were
+
+static uint32_t oldWheel(Adafruit_NeoPixel &strip, byte WheelPos) {
+  WheelPos = 255 - WheelPos;
+  if ( WheelPos < 85 ) {
+    return strip.Color(255 - WheelPos * 3, 0, WheelPos * 3);
+  } else if ( WheelPos < 170 ) {
+    WheelPos -= 85;
+    return strip.Color(0, WheelPos * 3, 255 - WheelPos * 3);
+  } else {
+    WheelPos -= 170;
+    return strip.Color(WheelPos * 3, 255 - WheelPos * 3, 0);
+  }
+}
+
+static void oldRainbowGlow(Adafruit_NeoPixel &strip, int r, int g, int b, void *posData) {
+  int *pos = (int *)posData;
+  int next = (*pos);
+  for ( int i = 0; i < strip.numPixels(); i++ ) {
+    strip.setPixelColor(i, oldWheel(strip, (byte)((i + next) % 255)));
+  }
+  next += random(1, 5);
+  (*pos) = next;
+}
+
+static void oldSetStripColor(Adafruit_NeoPixel &strip, uint32_t c) {
+  for ( int i = 0; i < strip.numPixels(); i++ ) {
+    strip.setPixelColor(i, c);
+  }
+}
+
+//------
+
+static double hostNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( ts.tv_sec * 1e9 + ts.tv_nsec );
+}
+
+static void wheel() {
+  Adafruit_NeoPixel strip(1);
+  for ( int p = 0; p < 256; p++ ) CHECK(Wheel(strip, p) == oldWheel(strip, p));
+}
+
+static uint8_t frames[FRAMES][PLACARD_N * 3];
+
+static void rainbow(unsigned int seed) {
+  Adafruit_NeoPixel strip(PLACARD_N);
+  strip.setBrightness(100);
+
+  randomSeed(seed);
+  int pos = 0;
+  for ( int f = 0; f < FRAMES; f++ ) {
+    oldRainbowGlow(strip, 0, 0, 0, &pos);
+    memcpy(frames[f], strip.getPixels(), sizeof(frames[f]));
+  }
+
+  randomSeed(seed);
+  pos = 0;
+  int same = 0;
+  for ( int f = 0; f < FRAMES; f++ ) {
+    rainbowGlow(strip, 0, 0, 0, &pos);
+    same += memcmp(frames[f], strip.getPixels(), sizeof(frames[f])) == 0;
+  }
+  CHECK(same == FRAMES);
+}
+
+static void fill() {
+  const uint32_t colors[] = { 0, Adafruit_NeoPixel::Color(255, 100, 0), Adafruit_NeoPixel::Color(1, 2, 3) };
+  const uint8_t brightness[] = { 255, 40 };
+  for ( byte b = 0; b < sizeof(brightness); b++ ) {
+    for ( byte c = 0; c < sizeof(colors) / sizeof(colors[0]); c++ ) {
+      Adafruit_NeoPixel was(BUTTON_N), is(BUTTON_N);
+      was.setBrightness(brightness[b]);
+      is.setBrightness(brightness[b]);
+      oldSetStripColor(was, colors[c]);
+      setStripColor(is, colors[c]);
+      CHECK(memcmp(was.getPixels(), is.getPixels(), BUTTON_N * 3) == 0);
+    }
+  }
+}
+
+static void gammaCurve() {
+  for ( int i = 0; i < 256; i++ ) CHECK(GAMMA8(i) == (int)(255 * pow(i / 255.0, GAMMA) + 0.5));
+  CHECK(GAMMA8(0) == 0 && GAMMA8(255) == 255);
+}
+
+// the rim, one layer (the copy) and two (the blend), with the curve and without
+static void composite() {
+  static uint8_t plain[RIM_X * RIM_Y * 3];
+  const uint16_t n = rimJob.numPixels();
+  for ( int layers = 1; layers <= 2; layers++ ) {
+    for ( uint16_t i = 0; i < n; i++ ) rimEffect.setPixelColor(i, Wheel(rimEffect, i));
+    compositor.drawn(rimEffect);
+    if ( layers == 2 ) {
+      for ( uint16_t i = 0; i < rimBack.numPixels(); i++ ) rimBack.setPixelColor(i, Wheel(rimBack, 255 - 80 * i));
+      compositor.drawn(rimBack);
+      compositor.brightness(rimBack, IDLE_UNDER_PRESS);
+    } else {
+      compositor.clear(rimBack);
+    }
+
+    compositor.gamma(rimJob, false);
+    compositor.update();
+    memcpy(plain, rimJob.getPixels(), n * 3);
+    if ( layers == 2 ) {
+      // the background's a pixel a row, along the whole row, under the effect
+      int right = 0;
+      const CRGB *effect = (const CRGB *)rimEffect.getPixels(), *back = (const CRGB *)rimBack.getPixels();
+      for ( uint16_t i = 0; i < n; i++ ) {
+        CRGB c = back[i / RIM_X];
+        c.nscale8(IDLE_UNDER_PRESS);
+        c += effect[i];
+        right += memcmp(&c, plain + i * 3, 3) == 0;
+      }
+      CHECK(right == n);
+    }
+    compositor.gamma(rimJob, true);
+    compositor.update();
+
+    int same = 0;
+    for ( uint16_t k = 0; k < n * 3; k++ ) same += rimJob.getPixels()[k] == GAMMA8(plain[k]);
+    CHECK(same == n * 3);
+  }
+  compositor.gamma(rimJob, RIM_GAMMA);
+  compositor.brightness(rimBack, 255);
+
+  // a row drawn on the background lights the rim's row, as a matrix animation has it
+  for ( int16_t y = 0; y < RIM_Y; y++ ) {
+    rimLayers(false, false);
+    rimEffect.drawPixel(RIM_X / 2, y, rimEffect.Color(255, 255, 255));
+    int inRow = -1;
+    for ( uint16_t i = 0; i < n; i++ ) if ( rimEffect.getPixelColor(i) ) inRow = i / RIM_X;
+    rimEffect.drawPixel(RIM_X / 2, y, 0);
+    rimLayers(true, false);
+    rimBack.drawPixel(0, y, rimBack.Color(255, 0, 0));
+    compositor.drawn(rimBack);
+    compositor.update();
+    int lit = 0, there = 0;
+    for ( uint16_t i = 0; i < n; i++ ) {
+      if ( !rimJob.getPixelColor(i) ) continue;
+      lit++;
+      there += (int)(i / RIM_X) == inRow;
+    }
+    CHECK(lit == RIM_X && there == RIM_X);
+  }
+  rimLayers(false, false);
+  compositor.update();
+}
+
+//------ what it saves
+
+static double timeWheel(uint32_t (*w)(Adafruit_NeoPixel &, byte)) {
+  Adafruit_NeoPixel strip(1);
+  volatile uint32_t sink = 0;
+  double before = hostNs();
+  for ( int i = 0; i < TIMED_CALLS; i++ ) sink += w(strip, i & 0xFF);
+  return ( (hostNs() - before) / TIMED_CALLS );
+}
+
+static double timeRainbow(void (*glow)(Adafruit_NeoPixel &, int, int, int, void *)) {
+  Adafruit_NeoPixel strip(PLACARD_N);
+  int pos = 0;
+  double before = hostNs();
+  for ( int i = 0; i < TIMED_CALLS; i++ ) glow(strip, 0, 0, 0, &pos);
+  return ( (hostNs() - before) / TIMED_CALLS );
+}
+
+static unsigned long long fillCycles(void (*fill)(Adafruit_NeoPixel &, uint32_t), uint8_t brightness) {
+  Adafruit_NeoPixel strip(BUTTON_N);
+  strip.setBrightness(brightness);
+  unsigned long long before = hostClock.cyclesSpent();
+  fill(strip, strip.Color(255, 100, 0));
+  return ( hostClock.cyclesSpent() - before );
+}
+
+static void fillNew(Adafruit_NeoPixel &strip, uint32_t c) {
+  setStripColor(strip, c);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  unsigned int seed = 1;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [-v] [-s seed]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  hostBegin();
+  Serial.echo(verbose);
+  setup();
+
+  wheel();
+  rainbow(seed);
+  fill();
+  gammaCurve();
+  composite();
+
+  // the best of a few rounds, as the host has other things to do
+  double wheelNs[2] = { 1e9, 1e9 }, glowNs[2] = { 1e9, 1e9 };
+  for ( int round = 0; round < 5; round++ ) {
+    wheelNs[0] = min(wheelNs[0], timeWheel(oldWheel));
+    wheelNs[1] = min(wheelNs[1], timeWheel(Wheel));
+    glowNs[0] = min(glowNs[0], timeRainbow(oldRainbowGlow));
+    glowNs[1] = min(glowNs[1], timeRainbow(rainbowGlow));
+  }
+  char what[32];
+  printf("  host ns per call       |    old    new\n");
+  printf("  %-22s | %6.1f %6.1f\n", "Wheel()", wheelNs[0], wheelNs[1]);
+  snprintf(what, sizeof(what), "rainbowGlow(), %d LEDs", PLACARD_N);
+  printf("  %-22s | %6.1f %6.1f\n", what, glowNs[0], glowNs[1]);
+  printf("  cycles charged         |    old    new\n");
+  snprintf(what, sizeof(what), "setStripColor(), %d", BUTTON_N);
+  printf("  %-22s | %6llu %6llu\n", what, fillCycles(oldSetStripColor, 255), fillCycles(fillNew, 255));
+  printf("  %-22s | %6llu %6llu\n", "...at brightness 40", fillCycles(oldSetStripColor, 40), fillCycles(fillNew, 40));
+
+  printf("colortest: %s\n", failures ? "FAILED" : "ok");
+  return ( failures ? 1 : 0 );
+}
@@ -0,0 +1,500 @@
+// Light module benchmark: what each animation costs the Light's Mega, frame by frame.
+//
+//   ./build/lightbench [options]
+//     -f frames    frames per animation (default 1000)
+//     -t s         virtual seconds per Light mode, for the sketch as a whole (default 10)
+//     -s seed      randomSeed() (default 1)
+//     -d dir       dump each animation's frames to dir/<animation>.ppm
+//     -v           echo the sketch's Serial output
+//
+// Runs the Light sketch's setup(), then each animation in Animations.cpp on the strip and
+// config Strip.cpp gives it, at that config's frame rate, with inputs like the ones
+// mapToAnimation() feeds it.  The NeoPixel stand-in charges the cycles the Mega spends
+// setting and reading pixels, random() charges its 32-bit math, and show() charges the
+// time the strip's bits take on the wire, with interrupts off.  The animations' own
+// arithmetic and NeoMatrix's remapping aren't charged, so the CPU column is a floor.
+// Then the sketch's loop() runs in each Light mode, as the Console would ask for it, and
+// reports the share of the Mega that's busy and how often each strip shows.  Last,
+// mapToAnimation() on its own: host time per call and stack depth, per mode.
+// In between, the rim's gameplay animation runs straight on the rim, as it did before the
+// compositor, and then on a layer over the idle rainbow in each blend mode; lib8tion's
+// math is charged (hal/FastLED.h), so the composite column is what blending costs.  And
+// palette-indexed strips (IndexedStrip.h) of each length the Light has: the RAM they take
+// against an RGB strip's, and what expanding them to the wire costs show().
+//
+// A dump is a binary PPM: one row per frame, one pixel per LED in wire order, as the
+// LEDs showed it (brightness and all).  Any image viewer opens it.
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include <Adafruit_NeoMatrix.h>
+#include <FastLED.h>
+#include <time.h>
+
+#include "Host.h"
+#include "Sketch.h"
+#include <Simon_Common.h>
+#include <Strip.h>
+
+#define MAX_FRAMES 100000
+
+// the sketch's strips, configs and animation state; Strip.cpp
+extern Adafruit_NeoMatrix rimJob;
+extern IndexedStrip redL, grnL, bluL, yelL;
+extern Adafruit_NeoPixel buttonPixels, cirL, placL;
+extern systemState inst;
+extern ConcurrentAnimator animator;
+extern Adafruit_NeoMatrix rimBack, rimEffect;
+extern AnimationConfig rimConfig, rimBackConfig, rimConfigStrip, redButtonConfig, circleConfig, placardConfig;
+extern ProxPulsePosition proxPulsePos, idlePos;
+extern GameplayPosition gameplayPos;
+extern TronCycles tronCycles[MAX_CYCLES];
+extern TronPosition tronPosition;
+extern RgbColor red, green, blue, yellow;
+
+//------ per animation
+
+// the Console's inputs for frame 'f', as mapToAnimation() would pass them on
+static void noInputs(unsigned long f) {}
+
+static void proximityInputs(unsigned long f) {
+  // a hand comes and goes every two seconds
+  rimConfig.position = &proxPulsePos;
+  proxPulsePos.magnitude = (f / 60) % 2 ? 10 : 60;
+  rimConfig.color.red = 255;
+  rimConfig.color.green = 100;
+  rimConfig.color.blue = 0;
+}
+
+static void gameplayInputs(unsigned long f) {
+  // a button lit for 15 frames, in turn
+  rimConfig.position = &gameplayPos;
+  byte lit = (f / 15) % (2 * N_COLORS);
+  rimConfig.color.red = lit == I_RED ? 255 : 0;
+  rimConfig.color.green = lit == I_GRN ? 255 : 0;
+  rimConfig.color.blue = lit == I_BLU ? 255 : 0;
+  gameplayPos.yellow = lit == I_YEL ? 255 : 0;
+}
+
+static void tronInputs(unsigned long f) {
+  // bongo: now and then a pad gets hit, and a cycle or two sets off from it
+  const uint32_t at[N_COLORS] = { RED_X, GRN_X, BLU_X, YEL_X };
+  const RgbColor color[N_COLORS] = { red, green, blue, yellow };
+  byte live = 0;
+  for ( byte c = 0; c < MAX_CYCLES; c++ ) live += tronCycles[c].live;
+
+  tronPosition.addCycle = f % 8 == 0 && live < MAX_CYCLES - 1;
+  byte pad = (f / 8) % N_COLORS;
+  tronPosition.x = at[pad];
+  tronPosition.y = ALL_Y;
+  rimConfigStrip.color = color[pad];
+}
+
+static void tronFullInputs(unsigned long f) {
+  // every slot live going into the frame (the crashed ones set off again, uncharged), and
+  // one more in it, so the oldest makes way for it
+  const uint32_t at[N_COLORS] = { RED_X, GRN_X, BLU_X, YEL_X };
+  const RgbColor color[N_COLORS] = { red, green, blue, yellow };
+  for ( byte c = 0; tronPosition.live < MAX_CYCLES; c++ ) {
+    RgbColor k = color[c % N_COLORS];
+    addCycle(*rimConfigStrip.strip, &tronPosition, at[c % N_COLORS], ALL_Y, rimJob.Color(k.red, k.green, k.blue));
+  }
+
+  tronPosition.addCycle = true;
+  byte pad = f % N_COLORS;
+  tronPosition.x = at[pad];
+  tronPosition.y = ALL_Y;
+  rimConfigStrip.color = color[pad];
+}
+
+typedef struct {
+  const char *name;
+  AnimateFunc strip;
+  AnimateMatrixFunc matrix;
+  AnimateIndexedFunc indexed;
+  AnimationConfig *config;
+  unsigned long period; // ms; the config's Metro
+  void (*inputs)(unsigned long f);
+} animation;
+
+static const animation animations[] = {
+  { "laserWipe", NULL, NULL, laserWipe, &redButtonConfig, 50, noInputs },
+  { "twinkleRand", NULL, NULL, twinkleRand, &redButtonConfig, 50, noInputs },
+  { "rainbowGlow", rainbowGlow, NULL, NULL, &placardConfig, 1000, noInputs },
+  { "colorWipe", colorWipe, NULL, NULL, &circleConfig, 100, noInputs },
+  { "idleMatrix", NULL, idleMatrix, NULL, &rimBackConfig, 50, noInputs },
+  { "proximityPulseMatrix", NULL, proximityPulseMatrix, NULL, &rimConfig, 30, proximityInputs },
+  { "gameplayMatrix", NULL, gameplayMatrix, NULL, &rimConfig, 20, gameplayInputs },
+  { "tronLightCycles", tronLightCycles, NULL, NULL, &rimConfigStrip, 30, tronInputs },
+  { "tronLightCycles x50", tronLightCycles, NULL, NULL, &rimConfigStrip, 30, tronFullInputs },
+};
+#define N_ANIMATIONS (sizeof(animations) / sizeof(animations[0]))
+
+// frames go to the dump as they're shown
+static FILE *dump;
+static Adafruit_NeoPixel *dumping;
+static void shown(Adafruit_NeoPixel &strip) {
+  if ( !dump || &strip != dumping ) return;
+  for ( uint16_t i = 0; i < strip.numPixels(); i++ ) {
+    uint32_t c = strip.shownColor(i);
+    fputc(c >> 16, dump);
+    fputc(c >> 8, dump);
+    fputc(c, dump);
+  }
+}
+
+static int compare(const void *a, const void *b) {
+  unsigned long x = *(const unsigned long *)a, y = *(const unsigned long *)b;
+  return ( (x > y) - (x < y) );
+}
+
+static unsigned long cycles[MAX_FRAMES];
+
+static void bench(const animation &a, unsigned long frames, const char *dir) {
+  AnimationConfig &config = *a.config;
+  // the buttons show through buttonPixels
+  Adafruit_NeoPixel &strip = a.indexed ? buttonPixels : a.matrix ? *config.matrix : *config.strip;
+
+  // a dark strip to start
+  if ( a.indexed ) {
+    config.indexed->clear();
+    config.indexed->show();
+  } else {
+    strip.clear();
+    strip.show();
+  }
+
+  if ( dir ) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.ppm", dir, a.name);
+    dump = fopen(path, "wb");
+    if ( dump == NULL ) {
+      perror(path);
+      exit(2);
+    }
+    fprintf(dump, "P6\n%u %lu\n255\n", strip.numPixels(), frames);
+    dumping = &strip;
+  }
+
+  unsigned long long showUs = 0;
+  for ( unsigned long f = 0; f < frames; f++ ) {
+    unsigned long long frameStart = hostClock.now();
+    a.inputs(f);
+
+    unsigned long long before = hostClock.cyclesSpent();
+    if ( a.indexed ) a.indexed(*config.indexed, config.color.red, config.color.green, config.color.blue, config.position);
+    else if ( a.matrix ) a.matrix(*config.matrix, config.color.red, config.color.green, config.color.blue, config.position);
+    else a.strip(*config.strip, config.color.red, config.color.green, config.color.blue, config.position);
+    cycles[f] = hostClock.cyclesSpent() - before;
+
+    unsigned long long showStart = hostClock.now();
+    if ( a.indexed ) config.indexed->show();
+    else strip.show();
+    showUs += hostClock.now() - showStart;
+
+    hostClock.advanceTo(frameStart + a.period * 1000ULL);
+  }
+  if ( dump ) fclose(dump);
+  dump = NULL;
+
+  unsigned long long total = 0;
+  for ( unsigned long f = 0; f < frames; f++ ) total += cycles[f];
+  qsort(cycles, frames, sizeof(unsigned long), compare);
+  double cpuUs = (double)total / frames / HOST_CPU_MHZ;
+  double wireUs = (double)showUs / frames;
+  printf("  %-20s %4u %5lu | %7.0f %7lu %7lu | %7.0f %6.0f | %5.1f%%\n",
+         a.name, strip.numPixels(), a.period, (double)total / frames, cycles[(unsigned long)(0.99 * (frames - 1))],
+         cycles[frames - 1], cpuUs, wireUs, 100.0 * (cpuUs + wireUs) / (a.period * 1000.0));
+}
+
+//------ compositing the rim
+
+typedef struct {
+  const char *name;
+  boolean layered; // false: gameplayMatrix straight on the rim, as before the compositor
+  boolean idle; // the idle rainbow underneath
+  byte idleBrightness, mode, alpha;
+} composition;
+
+static const composition compositions[] = {
+  { "single writer", false, false, 255, BLEND_ADD, 255 },
+  { "effect layer", true, false, 255, BLEND_ADD, 255 },
+  { "idle + press, add", true, true, 255, BLEND_ADD, 255 },
+  { "idle dim + press, add", true, true, IDLE_UNDER_PRESS, BLEND_ADD, 255 },
+  { "idle dim + press, max", true, true, IDLE_UNDER_PRESS, BLEND_MAX, 255 },
+  { "idle dim + press, alpha", true, true, IDLE_UNDER_PRESS, BLEND_ALPHA, 128 },
+};
+#define N_COMPOSITIONS (sizeof(compositions) / sizeof(compositions[0]))
+
+static unsigned long composed[MAX_FRAMES];
+
+// gameplayMatrix at its 20 ms, with idleMatrix at its 50 ms underneath, one composite a frame
+static void compose(const composition &c, unsigned long frames) {
+  const unsigned long period = 20;
+  rimConfig.position = &gameplayPos;
+  rimJob.clear();
+  rimJob.setBrightness(255);
+  compositor.clear(rimBack);
+  compositor.clear(rimEffect);
+  compositor.layer(rimJob, L_EFFECT, rimEffect, c.mode, 255, c.alpha);
+  compositor.brightness(rimBack, c.idleBrightness);
+  compositor.update();
+
+  unsigned long long drawTotal = 0;
+  for ( unsigned long f = 0; f < frames; f++ ) {
+    unsigned long long frameStart = hostClock.now();
+    gameplayInputs(f);
+
+    unsigned long long before = hostClock.cyclesSpent();
+    if ( c.idle && f * period / 50 != (f + 1) * period / 50 ) {
+      idleMatrix(rimBack, 0, 0, 0, &idlePos);
+      compositor.drawn(rimBack);
+    }
+    Adafruit_NeoMatrix &target = c.layered ? rimEffect : rimJob;
+    gameplayMatrix(target, rimConfig.color.red, rimConfig.color.green, rimConfig.color.blue, &gameplayPos);
+    if ( c.layered ) compositor.drawn(rimEffect);
+    unsigned long long drawn = hostClock.cyclesSpent();
+    drawTotal += drawn - before;
+
+    compositor.update();
+    composed[f] = hostClock.cyclesSpent() - drawn;
+
+    hostClock.advanceTo(frameStart + period * 1000ULL);
+  }
+
+  unsigned long long total = 0;
+  for ( unsigned long f = 0; f < frames; f++ ) total += composed[f];
+  qsort(composed, frames, sizeof(unsigned long), compare);
+  double drawUs = (double)drawTotal / frames / HOST_CPU_MHZ, compositeUs = (double)total / frames / HOST_CPU_MHZ;
+  printf("  %-24s | %7.0f | %7.0f %7lu | %6.0f %6.0f | %5.1f%%\n", c.name, (double)drawTotal / frames,
+         (double)total / frames, composed[frames - 1], drawUs, compositeUs, 100.0 * (drawUs + compositeUs) / (period * 1000.0));
+
+  // as the sketch has it
+  compositor.layer(rimJob, L_EFFECT, rimEffect, BLEND_ADD);
+  rimJob.setBrightness(255);
+}
+
+//------ palette-indexed strips
+
+#define INDEXED_PIN 40 // nothing on it
+#define INDEXED_SHOWS 100
+
+// a strip of 'n' as the buttons draw it (4 bits: a background and a laser, or a twinkle), or
+// a rainbow's steps around a sixteen-color palette (8 bits); RAM against an RGB strip's, and
+// the cycles show() spends expanding it.  the wire's time is the same either way.
+static void indexed(uint16_t n, uint8_t bits) {
+  Adafruit_NeoPixel pixels(n, INDEXED_PIN, NEO_GRB + NEO_KHZ800);
+  IndexedWire wire = { pixels, INDEXED_PIN };
+  IndexedStrip strip(n, INDEXED_PIN, wire, bits);
+  strip.begin();
+
+  if ( bits == INDEX_4BIT ) {
+    for ( uint16_t i = 0; i < n; i++ ) strip.setPixelColor(i, 255, 0, 0);
+    strip.setPixelColor(n - 1, 0, 0, 255);
+    strip.setPixelColor(n / 2, random(255));
+  } else {
+    CRGBPalette16 rainbow;
+    for ( byte e = 0; e < 16; e++ ) {
+      uint32_t c = Wheel(pixels, e * 16);
+      rainbow[e] = CRGB(c >> 16, c >> 8, c);
+    }
+    strip.setPalette(rainbow);
+    for ( uint16_t i = 0; i < n; i++ ) strip.setIndex(i, i * 256UL / n);
+  }
+  strip.setBrightness(40);
+
+  unsigned long long cycles = 0;
+  for ( int k = 0; k < INDEXED_SHOWS; k++ ) {
+    unsigned long long before = hostClock.cyclesSpent();
+    strip.show();
+    cycles += hostClock.cyclesSpent() - before;
+  }
+  double perShow = (double)cycles / INDEXED_SHOWS;
+  unsigned int rgb = n * 3, mem = INDEXED_MEM(n, bits);
+  printf("  %5u %4u | %5u %5u %6d | %7.0f %6.0f %6lu\n", n, bits, rgb, mem, (int)rgb - (int)mem,
+         perShow, perShow / HOST_CPU_MHZ, (unsigned long)n * NEO_PIXEL_US);
+}
+
+//------ the sketch as a whole
+
+typedef struct {
+  const char *name;
+  byte animation; // animationInstruction
+} lightMode;
+
+static const lightMode modes[] = {
+  { "Idle", A_Idle },
+  { "Gameplay", A_Gameplay },
+  { "LaserWipe", A_LaserWipe },
+  { "ProximityPulseMatrix", A_ProximityPulseMatrix },
+  { "GameplayPressed", A_GameplayPressed },
+  { "TronCycles", A_TronCycles },
+};
+#define N_MODES (sizeof(modes) / sizeof(modes[0]))
+
+// the scheduler's strips, in the order Strip.cpp adds them
+static const uint16_t stripPixels[] = { RIM_X * RIM_Y, BUTTON_N, BUTTON_N, BUTTON_N, BUTTON_N, CIRCLE_N, PLACARD_N };
+#define N_STRIPS (sizeof(stripPixels) / sizeof(stripPixels[0]))
+
+static unsigned long allShows() {
+  unsigned long n = 0;
+  for ( byte s = 0; s < N_STRIPS; s++ ) n += showScheduler.shows(s);
+  return ( n );
+}
+
+static void run(const lightMode &m, unsigned long seconds) {
+  unsigned long shows[N_STRIPS];
+  for ( byte s = 0; s < N_STRIPS; s++ ) shows[s] = showScheduler.shows(s);
+
+  inst.animation = m.animation;
+  unsigned long long start = hostClock.now(), stopAt = start + seconds * 1000000ULL;
+  unsigned long long busy = 0, slowest = 0;
+  unsigned long loops = 0;
+  while ( hostClock.now() < stopAt ) {
+    // the Console's buttons: one lit at a time, for half a second
+    byte lit = (hostClock.now() - start) / 500000ULL % N_COLORS;
+    for ( byte c = 0; c < N_COLORS; c++ ) {
+      inst.light[c].red = inst.light[c].green = inst.light[c].blue = c == lit ? 255 : 0;
+    }
+
+    unsigned long long before = hostClock.now(), cyclesBefore = hostClock.cyclesSpent();
+    unsigned long showsBefore = allShows();
+    loop();
+    loops++;
+    unsigned long long spent = hostClock.now() - before;
+    unsigned long showsAfter = allShows();
+    // a loop() that did nothing but look at the clock and the serial port is idle
+    if ( showsAfter != showsBefore || hostClock.cyclesSpent() != cyclesBefore ) {
+      busy += spent;
+      slowest = max(slowest, spent);
+    }
+  }
+
+  // show() holds interrupts off for all of its wire time
+  unsigned long long offUs = 0;
+  for ( byte s = 0; s < N_STRIPS; s++ ) offUs += (showScheduler.shows(s) - shows[s]) * stripPixels[s] * NEO_PIXEL_US;
+  printf("  %-20s | %5.1f%% %6.1f %6.0f |", m.name, 100.0 * busy / (stopAt - start), slowest / 1e3,
+         offUs / 1e3 / seconds);
+  for ( byte s = 0; s < N_STRIPS; s++ ) printf(" %5.1f", (showScheduler.shows(s) - shows[s]) / (double)seconds);
+  printf("\n");
+}
+
+//------ mapToAnimation() itself
+
+// the host's stack, not the Mega's, but what the dispatch passes and keeps shows the same way.
+// paint() and painted() are called from the same frame, so their buffers land in the same place:
+// whatever ran between them wrote over the top of it.
+#define STACK_PAINT 16384
+// reading what's left on the stack is the point
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+static void __attribute__((noinline)) paint() {
+  volatile uint8_t buf[STACK_PAINT];
+  for ( size_t i = 0; i < STACK_PAINT; i++ ) buf[i] = 0xA5;
+}
+static size_t __attribute__((noinline)) painted() {
+  volatile uint8_t buf[STACK_PAINT];
+  size_t i = 0;
+  while ( i < STACK_PAINT && buf[i] == 0xA5 ) i++;
+  return ( STACK_PAINT - i );
+}
+#pragma GCC diagnostic pop
+
+static double hostNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( ts.tv_sec * 1e9 + ts.tv_nsec );
+}
+
+static int compareDouble(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return ( (x > y) - (x < y) );
+}
+
+#define DISPATCH_CALLS 501
+static double dispatchNs[DISPATCH_CALLS];
+
+// host time per call with no animation due, so it's the dispatch and the timers' checks; and
+// the deepest stack over a second of calls, animations and all
+static void dispatch(const lightMode &m) {
+  inst.animation = m.animation;
+  size_t deepest = 0;
+  unsigned long long stopAt = hostClock.now() + 1000000ULL;
+  while ( hostClock.now() < stopAt ) {
+    unsigned long long frameStart = hostClock.now();
+    paint();
+    mapToAnimation(animator, inst);
+    deepest = max(deepest, painted());
+    hostClock.advanceTo(frameStart + FASTER_STIRP_UPDATE * 1000ULL);
+  }
+
+  // the clock only moves for the timers' reads, so nothing comes due (the median says so).
+  // the best of a few rounds, as the host has other things to do.
+  hostClock.setReadCost(1);
+  double best = 0;
+  for ( int round = 0; round < 5; round++ ) {
+    for ( int i = 0; i < DISPATCH_CALLS; i++ ) {
+      double before = hostNs();
+      mapToAnimation(animator, inst);
+      dispatchNs[i] = hostNs() - before;
+    }
+    qsort(dispatchNs, DISPATCH_CALLS, sizeof(double), compareDouble);
+    if ( round == 0 || dispatchNs[DISPATCH_CALLS / 2] < best ) best = dispatchNs[DISPATCH_CALLS / 2];
+  }
+  hostClock.setReadCost(0);
+  printf("  %-20s | %12.0f | %11lu\n", m.name, best, (unsigned long)deepest);
+}
+
+int main(int argc, char **argv) {
+  unsigned long frames = 1000, seconds = 10;
+  unsigned int seed = 1;
+  const char *dir = NULL;
+  boolean verbose = false;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-f") == 0 && i + 1 < argc ) frames = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) seconds = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atoi(argv[++i]);
+    else if ( strcmp(argv[i], "-d") == 0 && i + 1 < argc ) dir = argv[++i];
+    else if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else {
+      fprintf(stderr, "usage: %s [-f frames] [-t s] [-s seed] [-d dir] [-v]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+  if ( frames < 1 ) frames = 1;
+  if ( frames > MAX_FRAMES ) frames = MAX_FRAMES;
+
+  hostBegin();
+  Serial.echo(verbose);
+  hostPins.setAnalog(A5, seed & 0x3FF);
+  hostClock.setDeadline((frames * 1000ULL + seconds * N_MODES) * 1000000ULL); // an animation that hangs (getPixelN() does)
+  setup();
+  randomSeed(seed);
+  neoPixelShown = shown;
+
+  printf("lightbench: %lu frames per animation, cycles at %d MHz\n", frames, HOST_CPU_MHZ);
+  printf("  animation            LEDs    ms | cycles/frame: mean     p99     max | CPU us show us | of frame\n");
+  for ( byte i = 0; i < N_ANIMATIONS; i++ ) bench(animations[i], frames, dir);
+
+  printf("\nthe rim composited, %lu frames of gameplayMatrix every 20 ms; cycles/frame\n", frames);
+  printf("  rim                      |    draw | composite     max | draw us comp us | of frame\n");
+  for ( byte i = 0; i < N_COMPOSITIONS; i++ ) compose(compositions[i], frames);
+
+  printf("\npalette-indexed strips: RAM per strip against RGB (the wire's 3n is once per wire), and show()\n");
+  printf("    LEDs bits |   RGB index  saved | expand cycles     us wire us\n");
+  const uint16_t lengths[] = { CIRCLE_N, BUTTON_N, RIM_X * RIM_Y };
+  for ( byte i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++ ) {
+    indexed(lengths[i], INDEX_4BIT);
+    indexed(lengths[i], INDEX_8BIT);
+  }
+
+  printf("\nthe sketch, %lu s per Light mode; shows/s per strip\n", seconds);
+  printf("  mode                 |  busy slowest ms irq off ms/s |   rim   red   grn   blu   yel   cir  plac\n");
+  for ( byte i = 0; i < N_MODES; i++ ) run(modes[i], seconds);
+
+  printf("\nmapToAnimation(), per call on this host\n");
+  printf("  mode                 | ns, none due | stack bytes\n");
+  for ( byte i = 0; i < N_MODES; i++ ) dispatch(modes[i]);
+  return ( 0 );
+}
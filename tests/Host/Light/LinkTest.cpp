@@ -0,0 +1,235 @@
+// Console to Light link test: frames over Serial1 while the Light's strips are showing.
+//
+//   ./build/linktest [-v] [-s seed] [-t s]
+//
+// Runs the Light sketch with a Console on the far end of its Serial1.  The Console is a
+// model: its loop() takes 1-20 ms, and now and then 20-60 ms, and it changes the lights
+// every 20 ms, but it talks to the Light through the firmware's own LightLink
+// (Simon_Link.h) and EasyTransfer.  It runs concurrently with the Light, so it can send
+// in the middle of a show().  While show() has interrupts off, the Light's UART keeps
+// three bytes and overruns on the rest (hal/HardwareSerial.h).
+// Each Light mode runs with flow control, where every frame must arrive whole, and then
+// again with the Console sending as soon as a change is due, as it used to.
+// Reports frames sent, taken and lost, UART overruns, and how long a change took to
+// reach the Light.
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include <EasyTransfer.h>
+
+#include "Host.h"
+#include "Check.h"
+#include "Sketch.h"
+#include <Simon_Common.h>
+#include <Simon_Link.h>
+#include <Strip.h>
+
+#define CHANGE_MS 20UL // the Console's lights change this often
+#define TAIL_US 200000ULL // after the last change, for the last frame to get there
+#define MAX_SAMPLES 65536
+
+extern systemState inst;
+
+//------ the Console's end of the wire
+
+class ConsolePort : public Stream, public SerialDevice {
+  public:
+    // from the Light
+    void receive(uint8_t b, unsigned long long at) {
+      if ( this->count == sizeof(this->rx) ) return;
+      byte tail = (this->head + this->count) % sizeof(this->rx);
+      this->rx[tail] = b;
+      this->rxAt[tail] = at;
+      this->count++;
+    }
+    int available() {
+      int n = 0;
+      while ( n < this->count && this->rxAt[(this->head + n) % sizeof(this->rx)] <= hostClock.now() ) n++;
+      return ( n );
+    }
+    int peek() {
+      return ( available() ? this->rx[this->head] : -1 );
+    }
+    int read() {
+      if ( !available() ) return ( -1 );
+      uint8_t b = this->rx[this->head];
+      this->head = (this->head + 1) % sizeof(this->rx);
+      this->count--;
+      return ( b );
+    }
+    void flush() {}
+
+    // to the Light, 10 bits a byte at the Light's baud
+    size_t write(uint8_t b) {
+      unsigned long long now = hostClock.now();
+      if ( this->txFreeAt < now ) this->txFreeAt = now;
+      this->txFreeAt += Serial1.byteTime();
+      Serial1.inject(b, this->txFreeAt);
+      return ( 1 );
+    }
+    using Print::write;
+
+  private:
+    uint8_t rx[256];
+    unsigned long long rxAt[256];
+    int head, count;
+    unsigned long long txFreeAt;
+};
+
+static ConsolePort port;
+static systemState state;
+static EasyTransfer ET;
+static LightLink link;
+
+static uint32_t rng;
+static uint32_t next() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return ( rng );
+}
+
+// how long the rest of the Console's loop() takes, us
+static unsigned long long loopTime() {
+  if ( next() % 20 == 0 ) return ( (20 + next() % 41) * 1000ULL );
+  return ( (1 + next() % 20) * 1000ULL );
+}
+
+static boolean flow, running, owed;
+static unsigned long long changeAt, stopChanges;
+static unsigned long long changedAt[256]; // by packetNumber
+static unsigned long sent;
+
+// the Console's loop(), as Network::update() does it
+static void console(void *arg) {
+  unsigned long long now = hostClock.now();
+  link.update(millis());
+
+  // the lights change; the newest goes in the next frame
+  if ( now >= changeAt && now < stopChanges ) {
+    state.packetNumber++;
+    byte lit = state.packetNumber % N_COLORS;
+    for ( byte c = 0; c < N_COLORS; c++ ) {
+      state.light[c].red = state.light[c].green = state.light[c].blue = c == lit ? 255 : 0;
+    }
+    changedAt[state.packetNumber] = now;
+    owed = true;
+    changeAt += CHANGE_MS * 1000ULL;
+  }
+
+  if ( owed && (!flow || link.clear()) ) {
+    ET.sendData();
+    link.sent();
+    sent++;
+    owed = false;
+  }
+
+  if ( running ) hostClock.schedule(now + loopTime(), console);
+}
+
+//------ the runs
+
+typedef struct {
+  const char *name;
+  byte animation; // animationInstruction
+} lightMode;
+
+static const lightMode modes[] = {
+  { "Idle", A_Idle },
+  { "GameplayPressed", A_GameplayPressed },
+  { "TronCycles", A_TronCycles },
+};
+#define N_MODES (sizeof(modes) / sizeof(modes[0]))
+
+static int compare(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return ( (x > y) - (x < y) );
+}
+
+static double percentile(double *v, unsigned long n, double p) {
+  if ( n == 0 ) return ( 0 );
+  unsigned long i = (unsigned long)(p * (n - 1) + 0.5);
+  return ( v[i] );
+}
+
+static double lag[MAX_SAMPLES];
+
+static void run(const lightMode &m, boolean withFlow, unsigned long seconds, uint32_t seed) {
+  rng = seed ? seed : 1;
+  flow = withFlow;
+  link.begin(&port);
+  state.animation = m.animation;
+  owed = false;
+  sent = 0;
+
+  unsigned long framesIn = showScheduler.framesIn, framesLost = showScheduler.framesLost;
+  unsigned long overrun = Serial1.rxOverrun;
+  unsigned long n = 0;
+
+  unsigned long long start = hostClock.now();
+  changeAt = start;
+  stopChanges = start + seconds * 1000000ULL;
+  running = true;
+  hostClock.schedule(start + loopTime(), console);
+
+  byte lastNumber = inst.packetNumber;
+  while ( hostClock.now() < stopChanges + TAIL_US ) {
+    loop();
+    // a change is in when the Light has its frame
+    if ( inst.packetNumber != lastNumber ) {
+      lastNumber = inst.packetNumber;
+      if ( n < MAX_SAMPLES ) lag[n++] = (hostClock.now() - changedAt[lastNumber]) / 1000.0;
+    }
+  }
+  // the Console stops; the Light finishes with whatever's on the wire
+  running = false;
+  unsigned long long settled = hostClock.now() + 100000ULL;
+  while ( hostClock.now() < settled ) loop();
+
+  framesIn = showScheduler.framesIn - framesIn;
+  framesLost = showScheduler.framesLost - framesLost;
+  overrun = Serial1.rxOverrun - overrun;
+
+  if ( withFlow ) {
+    CHECK(overrun == 0);
+    CHECK(framesLost == 0);
+    CHECK(framesIn == sent);
+    CHECK(memcmp(&inst, &state, sizeof(systemState)) == 0);
+  }
+
+  qsort(lag, n, sizeof(double), compare);
+  printf("  %-16s %-7s | %5lu %5lu %5lu %7lu | %5.1f %5.1f %5.1f\n",
+         m.name, withFlow ? "xon" : "none", sent, framesIn, sent - framesIn, overrun,
+         percentile(lag, n, 0.5), percentile(lag, n, 0.99), n ? lag[n - 1] : 0);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  uint32_t seed = 1;
+  unsigned long seconds = 20;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atol(argv[++i]);
+    else if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) seconds = atol(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [-v] [-s seed] [-t s]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  hostBegin();
+  Serial.echo(verbose);
+  Serial1.attach(&port);
+  hostPins.setAnalog(A5, seed & 0x3FF);
+  setup();
+  ET.begin(details(state), &port);
+
+  printf("  mode             console | frames sent    in  lost overrun | change to Light ms: p50 p99 max\n");
+  for ( byte i = 0; i < N_MODES; i++ ) run(modes[i], true, seconds, seed);
+  // then as it was.  a frame lost part way leaves EasyTransfer waiting on the rest, and it takes
+  // the next frame's bytes for them, so these go last.
+  for ( byte i = 0; i < N_MODES; i++ ) run(modes[i], false, seconds, seed);
+
+  printf("linktest: %s, %.1f s virtual\n", failures ? "FAILED" : "ok", hostClock.now() / 1e6);
+  return ( failures ? 1 : 0 );
+}
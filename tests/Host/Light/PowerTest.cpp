@@ -0,0 +1,271 @@
+// Light power limiter test: the strips' draw, estimated and as shown, against the supply's cap.
+//
+//   ./build/powertest [-v] [-s seed]
+//
+// First the estimate: random frames, read off NEO_GRB bytes and off channel sums, against
+// FastLED's power_mgt (hal/FastLED.h) on the same colors in RGB.  Then the limiter on its own,
+// synthetic demands: the limit comes down to fit at once and goes back up POWER_RECOVER a
+// frame.  Then the Light, every strip full white and back to black, a frame at a time: what
+// goes out on the wires (counted off the bytes each show() leaves on the LEDs) never tops the
+// cap, and with little lit the limit stays off and the bytes are what was drawn.  Last, a
+// gradient drawn once on the rim and the placard, the limit down and back up over it by the
+// other strips: it goes out as it did before, not darkened or banded by the limit it went through.
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include <FastLED.h>
+
+#include "Host.h"
+#include "Check.h"
+#include "Sketch.h"
+#include <Strip.h>
+
+#define FRAMES 200 // random frames for the estimate
+#define SETTLE 40 // frames for every strip to show, and the limit to settle
+
+extern Adafruit_NeoMatrix rimJob, rimBack, rimEffect;
+extern IndexedStrip redL, grnL, bluL, yelL;
+extern Adafruit_NeoPixel cirL, placL;
+
+//------ the estimate
+
+static void estimate() {
+  static CRGB rgb[RIM_X * RIM_Y];
+  Adafruit_NeoPixel strip(RIM_X * RIM_Y), dim(RIM_X * RIM_Y);
+  dim.setBrightness(100);
+
+  int worst = 0, worstDim = 0;
+  for ( int f = 0; f < FRAMES; f++ ) {
+    // mostly dark, some of it bright, as the animations are
+    uint32_t r = 0, g = 0, b = 0;
+    for ( uint16_t i = 0; i < strip.numPixels(); i++ ) {
+      rgb[i] = random(4) ? CRGB(random(40), random(40), random(40)) : CRGB(random(256), random(256), random(256));
+      strip.setPixelColor(i, rgb[i].r, rgb[i].g, rgb[i].b);
+      dim.setPixelColor(i, rgb[i].r, rgb[i].g, rgb[i].b);
+      r += rgb[i].r;
+      g += rgb[i].g;
+      b += rgb[i].b;
+    }
+    long reference = calculate_unscaled_power_mW(rgb, strip.numPixels()) / 5 + POWER_MCU_MA;
+
+    PowerLimiter p;
+    p.begin();
+    p.demand(0, strip.getPixels(), strip.numPixels(), strip.getBrightness());
+    worst = max(worst, (int)labs(p.demanded() - reference));
+    p.demand(0, r, g, b, strip.numPixels());
+    worst = max(worst, (int)labs(p.demanded() - reference));
+
+    // bytes that went in at a brightness: what they'd be at full, less what scale8() lost
+    p.demand(0, dim.getPixels(), dim.numPixels(), dim.getBrightness());
+    worstDim = max(worstDim, (int)(labs(p.demanded() - reference) * 100 / reference));
+  }
+  // each channel rounds its own way
+  CHECK(worst <= 3);
+  CHECK(worstDim <= 3);
+  printf("  estimate against power_mgt, %d frames of %d | worst %d mA, at brightness 100 %d%%\n",
+         FRAMES, RIM_X * RIM_Y, worst, worstDim);
+}
+
+//------ the limiter, on demands
+
+static void limiter() {
+  PowerLimiter p;
+  p.begin(1000);
+  CHECK(p.limit() == 255);
+
+  // 4 A of white wanted, 1 A to be had
+  p.demand(0, 255UL * 100, 255UL * 100, 255UL * 100, 200);
+  CHECK(p.update());
+  CHECK(p.limit() < 255 && p.limit() >= POWER_MIN_LIMIT);
+  CHECK(p.drawn() <= 1000 && p.drawn() > 900);
+  CHECK(!p.update());
+  uint8_t fit = p.limit();
+
+  // half of it off: back up, a little at a time
+  p.demand(0, 255UL * 50, 255UL * 50, 255UL * 50, 200);
+  int frames = 0;
+  uint8_t was = p.limit();
+  while ( p.update() ) {
+    CHECK(p.limit() > was && p.limit() <= was + POWER_RECOVER);
+    CHECK(p.drawn() <= 1000);
+    was = p.limit();
+    frames++;
+  }
+  CHECK(frames > 1 && p.limit() > fit);
+
+  // and all of it on again: down at once
+  p.demand(0, 255UL * 100, 255UL * 100, 255UL * 100, 200);
+  CHECK(p.update() && p.limit() == fit);
+
+  // more than the dark pixels alone can have: as low as it goes
+  p.demand(0, 255UL * 100, 255UL * 100, 255UL * 100, 2000);
+  p.update();
+  CHECK(p.limit() == POWER_MIN_LIMIT);
+
+  // everything off: all the way up
+  p.demand(0, 0, 0, 0, 200);
+  for ( int f = 0; f < 255 / POWER_RECOVER + 1; f++ ) p.update();
+  CHECK(p.limit() == 255);
+  CHECK(p.frames > 0 && p.limited < p.frames);
+}
+
+//------ the Light
+
+// what each wire has on it, mA, by the bytes the last show() left on the LEDs
+static uint16_t wired[HOST_NUM_PINS];
+static void shown(Adafruit_NeoPixel &strip) {
+  uint32_t r = 0, g = 0, b = 0;
+  for ( uint16_t i = 0; i < strip.numPixels(); i++ ) {
+    uint32_t c = strip.shownColor(i);
+    r += (c >> 16) & 0xFF;
+    g += (c >> 8) & 0xFF;
+    b += c & 0xFF;
+  }
+  wired[strip.getPin()] = POWER_MA(r, g, b, strip.numPixels());
+}
+
+static uint16_t onTheWires() {
+  uint32_t total = POWER_MCU_MA;
+  for ( byte p = 0; p < HOST_NUM_PINS; p++ ) total += wired[p];
+  return ( total );
+}
+
+// a frame, as loop() has it: layers into the rim, then the shows
+static uint16_t most;
+static void frame() {
+  unsigned long long start = hostClock.now();
+  compositor.update();
+  showScheduler.update();
+  hostClock.advanceTo(start + SHOW_FRAME * 1000ULL);
+  most = max(most, onTheWires());
+}
+
+static void everything(colorInstruction color) {
+  for ( uint16_t i = 0; i < rimEffect.numPixels(); i++ ) rimEffect.setPixelColor(i, color.red, color.green, color.blue);
+  compositor.drawn(rimEffect);
+  setStripColor(redL, color);
+  setStripColor(grnL, color);
+  setStripColor(bluL, color);
+  setStripColor(yelL, color);
+  setStripColor(cirL, color);
+  setStripColor(placL, color);
+}
+
+static void light() {
+  rimLayers(false, true);
+  for ( int f = 0; f < SETTLE; f++ ) frame();
+
+  // a button lit: nowhere near the cap
+  colorInstruction red = cRed;
+  setStripColor(redL, red);
+  most = 0;
+  for ( int f = 0; f < SETTLE; f++ ) frame();
+  CHECK(powerLimiter.limit() == 255);
+  CHECK(redL.getBrightness() == 255 && cirL.getBrightness() == 255 && rimJob.getBrightness() == 255);
+  uint16_t dim = most;
+
+  // and everything white
+  unsigned long limitedBefore = powerLimiter.limited;
+  colorInstruction white = cWhite;
+  everything(white);
+  most = 0;
+  int toFit = -1;
+  for ( int f = 0; f < SETTLE; f++ ) {
+    frame();
+    if ( toFit < 0 && powerLimiter.limit() < 255 ) toFit = f + 1;
+  }
+  // the first frame's shows wait on the Console's window; the limit is on before they go
+  CHECK(toFit > 0 && toFit <= 2);
+  CHECK(most <= POWER_MAX_MA);
+  CHECK(most > POWER_MAX_MA * 9 / 10);
+  CHECK(powerLimiter.demanded() > 2 * POWER_MAX_MA);
+  CHECK(powerLimiter.limited > limitedBefore);
+  uint16_t white_ = most, whiteAtFull = powerLimiter.demanded();
+  uint8_t whiteLimit = powerLimiter.limit();
+
+  // and off again: the limit back up, a step a frame
+  colorInstruction off = cOff;
+  everything(off);
+  uint8_t was = powerLimiter.limit();
+  int toFull = 0;
+  for ( int f = 0; f < 4 * SETTLE && was < 255; f++ ) {
+    frame();
+    CHECK(powerLimiter.limit() >= was && powerLimiter.limit() <= was + POWER_RECOVER);
+    if ( powerLimiter.limit() != was ) toFull = f + 1;
+    was = powerLimiter.limit();
+  }
+  CHECK(powerLimiter.limit() == 255);
+
+  // with it off, what's drawn goes out as drawn
+  setStripColor(cirL, red);
+  for ( int f = 0; f < SETTLE; f++ ) frame();
+  CHECK(cirL.shownColor(0) == Adafruit_NeoPixel::Color(255, 0, 0));
+  CHECK(cirL.getBrightness() == 255);
+
+  // a gradient drawn once, and what it went out as
+  static uint32_t rimWas[RIM_X * RIM_Y], placWas[PLACARD_N];
+  for ( uint16_t i = 0; i < rimEffect.numPixels(); i++ ) rimEffect.setPixelColor(i, i % 256, 255 - i % 256, i / 2 % 256);
+  compositor.drawn(rimEffect);
+  for ( uint16_t i = 0; i < placL.numPixels(); i++ ) placL.setPixelColor(i, i * 14, 3 + i * 7, 255 - i * 13);
+  showScheduler.show(placL);
+  for ( int f = 0; f < SETTLE; f++ ) frame();
+  CHECK(powerLimiter.limit() == 255);
+  for ( uint16_t i = 0; i < rimJob.numPixels(); i++ ) rimWas[i] = rimJob.shownColor(i);
+  for ( uint16_t i = 0; i < placL.numPixels(); i++ ) placWas[i] = placL.shownColor(i);
+
+  // the limit down over it, and back up
+  setStripColor(redL, white);
+  setStripColor(grnL, white);
+  setStripColor(bluL, white);
+  setStripColor(yelL, white);
+  setStripColor(cirL, white);
+  for ( int f = 0; f < SETTLE; f++ ) frame();
+  CHECK(powerLimiter.limit() < 255);
+  setStripColor(redL, off);
+  setStripColor(grnL, off);
+  setStripColor(bluL, off);
+  setStripColor(yelL, off);
+  setStripColor(cirL, off);
+  for ( int f = 0; f < 4 * SETTLE && powerLimiter.limit() < 255; f++ ) frame();
+  for ( int f = 0; f < SETTLE; f++ ) frame();
+  CHECK(powerLimiter.limit() == 255);
+  int rimOff = 0, placOff = 0;
+  for ( uint16_t i = 0; i < rimJob.numPixels(); i++ ) rimOff += rimJob.shownColor(i) != rimWas[i];
+  for ( uint16_t i = 0; i < placL.numPixels(); i++ ) placOff += placL.shownColor(i) != placWas[i];
+  CHECK(rimOff == 0);
+  CHECK(placOff == 0);
+  CHECK(placL.getBrightness() == 255 && rimJob.getBrightness() == 255);
+
+  printf("  Light, cap %d mA         |  at full  on wires  limit  frames\n", POWER_MAX_MA);
+  printf("  a button red            |  %7s  %8u  %5d\n", "", dim, 255);
+  printf("  everything white        |  %7u  %8u  %5u  %6d to fit\n", whiteAtFull, white_, whiteLimit, toFit);
+  printf("  everything off          |  %7s  %8s  %5u  %6d to full\n", "", "", powerLimiter.limit(), toFull);
+  printf("  a gradient, limit through | pixels off after: rim %d, placard %d\n", rimOff, placOff);
+  printf("  peak %u mA, limited %lu of %lu frames\n", powerLimiter.peak, powerLimiter.limited, powerLimiter.frames);
+}
+
+int main(int argc, char **argv) {
+  boolean verbose = false;
+  unsigned int seed = 1;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( strcmp(argv[i], "-v") == 0 ) verbose = true;
+    else if ( strcmp(argv[i], "-s") == 0 && i + 1 < argc ) seed = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [-v] [-s seed]\n", argv[0]);
+      return ( 2 );
+    }
+  }
+
+  hostBegin();
+  Serial.echo(verbose);
+  neoPixelShown = shown;
+  setup();
+
+  randomSeed(seed);
+  estimate();
+  limiter();
+  light();
+
+  printf("powertest: %s\n", failures ? "FAILED" : "ok");
+  return ( failures ? 1 : 0 );
+}
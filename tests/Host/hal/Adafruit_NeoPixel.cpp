@@ -0,0 +1,139 @@
+#include "Adafruit_NeoPixel.h"
+#include "Host.h"
+
+void (*neoPixelShown)(Adafruit_NeoPixel &strip) = NULL;
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, uint8_t p, uint8_t t) : shows(0), numLEDs(n), numBytes(n * 3), pin(p)
+  ,brightness(0), pixels(NULL), type(t), endTime(0) {
+  if ( (pixels = (uint8_t *)malloc(numBytes)) ) memset(pixels, 0, numBytes);
+  if ( (shown = (uint8_t *)malloc(numBytes)) ) memset(shown, 0, numBytes);
+  if ( t & NEO_GRB ) { // GRB vs RGB; might add others if needed
+    rOffset = 1;
+    gOffset = 0;
+    bOffset = 2;
+  } else if ( t & NEO_BRG ) {
+    rOffset = 1;
+    gOffset = 2;
+    bOffset = 0;
+  } else {
+    rOffset = 0;
+    gOffset = 1;
+    bOffset = 2;
+  }
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel() {
+  if ( pixels ) free(pixels);
+  if ( shown ) free(shown);
+}
+
+void Adafruit_NeoPixel::begin(void) {
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, LOW);
+}
+
+void Adafruit_NeoPixel::show(void) {
+  if ( !pixels ) return;
+
+  // hold off for the latch, then clock every bit out with interrupts off
+  while ( !canShow() );
+  noInterrupts();
+  hostClock.advance((unsigned long long)numLEDs * NEO_PIXEL_US);
+  memcpy(shown, pixels, numBytes);
+  interrupts();
+  endTime = micros();
+
+  shows++;
+  if ( neoPixelShown ) neoPixelShown(*this);
+}
+
+void Adafruit_NeoPixel::setPin(uint8_t p) {
+  pinMode(pin, INPUT);
+  pin = p;
+  pinMode(p, OUTPUT);
+  digitalWrite(p, LOW);
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+  hostClock.spendCycles(NEO_SET_CYCLES + (brightness ? NEO_SCALE_CYCLES : 0));
+  if ( n < numLEDs ) {
+    if ( brightness ) { // See notes in setBrightness()
+      r = (r * brightness) >> 8;
+      g = (g * brightness) >> 8;
+      b = (b * brightness) >> 8;
+    }
+    uint8_t *p = &pixels[n * 3];
+    p[rOffset] = r;
+    p[gOffset] = g;
+    p[bOffset] = b;
+  }
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c) {
+  setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+uint32_t Adafruit_NeoPixel::Color(uint8_t r, uint8_t g, uint8_t b) {
+  return ( ((uint32_t)r << 16) | ((uint32_t)g << 8) | b );
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const {
+  hostClock.spendCycles(NEO_GET_CYCLES + (brightness ? NEO_UNSCALE_CYCLES : 0));
+  if ( n >= numLEDs ) return ( 0 );
+
+  uint8_t *p = &pixels[n * 3];
+  uint32_t c = ((uint32_t)p[rOffset] << 16) | ((uint32_t)p[gOffset] << 8) | (uint32_t)p[bOffset];
+  // back up to the true color, as the library does (lossy)
+  if ( brightness ) {
+    uint8_t *c_ptr = reinterpret_cast<uint8_t *>(&c);
+    c_ptr[0] = (c_ptr[0] << 8) / brightness;
+    c_ptr[1] = (c_ptr[1] << 8) / brightness;
+    c_ptr[2] = (c_ptr[2] << 8) / brightness;
+  }
+  return ( c );
+}
+
+uint32_t Adafruit_NeoPixel::shownColor(uint16_t n) const {
+  if ( n >= numLEDs ) return ( 0 );
+  uint8_t *p = &shown[n * 3];
+  return ( ((uint32_t)p[rOffset] << 16) | ((uint32_t)p[gOffset] << 8) | (uint32_t)p[bOffset] );
+}
+
+uint8_t Adafruit_NeoPixel::getPin(void) const {
+  return ( pin );
+}
+
+uint8_t *Adafruit_NeoPixel::getPixels(void) const {
+  return ( pixels );
+}
+
+uint16_t Adafruit_NeoPixel::numPixels(void) const {
+  return ( numLEDs );
+}
+
+// the library's: rescales what's in RAM, lossy.  0 in 'brightness' is full (no scaling).
+void Adafruit_NeoPixel::setBrightness(uint8_t b) {
+  uint8_t newBrightness = b + 1;
+  if ( newBrightness != brightness ) {
+    hostClock.spendCycles((unsigned long)numBytes * NEO_RESCALE_CYCLES);
+    uint8_t c, *ptr = pixels, oldBrightness = brightness - 1;
+    uint16_t scale;
+    if ( oldBrightness == 0 ) scale = 0; // Avoid /0
+    else if ( b == 255 ) scale = 65535 / oldBrightness;
+    else scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
+    for ( uint16_t i = 0; i < numBytes; i++ ) {
+      c = *ptr;
+      *ptr++ = (c * scale) >> 8;
+    }
+    brightness = newBrightness;
+  }
+}
+
+uint8_t Adafruit_NeoPixel::getBrightness(void) const {
+  return ( brightness - 1 );
+}
+
+void Adafruit_NeoPixel::clear() {
+  hostClock.spendCycles((unsigned long)numBytes * NEO_CLEAR_CYCLES);
+  memset(pixels, 0, numBytes);
+}
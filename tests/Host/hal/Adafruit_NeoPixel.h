@@ -0,0 +1,92 @@
+// Host stand-in for the Adafruit NeoPixel library.
+//
+// Pixels are kept as the library keeps them (wire order, brightness scaled into RAM), so
+// sketches that read back or poke getPixels() see the same bytes.  Pixel work charges
+// the cycles the Mega spends on it; show() charges the time the strip's bits take on the
+// wire (the library has interrupts off for all of it) and hands the frame to a watcher.
+
+#ifndef ADAFRUIT_NEOPIXEL_H
+#define ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+// 'type' flags for LED pixels (third parameter to constructor):
+#define NEO_RGB     0x00 // Wired for RGB data order
+#define NEO_GRB     0x01 // Wired for GRB data order
+#define NEO_BRG     0x04
+
+#define NEO_COLMASK 0x01
+#define NEO_KHZ800  0x02 // 800 KHz datastream
+#define NEO_SPDMASK 0x02
+#define NEO_KHZ400  0x00 // 400 KHz datastream
+
+// what the library's code costs on the Mega, in cycles; counted off its C, roughly
+#define NEO_SET_CYCLES 60 // setPixelColor(): bounds check, index, three stores
+#define NEO_SCALE_CYCLES 30 // ...and three 8x8 multiplies if brightness is set
+#define NEO_GET_CYCLES 50 // getPixelColor()
+#define NEO_UNSCALE_CYCLES 650 // ...and three 16-bit divides if brightness is set
+#define NEO_RESCALE_CYCLES 12 // setBrightness(), per byte
+#define NEO_CLEAR_CYCLES 4 // clear(), per byte
+
+// on the wire: 24 bits at 800 kHz a pixel, and the latch
+#define NEO_PIXEL_US 30
+#define NEO_LATCH_US 50
+
+class Adafruit_NeoPixel {
+
+ public:
+
+  // Constructor: number of LEDs, pin number, LED type
+  Adafruit_NeoPixel(uint16_t n, uint8_t p=6, uint8_t t=NEO_GRB + NEO_KHZ800);
+  ~Adafruit_NeoPixel();
+
+  void
+    begin(void),
+    show(void),
+    setPin(uint8_t p),
+    setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b),
+    setPixelColor(uint16_t n, uint32_t c),
+    setBrightness(uint8_t),
+    clear();
+  uint8_t
+   *getPixels(void) const,
+    getBrightness(void) const;
+  uint16_t
+    numPixels(void) const;
+  static uint32_t
+    Color(uint8_t r, uint8_t g, uint8_t b);
+  uint32_t
+    getPixelColor(uint16_t n) const;
+  inline bool
+    canShow(void) { return (micros() - endTime) >= 50L; }
+
+  // host side: what went out on the last show(), as packed RGB like getPixelColor() but
+  // as the LEDs have it, brightness and all.
+  uint32_t shownColor(uint16_t n) const;
+  uint8_t getPin(void) const;
+  unsigned long shows;
+
+ private:
+
+  const uint16_t
+    numLEDs,       // Number of RGB LEDs in strip
+    numBytes;      // Size of 'pixels' buffer below
+  uint8_t
+    pin,           // Output pin number
+    brightness,
+   *pixels,        // Holds LED color values (3 bytes each)
+   *shown,         // what the LEDs have
+    rOffset,       // Index of red byte within each 3-byte pixel
+    gOffset,       // Index of green byte
+    bOffset;       // Index of blue byte
+  const uint8_t
+    type;          // Pixel flags (400 vs 800 KHz, RGB vs GRB color)
+  uint32_t
+    endTime;       // Latch timing reference
+
+};
+
+// host side: called after every show(), with the strip that showed.
+extern void (*neoPixelShown)(Adafruit_NeoPixel &strip);
+
+#endif // ADAFRUIT_NEOPIXEL_H
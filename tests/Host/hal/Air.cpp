@@ -0,0 +1,97 @@
+#include "Air.h"
+
+#include <math.h>
+
+Air air;
+
+void Air::transmit(AirFrame &frame, AirListener *sender) {
+  this->frames++;
+  this->bytes += frame.len;
+  this->busy += frame.end - frame.start;
+
+  if ( this->monitor ) this->monitor(frame);
+
+  for ( byte i = 0; i < this->nListeners; i++ ) {
+    if ( this->listener[i] == sender && lose(this->tx[i], frame.start) ) {
+      this->drops++;
+      return;
+    }
+  }
+
+  for ( byte i = 0; i < this->nListeners; i++ ) {
+    if ( this->listener[i] == sender ) continue;
+    if ( lose(this->rx[i], frame.start) ) {
+      this->drops++;
+      continue;
+    }
+    this->listener[i]->hear(frame);
+  }
+}
+
+void Air::listen(AirListener *radio) {
+  for ( byte i = 0; i < this->nListeners; i++ ) {
+    if ( this->listener[i] == radio ) return;
+  }
+  if ( this->nListeners == AIR_MAX_LISTENERS ) return;
+  this->listener[this->nListeners] = radio;
+  setLink(this->rx[this->nListeners], 0, 0);
+  setLink(this->tx[this->nListeners], 0, 0);
+  this->nListeners++;
+}
+
+void Air::ignore(AirListener *radio) {
+  for ( byte i = 0; i < this->nListeners; i++ ) {
+    if ( this->listener[i] != radio ) continue;
+    this->nListeners--;
+    this->listener[i] = this->listener[this->nListeners];
+    this->rx[i] = this->rx[this->nListeners];
+    this->tx[i] = this->tx[this->nListeners];
+    return;
+  }
+}
+
+void Air::setLoss(AirListener *radio, float loss, unsigned long fade) {
+  for ( byte i = 0; i < this->nListeners; i++ ) {
+    if ( this->listener[i] == radio ) setLink(this->rx[i], loss, fade);
+  }
+}
+
+void Air::setSendLoss(AirListener *radio, float loss, unsigned long fade) {
+  for ( byte i = 0; i < this->nListeners; i++ ) {
+    if ( this->listener[i] == radio ) setLink(this->tx[i], loss, fade);
+  }
+}
+
+void Air::setLink(Link &link, float loss, unsigned long fade) {
+  link.loss = constrain(loss, 0.0, 1.0);
+  link.fade = fade;
+  link.faded = false;
+  link.spellEnd = 0;
+}
+
+void Air::seed(uint32_t s) {
+  this->state = s;
+}
+
+boolean Air::lose(Link &link, unsigned long long at) {
+  if ( link.loss <= 0 ) return ( false );
+  if ( link.loss >= 1 ) return ( true );
+  if ( link.fade == 0 ) return ( uniform() < link.loss );
+
+  // alternating clear and faded spells, exponentially long, faded 'loss' of the time
+  while ( link.spellEnd <= at ) {
+    link.faded = !link.faded;
+    float mean = link.faded ? link.fade : link.fade * (1 - link.loss) / link.loss;
+    link.spellEnd += 1 + (unsigned long long)(-mean * log(1.0 - uniform()));
+  }
+  return ( link.faded );
+}
+
+// xorshift32; independent of the sketch's random().  [0,1)
+double Air::uniform() {
+  if ( this->state == 0 ) this->state = 2463534242UL;
+  this->state ^= this->state << 13;
+  this->state ^= this->state >> 17;
+  this->state ^= this->state << 5;
+  return ( this->state / 4294967296.0 );
+}
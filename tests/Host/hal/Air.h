@@ -0,0 +1,72 @@
+// Simulated radio channel shared by every radio stand-in in the process.
+//
+// A transmission occupies the air for its on-air time and is then offered to each
+// listening radio.  Listeners can be given a loss rate, either frame by frame or
+// as fades of some mean length; the drops come from a private generator so they
+// don't disturb the sketch's random() sequence.
+
+#ifndef Air_h
+#define Air_h
+
+#include <Arduino.h>
+
+#define AIR_MAX_DATA 66
+#define AIR_MAX_LISTENERS 8
+
+typedef struct {
+  unsigned long long start, end; // us on the virtual clock
+  uint8_t group, from, to;
+  boolean ackRequested, isAck;
+  uint8_t len;
+  uint8_t data[AIR_MAX_DATA];
+} AirFrame;
+
+// a radio that can hear the channel
+class AirListener {
+  public:
+    virtual ~AirListener() {}
+    virtual void hear(const AirFrame &frame) = 0;
+};
+
+class Air {
+  public:
+    // a radio puts a frame on the air; listeners other than 'sender' hear it.
+    void transmit(AirFrame &frame, AirListener *sender);
+
+    void listen(AirListener *radio);
+    void ignore(AirListener *radio);
+
+    // fraction [0,1] of frames this listener misses.  with 'fade' (mean us) the
+    // losses come as fades that long, 'loss' of the time; otherwise frame by frame.
+    void setLoss(AirListener *radio, float loss, unsigned long fade = 0);
+    // the same for everything this radio sends: nobody hears what's lost.
+    void setSendLoss(AirListener *radio, float loss, unsigned long fade = 0);
+    void seed(uint32_t s);
+
+    // if set, every frame is also handed here (sniffer, test recorder)
+    void (*monitor)(const AirFrame &frame);
+
+    // counters
+    unsigned long frames, bytes, drops;
+    unsigned long long busy; // total on-air us
+
+  private:
+    struct Link {
+      float loss;
+      unsigned long fade;
+      boolean faded;
+      unsigned long long spellEnd;
+    };
+    void setLink(Link &link, float loss, unsigned long fade);
+    boolean lose(Link &link, unsigned long long at);
+    double uniform();
+
+    AirListener *listener[AIR_MAX_LISTENERS];
+    Link rx[AIR_MAX_LISTENERS], tx[AIR_MAX_LISTENERS];
+    byte nListeners;
+    uint32_t state;
+};
+
+extern Air air;
+
+#endif
@@ -0,0 +1,169 @@
+#include "Arduino.h"
+#include "Host.h"
+
+// freeRam() in the sketches takes the address of these.
+int *__brkval = 0;
+
+__attribute__((noinline)) int *hostHeapStart() {
+  return ( (int *)((char *)__builtin_frame_address(0) - HOST_FREE_RAM) );
+}
+
+//------ time
+
+unsigned long millis(void) {
+  hostClock.advance(hostClock.readCost());
+  return ( (unsigned long)(hostClock.now() / 1000ULL) );
+}
+
+unsigned long micros(void) {
+  hostClock.advance(hostClock.readCost());
+  // the AVR timer only resolves 4 us
+  return ( (unsigned long)(hostClock.now() & ~3ULL) );
+}
+
+void delay(unsigned long ms) {
+  hostClock.advance(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  hostClock.advance(us);
+}
+
+//------ pins
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  hostPins.pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  hostClock.advance(HOST_DIGITAL_US);
+  hostPins.digitalWrite(pin, val);
+}
+
+int digitalRead(uint8_t pin) {
+  hostClock.advance(HOST_DIGITAL_US);
+  return ( hostPins.level(pin) );
+}
+
+int analogRead(uint8_t pin) {
+  hostClock.advance(HOST_ANALOGREAD_US);
+  return ( hostPins.analogRead(pin) );
+}
+
+void analogWrite(uint8_t pin, int val) {
+  hostClock.advance(HOST_DIGITAL_US);
+  hostPins.analogWrite(pin, val);
+}
+
+void analogReference(uint8_t mode) {
+}
+
+//------ interrupts
+
+// external interrupt number to Mega pin
+static uint8_t interruptPin(uint8_t interruptNum) {
+  static const uint8_t pins[] = { 2, 3, 21, 20, 19, 18 };
+  if ( interruptNum >= sizeof(pins) ) return ( 0xFF );
+  return ( pins[interruptNum] );
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
+  hostPins.attach(interruptPin(interruptNum), userFunc, mode);
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  hostPins.detach(interruptPin(interruptNum));
+}
+
+void interrupts() {
+  hostPins.enableInterrupts(true);
+}
+
+void noInterrupts() {
+  hostPins.enableInterrupts(false);
+}
+
+//------ math
+
+// avr-libc's do_random(), so seeded games play out as they do on the Mega.
+static uint32_t randomState = 1;
+
+static long doRandom(uint32_t *ctx) {
+  int32_t hi, lo, x;
+
+  x = *ctx;
+  if ( x == 0 ) x = 123459876L;
+  hi = x / 127773L;
+  lo = x % 127773L;
+  x = 16807L * lo - 2836L * hi;
+  if ( x < 0 ) x += 0x7fffffffL;
+  return ( (*ctx = x) % ((uint32_t)0x7fffffffL + 1) );
+}
+
+long random(long howbig) {
+  hostClock.spendCycles(HOST_RANDOM_CYCLES);
+  if ( howbig == 0 ) return ( 0 );
+  return ( doRandom(&randomState) % howbig );
+}
+
+long random(long howsmall, long howbig) {
+  if ( howsmall >= howbig ) return ( howsmall );
+  return ( random(howbig - howsmall) + howsmall );
+}
+
+void randomSeed(unsigned int seed) {
+  if ( seed != 0 ) randomState = seed;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return ( (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min );
+}
+
+unsigned int makeWord(unsigned int w) {
+  return ( w );
+}
+
+unsigned int makeWord(unsigned char h, unsigned char l) {
+  return ( (h << 8) | l );
+}
+
+//------ avr-libc conversions
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *sout) {
+  sprintf(sout, "%*.*f", width, prec, val);
+  return ( sout );
+}
+
+static char *toRadix(unsigned long val, char *s, int radix, boolean negative) {
+  char buf[8 * sizeof(long) + 2];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  if ( radix < 2 || radix > 36 ) radix = 10;
+  do {
+    int d = val % radix;
+    *--p = d < 10 ? '0' + d : 'a' + d - 10;
+    val /= radix;
+  } while ( val );
+  if ( negative ) *--p = '-';
+  strcpy(s, p);
+  return ( s );
+}
+
+char *itoa(int val, char *s, int radix) {
+  // avr-libc: only base 10 is signed
+  if ( radix == 10 && val < 0 ) return ( toRadix(-(long)val, s, radix, true) );
+  return ( toRadix((unsigned int)val, s, radix, false) );
+}
+
+char *ltoa(long val, char *s, int radix) {
+  if ( radix == 10 && val < 0 ) return ( toRadix(-(unsigned long)val, s, radix, true) );
+  return ( toRadix((unsigned long)val, s, radix, false) );
+}
+
+char *utoa(unsigned int val, char *s, int radix) {
+  return ( toRadix(val, s, radix, false) );
+}
+
+char *ultoa(unsigned long val, char *s, int radix) {
+  return ( toRadix(val, s, radix, false) );
+}
@@ -0,0 +1,133 @@
+// Host stand-in for the Arduino core.
+//
+// Just enough of the AVR core for the Simon sketches and their bundled libraries to
+// compile and run on Linux.  millis() and micros() read the virtual clock in Host.h,
+// so time only moves when the sketch (or a test) spends it.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "avr/pgmspace.h"
+
+typedef uint8_t boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define DEFAULT 1
+#define EXTERNAL 0
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+// templates rather than the core's macros, so host tooling can still use <algorithm>.
+template<class T, class U> inline auto min(const T &a, const U &b) -> decltype(a < b ? a : b) { return a < b ? a : b; }
+template<class T, class U> inline auto max(const T &a, const U &b) -> decltype(a > b ? a : b) { return a > b ? a : b; }
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define sq(x) ((x)*(x))
+
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) (bitvalue ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+#ifndef _BV
+#define _BV(b) (1UL << (b))
+#endif
+
+// Mega 2560 pin numbering, so A0..A15 don't collide with the digital pins.
+#define NUM_DIGITAL_PINS 70
+static const uint8_t A0 = 54;
+static const uint8_t A1 = 55;
+static const uint8_t A2 = 56;
+static const uint8_t A3 = 57;
+static const uint8_t A4 = 58;
+static const uint8_t A5 = 59;
+static const uint8_t A6 = 60;
+static const uint8_t A7 = 61;
+static const uint8_t A8 = 62;
+static const uint8_t A9 = 63;
+static const uint8_t A10 = 64;
+static const uint8_t A11 = 65;
+static const uint8_t A12 = 66;
+static const uint8_t A13 = 67;
+static const uint8_t A14 = 68;
+static const uint8_t A15 = 69;
+static const uint8_t SS = 53;
+
+// digital and analog I/O; values live in hostPins (Host.h)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+void analogReference(uint8_t mode);
+
+// time, from the virtual clock
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// interrupts
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+void interrupts();
+void noInterrupts();
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+// avr-libc's random(), so a seed plays out the same way it does on the board
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned int seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+unsigned int makeWord(unsigned int w);
+unsigned int makeWord(unsigned char h, unsigned char l);
+#define word(...) makeWord(__VA_ARGS__)
+
+// avr-libc conversions
+char *dtostrf(double val, signed char width, unsigned char prec, char *sout);
+char *itoa(int val, char *s, int radix);
+char *ltoa(long val, char *s, int radix);
+char *utoa(unsigned int val, char *s, int radix);
+char *ultoa(unsigned long val, char *s, int radix);
+
+// freeRam() in the sketches prints a stack address less &__heap_start.  Host addresses
+// move from run to run, so the heap starts a fixed distance below the caller's stack
+// instead, and the printout (and the serial time it costs) is the same every run.
+#define HOST_FREE_RAM 4096
+int *hostHeapStart();
+#define __heap_start *hostHeapStart() // declared, and taken the address of; never more
+
+#include "HardwareSerial.h"
+
+#endif
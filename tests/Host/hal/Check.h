@@ -0,0 +1,21 @@
+// CHECK() for the host tests and benches: a condition that's false is printed on stderr, with
+// the test's name, the line and the virtual time, and counted in 'failures' for main() to
+// return.  The name is the program's, as it was run: build/smoke says "smoke".
+
+#ifndef Check_h
+#define Check_h
+
+#include <errno.h>
+#include <stdio.h>
+#include "Host.h"
+
+static int failures = 0;
+
+#define CHECK(cond) check(cond, #cond, __LINE__)
+static void check(bool ok, const char *what, int line) {
+  if ( ok ) return;
+  fprintf(stderr, "%s: FAIL line %d: %s (t=%.3f s)\n", program_invocation_short_name, line, what, hostClock.now() / 1e6);
+  failures++;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#include "Arduino.h"
+#include "Host.h"
+#include "EEPROM.h"
+
+EEPROMClass EEPROM;
+
+void EEPROMClass::init() {
+  if ( this->ready ) return;
+  memset(this->cell, 0xFF, sizeof(this->cell));
+  this->ready = true;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  init();
+  if ( address < 0 || address >= EEPROM_SIZE ) return ( 0xFF );
+  return ( this->cell[address] );
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  init();
+  if ( address < 0 || address >= EEPROM_SIZE ) return;
+  this->cell[address] = value;
+  this->writes++;
+  hostClock.advance(EEPROM_WRITE_US);
+}
+
+void EEPROMClass::erase() {
+  this->ready = false;
+  init();
+}
+
+void EEPROMClass::preset(int address, uint8_t value) {
+  init();
+  if ( address < 0 || address >= EEPROM_SIZE ) return;
+  this->cell[address] = value;
+}
@@ -0,0 +1,32 @@
+// Host stand-in for the EEPROM library: 4 KB (Mega 2560), erased to 0xFF.
+// Writes cost the 3.3 ms the cell takes to program.
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <inttypes.h>
+
+#define EEPROM_SIZE 4096
+#define EEPROM_WRITE_US 3300
+
+class EEPROMClass {
+  public:
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+
+    // host side: back to factory-fresh, or contents as flashed (no time, not counted).
+    void erase();
+    void preset(int address, uint8_t value);
+    // write counter, for wear checks
+    unsigned long writes;
+
+  private:
+    void init();
+
+    uint8_t cell[EEPROM_SIZE];
+    bool ready;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
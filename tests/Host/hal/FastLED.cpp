@@ -0,0 +1,3 @@
+#include "FastLED.h"
+
+uint16_t rand16seed = RAND16_SEED;
@@ -0,0 +1,231 @@
+// Host stand-in for FastLED: CRGB and the lib8tion calls the Light uses.
+//
+// No controllers or LED drivers; the Light shows through Adafruit NeoPixel.  The math is
+// the library's C fallback (lib8tion/math8.h, scale8.h, colorutils.cpp, with
+// FASTLED_SCALE8_FIXED), so results match the Mega's bit for bit.  Each call charges what
+// the AVR assembly costs, counted off the library's asm, roughly.
+
+#ifndef FASTLED_H
+#define FASTLED_H
+
+#include <Arduino.h>
+#include "Host.h"
+
+#define FASTLED_VERSION 3002001
+
+// what lib8tion costs on the Mega, in cycles
+#define FL_MOVE_CYCLES 6 // a CRGB loaded or stored: three ld/st
+#define FL_TEST_CYCLES 4 // a CRGB tested for black
+#define FL_QADD8_CYCLES 4 // a channel, saturating; qsub8() too
+#define FL_MAX_CYCLES 4 // a channel, cp and branch
+#define FL_SCALE8_CYCLES 7 // a channel: mul, add, clr r1
+#define FL_BLEND8_CYCLES 14 // a channel: two muls and the 16-bit sums
+#define FL_MEM8_CYCLES 4 // memcpy8()/memset8(), per byte
+#define FL_RANDOM8_CYCLES 20 // random8(): the 16-bit LCG step, and the range's mul
+#define FL_PALETTE_CYCLES 16 // ColorFromPalette(): the call, the entry's address and loads
+
+typedef uint8_t fract8;
+
+static inline uint8_t qadd8(uint8_t i, uint8_t j) {
+  hostClock.spendCycles(FL_QADD8_CYCLES);
+  unsigned int t = i + j;
+  return ( t > 255 ? 255 : t );
+}
+
+static inline uint8_t qsub8(uint8_t i, uint8_t j) {
+  hostClock.spendCycles(FL_QADD8_CYCLES);
+  int t = i - j;
+  return ( t < 0 ? 0 : t );
+}
+
+static inline uint8_t scale8(uint8_t i, fract8 scale) {
+  hostClock.spendCycles(FL_SCALE8_CYCLES);
+  return ( ((uint16_t)i * (1 + (uint16_t)scale)) >> 8 );
+}
+
+static inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+  hostClock.spendCycles(FL_BLEND8_CYCLES);
+  uint16_t partial = a * (255 - amountOfB) + a;
+  partial += b * amountOfB + b;
+  return ( partial >> 8 );
+}
+
+// random8.h: X(n+1) = 2053 * X(n) + 13849
+#define RAND16_SEED 1337
+extern uint16_t rand16seed;
+
+static inline uint8_t random8() {
+  hostClock.spendCycles(FL_RANDOM8_CYCLES);
+  rand16seed = (rand16seed * (uint16_t)2053) + (uint16_t)13849;
+  return ( (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8))) );
+}
+
+static inline uint8_t random8(uint8_t lim) {
+  uint8_t r = random8();
+  return ( (r * lim) >> 8 );
+}
+
+static inline uint8_t random8(uint8_t min, uint8_t lim) {
+  return ( random8(lim - min) + min );
+}
+
+static inline void random16_set_seed(uint16_t seed) {
+  rand16seed = seed;
+}
+
+static inline void *memcpy8(void *dst, const void *src, uint16_t num) {
+  hostClock.spendCycles((unsigned long)num * FL_MEM8_CYCLES);
+  return ( memcpy(dst, src, num) );
+}
+
+static inline void *memset8(void *ptr, uint8_t value, uint16_t num) {
+  hostClock.spendCycles((unsigned long)num * FL_MEM8_CYCLES);
+  return ( memset(ptr, value, num) );
+}
+
+struct CRGB {
+  union {
+    struct {
+      union { uint8_t r; uint8_t red; };
+      union { uint8_t g; uint8_t green; };
+      union { uint8_t b; uint8_t blue; };
+    };
+    uint8_t raw[3];
+  };
+
+  inline CRGB() {}
+  inline CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  inline CRGB(const CRGB &rhs) {
+    hostClock.spendCycles(FL_MOVE_CYCLES);
+    r = rhs.r;
+    g = rhs.g;
+    b = rhs.b;
+  }
+  inline CRGB &operator=(const CRGB &rhs) {
+    hostClock.spendCycles(FL_MOVE_CYCLES);
+    r = rhs.r;
+    g = rhs.g;
+    b = rhs.b;
+    return ( *this );
+  }
+
+  // add, saturating at 0xFF
+  inline CRGB &operator+=(const CRGB &rhs) {
+    r = qadd8(r, rhs.r);
+    g = qadd8(g, rhs.g);
+    b = qadd8(b, rhs.b);
+    return ( *this );
+  }
+  // each channel up to the higher of the two
+  inline CRGB &operator|=(const CRGB &rhs) {
+    hostClock.spendCycles(3 * FL_MAX_CYCLES);
+    if ( rhs.r > r ) r = rhs.r;
+    if ( rhs.g > g ) g = rhs.g;
+    if ( rhs.b > b ) b = rhs.b;
+    return ( *this );
+  }
+  // down to N 256ths
+  inline CRGB &nscale8(uint8_t scaledown) {
+    r = scale8(r, scaledown);
+    g = scale8(g, scaledown);
+    b = scale8(b, scaledown);
+    return ( *this );
+  }
+  inline operator bool() const {
+    hostClock.spendCycles(FL_TEST_CYCLES);
+    return ( r || g || b );
+  }
+};
+
+inline bool operator==(const CRGB &lhs, const CRGB &rhs) {
+  hostClock.spendCycles(FL_TEST_CYCLES);
+  return ( lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b );
+}
+inline bool operator!=(const CRGB &lhs, const CRGB &rhs) {
+  return ( !(lhs == rhs) );
+}
+
+// colorutils: 'existing' moves toward 'overlay' by amountOfOverlay/255
+static inline CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay) {
+  if ( amountOfOverlay == 0 ) return ( existing );
+  if ( amountOfOverlay == 255 ) {
+    existing = overlay;
+    return ( existing );
+  }
+  existing.red = blend8(existing.red, overlay.red, amountOfOverlay);
+  existing.green = blend8(existing.green, overlay.green, amountOfOverlay);
+  existing.blue = blend8(existing.blue, overlay.blue, amountOfOverlay);
+  return ( existing );
+}
+
+// colorutils.h: sixteen colors; an index's high nibble picks one, the low blends toward the next
+class CRGBPalette16 {
+  public:
+    CRGB entries[16];
+    CRGBPalette16() {}
+    inline CRGB &operator[](uint8_t x) { return ( entries[x] ); }
+    inline const CRGB &operator[](uint8_t x) const { return ( entries[x] ); }
+};
+
+typedef enum { NOBLEND = 0, LINEARBLEND = 1 } TBlendType;
+
+static inline CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness = 255,
+                                    TBlendType blendType = LINEARBLEND) {
+  hostClock.spendCycles(FL_PALETTE_CYCLES);
+  uint8_t hi4 = index >> 4;
+  uint8_t lo4 = index & 0x0F;
+  const CRGB &entry = pal.entries[hi4];
+  uint8_t red1 = entry.red, green1 = entry.green, blue1 = entry.blue;
+
+  if ( lo4 && blendType != NOBLEND ) {
+    const CRGB &next = pal.entries[hi4 == 15 ? 0 : hi4 + 1];
+    uint8_t f2 = lo4 << 4;
+    uint8_t f1 = 255 - f2;
+    red1 = scale8(red1, f1) + scale8(next.red, f2);
+    green1 = scale8(green1, f1) + scale8(next.green, f2);
+    blue1 = scale8(blue1, f1) + scale8(next.blue, f2);
+  }
+
+  if ( brightness != 255 ) {
+    if ( brightness ) {
+      brightness++; // adjust for rounding
+      if ( red1 ) red1 = scale8(red1, brightness);
+      if ( green1 ) green1 = scale8(green1, brightness);
+      if ( blue1 ) blue1 = scale8(blue1, brightness);
+    } else {
+      red1 = green1 = blue1 = 0;
+    }
+  }
+  return ( CRGB(red1, green1, blue1) );
+}
+
+// power_mgt.cpp: the draw of an RGB buffer at full brightness, and the brightness that keeps it
+// under a budget.  Not charged: the tests use it as the reference for the Light's own estimate.
+#define FL_RED_MW (16 * 5) // 16 mA at 5 V
+#define FL_GREEN_MW (11 * 5)
+#define FL_BLUE_MW (15 * 5)
+#define FL_DARK_MW (1 * 5)
+
+static inline uint32_t calculate_unscaled_power_mW(const CRGB *ledbuffer, uint16_t numLeds) {
+  uint32_t red32 = 0, green32 = 0, blue32 = 0;
+  const uint8_t *p = (const uint8_t *)ledbuffer;
+  for ( uint16_t count = numLeds; count > 0; count-- ) {
+    red32 += *p++;
+    green32 += *p++;
+    blue32 += *p++;
+  }
+  red32 = (red32 * FL_RED_MW) >> 8;
+  green32 = (green32 * FL_GREEN_MW) >> 8;
+  blue32 = (blue32 * FL_BLUE_MW) >> 8;
+  return ( red32 + green32 + blue32 + (uint32_t)FL_DARK_MW * numLeds );
+}
+
+static inline uint8_t calculate_max_brightness_for_power_mW(const CRGB *ledbuffer, uint16_t numLeds,
+                                                            uint8_t target_brightness, uint32_t max_power_mW) {
+  uint32_t total_mW = calculate_unscaled_power_mW(ledbuffer, numLeds);
+  uint32_t requested_power_mW = total_mW * target_brightness / 256;
+  if ( requested_power_mW <= max_power_mW ) return ( target_brightness );
+  return ( (uint32_t)target_brightness * max_power_mW / requested_power_mW );
+}
+
+#endif // FASTLED_H
@@ -0,0 +1,139 @@
+#include "Arduino.h"
+#include "Host.h"
+
+// no constructors: these are zero-initialized before any sketch global runs.
+HardwareSerial Serial, Serial1, Serial2, Serial3;
+
+void HardwareSerial::begin(unsigned long baud) {
+  this->baud = baud;
+  this->txFreeAt = hostClock.now();
+}
+
+void HardwareSerial::end() {
+  flush();
+  this->baud = 0;
+}
+
+void HardwareSerial::attach(SerialDevice *device) {
+  this->device = device;
+}
+
+void HardwareSerial::echo(boolean on) {
+  this->echoing = on;
+}
+
+unsigned long HardwareSerial::byteTime() {
+  if ( this->baud == 0 ) return ( 0 );
+  // start + 8 data + stop
+  return ( (10000000UL + this->baud / 2) / this->baud );
+}
+
+unsigned long long HardwareSerial::txDoneAt() {
+  return ( this->txFreeAt );
+}
+
+size_t HardwareSerial::write(uint8_t b) {
+  // not started; the board would hang here, but there's no point in that.
+  if ( this->baud == 0 ) return ( 1 );
+
+  unsigned long long now = hostClock.now();
+  unsigned long bt = byteTime();
+  if ( this->txFreeAt < now ) this->txFreeAt = now;
+
+  // TX buffer full?  block until the UART drains a byte, like the core does.
+  if ( (this->txFreeAt - now) / bt >= SERIAL_BUFFER_SIZE ) {
+    hostClock.advanceTo(this->txFreeAt - (SERIAL_BUFFER_SIZE - 1) * bt);
+  }
+
+  this->txFreeAt += bt;
+  this->txBytes++;
+
+  if ( this->echoing ) fputc(b, stdout);
+  if ( this->device ) this->device->receive(b, this->txFreeAt);
+
+  return ( 1 );
+}
+
+void HardwareSerial::flush() {
+  if ( this->txFreeAt > hostClock.now() ) hostClock.advanceTo(this->txFreeAt);
+}
+
+void HardwareSerial::inject(uint8_t b, unsigned long long at) {
+  if ( this->pendingCount == SERIAL_PENDING_SIZE ) {
+    this->rxDropped++;
+    return;
+  }
+  unsigned int tail = (this->pendingHead + this->pendingCount) % SERIAL_PENDING_SIZE;
+  this->pending[tail].at = at;
+  this->pending[tail].b = b;
+  this->pendingCount++;
+}
+
+void HardwareSerial::land(uint8_t b) {
+  // the RX ISR drops bytes when the ring is full
+  if ( this->rxCount == SERIAL_BUFFER_SIZE ) {
+    this->rxDropped++;
+  } else {
+    this->rxBuffer[(this->rxHead + this->rxCount) % SERIAL_BUFFER_SIZE] = b;
+    this->rxCount++;
+    this->rxBytes++;
+  }
+}
+
+void HardwareSerial::service() {
+  if ( this->masked ) return;
+
+  unsigned long long now = hostClock.now();
+  while ( this->pendingCount > 0 && this->pending[this->pendingHead].at <= now ) {
+    uint8_t b = this->pending[this->pendingHead].b;
+    this->pendingHead = (this->pendingHead + 1) % SERIAL_PENDING_SIZE;
+    this->pendingCount--;
+    land(b);
+  }
+}
+
+void HardwareSerial::mask(boolean on) {
+  if ( on == this->masked ) return;
+  if ( on ) {
+    // everything up to now made it in
+    service();
+    this->masked = true;
+    return;
+  }
+  this->masked = false;
+
+  // everything since arrived with the ISR off: the UART kept the first few
+  unsigned long long now = hostClock.now();
+  unsigned int held = 0;
+  while ( this->pendingCount > 0 && this->pending[this->pendingHead].at <= now ) {
+    uint8_t b = this->pending[this->pendingHead].b;
+    this->pendingHead = (this->pendingHead + 1) % SERIAL_PENDING_SIZE;
+    this->pendingCount--;
+    if ( held++ < SERIAL_UART_FIFO ) {
+      land(b);
+    } else {
+      this->rxOverrun++;
+      this->rxDropped++;
+    }
+  }
+}
+
+int HardwareSerial::available() {
+  service();
+  return ( this->rxCount );
+}
+
+int HardwareSerial::peek() {
+  service();
+  if ( this->rxCount == 0 ) return ( -1 );
+  return ( this->rxBuffer[this->rxHead] );
+}
+
+int HardwareSerial::read() {
+  service();
+  if ( this->rxCount == 0 ) return ( -1 );
+  uint8_t b = this->rxBuffer[this->rxHead];
+  this->rxHead = (this->rxHead + 1) % SERIAL_BUFFER_SIZE;
+  this->rxCount--;
+  return ( b );
+}
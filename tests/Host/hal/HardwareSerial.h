@@ -0,0 +1,82 @@
+// Host stand-in for the core's HardwareSerial.
+//
+// Bytes take 10 bit-times on the wire at the configured baud.  Writes block once the
+// 64 byte TX buffer is full, exactly as the AVR core does, and bytes arriving to a
+// full RX buffer are dropped and counted.  While interrupts are off, the RX ISR can't
+// run: the UART holds a few bytes and overruns on the rest, and those are counted too.
+
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include <inttypes.h>
+
+#include "Stream.h"
+
+#define SERIAL_BUFFER_SIZE 64
+#define SERIAL_PENDING_SIZE 1024
+#define SERIAL_UART_FIFO 3 // bytes the UART keeps with interrupts off: two in UDR, one in the shifter
+
+// something on the far end of a UART (e.g. the WAV Trigger on Serial2).
+class SerialDevice {
+  public:
+    virtual ~SerialDevice() {}
+    // a byte from the board, done clocking out at virtual time 'at' (us).
+    virtual void receive(uint8_t b, unsigned long long at) = 0;
+};
+
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long baud);
+    void end();
+
+    virtual int available(void);
+    virtual int peek(void);
+    virtual int read(void);
+    virtual void flush(void);
+    virtual size_t write(uint8_t);
+    using Print::write;
+
+    operator bool() { return ( true ); }
+
+    // host side: wire up the far end.
+    void attach(SerialDevice *device);
+    // host side: far end sends a byte, which lands in the RX buffer at 'at' (us).
+    void inject(uint8_t b, unsigned long long at);
+    // host side: copy everything transmitted to stdout.
+    void echo(boolean on);
+    // host side: us to clock one byte out at the current baud.
+    unsigned long byteTime();
+    // host side: virtual time the last queued TX byte finishes.
+    unsigned long long txDoneAt();
+    // host side: interrupts went off (or back on).
+    void mask(boolean on);
+
+    // traffic counters
+    unsigned long txBytes, rxBytes, rxDropped, rxOverrun;
+
+  private:
+    // moves arrived bytes from the wire into the RX buffer.
+    void service();
+    // the RX ISR takes a byte
+    void land(uint8_t b);
+    boolean masked;
+
+    unsigned long baud;
+    SerialDevice *device;
+    boolean echoing;
+    unsigned long long txFreeAt;
+
+    uint8_t rxBuffer[SERIAL_BUFFER_SIZE];
+    uint8_t rxHead, rxCount;
+
+    // bytes on the wire, not yet arrived
+    struct Pending {
+      unsigned long long at;
+      uint8_t b;
+    } pending[SERIAL_PENDING_SIZE];
+    unsigned int pendingHead, pendingCount;
+};
+
+extern HardwareSerial Serial, Serial1, Serial2, Serial3;
+
+#endif
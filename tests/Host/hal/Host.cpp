@@ -0,0 +1,236 @@
+#include "Host.h"
+
+#include "Wire.h"
+#include "SimMPR121.h"
+#include "SimLCD.h"
+#include "SimWavTrigger.h"
+#include "SimMSGEQ7.h"
+
+// no constructors: zero-initialized, so static constructors in the sketch may use them.
+HostClock hostClock;
+HostPins hostPins;
+
+//------ clock
+
+unsigned long long HostClock::now() {
+  return ( this->t );
+}
+
+void HostClock::advance(unsigned long long us) {
+  advanceTo(this->t + us);
+}
+
+void HostClock::advanceTo(unsigned long long at) {
+  if ( at < this->t ) return;
+
+  // callbacks may spend time or schedule more; don't recurse into the queue.
+  if ( !this->running ) {
+    this->running = true;
+    while ( this->nEvents > 0 && this->events[0].at <= at ) {
+      Event e = this->events[0];
+      this->nEvents--;
+      memmove(&this->events[0], &this->events[1], this->nEvents * sizeof(Event));
+      if ( e.at > this->t ) this->t = e.at;
+      e.fn(e.arg);
+    }
+    this->running = false;
+  }
+  if ( at > this->t ) this->t = at;
+
+  if ( this->deadline && this->t > this->deadline ) {
+    fprintf(stderr, "Host: deadline of %llu us passed; sketch is stuck?\n", this->deadline);
+    exit(3);
+  }
+}
+
+void HostClock::spendCycles(unsigned long cycles) {
+  this->cycles += cycles;
+  unsigned long long total = this->cycleRemainder + (unsigned long long)cycles;
+  this->cycleRemainder = total % HOST_CPU_MHZ;
+  advance(total / HOST_CPU_MHZ);
+}
+
+unsigned long long HostClock::cyclesSpent() {
+  return ( this->cycles );
+}
+
+void HostClock::setReadCost(unsigned int us) {
+  this->cost = us;
+}
+
+unsigned int HostClock::readCost() {
+  return ( this->cost ? this->cost : HOST_READ_COST_US );
+}
+
+boolean HostClock::schedule(unsigned long long at, hostCallback fn, void *arg) {
+  if ( this->nEvents == HOST_MAX_EVENTS ) return ( false );
+
+  // keep sorted; equal times run in the order they were scheduled.
+  unsigned int i = this->nEvents;
+  while ( i > 0 && this->events[i - 1].at > at ) {
+    this->events[i] = this->events[i - 1];
+    i--;
+  }
+  this->events[i].at = at;
+  this->events[i].fn = fn;
+  this->events[i].arg = arg;
+  this->nEvents++;
+
+  return ( true );
+}
+
+void HostClock::setDeadline(unsigned long long at) {
+  this->deadline = at;
+}
+
+//------ pins
+
+void HostPins::drive(uint8_t pin, uint8_t level) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  uint8_t was = this->level(pin);
+  this->driven[pin] = true;
+  this->ext[pin] = level ? HIGH : LOW;
+  edge(pin, was, this->level(pin));
+}
+
+void HostPins::release(uint8_t pin) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  uint8_t was = this->level(pin);
+  this->driven[pin] = false;
+  edge(pin, was, this->level(pin));
+}
+
+void HostPins::setAnalog(uint8_t pin, int value) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  this->analog[pin] = constrain(value, 0, 1023);
+}
+
+void HostPins::connect(uint8_t pin, PinDevice *device) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  this->device[pin] = device;
+}
+
+uint8_t HostPins::mode(uint8_t pin) {
+  if ( pin >= HOST_NUM_PINS ) return ( INPUT );
+  return ( this->modes[pin] );
+}
+
+uint8_t HostPins::level(uint8_t pin) {
+  if ( pin >= HOST_NUM_PINS ) return ( LOW );
+  if ( this->driven[pin] ) return ( this->ext[pin] );
+  if ( this->modes[pin] == OUTPUT ) return ( this->out[pin] );
+  if ( this->modes[pin] == INPUT_PULLUP ) return ( HIGH );
+  // writing HIGH to an input turns on the pullup, same as on the AVR
+  return ( this->out[pin] );
+}
+
+int HostPins::pwm(uint8_t pin) {
+  if ( pin >= HOST_NUM_PINS ) return ( 0 );
+  return ( this->duty[pin] );
+}
+
+unsigned long HostPins::writes(uint8_t pin) {
+  if ( pin >= HOST_NUM_PINS ) return ( 0 );
+  return ( this->writeCount[pin] );
+}
+
+void HostPins::pinMode(uint8_t pin, uint8_t mode) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  uint8_t was = level(pin);
+  this->modes[pin] = mode;
+  if ( mode == INPUT_PULLUP ) this->out[pin] = HIGH;
+  else if ( mode == INPUT ) this->out[pin] = LOW;
+  edge(pin, was, level(pin));
+}
+
+void HostPins::digitalWrite(uint8_t pin, uint8_t val) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  uint8_t was = level(pin);
+  this->out[pin] = val ? HIGH : LOW;
+  this->duty[pin] = val ? 255 : 0;
+  this->writeCount[pin]++;
+  edge(pin, was, level(pin));
+  if ( this->device[pin] ) this->device[pin]->written(pin, level(pin));
+}
+
+int HostPins::analogRead(uint8_t pin) {
+  // accepts channel numbers as well as A0..A15, like the core does
+  if ( pin < 16 ) pin += A0;
+  if ( pin >= HOST_NUM_PINS ) return ( 0 );
+  int v = this->device[pin] ? this->device[pin]->reading(pin) : -1;
+  return ( v < 0 ? this->analog[pin] : constrain(v, 0, 1023) );
+}
+
+void HostPins::analogWrite(uint8_t pin, int val) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  this->modes[pin] = OUTPUT;
+  if ( val <= 0 ) digitalWrite(pin, LOW);
+  else if ( val >= 255 ) digitalWrite(pin, HIGH);
+  else {
+    this->out[pin] = HIGH;
+    this->writeCount[pin]++;
+  }
+  this->duty[pin] = constrain(val, 0, 255);
+}
+
+void HostPins::attach(uint8_t pin, void (*isr)(void), int mode) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  this->isr[pin] = isr;
+  this->isrMode[pin] = mode;
+  this->pending[pin] = false;
+}
+
+void HostPins::detach(uint8_t pin) {
+  if ( pin >= HOST_NUM_PINS ) return;
+  this->isr[pin] = NULL;
+  this->pending[pin] = false;
+}
+
+void HostPins::enableInterrupts(boolean on) {
+  this->masked = !on;
+  Serial.mask(this->masked);
+  Serial1.mask(this->masked);
+  Serial2.mask(this->masked);
+  Serial3.mask(this->masked);
+  if ( this->masked ) return;
+
+  // anything that happened while masked is serviced now, like a latched INTF flag.
+  for ( uint8_t pin = 0; pin < HOST_NUM_PINS; pin++ ) {
+    if ( this->pending[pin] && this->isr[pin] ) {
+      this->pending[pin] = false;
+      this->isr[pin]();
+    }
+  }
+}
+
+boolean HostPins::interruptsEnabled() {
+  return ( !this->masked );
+}
+
+void HostPins::edge(uint8_t pin, uint8_t from, uint8_t to) {
+  if ( this->isr[pin] == NULL ) return;
+
+  boolean fire = false;
+  switch ( this->isrMode[pin] ) {
+    case LOW: fire = (to == LOW); break;
+    case CHANGE: fire = (from != to); break;
+    case FALLING: fire = (from == HIGH && to == LOW); break;
+    case RISING: fire = (from == LOW && to == HIGH); break;
+  }
+  if ( !fire ) return;
+
+  if ( this->masked ) this->pending[pin] = true;
+  else this->isr[pin]();
+}
+
+//------ peripherals
+
+void hostBegin() {
+  // Console wiring: MPR121 and LCD on the I2C bus, WAV Trigger on Serial2
+  Wire.attach(MPR121_SIM_ADDRESS, &simMPR121);
+  simMPR121.setIrqPin(3);
+  Wire.attach(LCD_SIM_ADDRESS, &simLCD);
+  simWav.connect(&Serial2);
+  // and its output through an MSGEQ7 to the analog pins; Mic.h's WAV_*_PIN
+  simWavEQ.connect(A2, A1, A0);
+}
@@ -0,0 +1,131 @@
+// Host-side controls for the simulated board.
+//
+// hostClock is the virtual clock behind millis()/micros().  It only moves when the
+// sketch spends time: delay(), bus traffic, ADC reads, and a small charge on every
+// millis()/micros() call so that busy-waits on a Metro still terminate.  Stand-ins for
+// CPU-heavy calls (random(), NeoPixel pixel work) charge the cycles the Mega would spend.
+// Tests can advance it directly and schedule callbacks at a virtual time.
+//
+// hostPins holds pin modes and levels.  Tests drive inputs (and fire interrupts on
+// the edges) and read back outputs and PWM; simulated parts on the pins hear the writes.
+
+#ifndef Host_h
+#define Host_h
+
+#include <Arduino.h>
+
+// what the board spends on common operations, in us
+#define HOST_READ_COST_US 4 // millis()/micros()
+#define HOST_DIGITAL_US 4 // digitalWrite()/digitalRead()
+#define HOST_ANALOGREAD_US 112 // 13 ADC clocks at 125 kHz, plus overhead
+
+// and in cycles, where it's CPU
+#define HOST_CPU_MHZ 16
+#define HOST_RANDOM_CYCLES 1300 // random(n): do_random()'s 32-bit divide and multiplies, and a 32-bit modulo
+
+#define HOST_MAX_EVENTS 256
+#define HOST_NUM_PINS NUM_DIGITAL_PINS
+
+typedef void (*hostCallback)(void *arg);
+
+// something wired to the board's pins (e.g. the MSGEQ7s): told of the sketch's writes, and
+// asked for the voltage on an analog pin.
+class PinDevice {
+  public:
+    virtual ~PinDevice() {}
+    // the sketch wrote 'level' to one of our pins
+    virtual void written(uint8_t pin, uint8_t level) = 0;
+    // 10-bit reading of an analog pin of ours; -1 leaves it to setAnalog()
+    virtual int reading(uint8_t pin) = 0;
+};
+
+class HostClock {
+  public:
+    // virtual time, us since power on
+    unsigned long long now();
+
+    // spend time; scheduled callbacks run at their time, in order.
+    void advance(unsigned long long us);
+    void advanceTo(unsigned long long at);
+
+    // spend CPU cycles at HOST_CPU_MHZ; and all that have been spent this way.
+    void spendCycles(unsigned long cycles);
+    unsigned long long cyclesSpent();
+
+    // per-call charge for millis()/micros().  0 restores the default.
+    void setReadCost(unsigned int us);
+    unsigned int readCost();
+
+    // run fn(arg) once the clock reaches 'at'.  returns false if the queue is full.
+    boolean schedule(unsigned long long at, hostCallback fn, void *arg = NULL);
+
+    // give up (exit 3) if the sketch runs past this time; 0 disables.
+    void setDeadline(unsigned long long at);
+
+  private:
+    unsigned long long t, deadline;
+    unsigned int cost;
+    unsigned long long cycles;
+    unsigned int cycleRemainder; // less than a us, carried
+
+    struct Event {
+      unsigned long long at;
+      hostCallback fn;
+      void *arg;
+    } events[HOST_MAX_EVENTS];
+    unsigned int nEvents;
+    boolean running;
+};
+
+class HostPins {
+  public:
+    // the outside world pulls an input pin to a level, or lets go of it.
+    void drive(uint8_t pin, uint8_t level);
+    void release(uint8_t pin);
+    // voltage at an analog pin, as a 10-bit reading.
+    void setAnalog(uint8_t pin, int value);
+    // wire a simulated part to a pin; NULL disconnects.
+    void connect(uint8_t pin, PinDevice *device);
+
+    // what the sketch has done with a pin
+    uint8_t mode(uint8_t pin);
+    uint8_t level(uint8_t pin);
+    int pwm(uint8_t pin);
+    unsigned long writes(uint8_t pin);
+
+    // used by the core stand-ins
+    void pinMode(uint8_t pin, uint8_t mode);
+    void digitalWrite(uint8_t pin, uint8_t val);
+    int analogRead(uint8_t pin);
+    void analogWrite(uint8_t pin, int val);
+    void attach(uint8_t pin, void (*isr)(void), int mode);
+    void detach(uint8_t pin);
+    void enableInterrupts(boolean on);
+    boolean interruptsEnabled();
+
+  private:
+    // fires the pin's ISR if 'from'->'to' is an edge it wants.
+    void edge(uint8_t pin, uint8_t from, uint8_t to);
+
+    uint8_t modes[HOST_NUM_PINS];
+    uint8_t out[HOST_NUM_PINS];
+    boolean driven[HOST_NUM_PINS];
+    uint8_t ext[HOST_NUM_PINS];
+    int analog[HOST_NUM_PINS];
+    int duty[HOST_NUM_PINS];
+    unsigned long writeCount[HOST_NUM_PINS];
+    PinDevice *device[HOST_NUM_PINS];
+
+    void (*isr[HOST_NUM_PINS])(void);
+    int isrMode[HOST_NUM_PINS];
+    boolean masked; // noInterrupts()
+    boolean pending[HOST_NUM_PINS];
+};
+
+extern HostClock hostClock;
+extern HostPins hostPins;
+
+// attaches the simulated peripherals to their buses.  call once, before setup().
+void hostBegin();
+
+#endif
@@ -0,0 +1,117 @@
+#include "RFM12B.h"
+#include "Host.h"
+
+uint8_t RFM12B::networkID;
+uint8_t RFM12B::nodeID;
+const byte RFM12B::DATAMAXLEN = RF12_MAXDATA;
+
+void RFM12B::Initialize(uint8_t ID, uint8_t freqBand, uint8_t networkid, uint8_t txPower, uint8_t airKbps, uint8_t lowVoltageThreshold) {
+  nodeID = ID;
+  networkID = networkid;
+
+  // datasheet: BR = 10000 / 29 / (R+1) / (1 + cs*7) kbps, cs is bit 7
+  float kbps = 10000.0 / 29.0 / ((airKbps & 0x7F) + 1) / (1 + (airKbps >> 7) * 7);
+  this->usPerByte = 8000.0 / kbps;
+
+  this->receiving = false;
+  this->rxCount = 0;
+  air.listen(this);
+}
+
+unsigned long RFM12B::airTime(uint8_t len) {
+  return ( (unsigned long)((len + RF12_OVERHEAD_BYTES) * this->usPerByte + 0.5) );
+}
+
+void RFM12B::ReceiveStart() {
+  this->receiving = true;
+  this->length = 0;
+}
+
+bool RFM12B::ReceiveComplete() {
+  if ( !this->receiving ) {
+    ReceiveStart();
+    return ( false );
+  }
+
+  // the oldest frame that has finished arriving
+  if ( this->rxCount == 0 || this->rxQueue[this->rxHead].end > hostClock.now() ) return ( false );
+  AirFrame &f = this->rxQueue[this->rxHead];
+  this->rxHead = (this->rxHead + 1) % RF12_RX_QUEUE;
+  this->rxCount--;
+
+  memcpy(this->buffer, f.data, f.len);
+  this->length = f.len;
+  this->sender = f.from;
+  this->dest = f.to;
+  this->ackRequested = f.ackRequested;
+  this->isAck = f.isAck;
+  this->received++;
+
+  // buffer holds until the next ReceiveStart()
+  this->receiving = false;
+  return ( true );
+}
+
+bool RFM12B::CanSend() {
+  // one frame at a time; the channel has no contention model
+  return ( hostClock.now() >= this->txDoneAt );
+}
+
+void RFM12B::SendStart(uint8_t toNodeID, bool requestACK, bool sendACK) {
+  this->pending.group = networkID;
+  this->pending.from = nodeID;
+  this->pending.to = toNodeID;
+  this->pending.ackRequested = requestACK;
+  this->pending.isAck = sendACK;
+  this->pending.start = hostClock.now();
+  this->pending.end = this->pending.start + airTime(this->pending.len);
+  this->txDoneAt = this->pending.end;
+
+  this->sent++;
+  air.transmit(this->pending, this);
+  this->receiving = false;
+}
+
+void RFM12B::SendStart(uint8_t toNodeID, const void *sendBuf, uint8_t sendLen, bool requestACK, bool sendACK, uint8_t waitMode) {
+  if ( sendLen > AIR_MAX_DATA ) sendLen = AIR_MAX_DATA;
+  memcpy(this->pending.data, sendBuf, sendLen);
+  this->pending.len = sendLen;
+  SendStart(toNodeID, requestACK, sendACK);
+  SendWait(waitMode);
+}
+
+void RFM12B::SendACK(const void *sendBuf, uint8_t sendLen, uint8_t waitMode) {
+  SendWait();
+  SendStart(this->sender, sendBuf, sendLen, false, true, waitMode);
+}
+
+void RFM12B::Send(uint8_t toNodeID, const void *sendBuf, uint8_t sendLen, bool requestACK, uint8_t waitMode) {
+  SendWait();
+  SendStart(toNodeID, sendBuf, sendLen, requestACK, false, waitMode);
+}
+
+void RFM12B::SendWait(uint8_t waitMode) {
+  // the ISR clocks the packet out; the sketch waits.
+  if ( hostClock.now() < this->txDoneAt ) hostClock.advanceTo(this->txDoneAt);
+}
+
+bool RFM12B::ACKRequested() {
+  return ( this->ackRequested && !this->isAck && this->dest != 0 );
+}
+
+bool RFM12B::ACKReceived(uint8_t fromNodeID) {
+  if ( !ReceiveComplete() ) return ( false );
+  return ( this->isAck && this->dest == nodeID && (fromNodeID == 0 || this->sender == fromNodeID) );
+}
+
+void RFM12B::hear(const AirFrame &frame) {
+  if ( frame.group != networkID ) return;
+  if ( frame.to != 0 && frame.to != nodeID ) return;
+
+  if ( this->rxCount == RF12_RX_QUEUE ) {
+    this->overruns++;
+    return;
+  }
+  this->rxQueue[(this->rxHead + this->rxCount) % RF12_RX_QUEUE] = frame;
+  this->rxCount++;
+}
@@ -0,0 +1,104 @@
+// Host stand-in for the RFM12B library (LowPowerLab, RF69_COMPAT framing).
+//
+// Same public interface as libraries/RFM12B.  Frames go out on the simulated air
+// channel (Air.h); Send() blocks for the on-air time at the configured bit rate, as
+// the real driver does while the ISR clocks the packet out.
+
+#ifndef RFM12B_h
+#define RFM12B_h
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+
+#include "Air.h"
+
+#define RF12_MAXDATA 128
+#define RF_MAX (RF12_MAXDATA + 6)
+
+#define RF12_315MHZ 0
+#define RF12_433MHZ 1
+#define RF12_868MHZ 2
+#define RF12_915MHZ 3
+
+#define RF12_2v25 0
+#define RF12_2v55 3
+#define RF12_2v65 4
+#define RF12_2v75 5
+#define RF12_3v05 8
+#define RF12_3v15 9
+#define RF12_3v25 10
+
+#define RF12_SLEEP 0
+#define RF12_WAKEUP -1
+
+// preamble x3, sync x2, len, hdr x3, crc x2, tail
+#define RF12_OVERHEAD_BYTES 12
+#define RF12_RX_QUEUE 8
+
+class RFM12B : public AirListener {
+  public:
+    RFM12B() : Data(buffer), DataLen(&length) {}
+
+    static uint8_t networkID;
+    static uint8_t nodeID;
+    static const byte DATAMAXLEN;
+
+    volatile uint8_t *Data;
+    volatile uint8_t *DataLen;
+
+    static void InterruptHandler() {}
+
+    void Initialize(uint8_t nodeid, uint8_t freqBand, uint8_t groupid = 0xAA, uint8_t txPower = 0, uint8_t airKbps = 0x7F, uint8_t lowVoltageThreshold = RF12_2v75);
+    void SetCS(uint8_t pin) {}
+    void ReceiveStart();
+    bool ReceiveComplete();
+    bool CanSend();
+    uint16_t Control(uint16_t cmd) { return ( 0 ); }
+
+    void SendStart(uint8_t toNodeId, bool requestACK = false, bool sendACK = false);
+    void SendStart(uint8_t toNodeId, const void *sendBuf, uint8_t sendLen, bool requestACK = false, bool sendACK = false, uint8_t waitMode = SLEEP_MODE_STANDBY);
+    void SendACK(const void *sendBuf = "", uint8_t sendLen = 0, uint8_t waitMode = SLEEP_MODE_IDLE);
+    void Send(uint8_t toNodeId, const void *sendBuf, uint8_t sendLen, bool requestACK = false, uint8_t waitMode = SLEEP_MODE_STANDBY);
+    void SendWait(uint8_t waitMode = 0);
+
+    void OnOff(uint8_t value) {}
+    void Sleep(char n) {}
+    void Sleep() {}
+    void Wakeup() {}
+
+    volatile uint8_t *GetData() { return ( Data ); }
+    uint8_t GetDataLen() { return ( length ); }
+    uint8_t GetSender() { return ( sender ); }
+    bool LowBattery() { return ( false ); }
+    bool ACKRequested();
+    bool ACKReceived(uint8_t fromNodeID = 0);
+    static void CryptFunction(bool sending) {}
+    void Encrypt(const uint8_t *key, uint8_t keyLen = 16) {}
+    bool CRCPass() { return ( true ); }
+    bool ReceiveStarted() { return ( false ); }
+
+    // AirListener
+    virtual void hear(const AirFrame &frame);
+
+    // host side: us on air for a payload of this many bytes.
+    unsigned long airTime(uint8_t len);
+
+    // counters
+    unsigned long sent, received, overruns;
+
+  private:
+    uint8_t buffer[RF12_MAXDATA];
+    volatile uint8_t length;
+    uint8_t sender, dest;
+    bool ackRequested, isAck;
+
+    AirFrame pending; // built by SendStart
+    unsigned long long txDoneAt;
+    bool receiving;
+    float usPerByte;
+
+    AirFrame rxQueue[RF12_RX_QUEUE];
+    byte rxHead, rxCount;
+};
+
+#endif
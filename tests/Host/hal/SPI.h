@@ -0,0 +1,35 @@
+// Host stand-in for the SPI library.  Nothing is on the bus; transfers read back 0.
+
+#ifndef _SPI_H_INCLUDED
+#define _SPI_H_INCLUDED
+
+#include <Arduino.h>
+
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV16 0x01
+#define SPI_CLOCK_DIV64 0x02
+#define SPI_CLOCK_DIV128 0x03
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV8 0x05
+#define SPI_CLOCK_DIV32 0x06
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPIClass {
+  public:
+    static void begin() {}
+    static void end() {}
+    static uint8_t transfer(uint8_t data) { return ( 0 ); }
+    static void setBitOrder(uint8_t bitOrder) {}
+    static void setDataMode(uint8_t mode) {}
+    static void setClockDivider(uint8_t rate) {}
+    static void attachInterrupt() {}
+    static void detachInterrupt() {}
+};
+
+extern SPIClass SPI;
+
+#endif
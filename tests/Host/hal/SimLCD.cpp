@@ -0,0 +1,16 @@
+#include "SimLCD.h"
+
+SimLCD simLCD;
+
+boolean SimLCD::write(const uint8_t *data, uint8_t n) {
+  this->writes++;
+  this->bytes += n;
+  if ( n > 0 ) this->port = data[n - 1];
+  return ( true );
+}
+
+uint8_t SimLCD::read(uint8_t *data, uint8_t n) {
+  // quasi-bidirectional pins idle high
+  for ( uint8_t i = 0; i < n; i++ ) data[i] = 0xFF;
+  return ( n );
+}
@@ -0,0 +1,27 @@
+// Simulated 20x4 HD44780 LCD behind a PCF8574 I2C backpack.
+//
+// Accepts the expander writes (and their bus time) and answers the library's probe
+// read.  Only traffic is counted; the display contents aren't decoded.
+
+#ifndef SimLCD_h
+#define SimLCD_h
+
+#include <Arduino.h>
+#include "Wire.h"
+
+#define LCD_SIM_ADDRESS 0x27
+
+class SimLCD : public I2CDevice {
+  public:
+    virtual boolean write(const uint8_t *data, uint8_t n);
+    virtual uint8_t read(uint8_t *data, uint8_t n);
+
+    // traffic counters
+    unsigned long writes, bytes;
+    // last value on the expander pins
+    uint8_t port;
+};
+
+extern SimLCD simLCD;
+
+#endif
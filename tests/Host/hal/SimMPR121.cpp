@@ -0,0 +1,134 @@
+#include "SimMPR121.h"
+#include "Host.h"
+
+// register map, from the datasheet
+#define REG_TS1 0x00
+#define REG_TS2 0x01
+#define REG_OORS2 0x03
+#define REG_E0FDL 0x04
+#define REG_E0BV 0x1E
+#define REG_MHDR 0x2B
+#define REG_AFE1 0x5C
+#define REG_AFE2 0x5D
+#define REG_ECR 0x5E
+#define REG_SRST 0x80
+
+SimMPR121 simMPR121;
+
+static void pressEvent(void *arg) {
+  simMPR121.touch((uint8_t)(uintptr_t)arg, true);
+}
+static void releaseEvent(void *arg) {
+  simMPR121.touch((uint8_t)(uintptr_t)arg, false);
+}
+
+void SimMPR121::touch(uint8_t electrode, boolean on) {
+  if ( electrode >= MPR121_SIM_ELECTRODES ) return;
+  uint16_t was = this->mask;
+  if ( on ) this->mask |= 1 << electrode;
+  else this->mask &= ~(1 << electrode);
+  if ( this->mask != was ) setIrq(true);
+}
+
+void SimMPR121::pressAt(uint8_t electrode, unsigned long long at) {
+  hostClock.schedule(at, pressEvent, (void *)(uintptr_t)electrode);
+}
+
+void SimMPR121::releaseAt(uint8_t electrode, unsigned long long at) {
+  hostClock.schedule(at, releaseEvent, (void *)(uintptr_t)electrode);
+}
+
+void SimMPR121::releaseAll() {
+  if ( this->mask ) setIrq(true);
+  this->mask = 0;
+}
+
+uint16_t SimMPR121::touched() {
+  return ( this->mask );
+}
+
+void SimMPR121::setProximity(uint8_t electrode, int delta) {
+  if ( electrode >= MPR121_SIM_ELECTRODES ) return;
+  this->proximity[electrode] = delta;
+}
+
+void SimMPR121::setIrqPin(uint8_t pin) {
+  if ( this->irqWired ) hostPins.release(this->irqPin); // back to the pull-up
+  this->irqWired = pin != 0xFF;
+  this->irqPin = pin;
+  if ( this->irqWired ) hostPins.drive(pin, HIGH);
+}
+
+void SimMPR121::setIrq(boolean asserted) {
+  if ( this->irqWired ) hostPins.drive(this->irqPin, asserted ? LOW : HIGH);
+}
+
+void SimMPR121::reset() {
+  memset(this->reg, 0, sizeof(this->reg));
+  this->reg[REG_AFE1] = 0x10;
+  this->reg[REG_AFE2] = 0x24;
+  this->pointer = 0;
+  this->powered = true;
+}
+
+void SimMPR121::refresh() {
+  if ( !this->powered ) reset();
+
+  // ECR[3:0] is how many electrodes are running; 0 is stop mode.
+  uint8_t running = this->reg[REG_ECR] & 0x0F;
+  if ( running > 12 ) running = 12;
+  uint16_t enabled = (1 << running) - 1;
+  // ECR[5:4] enables the 13th (proximity) electrode
+  if ( this->reg[REG_ECR] & 0x30 ) enabled |= 1 << 12;
+
+  uint16_t status = this->mask & enabled;
+  this->reg[REG_TS1] = status & 0xFF;
+  this->reg[REG_TS2] = (status >> 8) & 0x1F;
+
+  for ( uint8_t e = 0; e < MPR121_SIM_ELECTRODES; e++ ) {
+    int filtered = MPR121_SIM_BASELINE - this->proximity[e];
+    if ( status & (1 << e) ) filtered -= MPR121_SIM_TOUCH_DELTA;
+    filtered = constrain(filtered, 0, 1023);
+    this->reg[REG_E0FDL + 2 * e] = filtered & 0xFF;
+    this->reg[REG_E0FDL + 2 * e + 1] = (filtered >> 8) & 0x03;
+    this->reg[REG_E0BV + e] = MPR121_SIM_BASELINE >> 2;
+  }
+}
+
+boolean SimMPR121::write(const uint8_t *data, uint8_t n) {
+  if ( !this->powered ) reset();
+  this->writes++;
+
+  // address-only transaction: nothing to do
+  if ( n == 0 ) return ( true );
+
+  this->pointer = data[0];
+  for ( uint8_t i = 1; i < n; i++ ) {
+    if ( this->pointer == REG_SRST ) {
+      if ( data[i] == 0x63 ) reset();
+      continue;
+    }
+    // status and data registers are read-only
+    if ( this->pointer >= REG_MHDR && this->pointer < sizeof(this->reg) ) this->reg[this->pointer] = data[i];
+    this->pointer++;
+  }
+
+  return ( true );
+}
+
+uint8_t SimMPR121::read(uint8_t *data, uint8_t n) {
+  refresh();
+  this->reads++;
+
+  for ( uint8_t i = 0; i < n; i++ ) {
+    if ( this->pointer == REG_TS1 || this->pointer == REG_TS2 ) {
+      this->statusReads++;
+      // reading status clears ~IRQ
+      setIrq(false);
+    }
+    data[i] = this->pointer < sizeof(this->reg) ? this->reg[this->pointer] : 0;
+    this->pointer++;
+  }
+
+  return ( n );
+}
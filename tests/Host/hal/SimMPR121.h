@@ -0,0 +1,60 @@
+// Simulated MPR121 capacitive touch controller on the I2C bus.
+//
+// Register-level model: the library's soft reset, readback checks, threshold writes,
+// status and filtered/baseline reads all behave as on the chip.  Tests press and
+// release electrodes now, or at a virtual time; ~IRQ goes low on a status change
+// and is released when the status registers are read.
+
+#ifndef SimMPR121_h
+#define SimMPR121_h
+
+#include <Arduino.h>
+#include "Wire.h"
+
+#define MPR121_SIM_ADDRESS 0x5A
+#define MPR121_SIM_ELECTRODES 13
+
+// untouched filtered reading, and how far a touch pulls it down
+#define MPR121_SIM_BASELINE 640
+#define MPR121_SIM_TOUCH_DELTA 40
+
+class SimMPR121 : public I2CDevice {
+  public:
+    // electrode state, now or at a virtual time (us)
+    void touch(uint8_t electrode, boolean on);
+    void pressAt(uint8_t electrode, unsigned long long at);
+    void releaseAt(uint8_t electrode, unsigned long long at);
+    void releaseAll();
+    uint16_t touched();
+
+    // something hovering near an electrode: filtered reading drops by 'delta'.
+    void setProximity(uint8_t electrode, int delta);
+
+    // wire ~IRQ to a pin (open drain, board pull-up).  0xFF disconnects.
+    void setIrqPin(uint8_t pin);
+
+    // I2CDevice
+    virtual boolean write(const uint8_t *data, uint8_t n);
+    virtual uint8_t read(uint8_t *data, uint8_t n);
+
+    // traffic counters
+    unsigned long reads, writes, statusReads;
+
+  private:
+    void reset();
+    void refresh(); // live registers from the electrode state
+    void setIrq(boolean asserted);
+
+    uint8_t reg[0x81];
+    uint8_t pointer;
+    boolean powered;
+
+    uint16_t mask;
+    int proximity[MPR121_SIM_ELECTRODES];
+    uint8_t irqPin;
+    boolean irqWired;
+};
+
+extern SimMPR121 simMPR121;
+
+#endif
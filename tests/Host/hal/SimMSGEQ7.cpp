@@ -0,0 +1,33 @@
+#include "SimMSGEQ7.h"
+
+SimMSGEQ7 simWavEQ;
+
+void SimMSGEQ7::connect(uint8_t resetPin, uint8_t strobePin, uint8_t outPin) {
+  this->resetPin = resetPin;
+  this->strobePin = strobePin;
+  this->outPin = outPin;
+  this->band = -1;
+  hostPins.connect(resetPin, this);
+  hostPins.connect(strobePin, this);
+  hostPins.connect(outPin, this);
+}
+
+void SimMSGEQ7::setLevels(bandLevel levels) {
+  this->levels = levels;
+}
+
+void SimMSGEQ7::written(uint8_t pin, uint8_t level) {
+  if ( pin == this->resetPin && level == HIGH ) {
+    this->band = -1;
+    this->resets++;
+  } else if ( pin == this->strobePin && level == LOW ) {
+    // the multiplexer wraps around after the last band
+    this->band = (this->band + 1) % MSGEQ7_SIM_BANDS;
+  }
+}
+
+int SimMSGEQ7::reading(uint8_t pin) {
+  if ( pin != this->outPin || !this->levels || this->band < 0 ) return ( -1 );
+  this->reads++;
+  return ( this->levels(this->band, hostClock.now()) );
+}
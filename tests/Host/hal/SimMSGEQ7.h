@@ -0,0 +1,40 @@
+// Simulated MSGEQ7 seven-band graphic equalizer, on three of the board's pins.
+//
+// As on the chip: a pulse on RESET starts it over, each falling edge on STROBE puts the next
+// band (63 Hz first, 16 kHz last) on OUT, and the sketch reads it with analogRead().  What
+// each band has on it is up to the test, as a 10-bit reading at a virtual time; until it
+// says, OUT reads whatever setAnalog() put there.
+
+#ifndef SimMSGEQ7_h
+#define SimMSGEQ7_h
+
+#include <Arduino.h>
+#include "Host.h"
+
+#define MSGEQ7_SIM_BANDS 7
+
+// a band's reading at a virtual time (us)
+typedef int (*bandLevel)(uint8_t band, unsigned long long at);
+
+class SimMSGEQ7 : public PinDevice {
+  public:
+    void connect(uint8_t resetPin, uint8_t strobePin, uint8_t outPin);
+    void setLevels(bandLevel levels);
+
+    // PinDevice
+    virtual void written(uint8_t pin, uint8_t level);
+    virtual int reading(uint8_t pin);
+
+    // counters
+    unsigned long resets, reads;
+
+  private:
+    uint8_t resetPin, strobePin, outPin;
+    int band; // on OUT; -1 after a reset, until the first strobe
+    bandLevel levels;
+};
+
+// on the WAV Trigger's output
+extern SimMSGEQ7 simWavEQ;
+
+#endif
@@ -0,0 +1,190 @@
+#include "SimWavTrigger.h"
+#include "Host.h"
+
+#include <wavTrigger.h> // command codes
+
+SimWavTrigger simWav;
+
+void SimWavTrigger::connect(HardwareSerial *port) {
+  this->port = port;
+  port->attach(this);
+}
+
+void SimWavTrigger::receive(uint8_t b, unsigned long long at) {
+  // hunt for the start of message
+  if ( this->rxCount == 0 && b != 0xf0 ) return;
+  if ( this->rxCount == 1 && b != 0xaa ) {
+    this->rxCount = 0;
+    this->badFrames++;
+    return;
+  }
+
+  this->rx[this->rxCount++] = b;
+
+  if ( this->rxCount < 3 ) return;
+  uint8_t len = this->rx[2];
+  if ( len < 5 || len > sizeof(this->rx) ) {
+    this->rxCount = 0;
+    this->badFrames++;
+    return;
+  }
+  if ( this->rxCount < len ) return;
+
+  if ( this->rx[len - 1] == 0x55 ) {
+    this->frames++;
+    execute(this->rx, at);
+  } else {
+    this->badFrames++;
+  }
+  this->rxCount = 0;
+}
+
+void SimWavTrigger::execute(const uint8_t *msg, unsigned long long at) {
+  uint8_t cmd = msg[3];
+  this->commands[cmd & 0x0F]++;
+  expire(at);
+
+  int track;
+  switch ( cmd ) {
+    case CMD_TRACK_CONTROL:
+      track = msg[5] | (msg[6] << 8);
+      switch ( msg[4] ) {
+        case TRK_PLAY_SOLO:
+          for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) this->voice[v].track = 0;
+          play(track, at);
+          break;
+        case TRK_PLAY_POLY:
+          play(track, at);
+          break;
+        case TRK_STOP:
+          stop(track, at);
+          break;
+      }
+      break;
+    case CMD_STOP_ALL:
+      for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) this->voice[v].track = 0;
+      break;
+    case CMD_MASTER_VOLUME:
+      this->master = (int16_t)(msg[4] | (msg[5] << 8));
+      break;
+    case CMD_GET_STATUS:
+      status(at);
+      break;
+    case CMD_TRACK_VOLUME:
+      track = msg[4] | (msg[5] << 8);
+      if ( track > 0 && track < WAV_SIM_TRACKS ) this->trackGain[track] = (int16_t)(msg[6] | (msg[7] << 8));
+      break;
+    case CMD_TRACK_FADE: {
+      track = msg[4] | (msg[5] << 8);
+      unsigned int ms = msg[8] | (msg[9] << 8);
+      if ( track > 0 && track < WAV_SIM_TRACKS ) this->trackGain[track] = (int16_t)(msg[6] | (msg[7] << 8));
+      // fade with the stop flag frees the voice when the fade is done
+      if ( msg[10] ) {
+        for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) {
+          if ( this->voice[v].track == track ) this->voice[v].endsAt = min(this->voice[v].endsAt, at + ms * 1000ULL);
+        }
+      }
+      break;
+    }
+  }
+}
+
+void SimWavTrigger::play(int track, unsigned long long at) {
+  if ( track <= 0 || track >= WAV_SIM_TRACKS ) return;
+
+  // restarting a playing track reuses its voice
+  byte slot = WAV_SIM_VOICES;
+  for ( byte v = 0; v < WAV_SIM_VOICES && slot == WAV_SIM_VOICES; v++ ) {
+    if ( this->voice[v].track == track ) slot = v;
+  }
+  for ( byte v = 0; v < WAV_SIM_VOICES && slot == WAV_SIM_VOICES; v++ ) {
+    if ( this->voice[v].track == 0 ) slot = v;
+  }
+  // all busy: the board steals the oldest voice
+  if ( slot == WAV_SIM_VOICES ) {
+    slot = 0;
+    for ( byte v = 1; v < WAV_SIM_VOICES; v++ ) {
+      if ( this->voice[v].startedAt < this->voice[slot].startedAt ) slot = v;
+    }
+    this->steals++;
+  }
+
+  unsigned long length = this->trackLength[track] ? this->trackLength[track] : WAV_SIM_TRACK_MS;
+  this->voice[slot].track = track;
+  this->voice[slot].startedAt = at;
+  this->voice[slot].endsAt = at + length * 1000ULL;
+
+  this->plays++;
+  this->lastPlayed = track;
+  this->lastPlayedAt = at;
+}
+
+void SimWavTrigger::stop(int track, unsigned long long at) {
+  for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) {
+    if ( this->voice[v].track == track ) {
+      this->voice[v].track = 0;
+      this->stops++;
+    }
+  }
+}
+
+void SimWavTrigger::expire(unsigned long long at) {
+  for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) {
+    if ( this->voice[v].track && this->voice[v].endsAt <= at ) this->voice[v].track = 0;
+  }
+}
+
+// STATUS: f0 aa len 83 [track LSB, MSB]... 55, with tracks 0-indexed on the wire.
+void SimWavTrigger::status(unsigned long long at) {
+  uint8_t msg[5 + 2 * WAV_SIM_VOICES];
+  byte n = 0;
+  for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) {
+    if ( this->voice[v].track == 0 ) continue;
+    msg[4 + 2 * n] = (this->voice[v].track - 1) & 0xFF;
+    msg[5 + 2 * n] = (this->voice[v].track - 1) >> 8;
+    n++;
+  }
+  msg[0] = 0xf0;
+  msg[1] = 0xaa;
+  msg[2] = 5 + 2 * n;
+  msg[3] = 0x83;
+  msg[4 + 2 * n] = 0x55;
+
+  unsigned long long t = at + WAV_SIM_REPLY_US;
+  unsigned long bt = this->port->byteTime();
+  for ( byte i = 0; i < msg[2]; i++ ) {
+    t += bt;
+    this->port->inject(msg[i], t);
+  }
+}
+
+void SimWavTrigger::setTrackLength(int track, unsigned long ms) {
+  if ( track <= 0 || track >= WAV_SIM_TRACKS ) return;
+  this->trackLength[track] = ms;
+}
+
+boolean SimWavTrigger::playing(int track) {
+  expire(hostClock.now());
+  for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) {
+    if ( this->voice[v].track == track ) return ( true );
+  }
+  return ( false );
+}
+
+byte SimWavTrigger::voices() {
+  expire(hostClock.now());
+  byte n = 0;
+  for ( byte v = 0; v < WAV_SIM_VOICES; v++ ) {
+    if ( this->voice[v].track ) n++;
+  }
+  return ( n );
+}
+
+int SimWavTrigger::gain(int track) {
+  if ( track <= 0 || track >= WAV_SIM_TRACKS ) return ( 0 );
+  return ( this->trackGain[track] );
+}
+
+int SimWavTrigger::masterGain() {
+  return ( this->master );
+}
@@ -0,0 +1,62 @@
+// Simulated Robertsonics WAV Trigger on a UART.
+//
+// Parses the serial protocol (f0 aa len cmd ... 55), keeps the 14 polyphonic voices
+// the board has, and answers GET_STATUS with the playing tracks, paced at the baud
+// rate.  Tracks run for a fixed length unless told otherwise.
+
+#ifndef SimWavTrigger_h
+#define SimWavTrigger_h
+
+#include <Arduino.h>
+
+#define WAV_SIM_VOICES 14
+#define WAV_SIM_TRACKS 1000
+#define WAV_SIM_TRACK_MS 30000UL // default track length
+#define WAV_SIM_REPLY_US 500 // board's turnaround before a status reply
+
+class SimWavTrigger : public SerialDevice {
+  public:
+    // plug into a UART on the board
+    void connect(HardwareSerial *port);
+
+    virtual void receive(uint8_t b, unsigned long long at);
+
+    // how long a track plays for before stopping on its own
+    void setTrackLength(int track, unsigned long ms);
+
+    // what's sounding at the current virtual time
+    boolean playing(int track);
+    byte voices();
+    int gain(int track);
+    int masterGain();
+
+    // counters
+    unsigned long frames, badFrames, commands[16];
+    unsigned long plays, stops, steals;
+    int lastPlayed;
+    unsigned long long lastPlayedAt; // us, as the board got the command
+
+  private:
+    void execute(const uint8_t *msg, unsigned long long at);
+    void play(int track, unsigned long long at);
+    void stop(int track, unsigned long long at);
+    void expire(unsigned long long at);
+    void status(unsigned long long at);
+
+    HardwareSerial *port;
+    uint8_t rx[32];
+    uint8_t rxCount;
+
+    struct Voice {
+      int track;
+      unsigned long long startedAt, endsAt;
+    } voice[WAV_SIM_VOICES];
+
+    int trackGain[WAV_SIM_TRACKS];
+    unsigned long trackLength[WAV_SIM_TRACKS];
+    int master;
+};
+
+extern SimWavTrigger simWav;
+
+#endif
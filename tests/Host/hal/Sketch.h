@@ -0,0 +1,13 @@
+// The prototypes the Arduino IDE generates for a sketch's .ino file, so the .ino
+// compiles as plain C++.  Declared here once for every sketch the host build knows.
+
+#ifndef Sketch_h
+#define Sketch_h
+
+void setup();
+void loop();
+
+// Console.ino, Light.ino
+int freeRam();
+
+#endif
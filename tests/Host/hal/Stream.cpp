@@ -0,0 +1,27 @@
+#include "Stream.h"
+#include "Arduino.h"
+
+void Stream::setTimeout(unsigned long timeout) {
+  _timeout = timeout;
+}
+
+// spins on the virtual clock, just like the board spins on the real one.
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if ( c >= 0 ) return ( c );
+  } while ( millis() - start < _timeout );
+  return ( -1 );
+}
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+  size_t count = 0;
+  while ( count < length ) {
+    int c = timedRead();
+    if ( c < 0 ) break;
+    *buffer++ = (char)c;
+    count++;
+  }
+  return ( count );
+}
@@ -0,0 +1,27 @@
+// Host stand-in for the core's Stream class.  Timeouts run on the virtual clock.
+
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print {
+  public:
+    Stream() : _timeout(1000) {}
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+
+    void setTimeout(unsigned long timeout);
+
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return ( readBytes((char *)buffer, length) ); }
+
+  protected:
+    unsigned long _timeout;
+    int timedRead();
+};
+
+#endif
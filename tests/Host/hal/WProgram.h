@@ -0,0 +1,3 @@
+// Pre-1.0 name for Arduino.h, still used by a few of the bundled libraries.
+
+#include <Arduino.h>
@@ -0,0 +1,126 @@
+#include "Arduino.h"
+#include "Host.h"
+#include "Wire.h"
+
+// no constructor: the MPR121 library calls Wire.begin() from its own.
+TwoWire Wire;
+
+void TwoWire::begin() {
+  this->rxIndex = this->rxLength = 0;
+  this->txLength = 0;
+  this->transmitting = false;
+}
+
+void TwoWire::begin(uint8_t address) {
+  begin();
+}
+
+void TwoWire::attach(uint8_t address, I2CDevice *device) {
+  for ( uint8_t i = 0; i < this->nDevices; i++ ) {
+    if ( this->devices[i].address == address ) {
+      this->devices[i].device = device;
+      return;
+    }
+  }
+  if ( this->nDevices == WIRE_MAX_DEVICES ) return;
+  this->devices[this->nDevices].address = address;
+  this->devices[this->nDevices].device = device;
+  this->nDevices++;
+}
+
+I2CDevice *TwoWire::find(uint8_t address) {
+  for ( uint8_t i = 0; i < this->nDevices; i++ ) {
+    if ( this->devices[i].address == address ) return ( this->devices[i].device );
+  }
+  return ( NULL );
+}
+
+// address byte plus n data bytes, and the start/stop framing
+void TwoWire::spend(uint8_t n) {
+  this->transactions++;
+  this->bytes += n;
+  hostClock.advance(WIRE_FRAME_US + (1 + n) * WIRE_BYTE_US);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  this->transmitting = true;
+  this->txAddress = address;
+  this->txLength = 0;
+}
+
+uint8_t TwoWire::endTransmission(void) {
+  return ( endTransmission(true) );
+}
+
+// like the AVR library, a bare endTransmission() re-sends to the last address.
+uint8_t TwoWire::endTransmission(uint8_t sendStop) {
+  I2CDevice *device = find(this->txAddress);
+
+  if ( device == NULL ) {
+    // address NACK; only the address byte went out
+    spend(0);
+    this->nacks++;
+    this->txLength = 0;
+    this->transmitting = false;
+    return ( 2 );
+  }
+
+  spend(this->txLength);
+  boolean ack = device->write(this->txBuffer, this->txLength);
+  this->txLength = 0;
+  this->transmitting = false;
+
+  if ( !ack ) {
+    this->nacks++;
+    return ( 3 );
+  }
+  return ( 0 );
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+  return ( requestFrom(address, quantity, (uint8_t)true) );
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+  if ( quantity > BUFFER_LENGTH ) quantity = BUFFER_LENGTH;
+
+  I2CDevice *device = find(address);
+  uint8_t n = 0;
+  if ( device == NULL ) this->nacks++;
+  else n = device->read(this->rxBuffer, quantity);
+
+  spend(n);
+
+  this->rxIndex = 0;
+  this->rxLength = n;
+  return ( n );
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if ( !this->transmitting || this->txLength >= BUFFER_LENGTH ) return ( 0 );
+  this->txBuffer[this->txLength++] = data;
+  return ( 1 );
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity) {
+  size_t n = 0;
+  while ( quantity-- ) n += write(*data++);
+  return ( n );
+}
+
+int TwoWire::available(void) {
+  return ( this->rxLength - this->rxIndex );
+}
+
+int TwoWire::read(void) {
+  if ( this->rxIndex >= this->rxLength ) return ( -1 );
+  return ( this->rxBuffer[this->rxIndex++] );
+}
+
+int TwoWire::peek(void) {
+  if ( this->rxIndex >= this->rxLength ) return ( -1 );
+  return ( this->rxBuffer[this->rxIndex] );
+}
+
+void TwoWire::flush(void) {
+}
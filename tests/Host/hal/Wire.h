@@ -0,0 +1,79 @@
+// Host stand-in for the Wire (TWI) library.
+//
+// Transactions go to simulated devices registered by address; anything else NACKs.
+// Each byte costs 9 bit-times at 100 kHz on the virtual clock, like the real bus.
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32
+#define WIRE_MAX_DEVICES 8
+
+// us per byte (8 data + ACK at 100 kHz), and per start/stop
+#define WIRE_BYTE_US 90
+#define WIRE_FRAME_US 20
+
+// something on the far end of the I2C bus (e.g. the MPR121).
+class I2CDevice {
+  public:
+    virtual ~I2CDevice() {}
+    // master writes n bytes after addressing us; return false to NACK.
+    virtual boolean write(const uint8_t *data, uint8_t n) = 0;
+    // master reads up to n bytes; returns how many we sent.
+    virtual uint8_t read(uint8_t *data, uint8_t n) = 0;
+};
+
+class TwoWire : public Stream {
+  public:
+    void begin();
+    void begin(uint8_t address);
+    void begin(int address) { begin((uint8_t)address); }
+
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    uint8_t endTransmission(void);
+    uint8_t endTransmission(uint8_t sendStop);
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop);
+    uint8_t requestFrom(int address, int quantity) { return ( requestFrom((uint8_t)address, (uint8_t)quantity) ); }
+    uint8_t requestFrom(int address, int quantity, int sendStop) { return ( requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)sendStop) ); }
+
+    virtual size_t write(uint8_t);
+    virtual size_t write(const uint8_t *, size_t);
+    virtual int available(void);
+    virtual int read(void);
+    virtual int peek(void);
+    virtual void flush(void);
+    using Print::write;
+
+    // host side: put a device on the bus.
+    void attach(uint8_t address, I2CDevice *device);
+
+    // traffic counters
+    unsigned long transactions, bytes, nacks;
+
+  private:
+    I2CDevice *find(uint8_t address);
+    void spend(uint8_t n);
+
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    uint8_t txLength;
+    boolean transmitting;
+
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    uint8_t rxIndex, rxLength;
+
+    struct Slot {
+      uint8_t address;
+      I2CDevice *device;
+    } devices[WIRE_MAX_DEVICES];
+    uint8_t nDevices;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,8 @@
+// Host stand-in for avr/interrupt.h.
+
+#ifndef interrupt_h
+#define interrupt_h
+
+#include <Arduino.h>
+
+#endif
@@ -0,0 +1,8 @@
+// Host stand-in for avr/io.h.  No registers on the host; included for completeness.
+
+#ifndef io_h
+#define io_h
+
+#include <stdint.h>
+
+#endif
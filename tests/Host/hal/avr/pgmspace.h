@@ -0,0 +1,42 @@
+// Host stand-in for avr/pgmspace.h.  Flash and RAM share one address space on the host.
+
+#ifndef pgmspace_h
+#define pgmspace_h
+
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+typedef char prog_char;
+typedef uint8_t prog_uchar;
+typedef uint16_t prog_uint16_t;
+typedef uint32_t prog_uint32_t;
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+// tables of strings are read back with pgm_read_word(); pointers are wider than a word here.
+template<class T> inline uint16_t hostReadWord(const T *addr) { return ( *(const uint16_t *)(addr) ); }
+template<class T> inline uintptr_t hostReadWord(T * const *addr) { return ( (uintptr_t)*addr ); }
+
+#define pgm_read_word(addr) hostReadWord(addr)
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define pgm_read_ptr(addr) (*(void * const *)(addr))
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define memcpy_P memcpy
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+#endif
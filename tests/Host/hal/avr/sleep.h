@@ -0,0 +1,18 @@
+// Host stand-in for avr/sleep.h.  Sleeping is a no-op; the radio stand-ins spend the time.
+
+#ifndef sleep_h
+#define sleep_h
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_ADC 1
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_PWR_SAVE 3
+#define SLEEP_MODE_STANDBY 6
+
+#define set_sleep_mode(mode)
+#define sleep_mode()
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_cpu()
+
+#endif
@@ -0,0 +1,8 @@
+// Host stand-in for the variant pin table; pin numbers are declared in Arduino.h.
+
+#ifndef Pins_Arduino_h
+#define Pins_Arduino_h
+
+#include <Arduino.h>
+
+#endif
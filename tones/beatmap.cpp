@@ -0,0 +1,183 @@
+// Beat map: the win tracks' beats and onsets, worked out from the files ahead of time, for the
+// Console's fanfare to throw fire and move light on.
+//
+//   beatmap [-r first last] file.wav... > ../src/Console/Beats.cpp
+//
+// Only the tracks numbered first..last (502..568, Sound.h's trWins) are mapped; the rest are
+// skipped, so it can be given the whole card.  Each is mixed down to mono and looked at in
+// 10 ms frames, twice: the bass (below ~150 Hz) for beats, and the highs (above ~2 kHz) for
+// onsets.  A beat or onset is where the level jumps: the rise from one frame to the next in dB,
+// a peak among its neighbours, clear of the rises around it, and not too soon after the last.
+// Its level is how loud the band is there, against the track's loudest.  Writes the tables
+// Cues.h describes, cues in time order, track by track.  convert.sh runs it over the card's
+// files; tests/Host's 'make beats' over tones/.  Builds with any C++ compiler; no Arduino here.
+
+#include <math.h>
+#include "wavfile.h"
+
+#define FRAME_MS 10 // the table's time unit; Cues.h
+#define BASS_HZ 150.0
+#define HIGHS_HZ 2000.0
+#define FLOOR_DB 60.0 // below the track's loudest frame counts as silence
+#define PEAK_FRAMES 2 // a rise bigger than those this close either side
+#define MEAN_FRAMES 50 // and clear of the average rise this close either side
+#define CLEAR_DB 3.0 // by this much
+#define BEAT_GAP_MS 100 // apart, at least
+#define LEVEL_DB 30.0 // the range level 0..255 covers, down from the loudest
+
+#define CUE_BEAT 0 // as Cues.h has them
+#define CUE_ONSET 1
+
+struct Cue {
+  int at; // frames
+  int level;
+  int kind;
+};
+
+struct Map {
+  int track;
+  const char *name;
+  std::vector<Cue> cues;
+  int beats, onsets;
+};
+
+// each frame's level in dB: the mono mix through a one-pole filter, twice over, low-pass or what
+// the low-pass takes out
+static std::vector<double> levels(const WavFile &w, double hz, bool low) {
+  double a = 1.0 - exp(-2.0 * M_PI * hz / w.rate);
+  uint32_t frame = w.rate * FRAME_MS / 1000;
+  std::vector<double> db;
+  double y1 = 0, y2 = 0, sum = 0;
+  uint32_t n = 0;
+  for ( uint32_t i = 0; i < w.frames(); i++ ) {
+    double x = w.mono(i) / 32768.0;
+    y1 += a * (x - y1);
+    y2 += a * (y1 - y2);
+    double y = low ? y2 : x - y2;
+    sum += y * y;
+    if ( ++n == frame ) {
+      db.push_back(10.0 * log10(sum / n + 1e-12));
+      sum = 0;
+      n = 0;
+    }
+  }
+
+  double loudest = -120;
+  for ( size_t i = 0; i < db.size(); i++ ) loudest = std::max(loudest, db[i]);
+  for ( size_t i = 0; i < db.size(); i++ ) db[i] = std::max(db[i], loudest - FLOOR_DB) - loudest;
+  return ( db );
+}
+
+// where 'db' jumps; 0 dB is the loudest
+static void onsets(const std::vector<double> &db, int kind, std::vector<Cue> &cues) {
+  int n = db.size();
+  // the rise into each frame; silence before the first
+  std::vector<double> rise(n);
+  for ( int i = 0; i < n; i++ ) rise[i] = std::max(0.0, db[i] - (i ? db[i - 1] : -FLOOR_DB));
+
+  int last = -1000;
+  for ( int i = 0; i < n; i++ ) {
+    bool peak = rise[i] > 0;
+    for ( int j = std::max(0, i - PEAK_FRAMES); peak && j <= std::min(n - 1, i + PEAK_FRAMES); j++ ) {
+      // the first of equals
+      if ( j < i ) peak = rise[j] < rise[i];
+      if ( j > i ) peak = rise[j] <= rise[i];
+    }
+    if ( !peak ) continue;
+
+    double mean = 0;
+    int lo = std::max(0, i - MEAN_FRAMES), hi = std::min(n - 1, i + MEAN_FRAMES);
+    for ( int j = lo; j <= hi; j++ ) mean += rise[j];
+    mean /= hi - lo + 1;
+    if ( rise[i] < mean + CLEAR_DB ) continue;
+    if ( (i - last) * FRAME_MS < BEAT_GAP_MS ) continue;
+    last = i;
+
+    // as loud as it gets in the frame and the next, the attack's
+    double top = std::max(db[i], i + 1 < n ? db[i + 1] : db[i]);
+    Cue c;
+    c.at = i;
+    c.level = (int)lround(255.0 * std::min(1.0, std::max(0.0, 1.0 + top / LEVEL_DB)));
+    c.kind = kind;
+    cues.push_back(c);
+  }
+}
+
+static bool byTime(const Cue &a, const Cue &b) {
+  return ( a.at < b.at || (a.at == b.at && a.kind < b.kind) );
+}
+
+static bool byTrack(const Map &a, const Map &b) {
+  return ( a.track < b.track );
+}
+
+int main(int argc, char **argv) {
+  int first = 502, last = 568;
+  int i = 1;
+  if ( argc > 3 && strcmp(argv[1], "-r") == 0 ) {
+    first = atoi(argv[2]);
+    last = atoi(argv[3]);
+    i = 4;
+  }
+  if ( i >= argc ) {
+    fprintf(stderr, "usage: %s [-r first last] file.wav... > Beats.cpp\n", argv[0]);
+    return ( 2 );
+  }
+
+  std::vector<Map> maps;
+  int bad = 0;
+  for ( ; i < argc; i++ ) {
+    WavFile w;
+    if ( !readWav(argv[i], w, "beatmap") ) {
+      bad++;
+      continue;
+    }
+    if ( w.track < first || w.track > last ) continue;
+
+    Map m;
+    m.track = w.track;
+    m.name = w.name;
+    onsets(levels(w, BASS_HZ, true), CUE_BEAT, m.cues);
+    m.beats = m.cues.size();
+    onsets(levels(w, HIGHS_HZ, false), CUE_ONSET, m.cues);
+    m.onsets = m.cues.size() - m.beats;
+    std::stable_sort(m.cues.begin(), m.cues.end(), byTime);
+    if ( m.cues.empty() || m.cues.back().at > 65535 ) {
+      fprintf(stderr, "beatmap: %s: %s\n", w.name, m.cues.empty() ? "no beats" : "too long");
+      bad++;
+      continue;
+    }
+    maps.push_back(m);
+  }
+  std::stable_sort(maps.begin(), maps.end(), byTrack);
+  for ( size_t m = 1; m < maps.size(); m++ ) {
+    if ( maps[m].track == maps[m - 1].track ) {
+      fprintf(stderr, "beatmap: %s and %s are both track %d\n", maps[m - 1].name, maps[m].name, maps[m].track);
+      bad++;
+    }
+  }
+  if ( bad ) return ( 1 );
+
+  printf("// Made by tones/beatmap from the win tracks' files; don't edit.  See Cues.h.\n\n");
+  printf("#include \"Cues.h\"\n\n");
+  printf("const beatCue beatCues[] PROGMEM = {\n");
+  printf("  // at (10 ms), level, kind\n");
+  int n = 0;
+  for ( size_t m = 0; m < maps.size(); m++ ) {
+    printf("  // %s: %d beats, %d onsets\n", maps[m].name, maps[m].beats, maps[m].onsets);
+    for ( size_t c = 0; c < maps[m].cues.size(); c++ ) {
+      const Cue &q = maps[m].cues[c];
+      printf("  { %5d, %3d, %s },\n", q.at, q.level, q.kind == CUE_BEAT ? "CUE_BEAT " : "CUE_ONSET");
+    }
+  }
+  printf("};\n\n");
+  printf("const beatMap beatMaps[] PROGMEM = {\n");
+  printf("  // track, first cue, cues\n");
+  for ( size_t m = 0; m < maps.size(); m++ ) {
+    printf("  { %3d, %5d, %4d }, // %s\n", maps[m].track, n, (int)maps[m].cues.size(), maps[m].name);
+    n += maps[m].cues.size();
+  }
+  printf("};\n\n");
+  printf("const int N_BEAT_MAPS = %d;\n", (int)maps.size());
+  return ( 0 );
+}
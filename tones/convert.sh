@@ -37,3 +37,14 @@ do
     echo "Processing command: $CMD"
     $CMD
 done
+
+# index what's now here for the Console: each track's length, peak and loop (src/Console/Tracks.cpp)
+SIMON=$(cd "$(dirname "$0")/.." && pwd)
+TABLE="$SIMON/src/Console/Tracks.cpp"
+make -C "$SIMON/tests/Host" build/trackindex && \
+    "$SIMON/tests/Host/build/trackindex" "$CURR_DIR"/[0-9][0-9][0-9]*.wav > "$TABLE.new" && mv "$TABLE.new" "$TABLE"
+
+# and the win tracks' beats, for the fanfare (src/Console/Beats.cpp)
+BEATS="$SIMON/src/Console/Beats.cpp"
+make -C "$SIMON/tests/Host" build/beatmap && \
+    "$SIMON/tests/Host/build/beatmap" "$CURR_DIR"/[0-9][0-9][0-9]*.wav > "$BEATS.new" && mv "$BEATS.new" "$BEATS"
@@ -0,0 +1,83 @@
+// Track index: what the Console needs to know of the WAV Trigger's tracks, off the files.
+//
+//   trackindex file.wav... > ../src/Console/Tracks.cpp
+//
+// Reads each file as the board would, the track number from the first three characters of
+// its name, and writes the table Tracks.h describes: the length, the peak, and the loop
+// points, sorted by track.  The loop is the file's 'smpl' chunk's first, if it has one, and
+// otherwise the whole file, as the board loops it.  convert.sh runs it over the card's files;
+// tests/Host's 'make tracks' over tones/.  Builds with any C++ compiler; no Arduino here.
+
+#include <math.h>
+#include "wavfile.h"
+
+struct Track {
+  int track;
+  unsigned long length; // ms
+  int peak; // dBFS
+  unsigned long loopStart, loopEnd; // ms
+  const char *name;
+};
+
+static bool readTrack(const char *path, Track &t) {
+  WavFile w;
+  if ( !readWav(path, w, "trackindex") ) return ( false );
+  t.track = w.track;
+  t.name = w.name;
+  t.length = (unsigned long)((uint64_t)w.frames() * 1000 / w.rate);
+
+  int most = 0;
+  for ( size_t i = 0; i < w.samples.size(); i++ ) most = std::max(most, abs((int)w.samples[i]));
+  // rounded up: a peak is never quieter than the table says
+  t.peak = most ? (int)ceil(20.0 * log10(most / 32768.0)) : -96;
+
+  t.loopStart = 0;
+  t.loopEnd = t.length;
+  if ( w.looped ) {
+    t.loopStart = (unsigned long)((uint64_t)w.loopStart * 1000 / w.rate);
+    t.loopEnd = (unsigned long)((uint64_t)(w.loopEnd + 1) * 1000 / w.rate);
+  }
+  return ( true );
+}
+
+static bool byTrack(const Track &a, const Track &b) {
+  return ( a.track < b.track );
+}
+
+int main(int argc, char **argv) {
+  if ( argc < 2 ) {
+    fprintf(stderr, "usage: %s file.wav... > Tracks.cpp\n", argv[0]);
+    return ( 2 );
+  }
+
+  std::vector<Track> tracks;
+  int bad = 0;
+  for ( int i = 1; i < argc; i++ ) {
+    Track t;
+    if ( !readTrack(argv[i], t) ) {
+      bad++;
+      continue;
+    }
+    tracks.push_back(t);
+  }
+  std::stable_sort(tracks.begin(), tracks.end(), byTrack);
+  for ( size_t i = 1; i < tracks.size(); i++ ) {
+    if ( tracks[i].track == tracks[i - 1].track ) {
+      fprintf(stderr, "trackindex: %s and %s are both track %d\n", tracks[i - 1].name, tracks[i].name, tracks[i].track);
+      bad++;
+    }
+  }
+  if ( bad ) return ( 1 );
+
+  printf("// Made by tones/trackindex from the WAV Trigger's files; don't edit.  See Tracks.h.\n\n");
+  printf("#include \"Tracks.h\"\n\n");
+  printf("const trackInfo trackTable[] PROGMEM = {\n");
+  printf("  // track, length ms, peak dBFS, loop start ms, loop end ms\n");
+  for ( size_t i = 0; i < tracks.size(); i++ ) {
+    const Track &t = tracks[i];
+    printf("  { %3d, %6luUL, %3d, %6luUL, %6luUL }, // %s\n", t.track, t.length, t.peak, t.loopStart, t.loopEnd, t.name);
+  }
+  printf("};\n\n");
+  printf("const int N_TRACK_INFO = %d;\n", (int)tracks.size());
+  return ( 0 );
+}
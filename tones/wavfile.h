@@ -0,0 +1,108 @@
+// A WAV Trigger file, read for the host tools here (trackindex, beatmap): its track number,
+// format, 16-bit samples, and its 'smpl' loop if it has one.  No Arduino here.
+
+#ifndef wavfile_h
+#define wavfile_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+struct WavFile {
+  int track; // from the first three characters of the name, as the board has it
+  const char *name;
+  uint16_t channels;
+  uint32_t rate;
+  std::vector<int16_t> samples; // interleaved
+  bool looped;
+  uint32_t loopStart, loopEnd; // frames, the end inclusive
+
+  uint32_t frames() const {
+    return ( samples.size() / channels );
+  }
+  // the channels mixed down
+  int mono(uint32_t frame) const {
+    int sum = 0;
+    for ( uint16_t c = 0; c < channels; c++ ) sum += samples[frame * channels + c];
+    return ( sum / channels );
+  }
+};
+
+static inline uint32_t wavLe32(const unsigned char *p) {
+  return ( p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24) );
+}
+static inline uint16_t wavLe16(const unsigned char *p) {
+  return ( p[0] | (p[1] << 8) );
+}
+
+// false, and why on stderr after 'tool', if it isn't a file the board plays
+static inline bool readWav(const char *path, WavFile &w, const char *tool) {
+  const char *slash = strrchr(path, '/');
+  const char *name = slash ? slash + 1 : path;
+  if ( strlen(name) < 3 || !isdigit(name[0]) || !isdigit(name[1]) || !isdigit(name[2]) ) {
+    fprintf(stderr, "%s: %s: no track number\n", tool, path);
+    return ( false );
+  }
+  w.track = (name[0] - '0') * 100 + (name[1] - '0') * 10 + (name[2] - '0');
+  w.name = name;
+
+  FILE *f = fopen(path, "rb");
+  if ( !f ) {
+    perror(path);
+    return ( false );
+  }
+  std::vector<unsigned char> d;
+  unsigned char buf[65536];
+  size_t n;
+  while ( (n = fread(buf, 1, sizeof(buf), f)) > 0 ) d.insert(d.end(), buf, buf + n);
+  fclose(f);
+
+  if ( d.size() < 12 || memcmp(&d[0], "RIFF", 4) || memcmp(&d[8], "WAVE", 4) ) {
+    fprintf(stderr, "%s: %s: not a WAV file\n", tool, path);
+    return ( false );
+  }
+
+  // the chunks we need: format, samples, and loops if any
+  uint16_t format = 0, bits = 0;
+  const unsigned char *data = 0, *smpl = 0;
+  uint32_t dataBytes = 0, smplBytes = 0;
+  w.channels = 0;
+  w.rate = 0;
+  for ( size_t pos = 12; pos + 8 <= d.size(); ) {
+    uint32_t size = wavLe32(&d[pos + 4]);
+    const unsigned char *body = &d[pos + 8];
+    uint32_t have = std::min((size_t)size, d.size() - pos - 8);
+    if ( !memcmp(&d[pos], "fmt ", 4) && have >= 16 ) {
+      format = wavLe16(body);
+      w.channels = wavLe16(body + 2);
+      w.rate = wavLe32(body + 4);
+      bits = wavLe16(body + 14);
+    } else if ( !memcmp(&d[pos], "data", 4) ) {
+      data = body;
+      dataBytes = have;
+    } else if ( !memcmp(&d[pos], "smpl", 4) ) {
+      smpl = body;
+      smplBytes = have;
+    }
+    pos += 8 + size + (size & 1);
+  }
+  if ( format != 1 || bits != 16 || w.channels == 0 || w.rate == 0 || !data ) {
+    fprintf(stderr, "%s: %s: not 16-bit PCM; see convert.sh\n", tool, path);
+    return ( false );
+  }
+
+  w.samples.resize(dataBytes / (2 * w.channels) * w.channels);
+  for ( size_t i = 0; i < w.samples.size(); i++ ) w.samples[i] = (int16_t)wavLe16(data + 2 * i);
+
+  // smpl: 36 bytes, then 24 a loop: id, type, start, end, fraction, count
+  w.looped = smpl && smplBytes >= 36 + 24 && wavLe32(smpl + 28) > 0;
+  w.loopStart = w.looped ? wavLe32(smpl + 36 + 8) : 0;
+  w.loopEnd = w.looped ? wavLe32(smpl + 36 + 12) : 0;
+  return ( true );
+}
+
+#endif